@@ -24,6 +24,7 @@
 #include "common/file.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/queue.h"
 #include "common/util.h"
 
@@ -466,6 +467,233 @@ AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp
 	return new LimitingAudioStream(parentStream, length, disposeAfterUse);
 }
 
+/**
+ * A SeekableAudioStream wrapper which decodes its parent stream into a ring
+ * buffer on a worker thread.
+ *
+ * The worker holds _decodeMutex while it decodes a chunk and appends it to
+ * the ring, so whoever holds _decodeMutex may safely use the parent stream.
+ * _ringMutex only protects the ring state and is held very briefly, so that
+ * the mixer thread never waits for a chunk to be decoded, unless the ring
+ * has run dry.
+ */
+class DecodeAheadStream : public SeekableAudioStream {
+public:
+	DecodeAheadStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse);
+	~DecodeAheadStream();
+
+	/** Prefill the ring and start the worker thread. */
+	bool start();
+
+	/** Do not delete the parent stream on destruction. */
+	void releaseParent() { _disposeAfterUse = DisposeAfterUse::NO; }
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool endOfData() const;
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+
+	bool seek(const Timestamp &where);
+	Timestamp getLength() const { return _length; }
+
+private:
+	enum {
+		kRingSize = 32768,
+		kChunkSize = 4096
+	};
+
+	static void workerProc(void *param);
+
+	/** Decode chunks until the ring is full. Must hold _decodeMutex. */
+	void decodeAhead();
+	/** Decode one chunk into the ring. Must hold _decodeMutex. */
+	bool decodeChunk();
+	/** Copy at most numSamples samples out of the ring. */
+	int readRing(int16 *buffer, int numSamples);
+
+	SeekableAudioStream *_parentStream;
+	DisposeAfterUse::Flag _disposeAfterUse;
+	const bool _stereo;
+	const int _rate;
+	const Timestamp _length;
+
+	Common::Thread _thread;
+	Common::Semaphore _wakeUp;
+	Common::Mutex _decodeMutex;
+	mutable Common::Mutex _ringMutex;
+
+	int16 *_ring;
+	int16 *_chunk;
+	uint _ringRead;
+	uint _ringFill;
+	bool _eos;
+	bool _quit;
+};
+
+DecodeAheadStream::DecodeAheadStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse) :
+		_parentStream(parentStream), _disposeAfterUse(disposeAfterUse),
+		_stereo(parentStream->isStereo()), _rate(parentStream->getRate()), _length(parentStream->getLength()),
+		_ringRead(0), _ringFill(0), _eos(false), _quit(false) {
+	_ring = new int16[kRingSize];
+	_chunk = new int16[kChunkSize];
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	{
+		Common::StackLock lock(_ringMutex);
+		_quit = true;
+	}
+
+	if (_thread.isRunning()) {
+		_wakeUp.post();
+		_thread.join();
+	}
+
+	delete[] _ring;
+	delete[] _chunk;
+
+	if (_disposeAfterUse == DisposeAfterUse::YES)
+		delete _parentStream;
+}
+
+bool DecodeAheadStream::start() {
+	if (!_wakeUp.isValid() || !_thread.start(workerProc, this))
+		return false;
+
+	// Only prefill once the wrapper is sure to be used, otherwise these
+	// samples would be lost with it
+	{
+		Common::StackLock lock(_decodeMutex);
+		decodeChunk();
+	}
+
+	_wakeUp.post();
+	return true;
+}
+
+void DecodeAheadStream::workerProc(void *param) {
+	DecodeAheadStream *stream = (DecodeAheadStream *)param;
+
+	while (true) {
+		stream->_wakeUp.wait();
+
+		Common::StackLock lock(stream->_decodeMutex);
+		{
+			Common::StackLock ringLock(stream->_ringMutex);
+			if (stream->_quit)
+				break;
+		}
+
+		stream->decodeAhead();
+	}
+}
+
+void DecodeAheadStream::decodeAhead() {
+	while (decodeChunk())
+		;
+}
+
+bool DecodeAheadStream::decodeChunk() {
+	{
+		Common::StackLock lock(_ringMutex);
+		if (_quit || _eos || _ringFill + kChunkSize > kRingSize)
+			return false;
+	}
+
+	// The chunk size is even, so stereo streams always return whole frames
+	const int samples = MAX(_parentStream->readBuffer(_chunk, kChunkSize), 0);
+	const bool eos = _parentStream->endOfData();
+
+	Common::StackLock lock(_ringMutex);
+	uint write = (_ringRead + _ringFill) % kRingSize;
+	const uint firstPart = MIN<uint>(samples, kRingSize - write);
+	memcpy(_ring + write, _chunk, firstPart * sizeof(int16));
+	memcpy(_ring, _chunk + firstPart, (samples - firstPart) * sizeof(int16));
+	_ringFill += samples;
+	_eos = eos;
+
+	// Stop if the parent did not deliver anything for now, instead of
+	// spinning on it
+	return samples > 0;
+}
+
+int DecodeAheadStream::readRing(int16 *buffer, int numSamples) {
+	Common::StackLock lock(_ringMutex);
+
+	const uint samples = MIN<uint>(numSamples, _ringFill);
+	const uint firstPart = MIN<uint>(samples, kRingSize - _ringRead);
+	memcpy(buffer, _ring + _ringRead, firstPart * sizeof(int16));
+	memcpy(buffer + firstPart, _ring, (samples - firstPart) * sizeof(int16));
+	_ringRead = (_ringRead + samples) % kRingSize;
+	_ringFill -= samples;
+
+	return samples;
+}
+
+int DecodeAheadStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = readRing(buffer, numSamples);
+
+	if (samples < numSamples) {
+		// The worker fell behind. Wait until it is done with the current
+		// chunk, then take what it produced and decode the rest ourselves.
+		Common::StackLock lock(_decodeMutex);
+		samples += readRing(buffer + samples, numSamples - samples);
+
+		bool eos;
+		{
+			Common::StackLock ringLock(_ringMutex);
+			eos = _eos;
+		}
+
+		if (samples < numSamples && !eos) {
+			samples += MAX(_parentStream->readBuffer(buffer + samples, numSamples - samples), 0);
+
+			Common::StackLock ringLock(_ringMutex);
+			_eos = _parentStream->endOfData();
+		}
+	}
+
+	_wakeUp.post();
+	return samples;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	Common::StackLock lock(_ringMutex);
+	return _eos && _ringFill == 0;
+}
+
+bool DecodeAheadStream::seek(const Timestamp &where) {
+	Common::StackLock lock(_decodeMutex);
+	const bool result = _parentStream->seek(where);
+
+	{
+		Common::StackLock ringLock(_ringMutex);
+		_ringRead = 0;
+		_ringFill = 0;
+		_eos = _parentStream->endOfData();
+	}
+
+	_wakeUp.post();
+	return result;
+}
+
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse) {
+	if (!parentStream)
+		return 0;
+
+	DecodeAheadStream *stream = new DecodeAheadStream(parentStream, disposeAfterUse);
+	if (!stream->start() && disposeAfterUse == DisposeAfterUse::YES) {
+		// No threads, so there is nothing to gain. Without ownership of the
+		// parent the caller still expects a separate object; the wrapper
+		// keeps working then, it simply decodes on demand.
+		stream->releaseParent();
+		delete stream;
+		return parentStream;
+	}
+
+	return stream;
+}
+
 /**
  * An AudioStream that plays nothing and immediately returns that
  * the endOfStream() has been reached
@@ -83,6 +83,16 @@ public:
 	 * By default this maps to endOfData()
 	 */
 	virtual bool endOfStream() const { return endOfData(); }
+
+	/**
+	 * May this stream be rendered on a mixer worker thread, concurrently
+	 * with other streams? Only expensive, self-contained sources (software
+	 * synthesizers, compressed audio decoders) should return true: their
+	 * readBuffer() must not touch state shared with other streams or with
+	 * the engine without proper locking.
+	 * By default this returns false.
+	 */
+	virtual bool supportsParallelRendering() const { return false; }
 };
 
 /**
@@ -126,6 +136,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	bool supportsParallelRendering() const { return _parent->supportsParallelRendering(); }
 
 	/**
 	 * Returns number of loops the stream has played.
@@ -255,6 +266,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	bool supportsParallelRendering() const { return _parent->supportsParallelRendering(); }
 private:
 	Common::DisposablePtr<SeekableAudioStream> _parent;
 
@@ -293,6 +305,7 @@ public:
 
 	bool endOfData() const { return (_pos >= _length) || _parent->endOfData(); }
 	bool endOfStream() const { return (_pos >= _length) || _parent->endOfStream(); }
+	bool supportsParallelRendering() const { return _parent->supportsParallelRendering(); }
 
 	bool seek(const Timestamp &where);
 
@@ -371,6 +384,24 @@ Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo
  */
 AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp &length, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
+/**
+ * Factory function for a SeekableAudioStream wrapper that decodes the parent
+ * stream ahead of time on a worker thread, so that the mixer only has to copy
+ * already decoded samples. This is meant for compressed music and speech,
+ * where decoding is comparatively expensive.
+ *
+ * Seeking and rewinding are passed through to the parent stream, discarding
+ * anything decoded in advance. The parent stream must not be accessed
+ * directly afterwards.
+ *
+ * If the backend does not support threads and the parent stream is to be
+ * disposed of, it is returned as it is.
+ *
+ * @param parentStream    The stream to decode ahead
+ * @param disposeAfterUse Whether the parent stream object should be destroyed on destruction of the returned stream
+ */
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
 /**
  * An AudioStream designed to work in terms of packets.
  *
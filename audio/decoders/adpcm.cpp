@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/simd.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -63,30 +64,46 @@ bool ADPCMStream::rewind() {
 	return true;
 }
 
+uint32 ADPCMStream::readChunk(byte *data, uint32 maxBytes) {
+	if (_stream->eos())
+		return 0;
 
-#pragma mark -
+	const int64 bytesLeft = _endpos - _stream->pos();
+	if (bytesLeft <= 0)
+		return 0;
 
+	return _stream->read(data, MIN<int64>(MIN<uint32>(maxBytes, kChunkSize), bytesLeft));
+}
 
-int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+void ADPCMStream::splitNibbles(const byte *src, uint32 count, byte *high, byte *low) {
+	uint32 i = 0;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
-		}
-
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+#if defined(SCUMMVM_SSE2)
+	const __m128i mask = _mm_set1_epi8(0x0f);
+	for (; i + 16 <= count; i += 16) {
+		const __m128i data = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(high + i), _mm_and_si128(_mm_srli_epi16(data, 4), mask));
+		_mm_storeu_si128((__m128i *)(low + i), _mm_and_si128(data, mask));
+	}
+#elif defined(SCUMMVM_NEON)
+	const uint8x16_t mask = vdupq_n_u8(0x0f);
+	for (; i + 16 <= count; i += 16) {
+		const uint8x16_t data = vld1q_u8(src + i);
+		vst1q_u8(high + i, vshrq_n_u8(data, 4));
+		vst1q_u8(low + i, vandq_u8(data, mask));
 	}
+#endif
 
-	return samples;
+	for (; i < count; i++) {
+		high[i] = src[i] >> 4;
+		low[i] = src[i] & 0x0f;
+	}
 }
 
+
+#pragma mark -
+
+
 static const int16 okiStepSize[49] = {
 	   16,   17,   19,   21,   23,   25,   28,   31,
 	   34,   37,   41,   45,   50,   55,   60,   66,
@@ -97,43 +114,138 @@ static const int16 okiStepSize[49] = {
 	 1552
 };
 
+static inline int16 decodeOKISample(byte code, int32 &last, int32 &stepIndex) {
+	const int32 E = (2 * (code & 0x7) + 1) * okiStepSize[stepIndex] / 8;
+	const int32 diff = (code & 0x08) ? -E : E;
+	// Clip the values to +/- 2^11 (supposed to be 12 bits)
+	last = CLIP<int32>(last + diff, -2048, 2047);
+
+	stepIndex = CLIP<int32>(stepIndex + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(okiStepSize) - 1);
+
+	// * 16 effectively converts 12-bit input to 16-bit output
+	return last * 16;
+}
+
 // Decode Linear to ADPCM
 int16 Oki_ADPCMStream::decodeOKI(byte code) {
-	int16 diff, E, samp;
+	return decodeOKISample(code, _status.ima_ch[0].last, _status.ima_ch[0].stepIndex);
+}
 
-	E = (2 * (code & 0x7) + 1) * okiStepSize[_status.ima_ch[0].stepIndex] / 8;
-	diff = (code & 0x08) ? -E : E;
-	samp = _status.ima_ch[0].last + diff;
-	// Clip the values to +/- 2^11 (supposed to be 12 bits)
-	samp = CLIP<int16>(samp, -2048, 2047);
+int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = 0;
 
-	_status.ima_ch[0].last = samp;
-	_status.ima_ch[0].stepIndex += _stepAdjustTable[code];
-	_status.ima_ch[0].stepIndex = CLIP<int32>(_status.ima_ch[0].stepIndex, 0, ARRAYSIZE(okiStepSize) - 1);
+	// The second sample of the byte decoded last time
+	if (_decodedSampleCount != 0 && numSamples > 0) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
 
-	// * 16 effectively converts 12-bit input to 16-bit output
-	return samp * 16;
+	byte data[kChunkSize], high[kChunkSize], low[kChunkSize];
+	int32 last = _status.ima_ch[0].last;
+	int32 stepIndex = _status.ima_ch[0].stepIndex;
+
+	while (samples + 2 <= numSamples) {
+		const uint32 bytes = readChunk(data, (numSamples - samples) / 2);
+		if (!bytes)
+			break;
+
+		splitNibbles(data, bytes, high, low);
+		for (uint32 i = 0; i < bytes; i++) {
+			buffer[samples++] = decodeOKISample(high[i], last, stepIndex);
+			buffer[samples++] = decodeOKISample(low[i], last, stepIndex);
+		}
+	}
+
+	_status.ima_ch[0].last = last;
+	_status.ima_ch[0].stepIndex = stepIndex;
+
+	// Only one sample is left to fill, keep the other one for later
+	if (samples < numSamples && !endOfData()) {
+		const byte code = _stream->readByte();
+		buffer[samples++] = decodeOKI(code >> 4);
+		_decodedSamples[1] = decodeOKI(code & 0x0f);
+		_decodedSampleCount = 1;
+	}
+
+	return samples;
 }
 
 
 #pragma mark -
 
 
+static inline int16 decodeIMASample(byte code, int32 &last, int32 &stepIndex) {
+	const int32 E = (2 * (code & 0x7) + 1) * Ima_ADPCMStream::_imaTable[stepIndex] / 8;
+	const int32 diff = (code & 0x08) ? -E : E;
+	last = CLIP<int32>(last + diff, -32768, 32767);
+
+	stepIndex = CLIP<int32>(stepIndex + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(Ima_ADPCMStream::_imaTable) - 1);
+
+	return last;
+}
+
+int16 Ima_ADPCMStream::decodeIMA(byte code, int channel) {
+	return decodeIMASample(code, _status.ima_ch[channel].last, _status.ima_ch[channel].stepIndex);
+}
+
+void Ima_ADPCMStream::decodeIMAPairs(const byte *first, const byte *second, uint32 count, int channel, int16 *buffer, int stride) {
+	int32 last = _status.ima_ch[channel].last;
+	int32 stepIndex = _status.ima_ch[channel].stepIndex;
+
+	for (uint32 i = 0; i < count; i++) {
+		*buffer = decodeIMASample(first[i], last, stepIndex);
+		buffer += stride;
+		*buffer = decodeIMASample(second[i], last, stepIndex);
+		buffer += stride;
+	}
+
+	_status.ima_ch[channel].last = last;
+	_status.ima_ch[channel].stepIndex = stepIndex;
+}
+
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
+	// The second sample of the byte decoded last time
+	if (_decodedSampleCount != 0 && numSamples > 0) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
+
+	byte data[kChunkSize], high[kChunkSize], low[kChunkSize];
+
+	while (samples + 2 <= numSamples) {
+		const uint32 bytes = readChunk(data, (numSamples - samples) / 2);
+		if (!bytes)
+			break;
+
+		splitNibbles(data, bytes, high, low);
+		if (_channels == 2) {
+			// The high nibbles are the left channel, the low ones the right
+			int32 last[2] = { _status.ima_ch[0].last, _status.ima_ch[1].last };
+			int32 stepIndex[2] = { _status.ima_ch[0].stepIndex, _status.ima_ch[1].stepIndex };
+
+			for (uint32 i = 0; i < bytes; i++) {
+				buffer[samples++] = decodeIMASample(high[i], last[0], stepIndex[0]);
+				buffer[samples++] = decodeIMASample(low[i], last[1], stepIndex[1]);
+			}
+
+			for (int i = 0; i < 2; i++) {
+				_status.ima_ch[i].last = last[i];
+				_status.ima_ch[i].stepIndex = stepIndex[i];
+			}
+		} else {
+			decodeIMAPairs(high, low, bytes, 0, buffer + samples, 1);
+			samples += bytes * 2;
 		}
+	}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// Only one sample is left to fill, keep the other one for later
+	if (samples < numSamples && !endOfData()) {
+		const byte code = _stream->readByte();
+		buffer[samples++] = decodeIMA(code >> 4, 0);
+		_decodedSamples[1] = decodeIMA(code & 0x0f, _channels == 2 ? 1 : 0);
+		_decodedSampleCount = 1;
 	}
 
 	return samples;
@@ -152,6 +264,8 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Number of samples per channel
 	int chanSamples = numSamples / _channels;
 
+	byte data[kChunkSize], high[kChunkSize], low[kChunkSize];
+
 	for (int i = 0; i < _channels; i++) {
 		_stream->seek(_streamPos[i]);
 
@@ -174,24 +288,35 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 				_blockPos[i] = 2;
 			}
 
-			if (_chunkPos[i] == 0) {
-				// Decode data
-				byte data = _stream->readByte();
-				_buffer[i][0] = decodeIMA(data &  0x0F, i);
-				_buffer[i][1] = decodeIMA(data >>    4, i);
-			}
-
 			// The original is interleaved block-wise, we want it sample-wise
-			buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
-
-			if (++_chunkPos[i] > 1) {
-				// We're about to decode the next byte, so advance the block position
+			if (_chunkPos[i] == 1) {
+				// The second sample of the byte decoded last time
+				buffer[_channels * samples[i] + i] = _buffer[i][1];
 				_chunkPos[i] = 0;
 				_blockPos[i]++;
+				samples[i]++;
+			} else {
+				// Decode as many whole bytes of this block as we need
+				uint32 bytes = MIN<uint32>((chanSamples - samples[i]) / 2, _blockAlign - _blockPos[i]);
+				if (bytes)
+					bytes = readChunk(data, bytes);
+
+				if (bytes) {
+					splitNibbles(data, bytes, high, low);
+					decodeIMAPairs(low, high, bytes, i, buffer + _channels * samples[i] + i, _channels);
+					_blockPos[i] += bytes;
+					samples[i] += bytes * 2;
+				} else {
+					// Only one sample is left to fill, keep the other one for later
+					const byte code = _stream->readByte();
+					_buffer[i][0] = decodeIMA(code &  0x0F, i);
+					_buffer[i][1] = decodeIMA(code >>    4, i);
+					buffer[_channels * samples[i] + i] = _buffer[i][0];
+					_chunkPos[i] = 1;
+					samples[i]++;
+				}
 			}
 
-			samples[i]++;
-
 			if (_channels == 2)
 				if (_blockPos[i] == _blockAlign)
 					// We're at the end of the block.
@@ -215,7 +340,25 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 
 	int samples = 0;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+	// The stream encodes four bytes per channel at a time, which makes
+	// a group of eight samples per channel
+	const uint32 groupSize = _channels * 4;
+	byte data[kChunkSize], high[kChunkSize], low[kChunkSize];
+
+	while (samples < numSamples) {
+		// Hand out what is left of the group decoded last
+		while (samples < numSamples && _samplesLeft[0] != 0) {
+			for (int i = 0; i < _channels; i++) {
+				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
+				_samplesLeft[i]--;
+			}
+
+			samples += _channels;
+		}
+
+		if (samples == numSamples || _stream->eos() || _stream->pos() >= _endpos)
+			break;
+
 		if (_blockPos[0] == _blockAlign) {
 			for (int i = 0; i < _channels; i++) {
 				// read block header
@@ -226,25 +369,36 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 			_blockPos[0] = _channels * 4;
 		}
 
-		// Decode a set of samples
-		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
-			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
-			}
-		}
+		// Read all the groups of this block which are needed at once. There
+		// is at least one, as the constructor makes sure that the blocks hold
+		// whole groups after their header.
+		const uint32 groupSamples = groupSize * 2;
+		const uint32 groups = MIN<uint32>(MIN<uint32>((numSamples - samples + groupSamples - 1) / groupSamples,
+		                                              (_blockAlign - _blockPos[0]) / groupSize),
+		                                  kChunkSize / groupSize);
+		const uint32 bytes = groups * groupSize;
 
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
+		const uint32 bytesRead = _stream->read(data, bytes);
+		memset(data + bytesRead, 0, bytes - bytesRead);
+		_blockPos[0] += bytes;
 
-			samples += _channels;
+		splitNibbles(data, bytes, high, low);
+
+		for (uint32 group = 0; group < groups; group++) {
+			const uint32 offset = group * groupSize;
+
+			if (samples + (int)groupSamples <= numSamples) {
+				for (int i = 0; i < _channels; i++)
+					decodeIMAPairs(low + offset + i * 4, high + offset + i * 4, 4, i, buffer + samples + i, _channels);
+
+				samples += groupSamples;
+			} else {
+				// The last group does not fit, keep it for later
+				for (int i = 0; i < _channels; i++) {
+					decodeIMAPairs(low + offset + i * 4, high + offset + i * 4, 4, i, _buffer[i], 1);
+					_samplesLeft[i] = 8;
+				}
+			}
 		}
 	}
 
@@ -287,11 +441,11 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 }
 
 int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
+	byte data[kChunkSize], high[kChunkSize], low[kChunkSize];
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+	while (samples < numSamples && !endOfData()) {
 		if (_decodedSampleCount == 0) {
 			if (_blockPos[0] == _blockAlign) {
 				// read block header
@@ -315,16 +469,38 @@ int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 
 				_blockPos[0] = _channels * 7;
 			} else {
-				data = _stream->readByte();
+				// Decode as many whole bytes of this block as we need
+				uint32 bytes = MIN<uint32>((numSamples - samples) / 2, _blockAlign - _blockPos[0]);
+				if (bytes)
+					bytes = readChunk(data, bytes);
+
+				if (bytes) {
+					ADPCMChannelStatus status[2] = { _status.ch[0], _status.ch[1] };
+					ADPCMChannelStatus *left = &status[0];
+					ADPCMChannelStatus *right = &status[_channels - 1];
+
+					splitNibbles(data, bytes, high, low);
+					for (uint32 j = 0; j < bytes; j++) {
+						buffer[samples++] = decodeMS(left, high[j]);
+						buffer[samples++] = decodeMS(right, low[j]);
+					}
+
+					_status.ch[0] = status[0];
+					_status.ch[1] = status[1];
+					_blockPos[0] += bytes;
+					continue;
+				}
+
+				const byte code = _stream->readByte();
 				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
+				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (code >> 4) & 0x0f);
+				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], code & 0x0f);
 			}
 			_decodedSampleIndex = 0;
 		}
 
 		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
+		buffer[samples++] = _decodedSamples[_decodedSampleIndex++];
 		_decodedSampleCount--;
 	}
 
@@ -340,7 +516,11 @@ do { \
 		_nibble = _lastByte >> 4; \
 		_topNibble = false; \
 	} else { \
-		_lastByte = _stream->readByte(); \
+		if (dataPos == dataSize) { \
+			dataSize = _stream->read(data, MIN<uint32>(MIN<uint32>(blockBytesLeft, (numSamples - samples) * 3 / 8 + 2), kChunkSize)); \
+			dataPos = 0; \
+		} \
+		_lastByte = (dataPos < dataSize) ? data[dataPos++] : 0; \
 		_nibble = _lastByte & 0xf; \
 		_topNibble = true; \
 		--blockBytesLeft; \
@@ -361,6 +541,11 @@ int DK3_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 		blockBytesLeft = 0;
 	}
 
+	// The block data is read in chunks. Whatever is left unused of the last
+	// chunk is given back to the stream at the end.
+	byte data[kChunkSize];
+	uint32 dataPos = 0, dataSize = 0;
+
 	int samples = 0;
 	while (samples < numSamples && audioBytesLeft) {
 		if (blockBytesLeft == 0) {
@@ -407,12 +592,18 @@ int DK3_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 		// if the last sample of a block ends on an odd byte, the encoder adds
 		// an extra alignment byte
 		if (!_topNibble && blockBytesLeft == 1) {
-			_stream->skip(1);
+			if (dataPos < dataSize)
+				++dataPos;
+			else
+				_stream->skip(1);
 			--blockBytesLeft;
 			--audioBytesLeft;
 		}
 	}
 
+	if (dataPos < dataSize)
+		_stream->seek((int32)dataPos - (int32)dataSize, SEEK_CUR);
+
 	return samples;
 }
 
@@ -444,18 +635,6 @@ const int16 Ima_ADPCMStream::_imaTable[89] = {
 	32767
 };
 
-int16 Ima_ADPCMStream::decodeIMA(byte code, int channel) {
-	int32 E = (2 * (code & 0x7) + 1) * _imaTable[_status.ima_ch[channel].stepIndex] / 8;
-	int32 diff = (code & 0x08) ? -E : E;
-	int32 samp = CLIP<int32>(_status.ima_ch[channel].last + diff, -32768, 32767);
-
-	_status.ima_ch[channel].last = samp;
-	_status.ima_ch[channel].stepIndex += _stepAdjustTable[code];
-	_status.ima_ch[channel].stepIndex = CLIP<int32>(_status.ima_ch[channel].stepIndex, 0, ARRAYSIZE(_imaTable) - 1);
-
-	return samp;
-}
-
 SeekableAudioStream *makeADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, ADPCMType type, int rate, int channels, uint32 blockAlign) {
 	// If size is 0, report the entire size of the stream
 	if (!size)
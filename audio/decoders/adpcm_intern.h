@@ -57,8 +57,27 @@ protected:
 		} ima_ch[2];
 	} _status;
 
+	enum {
+		/** Maximum number of bytes read from _stream at once */
+		kChunkSize = 256
+	};
+
 	virtual void reset();
 
+	/**
+	 * Read up to maxBytes bytes, but at most kChunkSize bytes, without going
+	 * past the end of the ADPCM data.
+	 *
+	 * @return the number of bytes actually read
+	 */
+	uint32 readChunk(byte *data, uint32 maxBytes);
+
+	/**
+	 * Split count bytes into their high and low nibbles, so that the decoder
+	 * loops can fetch the codes of either channel without any bit fiddling.
+	 */
+	static void splitNibbles(const byte *src, uint32 count, byte *high, byte *low);
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
 
@@ -101,6 +120,13 @@ class Ima_ADPCMStream : public ADPCMStream {
 protected:
 	int16 decodeIMA(byte code, int channel = 0); // Default to using the left channel/using one channel
 
+	/**
+	 * Decode the codes first[0], second[0], first[1], second[1], ... of one
+	 * channel, storing the 2 * count samples at every stride-th element of
+	 * buffer.
+	 */
+	void decodeIMAPairs(const byte *first, const byte *second, uint32 count, int channel, int16 *buffer, int stride);
+
 public:
 	Ima_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {}
@@ -161,7 +187,9 @@ public:
 		if (blockAlign == 0)
 			error("MSIma_ADPCMStream(): blockAlign isn't specified");
 
-		if (blockAlign % (_channels * 4))
+		// The blocks are made of a header and groups of four bytes per
+		// channel, which are the same size
+		if (blockAlign % (_channels * 4) || blockAlign == (uint32)_channels * 4)
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
 		_samplesLeft[0] = 0;
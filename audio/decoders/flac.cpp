@@ -131,6 +131,7 @@ public:
 
 	bool isStereo() const { return _streaminfo.channels >= 2; }
 	int getRate() const { return _streaminfo.sample_rate; }
+	bool supportsParallelRendering() const { return true; }
 	bool endOfData() const {
 		// End of data is reached if there either is no valid stream data available,
 		// or if we reached the last sample and completely emptied the sample cache.
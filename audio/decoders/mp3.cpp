@@ -99,6 +99,7 @@ public:
 	               DisposeAfterUse::Flag dispose);
 
 	int readBuffer(int16 *buffer, const int numSamples);
+	bool supportsParallelRendering() const { return true; }
 	bool seek(const Timestamp &where);
 	Timestamp getLength() const { return _length; }
 
@@ -300,6 +300,13 @@ void RealOPL::onTimer() {
 }
 
 EmulatedOPL::EmulatedOPL() :
+	_useWriteQueue(false),
+	_batching(false),
+	_applyingWrites(false),
+	_writeQueueHead(0),
+	_batchBuffer(0),
+	_batchFrame(0),
+	_batchRendered(0),
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
@@ -321,6 +328,11 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	int len = numSamples / stereoFactor;
 	int step;
 
+	if (_useWriteQueue) {
+		readBufferQueued(buffer, len);
+		return numSamples;
+	}
+
 	do {
 		step = len;
 		if (step > (_nextTick >> FIXP_SHIFT))
@@ -343,6 +355,111 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	return numSamples;
 }
 
+void EmulatedOPL::readBufferQueued(int16 *buffer, int len) {
+	{
+		Common::StackLock lock(_writeQueueMutex);
+		_batchBuffer = buffer;
+		_batchFrame = 0;
+		_batchRendered = 0;
+		_batching = true;
+	}
+
+	// Run the callbacks at the same positions as readBuffer() would, but
+	// only record their writes for now
+	const int total = len;
+	int step;
+
+	do {
+		step = len;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		_batchFrame += step;
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_callback && _callback->isValid())
+				(*_callback)();
+
+			_nextTick += _samplesPerTick;
+		}
+
+		len -= step;
+	} while (len);
+
+	flushWrites(total);
+}
+
+void EmulatedOPL::flushWrites(int upTo) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	for (;;) {
+		QueuedWrite write;
+		{
+			Common::StackLock lock(_writeQueueMutex);
+			if (_writeQueueHead == _writeQueue.size()) {
+				_writeQueue.resize(0);
+				_writeQueueHead = 0;
+
+				// Any later writes (e.g. from other threads) go straight to
+				// the chip again
+				_batching = false;
+				break;
+			}
+			write = _writeQueue[_writeQueueHead++];
+		}
+
+		if (write.frame > _batchRendered) {
+			generateSamples(_batchBuffer + _batchRendered * stereoFactor, (write.frame - _batchRendered) * stereoFactor);
+			_batchRendered = write.frame;
+		}
+
+		_applyingWrites = true;
+		switch (write.type) {
+		case kQueuedWrite:
+			this->write(write.a, write.v);
+			break;
+		case kQueuedWriteReg:
+			writeReg(write.a, write.v);
+			break;
+		case kQueuedReset:
+			reset();
+			break;
+		}
+		_applyingWrites = false;
+	}
+
+	if (upTo > _batchRendered) {
+		generateSamples(_batchBuffer + _batchRendered * stereoFactor, (upTo - _batchRendered) * stereoFactor);
+		_batchRendered = upTo;
+	}
+}
+
+bool EmulatedOPL::queueWrite(bool isReg, int a, int v) {
+	return queue(isReg ? kQueuedWriteReg : kQueuedWrite, a, v);
+}
+
+bool EmulatedOPL::queueReset() {
+	return queue(kQueuedReset, 0, 0);
+}
+
+bool EmulatedOPL::queue(QueuedWriteType type, int a, int v) {
+	if (_applyingWrites)
+		return false;
+
+	Common::StackLock lock(_writeQueueMutex);
+	if (!_batching)
+		return false;
+
+	QueuedWrite write;
+	write.frame = _batchFrame;
+	write.type = type;
+	write.a = a;
+	write.v = v;
+	_writeQueue.push_back(write);
+	return true;
+}
+
 int EmulatedOPL::getRate() const {
 	return g_system->getMixer()->getOutputRate();
 }
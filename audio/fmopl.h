@@ -25,7 +25,9 @@
 
 #include "audio/audiostream.h"
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -236,6 +238,13 @@ private:
  *
  * This will send callbacks based on the number of samples
  * decoded in readBuffer().
+ *
+ * Emulators which support the register-write queue (see queueWrite()) are
+ * rendered in whole blocks: readBuffer() first runs all the callbacks for
+ * the buffer, recording the writes they make together with their sample
+ * position, and then renders the buffer in one go, applying each write at
+ * its position. The result is identical to rendering in slices between
+ * the callbacks.
  */
 class EmulatedOPL : public OPL, protected Audio::AudioStream {
 public:
@@ -267,7 +276,67 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Enable the register-write queue. Subclasses which call this must
+	 * start their write() and writeReg() implementations with queueWrite(),
+	 * and their reset() implementation with queueReset().
+	 *
+	 * Reads are not queued, so only emulators whose read() does not depend
+	 * on the rendered chip state (e.g. the timer status bits) may use it.
+	 */
+	void enableWriteQueue() { _useWriteQueue = true; }
+
+	/**
+	 * Queue a write while readBuffer() runs the callbacks. The write will be
+	 * repeated by calling write() or writeReg() again once the chip has been
+	 * rendered up to the sample position of the callback.
+	 *
+	 * @param isReg	true for writeReg(), false for write()
+	 * @param a		port address or register number
+	 * @param v		value to write
+	 * @return true if the write has been queued and must not be executed now
+	 */
+	bool queueWrite(bool isReg, int a, int v);
+
+	/**
+	 * Queue a reset while readBuffer() runs the callbacks, like queueWrite().
+	 * The reset will be repeated by calling reset() again in its turn, so
+	 * that it neither overtakes writes made before it nor gets undone by
+	 * them.
+	 *
+	 * @return true if the reset has been queued and must not be executed now
+	 */
+	bool queueReset();
+
 private:
+	void readBufferQueued(int16 *buffer, int len);
+	void flushWrites(int upTo);
+
+	enum QueuedWriteType {
+		kQueuedWrite,
+		kQueuedWriteReg,
+		kQueuedReset
+	};
+
+	struct QueuedWrite {
+		int frame;
+		QueuedWriteType type;
+		int a;
+		int v;
+	};
+
+	bool queue(QueuedWriteType type, int a, int v);
+
+	bool _useWriteQueue;
+	bool _batching;
+	bool _applyingWrites;
+	Common::Mutex _writeQueueMutex;
+	Common::Array<QueuedWrite> _writeQueue;
+	uint _writeQueueHead;
+	int16 *_batchBuffer;
+	int _batchFrame;
+	int _batchRendered;
+
 	int _baseFreq;
 
 	enum {
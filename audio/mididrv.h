@@ -196,7 +196,11 @@ public:
 		PROP_OLD_ADLIB = 2,
 		PROP_CHANNEL_MASK = 3,
 		// HACK: Not so nice, but our SCUMM AdLib code is in audio/
-		PROP_SCUMM_OPL3 = 4
+		PROP_SCUMM_OPL3 = 4,
+		// Statistics of the MT-32 emulator's render-ahead mode: the number of
+		// frames currently rendered ahead, and the number of underruns so far
+		PROP_MT32_RENDER_AHEAD_DEPTH = 5,
+		PROP_MT32_UNDERRUNS = 6
 	};
 
 	/**
@@ -45,7 +45,9 @@ _sendSustainOffOnNotesOff(false),
 _numTracks(0),
 _activeTrack(255),
 _abortParse(false),
-_jumpingToTick(false) {
+_jumpingToTick(false),
+_useSeekIndex(false),
+_seekIndexTrack(0) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
 	memset(_tracks, 0, sizeof(_tracks));
 	_nextEvent.start = NULL;
@@ -312,6 +314,11 @@ void MidiParser::resetTracking() {
 	_position.clear();
 }
 
+void MidiParser::clearSeekIndex() {
+	_seekIndex.clear();
+	_seekIndexTrack = 0;
+}
+
 bool MidiParser::setTrack(int track) {
 	if (track < 0 || track >= _numTracks)
 		return false;
@@ -395,6 +402,45 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 
 	resetTracking();
 	_position._playPos = _tracks[_activeTrack];
+
+	// When no events are fired, skipping events only has to preserve the
+	// tempo, so we can continue from the last checkpoint before the target
+	const bool useSeekIndex = _useSeekIndex && !fireEvents;
+	const uint32 initialPsecPerTick = _psecPerTick;
+	uint32 eventCount = 0;
+	uint32 initialTempoTicks = 0;
+	bool tempoChanged = false;
+
+	if (useSeekIndex && tick > 0) {
+		if (_seekIndexTrack != _tracks[_activeTrack]) {
+			_seekIndex.clear();
+			_seekIndexTrack = _tracks[_activeTrack];
+		}
+
+		// Find the last checkpoint after an event before the target tick
+		uint lo = 0, hi = _seekIndex.size();
+		while (lo < hi) {
+			const uint mid = (lo + hi) / 2;
+			if (_seekIndex[mid].position._lastEventTick < tick)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		if (lo > 0) {
+			const SeekCheckpoint &checkpoint = _seekIndex[lo - 1];
+			_position = checkpoint.position;
+			eventCount = checkpoint.eventCount;
+			initialTempoTicks = checkpoint.initialTempoTicks;
+			tempoChanged = checkpoint.tempoChanged;
+			if (tempoChanged)
+				setTempo(checkpoint.tempo);
+
+			_position._lastEventTime = initialTempoTicks * initialPsecPerTick + checkpoint.timeSinceTempo;
+			_position._playTime = _position._lastEventTime;
+		}
+	}
+
 	parseNextEvent(_nextEvent);
 	if (tick > 0) {
 		while (true) {
@@ -425,6 +471,24 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				processEvent(info, fireEvents);
 			}
 
+			if (useSeekIndex) {
+				if (!tempoChanged && info.event == 0xFF && info.ext.type == 0x51 && info.length >= 3) {
+					tempoChanged = true;
+					initialTempoTicks = _position._lastEventTick;
+				}
+
+				if (++eventCount == (_seekIndex.size() + 1) * kSeekIndexInterval) {
+					SeekCheckpoint checkpoint;
+					checkpoint.position = _position;
+					checkpoint.eventCount = eventCount;
+					checkpoint.initialTempoTicks = tempoChanged ? initialTempoTicks : _position._lastEventTick;
+					checkpoint.timeSinceTempo = _position._lastEventTime - checkpoint.initialTempoTicks * initialPsecPerTick;
+					checkpoint.tempo = _tempo;
+					checkpoint.tempoChanged = tempoChanged;
+					_seekIndex.push_back(checkpoint);
+				}
+			}
+
 			parseNextEvent(_nextEvent);
 		}
 	}
@@ -452,6 +516,7 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 
 void MidiParser::unloadMusic() {
 	resetTracking();
+	clearSeekIndex();
 	allNotesOff();
 	_numTracks = 0;
 	_activeTrack = 255;
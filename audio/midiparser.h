@@ -26,6 +26,7 @@
 #define AUDIO_MIDIPARSER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/endian.h"
 
 class MidiDriver_BASE;
@@ -79,6 +80,24 @@ struct Tracker {
 	}
 };
 
+/**
+ * A point in a track from which jumpToTick() can continue parsing, instead
+ * of starting over at the beginning of the track.
+ *
+ * Event times depend on the tempo in effect when the jump starts, for as
+ * long as the track does not set its own tempo. So rather than the absolute
+ * time, a checkpoint stores the number of ticks before the first tempo event
+ * and the time which has passed since.
+ */
+struct SeekCheckpoint {
+	Tracker position;          ///< The position right after an event, before the next one is parsed
+	uint32 eventCount;         ///< The number of events from the start of the track up to here
+	uint32 initialTempoTicks;  ///< The number of ticks before the first tempo event, or all ticks if there was none
+	uint32 timeSinceTempo;     ///< The time, in microseconds, from the first tempo event up to here
+	uint32 tempo;              ///< The tempo in effect here, if tempoChanged is set
+	bool   tempoChanged;       ///< Whether there was a tempo event before this point
+};
+
 /**
  * Provides comprehensive information on the next event in the MIDI stream.
  * An EventInfo struct is instantiated by format-specific implementations
@@ -289,10 +308,25 @@ protected:
 	bool   _abortParse;    ///< If a jump or other operation interrupts parsing, flag to abort.
 	bool   _jumpingToTick; ///< True if currently inside jumpToTick
 
+	/**
+	 * Whether jumpToTick() may use a seek index for the active track.
+	 * Subclasses can only enable this if parseNextEvent() depends on
+	 * nothing but _position, and if processEvent() does nothing but
+	 * tempo changes when events are not fired.
+	 */
+	bool   _useSeekIndex;
+	Common::Array<SeekCheckpoint> _seekIndex; ///< Checkpoints of the active track, every kSeekIndexInterval events
+	byte  *_seekIndexTrack; ///< The track _seekIndex belongs to
+
+	enum {
+		kSeekIndexInterval = 256 ///< Number of events between two seek checkpoints
+	};
+
 protected:
 	static uint32 readVLQ(byte * &data);
 	virtual void resetTracking();
 	virtual void allNotesOff();
+	void clearSeekIndex();
 	virtual void parseNextEvent(EventInfo &info) = 0;
 	virtual bool processEvent(const EventInfo &info, bool fireEvents = true);
 
@@ -22,6 +22,9 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
+#include "common/simd.h"
+#include "common/thread.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -38,6 +41,38 @@ namespace Audio {
 #pragma mark -
 
 
+/**
+ * Forwards all calls to the stream of a channel, keeping track of the number
+ * of samples it produced and of its short reads. The channel only reads
+ * through it while the statistics are enabled.
+ */
+class ProfilingStream : public AudioStream {
+public:
+	ProfilingStream(AudioStream *stream)
+	    : _samplesRead(0), _underruns(0), _stream(stream) {}
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = _stream->readBuffer(buffer, numSamples);
+
+		if (samples > 0)
+			_samplesRead += samples;
+		if (samples < numSamples && !_stream->endOfStream())
+			_underruns++;
+		return samples;
+	}
+
+	virtual bool isStereo() const { return _stream->isStereo(); }
+	virtual int getRate() const { return _stream->getRate(); }
+	virtual bool endOfData() const { return _stream->endOfData(); }
+	virtual bool endOfStream() const { return _stream->endOfStream(); }
+
+	uint32 _samplesRead;
+	uint32 _underruns;
+
+private:
+	AudioStream *_stream;
+};
+
 /**
  * Channel used by the default Mixer implementation.
  */
@@ -49,19 +84,24 @@ public:
 	/**
 	 * Mixes the channel's samples into the given buffer.
 	 *
-	 * @param data buffer where to mix the data
+	 * @param data 32-bit mix bus where to mix the data. The samples are
+	 *             added without clipping.
 	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 *             10 means that the buffer contains twice 10 samples.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
 	bool isFinished() const { return _stream->endOfStream(); }
 
+	/**
+	 * Queries whether the channel may be rendered on a worker thread.
+	 */
+	bool supportsParallelRendering() const { return _stream->supportsParallelRendering(); }
+
 	/**
 	 * Queries whether the channel is a permanent channel.
 	 * A permanent channel is not affected by a Mixer::stopAll
@@ -126,6 +166,21 @@ public:
 	 */
 	Timestamp getElapsedTime();
 
+	/**
+	 * Queries how long the channel has spent rendering, in milliseconds.
+	 */
+	uint32 getRenderTime() const { return _renderTime; }
+
+	/**
+	 * Fills in the profiling statistics of the channel.
+	 */
+	void getStats(Mixer::ChannelStats &stats) const;
+
+	/**
+	 * Resets the profiling statistics of the channel.
+	 */
+	void resetStats();
+
 	/**
 	 * Queries the channel's sound type.
 	 */
@@ -163,27 +218,86 @@ private:
 	uint32 _mixerTimeStamp;
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
+	uint32 _renderTime;
+	uint32 _statsTime;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+	ProfilingStream _profiler;
 };
 
+/**
+ * Clip the 32-bit mix bus into the 16-bit output buffer.
+ *
+ * @param dst output buffer
+ * @param src mix bus
+ * @param len number of samples (not sample pairs)
+ */
+static void clipMixBuffer(int16 *dst, const int32 *src, uint len) {
+	uint i = 0;
+
+#if defined(SCUMMVM_SSE2)
+	for (; i + 8 <= len; i += 8) {
+		const __m128i lo = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i hi = _mm_loadu_si128((const __m128i *)(src + i + 4));
+		__m128i out = _mm_packs_epi32(lo, hi);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = _mm_xor_si128(out, _mm_set1_epi16((int16)0x8000));
+#endif
+		_mm_storeu_si128((__m128i *)(dst + i), out);
+	}
+#elif defined(SCUMMVM_NEON)
+	for (; i + 8 <= len; i += 8) {
+		int16x8_t out = vcombine_s16(vqmovn_s32(vld1q_s32(src + i)), vqmovn_s32(vld1q_s32(src + i + 4)));
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = veorq_s16(out, vdupq_n_s16((int16)0x8000));
+#endif
+		vst1q_s16(dst + i, out);
+	}
+#endif
+
+	for (; i < len; i++) {
+		const int32 val = CLIP<int32>(src[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		dst[i] = ((int16)val) ^ 0x8000;
+#else
+		dst[i] = val;
+#endif
+	}
+}
+
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _mixBuffer(0), _mixBufferSize(0), _renderPool(0), _renderBuffer(0), _renderBufferSize(0),
+	  _numParallelChannels(0), _numSerialChannels(0), _renderLen(0), _statsEnabled(false) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+	const int renderThreads = CLIP<int>(ConfMan.getInt("audio_render_threads"), 0, NUM_CHANNELS - 1);
+	if (renderThreads > 0) {
+		_renderPool = new Common::WorkerPool(renderThreads);
+		if (!_renderPool->getThreadCount()) {
+			warning("MixerImpl: Could not create any audio render threads");
+			delete _renderPool;
+			_renderPool = 0;
+		}
+	}
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	delete _renderPool;
+	free(_renderBuffer);
+	free(_mixBuffer);
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -277,27 +391,98 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	// Reallocate the mix bus, if necessary
+	if (2 * len > _mixBufferSize) {
+		free(_mixBuffer);
+		_mixBuffer = (int32 *)malloc(2 * len * sizeof(int32));
+		_mixBufferSize = 2 * len;
 
-	// mix all channels
-	int res = 0, tmp;
+		if (!_mixBuffer)
+			error("[MixerImpl::mixCallback] Cannot allocate memory for mix buffer");
+	}
+
+	//  zero the mix bus
+	memset(_mixBuffer, 0, 2 * len * sizeof(int32));
+
+	// collect all channels to mix
+	_numParallelChannels = _numSerialChannels = 0;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
 				delete _channels[i];
 				_channels[i] = 0;
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
+				if (_renderPool && _channels[i]->supportsParallelRendering())
+					_parallelChannels[_numParallelChannels++] = _channels[i];
+				else
+					_serialChannels[_numSerialChannels++] = _channels[i];
 			}
 		}
 
+	// Only go through the worker threads if there are at least two tasks
+	// for them; otherwise just mix everything here.
+	if (_numParallelChannels + (_numSerialChannels ? 1 : 0) < 2) {
+		for (uint i = 0; i < _numParallelChannels; i++)
+			_serialChannels[_numSerialChannels++] = _parallelChannels[i];
+		_numParallelChannels = 0;
+	}
+
+	// mix all channels
+	_renderLen = len;
+	int res = 0;
+
+	if (_numParallelChannels) {
+		const uint renderSize = 2 * len * _numParallelChannels;
+		if (renderSize > _renderBufferSize) {
+			free(_renderBuffer);
+			_renderBuffer = (int32 *)malloc(renderSize * sizeof(int32));
+			_renderBufferSize = renderSize;
+
+			if (!_renderBuffer)
+				error("[MixerImpl::mixCallback] Cannot allocate memory for render buffer");
+		}
+		memset(_renderBuffer, 0, renderSize * sizeof(int32));
+
+		_renderPool->run(renderTask, this, _numParallelChannels + 1);
+
+		for (uint i = 0; i < _numParallelChannels; i++) {
+			const int32 *src = _renderBuffer + 2 * len * i;
+			for (uint j = 0; j < 2 * len; j++)
+				_mixBuffer[j] += src[j];
+		}
+
+		for (uint i = 0; i <= _numParallelChannels; i++)
+			res = MAX(res, _renderResults[i]);
+	} else {
+		renderTask(this, 0);
+		res = _renderResults[0];
+	}
+
+	clipMixBuffer(buf, _mixBuffer, 2 * len);
+
 	return res;
 }
 
+void MixerImpl::renderTask(void *param, uint index) {
+	MixerImpl *mixer = (MixerImpl *)param;
+	const uint len = mixer->_renderLen;
+	int res = 0, tmp;
+
+	if (index == 0) {
+		// Task 0 mixes all the channels which must stay on one thread
+		for (uint i = 0; i < mixer->_numSerialChannels; i++) {
+			tmp = mixer->_serialChannels[i]->mix(mixer->_mixBuffer, len);
+
+			if (tmp > res)
+				res = tmp;
+		}
+	} else {
+		res = mixer->_parallelChannels[index - 1]->mix(mixer->_renderBuffer + 2 * len * (index - 1), len);
+	}
+
+	mixer->_renderResults[index] = res;
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -395,6 +580,39 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	return _channels[index]->getElapsedTime();
 }
 
+uint32 MixerImpl::getSoundRenderTime(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return 0;
+
+	return _channels[index]->getRenderTime();
+}
+
+void MixerImpl::enableChannelStats(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	if (enable && !_statsEnabled) {
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i])
+				_channels[i]->resetStats();
+		}
+	}
+	_statsEnabled = enable;
+}
+
+uint MixerImpl::getChannelStats(ChannelStats *stats, uint maxChannels) {
+	Common::StackLock lock(_mutex);
+
+	uint count = 0;
+	for (int i = 0; i != NUM_CHANNELS && count < maxChannels; i++) {
+		if (_channels[i])
+			_channels[i]->getStats(stats[count++]);
+	}
+	return count;
+}
+
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -498,8 +716,8 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+      _pauseStartTime(0), _pauseTime(0), _renderTime(0), _statsTime(0), _converter(0), _volL(0), _volR(0),
+      _stream(stream, autofreeStream), _profiler(stream) {
 	assert(mixer);
 	assert(stream);
 
@@ -602,7 +820,7 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int32 *data, uint len) {
 	assert(_stream);
 
 	int res = 0;
@@ -613,11 +831,40 @@ int Channel::mix(int16 *data, uint len) {
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		const bool stats = _mixer->isChannelStatsEnabled();
+		if (stats)
+			res = _converter->flowAccumulate(_profiler, data, len, _volL, _volR);
+		else
+			res = _converter->flowAccumulate(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
+
+		// The timer resolution is too coarse to time a single call, but the
+		// rounding errors average out over many calls.
+		const uint32 renderTime = g_system->getMillis(true) - _mixerTimeStamp;
+		_renderTime += renderTime;
+		if (stats)
+			_statsTime += renderTime;
 	}
 
 	return res;
 }
 
+void Channel::getStats(Mixer::ChannelStats &stats) const {
+	stats.handle = _handle;
+	stats.type = _type;
+	stats.id = _id;
+	stats.rate = _stream->getRate();
+	stats.stereo = _stream->isStereo();
+	stats.paused = isPaused();
+	stats.renderTime = _statsTime;
+	stats.samplesRead = _profiler._samplesRead;
+	stats.underruns = _profiler._underruns;
+}
+
+void Channel::resetStats() {
+	_statsTime = 0;
+	_profiler._samplesRead = 0;
+	_profiler._underruns = 0;
+}
+
 } // End of namespace Audio
@@ -65,6 +65,25 @@ public:
 		kMaxMixerVolume = 256
 	};
 
+	/**
+	 * Profiling statistics of a single mixer channel. The counters only
+	 * cover the time since the statistics were last enabled.
+	 * @see enableChannelStats(), getChannelStats()
+	 */
+	struct ChannelStats {
+		SoundHandle handle;
+		SoundType type;
+		int id;
+
+		uint32 rate;        ///< sample rate of the stream
+		bool stereo;        ///< whether the stream is stereo
+		bool paused;
+
+		uint32 renderTime;  ///< time spent decoding, converting and mixing, in milliseconds
+		uint32 samplesRead; ///< samples produced by the stream
+		uint32 underruns;   ///< short reads while the stream had not ended
+	};
+
 public:
 	Mixer() {}
 	virtual ~Mixer() {}
@@ -245,6 +264,33 @@ public:
 	 */
 	virtual Timestamp getElapsedTime(SoundHandle handle) = 0;
 
+	/**
+	 * Get the total time spent rendering the given sound so far, in
+	 * milliseconds. This covers decoding or synthesis and rate conversion.
+	 */
+	virtual uint32 getSoundRenderTime(SoundHandle handle) = 0;
+
+	/**
+	 * Start or stop gathering the profiling statistics of the channels.
+	 * Starting resets the statistics of all channels. They are disabled by
+	 * default, since they cost a little time in every mixer pass.
+	 */
+	virtual void enableChannelStats(bool enable) = 0;
+
+	/**
+	 * Check whether the profiling statistics of the channels are gathered.
+	 */
+	virtual bool isChannelStatsEnabled() const = 0;
+
+	/**
+	 * Get profiling statistics for all active channels.
+	 *
+	 * @param stats       array which receives the statistics
+	 * @param maxChannels number of entries available in stats
+	 * @return the number of entries filled in
+	 */
+	virtual uint getChannelStats(ChannelStats *stats, uint maxChannels) = 0;
+
 	/**
 	 * Check whether any channel of the given sound type is active.
 	 * For example, this can be used to check whether any SFX sound
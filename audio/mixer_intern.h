@@ -27,6 +27,10 @@
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Audio {
 
 /**
@@ -70,6 +74,34 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * 32-bit mix bus. All channels are accumulated into it without clipping,
+	 * and the result is clipped to 16 bits once at the end of mixCallback().
+	 */
+	int32 *_mixBuffer;
+	uint _mixBufferSize;
+
+	/**
+	 * Worker threads for rendering expensive channels in parallel, or 0 if
+	 * disabled. Channels which support it are rendered into their own slice
+	 * of _renderBuffer, while the remaining ones are mixed straight into the
+	 * mix bus as one extra task. The slices are summed up afterwards, which
+	 * gives exactly the same result as mixing everything serially.
+	 */
+	Common::WorkerPool *_renderPool;
+	int32 *_renderBuffer;
+	uint _renderBufferSize;
+
+	Channel *_parallelChannels[NUM_CHANNELS];
+	uint _numParallelChannels;
+	Channel *_serialChannels[NUM_CHANNELS];
+	uint _numSerialChannels;
+	int _renderResults[NUM_CHANNELS + 1];
+	uint _renderLen;
+
+	bool _statsEnabled;
+
+	static void renderTask(void *param, uint index);
 
 public:
 
@@ -110,6 +142,10 @@ public:
 
 	virtual uint32 getSoundElapsedTime(SoundHandle handle);
 	virtual Timestamp getElapsedTime(SoundHandle handle);
+	virtual uint32 getSoundRenderTime(SoundHandle handle);
+	virtual void enableChannelStats(bool enable);
+	virtual bool isChannelStatsEnabled() const { return _statsEnabled; }
+	virtual uint getChannelStats(ChannelStats *stats, uint maxChannels);
 
 	virtual bool hasActiveChannelOfType(SoundType type);
 
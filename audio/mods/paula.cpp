@@ -34,6 +34,7 @@
 #include <math.h>
 
 #include "common/scummsys.h"
+#include "common/simd.h"
 
 #include "audio/mods/paula.h"
 #include "audio/null.h"
@@ -120,60 +121,137 @@ int Paula::readBuffer(int16 *buffer, const int numSamples) {
  * The current filtering should be accurate to 2 dB with the filter on,
  * and to 1 dB with the filter off.
  */
-inline int32 filter(int32 input, Paula::FilterState &state, int voice) {
-	float normalOutput, ledOutput;
+static void filterBlock(int16 *block, int count, Paula::FilterState &state, int voice) {
+	float *rc = state.rc[voice];
+	const float a0 = state.a0[0], a1 = state.a0[1], a2 = state.a0[2];
 
 	switch (state.mode) {
 	case Paula::kFilterModeA500:
-		state.rc[voice][0] = state.a0[0] * input + (1 - state.a0[0]) * state.rc[voice][0] + DENORMAL_OFFSET;
-		state.rc[voice][1] = state.a0[1] * state.rc[voice][0] + (1-state.a0[1]) * state.rc[voice][1];
-		normalOutput = state.rc[voice][1];
+		for (int i = 0; i < count; i++) {
+			rc[0] = a0 * block[i] + (1 - a0) * rc[0] + DENORMAL_OFFSET;
+			rc[1] = a1 * rc[0] + (1 - a1) * rc[1];
+			const float normalOutput = rc[1];
 
-		state.rc[voice][2] = state.a0[2] * normalOutput        + (1 - state.a0[2]) * state.rc[voice][2];
-		state.rc[voice][3] = state.a0[2] * state.rc[voice][2]  + (1 - state.a0[2]) * state.rc[voice][3];
-		state.rc[voice][4] = state.a0[2] * state.rc[voice][3]  + (1 - state.a0[2]) * state.rc[voice][4];
+			rc[2] = a2 * normalOutput + (1 - a2) * rc[2];
+			rc[3] = a2 * rc[2]        + (1 - a2) * rc[3];
+			rc[4] = a2 * rc[3]        + (1 - a2) * rc[4];
 
-		ledOutput = state.rc[voice][4];
+			const float ledOutput = rc[4];
+			block[i] = CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+		}
 		break;
 
 	case Paula::kFilterModeA1200:
-		normalOutput = input;
+		for (int i = 0; i < count; i++) {
+			const float normalOutput = block[i];
 
-		state.rc[voice][1] = state.a0[2] * normalOutput        + (1 - state.a0[2]) * state.rc[voice][1] + DENORMAL_OFFSET;
-		state.rc[voice][2] = state.a0[2] * state.rc[voice][1]  + (1 - state.a0[2]) * state.rc[voice][2];
-		state.rc[voice][3] = state.a0[2] * state.rc[voice][2]  + (1 - state.a0[2]) * state.rc[voice][3];
+			rc[1] = a2 * normalOutput + (1 - a2) * rc[1] + DENORMAL_OFFSET;
+			rc[2] = a2 * rc[1]        + (1 - a2) * rc[2];
+			rc[3] = a2 * rc[2]        + (1 - a2) * rc[3];
 
-		ledOutput = state.rc[voice][3];
+			const float ledOutput = rc[3];
+			block[i] = CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+		}
 		break;
 
 	case Paula::kFilterModeNone:
 	default:
-		return input;
-
+		break;
 	}
+}
+
+/**
+ * Add a block of voice samples to the output buffer, panning them when
+ * mixing in stereo. The additions wrap around like 16-bit integer math.
+ */
+template<bool stereo>
+inline void mixBlock(int16 *buf, const int16 *block, int count, byte panning) {
+	int i = 0;
+
+	if (stereo) {
+#if defined(SCUMMVM_SSE2)
+		// Each sample is duplicated and multiplied by the left and the right
+		// factor. The low 16 bits of the 32-bit product shifted right by 7
+		// are put together from the low and the high half of the product.
+		const __m128i factors = _mm_set1_epi32((panning << 16) | (255 - panning));
+		for (; i + 8 <= count; i += 8) {
+			const __m128i samples = _mm_loadu_si128((const __m128i *)(block + i));
+			const __m128i pairs[2] = { _mm_unpacklo_epi16(samples, samples), _mm_unpackhi_epi16(samples, samples) };
+
+			for (int j = 0; j < 2; j++) {
+				const __m128i lo = _mm_mullo_epi16(pairs[j], factors);
+				const __m128i hi = _mm_mulhi_epi16(pairs[j], factors);
+				const __m128i mixed = _mm_or_si128(_mm_srli_epi16(lo, 7), _mm_slli_epi16(hi, 9));
+
+				__m128i *out = (__m128i *)(buf + i * 2 + j * 8);
+				_mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), mixed));
+			}
+		}
+#elif defined(SCUMMVM_NEON)
+		const int16x4_t left = vdup_n_s16(255 - panning);
+		const int16x4_t right = vdup_n_s16(panning);
+		for (; i + 4 <= count; i += 4) {
+			const int16x4_t samples = vld1_s16(block + i);
+			int16x4x2_t out = vld2_s16(buf + i * 2);
+			out.val[0] = vadd_s16(out.val[0], vmovn_s32(vshrq_n_s32(vmull_s16(samples, left), 7)));
+			out.val[1] = vadd_s16(out.val[1], vmovn_s32(vshrq_n_s32(vmull_s16(samples, right), 7)));
+			vst2_s16(buf + i * 2, out);
+		}
+#endif
 
-	return CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+		for (; i < count; i++) {
+			buf[i * 2] += (block[i] * (255 - panning)) >> 7;
+			buf[i * 2 + 1] += (block[i] * (panning)) >> 7;
+		}
+	} else {
+#if defined(SCUMMVM_SSE2)
+		for (; i + 8 <= count; i += 8) {
+			__m128i *out = (__m128i *)(buf + i);
+			_mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), _mm_loadu_si128((const __m128i *)(block + i))));
+		}
+#elif defined(SCUMMVM_NEON)
+		for (; i + 8 <= count; i += 8)
+			vst1q_s16(buf + i, vaddq_s16(vld1q_s16(buf + i), vld1q_s16(block + i)));
+#endif
+
+		for (; i < count; i++)
+			buf[i] += block[i];
+	}
 }
 
 template<bool stereo>
 inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning, Paula::FilterState &filterState, int voice) {
-	int samples;
-	for (samples = 0; samples < neededSamples && offset.int_off < bufSize; ++samples) {
-		const int32 tmp = filter(((int32) data[offset.int_off]) * volume, filterState, voice);
-		if (stereo) {
-			*buf++ += (tmp * (255 - panning)) >> 7;
-			*buf++ += (tmp * (panning)) >> 7;
-		} else
-			*buf++ += tmp;
-
-		// Step to next source sample
-		offset.rem_off += rate;
-		if (offset.rem_off >= (frac_t)FRAC_ONE) {
-			offset.int_off += fracToInt(offset.rem_off);
-			offset.rem_off &= FRAC_LO_MASK;
+	// The samples are fetched, filtered and mixed a block at a time. They
+	// fit into 16 bits: the filters clip their output, and without a filter
+	// the values range from -128 * 64 to 127 * 64.
+	int16 block[256];
+
+	// Keeping the offset in one fixed point number saves the carry handling
+	uint64 pos = ((uint64)offset.int_off << FRAC_BITS) | offset.rem_off;
+	const uint64 end = (uint64)bufSize << FRAC_BITS;
+
+	int samples = 0;
+	while (samples < neededSamples && pos < end) {
+		const int blockSize = MIN<int>(neededSamples - samples, ARRAYSIZE(block));
+
+		int count;
+		for (count = 0; count < blockSize && pos < end; ++count) {
+			block[count] = ((int32) data[pos >> FRAC_BITS]) * volume;
+
+			// Step to next source sample
+			pos += rate;
 		}
+
+		filterBlock(block, count, filterState, voice);
+		mixBlock<stereo>(buf, block, count, panning);
+
+		buf += stereo ? count * 2 : count;
+		samples += count;
 	}
 
+	offset.int_off = pos >> FRAC_BITS;
+	offset.rem_off = pos & FRAC_LO_MASK;
+
 	return samples;
 }
 
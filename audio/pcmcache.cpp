@@ -0,0 +1,279 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/pcmcache.h"
+#include "audio/audiostream.h"
+#include "audio/timestamp.h"
+#include "audio/decoders/raw.h"
+
+#include "common/config-manager.h"
+#include "common/memstream.h"
+#include "common/textconsole.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PCMCache);
+}
+
+namespace Audio {
+
+enum {
+	kDefaultMaxSize = 8 * 1024 * 1024,
+	// No single sound may take up more than this fraction of the cache
+	kMaxEntryFraction = 4,
+	kDecodeChunkSize = 4096
+};
+
+/**
+ * A memory stream over the data of a cache entry, which keeps the entry
+ * alive while it exists.
+ */
+class CachedPCMReadStream : public Common::MemoryReadStream {
+public:
+	CachedPCMReadStream(PCMCache::Entry *entry)
+		: Common::MemoryReadStream((const byte *)entry->data, entry->size, DisposeAfterUse::NO), _entry(entry) {}
+
+	~CachedPCMReadStream() {
+		PCMCache::instance().release(_entry);
+	}
+
+private:
+	PCMCache::Entry *_entry;
+};
+
+/**
+ * Plays a sound straight from its decoder, and records the decoded samples
+ * on the way. Once the sound has been played to its end, the recording is
+ * added to the cache.
+ */
+class CachingPCMStream : public SeekableAudioStream {
+public:
+	CachingPCMStream(const Common::String &key, SeekableAudioStream *parent, uint32 expectedSamples, uint32 maxSamples)
+		: _key(key), _parent(parent), _samples(0), _capacity(expectedSamples + kDecodeChunkSize), _maxSamples(maxSamples) {
+		_data = (int16 *)malloc(_capacity * sizeof(int16));
+	}
+
+	~CachingPCMStream() {
+		free(_data);
+		delete _parent;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int read = _parent->readBuffer(buffer, numSamples);
+		if (!_data)
+			return read;
+
+		if (read > 0)
+			record(buffer, read);
+
+		if (_data && _parent->endOfData()) {
+			PCMCache::instance().add(_key, _data, _samples, _parent->getRate(), _parent->isStereo());
+			_data = 0;
+		}
+
+		return read;
+	}
+
+	bool isStereo() const { return _parent->isStereo(); }
+	int getRate() const { return _parent->getRate(); }
+	bool endOfData() const { return _parent->endOfData(); }
+	bool endOfStream() const { return _parent->endOfStream(); }
+
+	bool seek(const Timestamp &where) {
+		// The recording would have a gap or an overlap now
+		if (_samples || where.totalNumberOfFrames())
+			abandon();
+		return _parent->seek(where);
+	}
+
+	Timestamp getLength() const { return _parent->getLength(); }
+
+private:
+	void record(const int16 *buffer, uint32 samples) {
+		// The length was not known in advance and turned out to be too
+		// large after all: play the rest of the sound uncached
+		if (_samples + samples > _maxSamples) {
+			abandon();
+			return;
+		}
+
+		if (_samples + samples > _capacity) {
+			_capacity = MAX(_capacity * 2, _samples + samples);
+			int16 *data = (int16 *)realloc(_data, _capacity * sizeof(int16));
+			if (!data) {
+				abandon();
+				return;
+			}
+			_data = data;
+		}
+
+		memcpy(_data + _samples, buffer, samples * sizeof(int16));
+		_samples += samples;
+	}
+
+	void abandon() {
+		free(_data);
+		_data = 0;
+	}
+
+	const Common::String _key;
+	SeekableAudioStream *_parent;
+	int16 *_data;	///< The recorded samples, 0 when not recording (anymore)
+	uint32 _samples;
+	uint32 _capacity;
+	const uint32 _maxSamples;
+};
+
+PCMCache::PCMCache() : _size(0), _maxSize(kDefaultMaxSize) {
+}
+
+PCMCache::~PCMCache() {
+	clear();
+}
+
+Common::String PCMCache::makeKey(const Common::String &source, uint32 offset, uint32 length, uint32 format) {
+	return Common::String::format("%s/%s:%u:%u:%08x", ConfMan.getActiveDomainName().c_str(), source.c_str(), offset, length, format);
+}
+
+SeekableAudioStream *PCMCache::find(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator i = _map.find(key);
+	if (i == _map.end())
+		return 0;
+
+	// Move the entry to the front of the LRU list
+	Entry *entry = *i->_value;
+	_entries.erase(i->_value);
+	_entries.push_front(entry);
+	i->_value = _entries.begin();
+
+	return makeStream(entry);
+}
+
+SeekableAudioStream *PCMCache::insert(const Common::String &key, SeekableAudioStream *stream) {
+	if (!stream)
+		return 0;
+
+	const int channels = stream->isStereo() ? 2 : 1;
+	uint32 maxSamples;
+	{
+		Common::StackLock lock(_mutex);
+		maxSamples = _maxSize / kMaxEntryFraction / sizeof(int16);
+	}
+
+	// Check the length up front, so that long sounds (e.g. speech) are not
+	// recorded in vain
+	const uint32 expectedSamples = stream->getLength().convertToFramerate(stream->getRate()).totalNumberOfFrames() * channels;
+	if (expectedSamples > maxSamples)
+		return stream;
+
+	return new CachingPCMStream(key, stream, expectedSamples, maxSamples);
+}
+
+void PCMCache::clear() {
+	Common::StackLock lock(_mutex);
+	evict(0);
+}
+
+uint32 PCMCache::getSize() const {
+	Common::StackLock lock(_mutex);
+	return _size;
+}
+
+void PCMCache::setMaxSize(uint32 size) {
+	Common::StackLock lock(_mutex);
+	_maxSize = size;
+	evict(_maxSize);
+}
+
+void PCMCache::add(const Common::String &key, int16 *data, uint32 samples, int rate, bool stereo) {
+	Entry *entry = new Entry();
+	entry->key = key;
+	entry->data = data;
+	entry->size = samples * sizeof(int16);
+	entry->rate = rate;
+	entry->stereo = stereo;
+	entry->refCount = 0;
+	entry->cached = true;
+
+	Common::StackLock lock(_mutex);
+
+	// The same sound may have been played more than once at the same time
+	EntryMap::iterator i = _map.find(key);
+	if (i != _map.end()) {
+		Entry *old = *i->_value;
+		_entries.erase(i->_value);
+		_map.erase(i);
+		_size -= old->size;
+		old->cached = false;
+		if (!old->refCount) {
+			free(old->data);
+			delete old;
+		}
+	}
+
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_size += entry->size;
+
+	evict(_maxSize);
+}
+
+SeekableAudioStream *PCMCache::makeStream(Entry *entry) {
+	byte flags = FLAG_16BITS;
+#ifdef SCUMM_LITTLE_ENDIAN
+	flags |= FLAG_LITTLE_ENDIAN;
+#endif
+	if (entry->stereo)
+		flags |= FLAG_STEREO;
+
+	entry->refCount++;
+	return makeRawStream(new CachedPCMReadStream(entry), entry->rate, flags, DisposeAfterUse::YES);
+}
+
+void PCMCache::release(Entry *entry) {
+	Common::StackLock lock(_mutex);
+
+	assert(entry->refCount > 0);
+	if (!--entry->refCount && !entry->cached) {
+		free(entry->data);
+		delete entry;
+	}
+}
+
+void PCMCache::evict(uint32 maxSize) {
+	while (_size > maxSize && !_entries.empty()) {
+		Entry *entry = _entries.back();
+		_entries.pop_back();
+		_map.erase(entry->key);
+		_size -= entry->size;
+
+		// Entries which are still being played are freed by release()
+		entry->cached = false;
+		if (!entry->refCount) {
+			free(entry->data);
+			delete entry;
+		}
+	}
+}
+
+} // End of namespace Audio
@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_PCMCACHE_H
+#define AUDIO_PCMCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * A process-wide cache of decoded PCM data, for sounds which are played
+ * over and over again (footsteps, UI clicks, ...) and would otherwise be
+ * decoded from scratch every time.
+ *
+ * Entries are identified by a key built with makeKey(). Streams handed out
+ * by the cache are raw streams reading straight from the shared, reference
+ * counted buffer of the entry, so they are cheap to create and to destroy.
+ * Sounds are not decoded up front: the first time a sound is played, it is
+ * played straight from its decoder, and the decoded samples are recorded on
+ * the way and only added to the cache once the sound has been played to
+ * its end.
+ * When the cache grows beyond its maximum size, the least recently used
+ * entries are dropped; the data of entries which are still being played is
+ * only freed once the last stream using it has been destroyed.
+ *
+ * All methods are thread-safe.
+ */
+class PCMCache : public Common::Singleton<PCMCache> {
+public:
+	/**
+	 * Build a cache key. Keys of different games never collide.
+	 *
+	 * @param source	name of the file or resource the sound comes from
+	 * @param offset	offset of the sound data in the source
+	 * @param length	length of the sound data in the source
+	 * @param format	the format of the sound data, e.g. a FourCC tag
+	 */
+	static Common::String makeKey(const Common::String &source, uint32 offset, uint32 length, uint32 format);
+
+	/**
+	 * Look up a sound in the cache.
+	 *
+	 * @return a new stream playing the cached sound, or 0 if it is not cached
+	 */
+	SeekableAudioStream *find(const Common::String &key);
+
+	/**
+	 * Add a sound to the cache, once it has been played.
+	 *
+	 * The returned stream plays the sound straight from the given stream,
+	 * and adds the decoded samples to the cache when it reaches the end of
+	 * the sound. Seeking before that point cancels caching the sound.
+	 * Streams which are too large to be cached are returned unchanged.
+	 *
+	 * @param key		the cache key of the sound
+	 * @param stream	the stream to decode; the cache takes ownership of it
+	 * @return a stream playing the sound
+	 */
+	SeekableAudioStream *insert(const Common::String &key, SeekableAudioStream *stream);
+
+	/** Drop all entries from the cache. */
+	void clear();
+
+	/** Set the maximum size of the cache in bytes. */
+	void setMaxSize(uint32 size);
+
+	/** Return the current size of the cache in bytes. */
+	uint32 getSize() const;
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class CachedPCMReadStream;
+	friend class CachingPCMStream;
+
+	PCMCache();
+	~PCMCache();
+
+	struct Entry {
+		Common::String key;
+		int16 *data;
+		uint32 size;
+		int rate;
+		bool stereo;
+		uint refCount;
+		bool cached;
+	};
+
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Common::String, EntryList::iterator> EntryMap;
+
+	void add(const Common::String &key, int16 *data, uint32 samples, int rate, bool stereo);
+	SeekableAudioStream *makeStream(Entry *entry);
+	void release(Entry *entry);
+	void evict(uint32 maxSize);
+
+	Common::Mutex _mutex;
+	EntryList _entries;	///< Most recently used first
+	EntryMap _map;
+	uint32 _size;
+	uint32 _maxSize;
+};
+
+} // End of namespace Audio
+
+#endif
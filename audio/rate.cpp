@@ -31,7 +31,13 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/config-manager.h"
 #include "common/frac.h"
+#include "common/mutex.h"
+#include "common/simd.h"
+#include "common/singleton.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -57,6 +63,139 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Add a sample to a 16-bit output buffer, clipping the result.
+ */
+static inline void mixSample(st_sample_t &dst, int val) {
+	clampedAdd(dst, val);
+}
+
+/**
+ * Add a sample to a 32-bit mix bus. Clipping is done once all channels have
+ * been mixed.
+ */
+static inline void mixSample(st_mix_t &dst, int val) {
+	dst += val;
+}
+
+/**
+ * Apply the channel volume to a block of converted samples and add them to
+ * the output buffer. The input holds one sample per frame for mono streams
+ * and two for stereo ones, the output always holds sample pairs.
+ */
+template<bool stereo, bool reverseStereo, typename OutT>
+struct BlockMixer {
+	static void mix(OutT *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+		for (; frames > 0; frames--) {
+			st_sample_t out0, out1;
+			out0 = *in++;
+			out1 = (stereo ? *in++ : out0);
+
+			// output left channel
+			mixSample(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+			// output right channel
+			mixSample(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+			obuf += 2;
+		}
+	}
+};
+
+#ifdef SCUMMVM_SIMD
+
+/**
+ * Vectorised BlockMixer for the 32-bit mix bus. Eight output samples are
+ * processed per iteration, the remainder goes through the generic code.
+ * Results are identical to the scalar version.
+ */
+template<bool stereo, bool reverseStereo>
+struct BlockMixer<stereo, reverseStereo, st_mix_t> {
+	static void mix(st_mix_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+		const st_size_t blockFrames = frames & ~3;
+		// Volumes in output order
+		const int16 vol0 = reverseStereo ? vol_r : vol_l;
+		const int16 vol1 = reverseStereo ? vol_l : vol_r;
+
+#if defined(SCUMMVM_SSE2)
+		const __m128i vol = _mm_set_epi16(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+
+		for (st_size_t i = 0; i < blockFrames; i += 4) {
+			__m128i samples;
+			if (stereo) {
+				samples = _mm_loadu_si128((const __m128i *)in);
+				if (reverseStereo)
+					samples = _mm_shufflehi_epi16(_mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+				in += 8;
+			} else {
+				samples = _mm_loadl_epi64((const __m128i *)in);
+				samples = _mm_unpacklo_epi16(samples, samples);
+				in += 4;
+			}
+
+			// 32-bit products of the samples and volumes
+			const __m128i lo = _mm_mullo_epi16(samples, vol);
+			const __m128i hi = _mm_mulhi_epi16(samples, vol);
+			__m128i prod0 = _mm_unpacklo_epi16(lo, hi);
+			__m128i prod1 = _mm_unpackhi_epi16(lo, hi);
+
+			// Divide by kMaxMixerVolume (256), rounding towards zero like C does
+			prod0 = _mm_srai_epi32(_mm_add_epi32(prod0, _mm_srli_epi32(_mm_srai_epi32(prod0, 31), 24)), 8);
+			prod1 = _mm_srai_epi32(_mm_add_epi32(prod1, _mm_srli_epi32(_mm_srai_epi32(prod1, 31), 24)), 8);
+
+			_mm_storeu_si128((__m128i *)obuf, _mm_add_epi32(_mm_loadu_si128((const __m128i *)obuf), prod0));
+			_mm_storeu_si128((__m128i *)(obuf + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(obuf + 4)), prod1));
+			obuf += 8;
+		}
+#elif defined(SCUMMVM_NEON)
+		const int16 volValues[4] = { vol0, vol1, vol0, vol1 };
+		const int16x4_t vol = vld1_s16(volValues);
+
+		for (st_size_t i = 0; i < blockFrames; i += 4) {
+			int16x4_t samples0, samples1;
+			if (stereo) {
+				samples0 = vld1_s16(in);
+				samples1 = vld1_s16(in + 4);
+				if (reverseStereo) {
+					samples0 = vrev32_s16(samples0);
+					samples1 = vrev32_s16(samples1);
+				}
+				in += 8;
+			} else {
+				const int16x4x2_t dup = vzip_s16(vld1_s16(in), vld1_s16(in));
+				samples0 = dup.val[0];
+				samples1 = dup.val[1];
+				in += 4;
+			}
+
+			int32x4_t prod0 = vmull_s16(samples0, vol);
+			int32x4_t prod1 = vmull_s16(samples1, vol);
+
+			// Divide by kMaxMixerVolume (256), rounding towards zero like C does
+			prod0 = vshrq_n_s32(vaddq_s32(prod0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod0, 31)), 24))), 8);
+			prod1 = vshrq_n_s32(vaddq_s32(prod1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod1, 31)), 24))), 8);
+
+			vst1q_s32(obuf, vaddq_s32(vld1q_s32(obuf), prod0));
+			vst1q_s32(obuf + 4, vaddq_s32(vld1q_s32(obuf + 4), prod1));
+			obuf += 8;
+		}
+#endif
+
+		// Leftover frames
+		for (st_size_t i = blockFrames; i < frames; i++) {
+			st_sample_t out0, out1;
+			out0 = *in++;
+			out1 = (stereo ? *in++ : out0);
+
+			obuf[reverseStereo    ] += (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
+			obuf[reverseStereo ^ 1] += (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
+			obuf += 2;
+		}
+	}
+};
+
+#endif // SCUMMVM_SIMD
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -77,9 +216,20 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	/** Resample up to 'frames' frames into outBuf, return the number produced. */
+	st_size_t resample(AudioStream &input, st_sample_t *outBuf, st_size_t frames);
+
+	template<typename OutT>
+	int flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -107,18 +257,11 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 	inLen = 0;
 }
 
-/*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
- */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
-
-	ostart = obuf;
-	oend = obuf + osamp * 2;
+st_size_t SimpleRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *outBuf, st_size_t frames) {
+	st_size_t produced = 0;
 
-	while (obuf < oend) {
+	while (produced < frames) {
 
 		// read enough input samples so that opos >= 0
 		do {
@@ -127,7 +270,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return produced;
 			}
 			inLen -= (stereo ? 2 : 1);
 			opos--;
@@ -136,22 +279,40 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			}
 		} while (opos >= 0);
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+		*outBuf++ = *inPtr++;
+		if (stereo)
+			*outBuf++ = *inPtr++;
 
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		produced++;
+	}
+	return produced;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+template<typename OutT>
+int SimpleRateConverter<stereo, reverseStereo>::flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_size_t maxFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_size_t done = 0;
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	while (done < osamp) {
+		const st_size_t request = MIN(osamp - done, maxFrames);
+		const st_size_t frames = resample(input, outBuf, request);
 
-		obuf += 2;
+		BlockMixer<stereo, reverseStereo, OutT>::mix(obuf + done * 2, outBuf, frames, vol_l, vol_r);
+		done += frames;
+
+		if (frames < request)
+			break;
 	}
-	return (obuf - ostart) / 2;
+	return done;
 }
 
 /**
@@ -183,9 +344,20 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** Interpolate up to 'frames' frames into outBuf, return the number produced. */
+	st_size_t interpolate(AudioStream &input, st_sample_t *outBuf, st_size_t frames);
+
+	template<typename OutT>
+	int flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -216,18 +388,11 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 	inLen = 0;
 }
 
-/*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
- */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+st_size_t LinearRateConverter<stereo, reverseStereo>::interpolate(AudioStream &input, st_sample_t *outBuf, st_size_t frames) {
+	st_size_t produced = 0;
 
-	ostart = obuf;
-	oend = obuf + osamp * 2;
-
-	while (obuf < oend) {
+	while (produced < frames) {
 
 		// read enough input samples so that opos < 0
 		while ((frac_t)FRAC_ONE_LOW <= opos) {
@@ -236,7 +401,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return produced;
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -250,27 +415,43 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 
 		// Loop as long as the outpos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
+		while (opos < (frac_t)FRAC_ONE_LOW && produced < frames) {
 			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			*outBuf++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (stereo)
+				*outBuf++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-			obuf += 2;
+			produced++;
 
 			// Increment output position
 			opos += opos_inc;
 		}
 	}
-	return (obuf - ostart) / 2;
+	return produced;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+template<typename OutT>
+int LinearRateConverter<stereo, reverseStereo>::flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_size_t maxFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		const st_size_t request = MIN(osamp - done, maxFrames);
+		const st_size_t frames = interpolate(input, outBuf, request);
+
+		BlockMixer<stereo, reverseStereo, OutT>::mix(obuf + done * 2, outBuf, frames, vol_l, vol_r);
+		done += frames;
+
+		if (frames < request)
+			break;
+	}
+	return done;
 }
 
 
@@ -284,20 +465,13 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
-public:
-	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
-	~CopyRateConverter() {
-		free(_buffer);
-	}
 
-	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	template<typename OutT>
+	int flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -313,23 +487,27 @@ public:
 
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
+		if ((int)len <= 0)
+			return 0;
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+		const st_size_t frames = len / (stereo ? 2 : 1);
+		BlockMixer<stereo, reverseStereo, OutT>::mix(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
+	}
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+public:
+	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
+	~CopyRateConverter() {
+		free(_buffer);
+	}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
 
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+	virtual int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -340,10 +518,383 @@ public:
 
 #pragma mark -
 
+
+/**
+ * Coefficients of a windowed-sinc polyphase filter for one pair of input
+ * and output rates.
+ *
+ * The ratio inrate / outrate is reduced to step / phases. Output sample j
+ * is centred on input position j * step / phases, so the filter needs one
+ * set of coefficients for each of the 'phases' possible fractional
+ * positions. Coefficients are stored as 16-bit fixed point values with
+ * SINC_COEF_BITS fractional bits, 'taps' per phase.
+ */
+struct SincFilter {
+	st_rate_t inRate;
+	st_rate_t outRate;
+
+	int phases;
+	int step;
+	int taps;
+
+	int16 *coefs;
+
+	int refCount;
+};
+
+enum {
+	/** Number of taps per phase when upsampling; a multiple of 8. */
+	SINC_BASE_TAPS = 16,
+	/** Higher downsampling ratios fall back to linear interpolation. */
+	SINC_MAX_RATIO = 8,
+	/** Rate pairs needing more phases fall back to linear interpolation. */
+	SINC_MAX_PHASES = 2048,
+	/** Fractional bits of the filter coefficients. */
+	SINC_COEF_BITS = 14
+};
+
+/**
+ * Zeroth order modified Bessel function of the first kind, used for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+/**
+ * Process wide cache of sinc filters, so all channels playing at the same
+ * rate share a single coefficient table.
+ */
+class SincFilterCache : public Common::Singleton<SincFilterCache> {
+public:
+	const SincFilter *acquire(st_rate_t inrate, st_rate_t outrate);
+	void release(const SincFilter *filter);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SincFilterCache() {}
+	~SincFilterCache();
+
+	static SincFilter *createFilter(st_rate_t inrate, st_rate_t outrate);
+
+	Common::Mutex _mutex;
+	Common::Array<SincFilter *> _filters;
+};
+
+SincFilterCache::~SincFilterCache() {
+	for (uint i = 0; i < _filters.size(); i++) {
+		delete[] _filters[i]->coefs;
+		delete _filters[i];
+	}
+}
+
+const SincFilter *SincFilterCache::acquire(st_rate_t inrate, st_rate_t outrate) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _filters.size(); i++) {
+		if (_filters[i]->inRate == inrate && _filters[i]->outRate == outrate) {
+			_filters[i]->refCount++;
+			return _filters[i];
+		}
+	}
+
+	SincFilter *filter = createFilter(inrate, outrate);
+	filter->refCount = 1;
+	_filters.push_back(filter);
+	return filter;
+}
+
+void SincFilterCache::release(const SincFilter *filter) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _filters.size(); i++) {
+		if (_filters[i] == filter) {
+			if (--_filters[i]->refCount == 0) {
+				delete[] _filters[i]->coefs;
+				delete _filters[i];
+				_filters.remove_at(i);
+			}
+			return;
+		}
+	}
+}
+
+SincFilter *SincFilterCache::createFilter(st_rate_t inrate, st_rate_t outrate) {
+	const st_rate_t div = Common::gcd(inrate, outrate);
+
+	SincFilter *filter = new SincFilter();
+	filter->inRate = inrate;
+	filter->outRate = outrate;
+	filter->phases = outrate / div;
+	filter->step = inrate / div;
+
+	// When downsampling the filter has to be widened to keep the same
+	// transition band relative to the output rate
+	const double ratio = MAX<double>(1.0, (double)inrate / outrate);
+	filter->taps = ((int)ceil(SINC_BASE_TAPS * ratio) + 7) & ~7;
+	filter->coefs = new int16[filter->phases * filter->taps];
+
+	// Cutoff relative to the input rate, slightly below the Nyquist
+	// frequency of the lower of both rates
+	const double cutoff = 0.91 / ratio;
+	const double beta = 8.0;
+	const double halfWidth = filter->taps / 2;
+	const double windowScale = 1.0 / besselI0(beta);
+
+	double *phaseCoefs = new double[filter->taps];
+	for (int p = 0; p < filter->phases; p++) {
+		double sum = 0.0;
+		for (int k = 0; k < filter->taps; k++) {
+			const double t = (k - (filter->taps / 2 - 1)) - (double)p / filter->phases;
+			const double x = t / halfWidth;
+			const double window = (x >= -1.0 && x <= 1.0) ? besselI0(beta * sqrt(1.0 - x * x)) * windowScale : 0.0;
+			const double arg = M_PI * cutoff * t;
+			const double sinc = (t == 0.0) ? 1.0 : sin(arg) / arg;
+
+			phaseCoefs[k] = cutoff * sinc * window;
+			sum += phaseCoefs[k];
+		}
+
+		// Normalise every phase to unity gain, so there is no ripple at DC
+		for (int k = 0; k < filter->taps; k++)
+			filter->coefs[p * filter->taps + k] = (int16)floor(phaseCoefs[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+	}
+	delete[] phaseCoefs;
+
+	return filter;
+}
+
+/**
+ * Compute the dot product of 'taps' input samples and filter coefficients.
+ * 'taps' must be a multiple of 8.
+ */
+static inline int32 sincDotProduct(const int16 *in, const int16 *coefs, int taps) {
+#if defined(SCUMMVM_SSE2)
+	__m128i acc = _mm_setzero_si128();
+	for (int k = 0; k < taps; k += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in + k)), _mm_loadu_si128((const __m128i *)(coefs + k))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(SCUMMVM_NEON)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (int k = 0; k < taps; k += 8) {
+		const int16x8_t x = vld1q_s16(in + k);
+		const int16x8_t c = vld1q_s16(coefs + k);
+		acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(c));
+		acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(c));
+	}
+	const int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#else
+	int32 acc = 0;
+	for (int k = 0; k < taps; k++)
+		acc += in[k] * coefs[k];
+	return acc;
+#endif
+}
+
+/**
+ * Audio rate converter based on a windowed-sinc polyphase FIR filter.
+ *
+ * This gives far less aliasing than linear interpolation, in particular when
+ * upsampling 11kHz and 22kHz samples. The input is processed in blocks and
+ * kept in per channel history buffers, so every output sample is a single
+ * dot product which is vectorised where possible.
+ */
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+class SincRateConverter : public RateConverter {
+protected:
+	enum {
+		HISTORY_SIZE = INTERMEDIATE_BUFFER_SIZE + SINC_BASE_TAPS * SINC_MAX_RATIO
+	};
+
+	const SincFilter *_filter;
+
+	/** deinterleaved input history, one buffer per channel */
+	int16 _history[stereo ? 2 : 1][HISTORY_SIZE];
+	/** number of frames in the history buffers */
+	int _historyLen;
+
+	/** history index of the input frame the next output is based on */
+	int _pos;
+	/** fractional part of the position, in 1 / _filter->phases units */
+	int _phase;
+	/** whether the history has been padded with silence after the input ended */
+	bool _padded;
+
+	st_sample_t _readBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	void dropHistory();
+	bool refill(AudioStream &input);
+	bool pad(AudioStream &input);
+
+	/** Resample up to 'frames' frames into outBuf, return the number produced. */
+	st_size_t resample(AudioStream &input, st_sample_t *outBuf, st_size_t frames);
+
+	template<typename OutT>
+	int flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	~SincRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return flowT(input, obuf, osamp, vol_l, vol_r);
+	}
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	_filter = SincFilterCache::instance().acquire(inrate, outrate);
+	assert(_filter->taps <= SINC_BASE_TAPS * SINC_MAX_RATIO);
+
+	// Start with silence in front of the first input sample, so the
+	// first output is centred on it
+	_historyLen = _filter->taps / 2 - 1;
+	_pos = _historyLen;
+	_phase = 0;
+	_padded = false;
+	for (int c = 0; c < (stereo ? 2 : 1); c++)
+		memset(_history[c], 0, sizeof(_history[c]));
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	SincFilterCache::instance().release(_filter);
+}
+
+template<bool stereo, bool reverseStereo>
+void SincRateConverter<stereo, reverseStereo>::dropHistory() {
+	// Drop the frames which are no longer needed by the filter
+	const int drop = MIN(_pos - (_filter->taps / 2 - 1), _historyLen);
+	if (drop > 0) {
+		for (int c = 0; c < (stereo ? 2 : 1); c++)
+			memmove(_history[c], _history[c] + drop, (_historyLen - drop) * sizeof(int16));
+		_historyLen -= drop;
+		_pos -= drop;
+	}
+}
+
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	dropHistory();
+
+	const int space = MIN<int>(HISTORY_SIZE - _historyLen, ARRAYSIZE(_readBuf) / (stereo ? 2 : 1));
+	const int len = input.readBuffer(_readBuf, space * (stereo ? 2 : 1));
+	if (len <= 0)
+		return false;
+
+	const int frames = len / (stereo ? 2 : 1);
+	const st_sample_t *in = _readBuf;
+	for (int i = 0; i < frames; i++) {
+		_history[0][_historyLen + i] = *in++;
+		if (stereo)
+			_history[stereo ? 1 : 0][_historyLen + i] = *in++;
+	}
+	_historyLen += frames;
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::pad(AudioStream &input) {
+	// Streams which merely ran dry for now, like queuing streams, go on
+	// later and must not get a gap of silence
+	if (_padded || !input.endOfStream())
+		return false;
+
+	// Follow the last input frame with silence, so the filter can be
+	// centred on all of the remaining input frames
+	dropHistory();
+	const int halfTaps = _filter->taps / 2;
+	for (int c = 0; c < (stereo ? 2 : 1); c++)
+		memset(_history[c] + _historyLen, 0, halfTaps * sizeof(int16));
+	_historyLen += halfTaps;
+	_padded = true;
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+st_size_t SincRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *outBuf, st_size_t frames) {
+	const int taps = _filter->taps;
+	const int halfTaps = taps / 2;
+	st_size_t produced = 0;
+
+	while (produced < frames) {
+		// Make sure all input frames covered by the filter are available
+		if (_pos + halfTaps >= _historyLen) {
+			if (!refill(input) && !pad(input))
+				break;
+			continue;
+		}
+
+		const int first = _pos - (halfTaps - 1);
+		const int16 *coefs = _filter->coefs + _phase * taps;
+
+		for (int c = 0; c < (stereo ? 2 : 1); c++) {
+			const int32 acc = sincDotProduct(_history[c] + first, coefs, taps);
+			*outBuf++ = (st_sample_t)CLIP<int32>((acc + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		}
+		produced++;
+
+		// Advance to the next output position
+		_phase += _filter->step;
+		_pos += _phase / _filter->phases;
+		_phase %= _filter->phases;
+	}
+	return produced;
+}
+
+template<bool stereo, bool reverseStereo>
+template<typename OutT>
+int SincRateConverter<stereo, reverseStereo>::flowT(AudioStream &input, OutT *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_size_t maxFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		const st_size_t request = MIN(osamp - done, maxFrames);
+		const st_size_t frames = resample(input, outBuf, request);
+
+		BlockMixer<stereo, reverseStereo, OutT>::mix(obuf + done * 2, outBuf, frames, vol_l, vol_r);
+		done += frames;
+
+		if (frames < request)
+			break;
+	}
+	return done;
+}
+
+/**
+ * Check whether the sinc converter can handle the given pair of rates.
+ */
+static bool canUseSincConverter(st_rate_t inrate, st_rate_t outrate) {
+	if (inrate > outrate * SINC_MAX_RATIO)
+		return false;
+	return outrate / Common::gcd(inrate, outrate) <= SINC_MAX_PHASES;
+}
+
+
+#pragma mark -
+
+template<bool stereo, bool reverseStereo>
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool highQuality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (highQuality && canUseSincConverter(inrate, outrate)) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -357,13 +908,19 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
  * Create and return a RateConverter object for the specified input and output rates.
  */
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+	const bool highQuality = ConfMan.get("audio_resampler") == "sinc";
+
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, highQuality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, highQuality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, highQuality);
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterCache);
+} // End of namespace Common
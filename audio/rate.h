@@ -24,12 +24,14 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "common/util.h"
 
 namespace Audio {
 
 class AudioStream;
 
 typedef int16 st_sample_t;
+typedef int32 st_mix_t;
 typedef uint16 st_volume_t;
 typedef uint32 st_size_t;
 typedef uint32 st_rate_t;
@@ -48,7 +50,7 @@ enum {
 static inline void clampedAdd(int16& a, int b) {
 	int val;
 #ifdef OUTPUT_UNSIGNED_AUDIO
-	val = (a ^ 0x8000) + b;
+	val = (int16)(a ^ 0x8000) + b;
 #else
 	val = a + b;
 #endif
@@ -75,7 +77,54 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Same as flow(), but adds the samples to a 32-bit mix bus without
+	 * clipping. The caller is responsible for clipping the mixed result.
+	 *
+	 * The default implementation goes through flow() and a temporary
+	 * 16-bit buffer, converters should override it with a direct version.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		st_sample_t tmp[512];
+		int total = 0;
+
+		while (osamp > 0) {
+			const st_size_t count = MIN<st_size_t>(osamp, ARRAYSIZE(tmp) / 2);
+			const int written = flowSilence(input, tmp, count, vol_l, vol_r);
+			for (int i = 0; i < written * 2; i++)
+				obuf[i] += tmp[i];
+
+			total += written;
+			if ((st_size_t)written < count)
+				break;
+			obuf += written * 2;
+			osamp -= written;
+		}
+		return total;
+	}
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
+
+private:
+	/**
+	 * Run flow() on a silent buffer, and return the signed samples it wrote.
+	 */
+	int flowSilence(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		// flow() mixes into unsigned samples, where 0x8000 is silence
+		for (st_size_t i = 0; i < osamp * 2; i++)
+			obuf[i] = (st_sample_t)0x8000;
+		const int written = flow(input, obuf, osamp, vol_l, vol_r);
+		for (int i = 0; i < written * 2; i++)
+			obuf[i] ^= 0x8000;
+		return written;
+#else
+		memset(obuf, 0, osamp * 2 * sizeof(st_sample_t));
+		return flow(input, obuf, osamp, vol_l, vol_r);
+#endif
+	}
 };
 
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
@@ -50,6 +50,14 @@ protected:
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * The timer callback runs engine code from readBuffer(), so drivers
+	 * which have one must stay on the mixer thread. Drivers whose own
+	 * onTimer() only touches their state can return !hasTimerCallback()
+	 * from supportsParallelRendering().
+	 */
+	bool hasTimerCallback() const { return _timerProc != 0; }
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -70,6 +70,7 @@ public:
 	// AudioStream API
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
+	bool supportsParallelRendering() const { return !hasTimerCallback(); }
 };
 
 // MidiDriver method implementations
@@ -20,86 +20,12 @@
  *
  */
 
-#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth.h"
+#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth_intern.h"
 #include "common/endian.h"
+#include "common/simd.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
-class TownsPC98_FmSynthOperator {
-public:
-	TownsPC98_FmSynthOperator(const uint32 tickLength, const uint32 envduration, const uint8 *rateTable,	const uint8 *shiftTable,
-		const uint8 *attackDecayTable, const uint32 *frqTable, const uint32 *sineTable, const int32 *tlevelOut, const int32 *detuneTable);
-	~TownsPC98_FmSynthOperator() {}
-
-	void keyOn();
-	void keyOff();
-	void frequencyHi(uint8 frqH);
-	void frequencyLo(uint8 frqL);
-	void updatePhaseIncrement();
-	void recalculateRates();
-	void generateOutput(int32 phasebuf, int32 *feedbuf, int32 &out);
-
-	void feedbackLevel(int32 level);
-	void detune(int value);
-	void multiple(uint32 value);
-	void attackRate(uint32 value);
-	bool scaleRate(uint8 value);
-	void decayRate(uint32 value);
-	void sustainRate(uint32 value);
-	void sustainLevel(uint32 value);
-	void releaseRate(uint32 value);
-	void envelopeShape(uint32 value);
-	void totalLevel(uint32 value);
-	void ampModulation(bool enable);
-	void reset();
-
-protected:
-	void frequency(int freq);
-
-	EnvelopeState _state;
-	bool _keyOn;
-	uint32 _feedbackLevel;
-	uint32 _multiple;
-	uint32 _totalLevel;
-	uint8 _keyScale1;
-	uint8 _keyScale2;
-	uint32 _specifiedAttackRate;
-	uint32 _specifiedDecayRate;
-	uint32 _specifiedSustainRate;
-	uint32 _specifiedReleaseRate;
-	uint32 _envelopeShapeSpecs;
-	uint32 _tickCount;
-	uint32 _sustainLevel;
-
-	bool _ampMod;
-	uint32 _frequency;
-	uint16 _freqTemp;
-	uint8 _kcode;
-	uint32 _phase;
-	uint32 _phaseIncrement;
-	uint32 _shapeState;
-	uint8 _shapeScale;
-	const int32 *_detn;
-
-	const uint8 *_rateTbl;
-	const uint8 *_rshiftTbl;
-	const uint8 *_adTbl;
-	const uint32 *_fTbl;
-	const uint32 *_sinTbl;
-	const int32 *_tLvlTbl;
-	const int32 *_detnTbl;
-
-	const uint32 _tickLength;
-	const uint32 _envDuration;
-	int32 _currentLevel;
-	uint32 _timer;
-
-	struct EvpState {
-		uint8 rate;
-		uint8 shift;
-	} fs_a, fs_d, fs_s, fs_r;
-};
-
 TownsPC98_FmSynthOperator::TownsPC98_FmSynthOperator(const uint32 tickLength, const uint32 envduration, const uint8 *rateTable, const uint8 *shiftTable,
 	const uint8 *attackDecayTable, const uint32 *frqTable, const uint32 *sineTable, const int32 *tlevelOut, const int32 *detuneTable) :
 	_envDuration(envduration), _rateTbl(rateTable), _rshiftTbl(shiftTable), _adTbl(attackDecayTable), _fTbl(frqTable), _sinTbl(sineTable),
@@ -183,9 +109,13 @@ void TownsPC98_FmSynthOperator::recalculateRates() {
 	fs_r.shift = _rshiftTbl[r + k];
 }
 
-void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int32 &out) {
+/**
+ * Advances the envelope by one sample and calculates the resulting level.
+ * Returns false if the operator is silent.
+ */
+inline bool TownsPC98_FmSynthOperator::updateEnvelope(uint32 &lvlout) {
 	if (_state == kEnvReady)
-		return;
+		return false;
 
 	_timer += _tickLength;
 	while (_timer >= _envDuration) {
@@ -200,7 +130,7 @@ void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int3
 		for (bool loop = true; loop;) {
 			switch (_state) {
 			case kEnvReady:
-				return;
+				return false;
 
 			case kEnvAttacking:
 				targetLevel = 0;
@@ -263,31 +193,96 @@ void TownsPC98_FmSynthOperator::generateOutput(int32 phasebuf, int32 *feed, int3
 		}
 	}
 
-	uint32 lvlout = _totalLevel + ((uint32) _currentLevel ^ (_state != kEnvReleasing ? ((_shapeScale * (_shapeState & 4)) >> 3) * 1023 : 0));
+	lvlout = _totalLevel + ((uint32) _currentLevel ^ (_state != kEnvReleasing ? ((_shapeScale * (_shapeState & 4)) >> 3) * 1023 : 0));
 	_shapeState ^= (((_shapeState & 0x40) >> 2) | ((_shapeState & 2) << 1));
 
-	int32 outp = 0;
-	int32 *i = &outp, *o = &outp;
-	int32 phaseShift = 0;
+	return true;
+}
 
-	if (feed) {
-		o = &feed[0];
-		i = &feed[1];
-		phaseShift = _feedbackLevel ? ((*o + *i) << _feedbackLevel) : 0;
-		*o = *i;
-	} else {
-		phaseShift = phasebuf << 15;
+uint32 TownsPC98_FmSynthOperator::prepareBlock(uint32 *levels, uint32 *phases, uint32 count) {
+	// Once the envelope has finished, nothing changes until the next key on,
+	// which can't happen during a block.
+	uint32 i = 0;
+	for (; i < count; ++i) {
+		if (!updateEnvelope(levels[i]))
+			break;
+		phases[i] = _phase & ~0xffff;
+		_phase += _phaseIncrement;
 	}
+	return i;
+}
 
-	if (lvlout < 832) {
-		uint32 index = (lvlout << 3) + _sinTbl[(((int32)(_phase & ~0xffff) + phaseShift) >> 16) & 0x3ff];
-		*i = ((index < 6656) ? _tLvlTbl[index] : 0);
-	} else {
-		*i = 0;
+void TownsPC98_FmSynthOperator::lookupBlock(const uint32 *levels, const uint32 *phases, const int32 *mod, int32 *out, uint32 count) {
+	uint32 index[kBlockSize];
+	uint32 i = 0;
+
+#if defined(SCUMMVM_SSE2)
+	const __m128i mask = _mm_set1_epi32(0x3ff);
+	for (; i + 4 <= count; i += 4) {
+		__m128i p = _mm_loadu_si128((const __m128i *)(phases + i));
+		if (mod)
+			p = _mm_add_epi32(p, _mm_slli_epi32(_mm_loadu_si128((const __m128i *)(mod + i)), 15));
+		_mm_storeu_si128((__m128i *)(index + i), _mm_and_si128(_mm_srai_epi32(p, 16), mask));
+	}
+#elif defined(SCUMMVM_NEON)
+	const int32x4_t mask = vdupq_n_s32(0x3ff);
+	for (; i + 4 <= count; i += 4) {
+		int32x4_t p = vreinterpretq_s32_u32(vld1q_u32(phases + i));
+		if (mod)
+			p = vaddq_s32(p, vshlq_n_s32(vld1q_s32(mod + i), 15));
+		vst1q_u32(index + i, vreinterpretq_u32_s32(vandq_s32(vshrq_n_s32(p, 16), mask)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		const int32 phaseShift = mod ? mod[i] << 15 : 0;
+		index[i] = ((phases[i] + (uint32)phaseShift) >> 16) & 0x3ff;
 	}
 
-	_phase += _phaseIncrement;
-	out += *o;
+	for (i = 0; i < count; ++i) {
+		if (levels[i] < 832) {
+			const uint32 idx = (levels[i] << 3) + _sinTbl[index[i]];
+			out[i] = (idx < 6656) ? _tLvlTbl[idx] : 0;
+		} else {
+			out[i] = 0;
+		}
+	}
+}
+
+void TownsPC98_FmSynthOperator::generateBlock(const int32 *mod, int32 *out, uint32 count) {
+	assert(count <= kBlockSize);
+
+	uint32 levels[kBlockSize];
+	uint32 phases[kBlockSize];
+	const uint32 active = prepareBlock(levels, phases, count);
+
+	lookupBlock(levels, phases, mod, out, active);
+	memset(out + active, 0, (count - active) * sizeof(int32));
+}
+
+void TownsPC98_FmSynthOperator::generateFeedbackBlock(int32 *feed, int32 *out, uint32 count) {
+	assert(count <= kBlockSize);
+
+	uint32 levels[kBlockSize];
+	uint32 phases[kBlockSize];
+	const uint32 active = prepareBlock(levels, phases, count);
+
+	// The output of each sample feeds into the next one, so this has to be
+	// done one sample at a time. The operator outputs its previous sample.
+	for (uint32 i = 0; i < active; ++i) {
+		const int32 phaseShift = _feedbackLevel ? ((feed[0] + feed[1]) << _feedbackLevel) : 0;
+		feed[0] = feed[1];
+
+		if (levels[i] < 832) {
+			const uint32 idx = (levels[i] << 3) + _sinTbl[((phases[i] + (uint32)phaseShift) >> 16) & 0x3ff];
+			feed[1] = (idx < 6656) ? _tLvlTbl[idx] : 0;
+		} else {
+			feed[1] = 0;
+		}
+
+		out[i] = feed[0];
+	}
+	memset(out + active, 0, (count - active) * sizeof(int32));
 }
 
 void TownsPC98_FmSynthOperator::feedbackLevel(int32 level) {
@@ -373,6 +368,110 @@ void TownsPC98_FmSynthOperator::reset() {
 	ampModulation(false);
 }
 
+void renderFmChannelBlock(TownsPC98_FmSynthOperator *const *o, uint8 algorithm, int32 *feed, int32 *output, uint32 count) {
+	// The operators are run in the same order as for a single sample. The
+	// value in feed[2] is delayed by one sample, so it is taken from the
+	// previous sample within the block.
+	int32 phbuf1[TownsPC98_FmSynthOperator::kBlockSize];
+	int32 phbuf2[TownsPC98_FmSynthOperator::kBlockSize];
+	int32 tmp[TownsPC98_FmSynthOperator::kBlockSize];
+	int32 &del = feed[2];
+	uint32 i;
+
+	assert(count && count <= TownsPC98_FmSynthOperator::kBlockSize);
+
+	switch (algorithm) {
+	case 0:
+		o[0]->generateFeedbackBlock(feed, phbuf1, count);
+		o[1]->generateBlock(phbuf1, tmp, count);
+		phbuf2[0] = del;
+		for (i = 1; i < count; ++i)
+			phbuf2[i] = tmp[i - 1];
+		o[2]->generateBlock(phbuf2, phbuf1, count);
+		o[3]->generateBlock(phbuf1, output, count);
+		del = tmp[count - 1];
+		break;
+	case 1:
+		o[0]->generateFeedbackBlock(feed, phbuf1, count);
+		o[1]->generateBlock(0, tmp, count);
+		for (i = 0; i < count; ++i)
+			phbuf1[i] += tmp[i];
+		phbuf2[0] = del;
+		for (i = 1; i < count; ++i)
+			phbuf2[i] = phbuf1[i - 1];
+		o[2]->generateBlock(phbuf2, tmp, count);
+		o[3]->generateBlock(tmp, output, count);
+		del = phbuf1[count - 1];
+		break;
+	case 2:
+		o[0]->generateFeedbackBlock(feed, phbuf2, count);
+		o[1]->generateBlock(0, phbuf1, count);
+		tmp[0] = del;
+		for (i = 1; i < count; ++i)
+			tmp[i] = phbuf1[i - 1];
+		o[2]->generateBlock(tmp, output, count);
+		for (i = 0; i < count; ++i)
+			phbuf2[i] += output[i];
+		o[3]->generateBlock(phbuf2, output, count);
+		del = phbuf1[count - 1];
+		break;
+	case 3:
+		o[0]->generateFeedbackBlock(feed, phbuf2, count);
+		o[2]->generateBlock(0, tmp, count);
+		o[1]->generateBlock(phbuf2, phbuf1, count);
+		tmp[0] += del;
+		for (i = 1; i < count; ++i)
+			tmp[i] += phbuf1[i - 1];
+		o[3]->generateBlock(tmp, output, count);
+		del = phbuf1[count - 1];
+		break;
+	case 4:
+		o[0]->generateFeedbackBlock(feed, phbuf1, count);
+		o[2]->generateBlock(0, phbuf2, count);
+		o[1]->generateBlock(phbuf1, output, count);
+		o[3]->generateBlock(phbuf2, tmp, count);
+		for (i = 0; i < count; ++i)
+			output[i] += tmp[i];
+		del = 0;
+		break;
+	case 5:
+		o[0]->generateFeedbackBlock(feed, phbuf1, count);
+		phbuf2[0] = del;
+		for (i = 1; i < count; ++i)
+			phbuf2[i] = phbuf1[i - 1];
+		o[2]->generateBlock(phbuf2, output, count);
+		o[1]->generateBlock(phbuf1, tmp, count);
+		for (i = 0; i < count; ++i)
+			output[i] += tmp[i];
+		o[3]->generateBlock(phbuf1, tmp, count);
+		for (i = 0; i < count; ++i)
+			output[i] += tmp[i];
+		del = phbuf1[count - 1];
+		break;
+	case 6:
+		o[0]->generateFeedbackBlock(feed, phbuf1, count);
+		o[2]->generateBlock(0, output, count);
+		o[1]->generateBlock(phbuf1, tmp, count);
+		for (i = 0; i < count; ++i)
+			output[i] += tmp[i];
+		o[3]->generateBlock(0, tmp, count);
+		for (i = 0; i < count; ++i)
+			output[i] += tmp[i];
+		del = 0;
+		break;
+	case 7:
+	default:
+		o[0]->generateFeedbackBlock(feed, output, count);
+		for (i = 1; i < 4; ++i) {
+			o[i]->generateBlock(0, tmp, count);
+			for (uint32 ii = 0; ii < count; ++ii)
+				output[ii] += tmp[ii];
+		}
+		del = 0;
+		break;
+	}
+}
+
 class TownsPC98_FmSynthSquareWaveSource {
 public:
 	TownsPC98_FmSynthSquareWaveSource(const uint32 tickLength, const uint32 envduration);
@@ -1572,6 +1671,9 @@ void TownsPC98_FmSynth::nextTick(int32 *buffer, uint32 bufferSize) {
 	if (!_ready)
 		return;
 
+	const int div = (_numChan + _numSSG - 3) / 3;
+	int32 output[TownsPC98_FmSynthOperator::kBlockSize];
+
 	for (int i = 0; i < _numChan; i++) {
 		TownsPC98_FmSynthOperator **o = _chanInternal[i].opr;
 
@@ -1581,87 +1683,31 @@ void TownsPC98_FmSynth::nextTick(int32 *buffer, uint32 bufferSize) {
 				o[ii]->updatePhaseIncrement();
 		}
 
-		for (uint32 ii = 0; ii < bufferSize ; ii++) {
-			int32 phbuf1, phbuf2, output;
-			phbuf1 = phbuf2 = output = 0;
-
-			int32 *leftSample = &buffer[ii * 2];
-			int32 *rightSample = &buffer[ii * 2 + 1];
-			int32 *del = &_chanInternal[i].feedbuf[2];
-			int32 *feed = _chanInternal[i].feedbuf;
-
-			switch (_chanInternal[i].algorithm) {
-			case 0:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				*del = 0;
-				o[1]->generateOutput(phbuf1, 0, *del);
-				o[3]->generateOutput(phbuf2, 0, output);
-				break;
-			case 1:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				o[1]->generateOutput(0, 0, phbuf1);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = phbuf1;
-				break;
-			case 2:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(*del, 0, phbuf2);
-				o[1]->generateOutput(0, 0, phbuf1);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = phbuf1;
-				break;
-			case 3:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(0, 0, *del);
-				o[1]->generateOutput(phbuf2, 0, phbuf1);
-				o[3]->generateOutput(*del, 0, output);
-				*del = phbuf1;
-				break;
-			case 4:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, 0, phbuf2);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(phbuf2, 0, output);
-				*del = 0;
-				break;
-			case 5:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, 0, output);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(phbuf1, 0, output);
-				*del = phbuf1;
-				break;
-			case 6:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, 0, output);
-				o[1]->generateOutput(phbuf1, 0, output);
-				o[3]->generateOutput(0, 0, output);
-				*del = 0;
-				break;
-			case 7:
-				o[0]->generateOutput(0, feed, output);
-				o[2]->generateOutput(0, 0, output);
-				o[1]->generateOutput(0, 0, output);
-				o[3]->generateOutput(0, 0, output);
-				*del = 0;
-				break;
-			};
+		const bool volA = ((1 << i) & _volMaskA) != 0;
+		const bool volB = ((1 << i) & _volMaskB) != 0;
+		const bool left = _chanInternal[i].enableLeft;
+		const bool right = _chanInternal[i].enableRight;
+
+		for (uint32 pos = 0; pos < bufferSize; pos += TownsPC98_FmSynthOperator::kBlockSize) {
+			const uint32 count = MIN<uint32>(bufferSize - pos, TownsPC98_FmSynthOperator::kBlockSize);
+			renderFmChannelBlock(o, _chanInternal[i].algorithm, _chanInternal[i].feedbuf, output, count);
 
-			int32 finOut = (output << 2) / ((_numChan + _numSSG - 3) / 3);
+			int32 *dst = &buffer[pos * 2];
+			for (uint32 ii = 0; ii < count; ii++) {
+				int32 finOut = (output[ii] << 2) / div;
 
-			if ((1 << i) & _volMaskA)
-				finOut = (finOut * _volumeA) / Audio::Mixer::kMaxMixerVolume;
+				if (volA)
+					finOut = (finOut * _volumeA) / Audio::Mixer::kMaxMixerVolume;
 
-			if ((1 << i) & _volMaskB)
-				finOut = (finOut * _volumeB) / Audio::Mixer::kMaxMixerVolume;
+				if (volB)
+					finOut = (finOut * _volumeB) / Audio::Mixer::kMaxMixerVolume;
 
-			if (_chanInternal[i].enableLeft)
-				*leftSample += finOut;
+				if (left)
+					dst[ii * 2] += finOut;
 
-			if (_chanInternal[i].enableRight)
-				*rightSample += finOut;
+				if (right)
+					dst[ii * 2 + 1] += finOut;
+			}
 		}
 	}
 }
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef TOWNS_PC98_FMSYNTH_INTERN_H
+#define TOWNS_PC98_FMSYNTH_INTERN_H
+
+#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth.h"
+
+class TownsPC98_FmSynthOperator {
+public:
+	TownsPC98_FmSynthOperator(const uint32 tickLength, const uint32 envduration, const uint8 *rateTable,	const uint8 *shiftTable,
+		const uint8 *attackDecayTable, const uint32 *frqTable, const uint32 *sineTable, const int32 *tlevelOut, const int32 *detuneTable);
+	~TownsPC98_FmSynthOperator() {}
+
+	void keyOn();
+	void keyOff();
+	void frequencyHi(uint8 frqH);
+	void frequencyLo(uint8 frqL);
+	void updatePhaseIncrement();
+	void recalculateRates();
+
+	enum {
+		kBlockSize = 256
+	};
+
+	/**
+	 * Renders up to kBlockSize samples at once. This produces the same
+	 * output as rendering one sample at a time, but the envelope and the
+	 * phase are advanced in one pass and the sine table indices are
+	 * computed in another one, which can be vectorised.
+	 *
+	 * @param mod   phase modulation input for each sample, or 0 for none
+	 * @param out   receives the output of each sample
+	 * @param count number of samples
+	 */
+	void generateBlock(const int32 *mod, int32 *out, uint32 count);
+
+	/**
+	 * Same as generateBlock(), for the first operator of a channel, which
+	 * modulates itself through the feedback buffer.
+	 */
+	void generateFeedbackBlock(int32 *feedbuf, int32 *out, uint32 count);
+
+	void feedbackLevel(int32 level);
+	void detune(int value);
+	void multiple(uint32 value);
+	void attackRate(uint32 value);
+	bool scaleRate(uint8 value);
+	void decayRate(uint32 value);
+	void sustainRate(uint32 value);
+	void sustainLevel(uint32 value);
+	void releaseRate(uint32 value);
+	void envelopeShape(uint32 value);
+	void totalLevel(uint32 value);
+	void ampModulation(bool enable);
+	void reset();
+
+protected:
+	void frequency(int freq);
+	bool updateEnvelope(uint32 &lvlout);
+	uint32 prepareBlock(uint32 *levels, uint32 *phases, uint32 count);
+	void lookupBlock(const uint32 *levels, const uint32 *phases, const int32 *mod, int32 *out, uint32 count);
+
+	EnvelopeState _state;
+	bool _keyOn;
+	uint32 _feedbackLevel;
+	uint32 _multiple;
+	uint32 _totalLevel;
+	uint8 _keyScale1;
+	uint8 _keyScale2;
+	uint32 _specifiedAttackRate;
+	uint32 _specifiedDecayRate;
+	uint32 _specifiedSustainRate;
+	uint32 _specifiedReleaseRate;
+	uint32 _envelopeShapeSpecs;
+	uint32 _tickCount;
+	uint32 _sustainLevel;
+
+	bool _ampMod;
+	uint32 _frequency;
+	uint16 _freqTemp;
+	uint8 _kcode;
+	uint32 _phase;
+	uint32 _phaseIncrement;
+	uint32 _shapeState;
+	uint8 _shapeScale;
+	const int32 *_detn;
+
+	const uint8 *_rateTbl;
+	const uint8 *_rshiftTbl;
+	const uint8 *_adTbl;
+	const uint32 *_fTbl;
+	const uint32 *_sinTbl;
+	const int32 *_tLvlTbl;
+	const int32 *_detnTbl;
+
+	const uint32 _tickLength;
+	const uint32 _envDuration;
+	int32 _currentLevel;
+	uint32 _timer;
+
+	struct EvpState {
+		uint8 rate;
+		uint8 shift;
+	} fs_a, fs_d, fs_s, fs_r;
+};
+
+/**
+ * Renders a block of samples of one FM channel by running each operator over
+ * the whole block in the order of the connection algorithm, instead of
+ * running all four operators for each sample.
+ *
+ * @param opr       the four operators of the channel
+ * @param algorithm the connection algorithm (0 - 7)
+ * @param feedbuf   the channel's feedback buffer
+ * @param out       receives the channel output of each sample
+ * @param count     number of samples, at most TownsPC98_FmSynthOperator::kBlockSize
+ */
+void renderFmChannelBlock(TownsPC98_FmSynthOperator *const *opr, uint8 algorithm, int32 *feedbuf, int32 *out, uint32 count);
+
+#endif
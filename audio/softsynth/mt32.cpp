@@ -35,6 +35,7 @@
 #include "common/events.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
@@ -113,6 +114,31 @@ private:
 
 	int _outputRate;
 
+	/**
+	 * Render-ahead mode: a separate thread renders up to _ringSize frames
+	 * ahead into a ring buffer, which generateSamples() merely copies from.
+	 * MIDI events are queued in the synth with the timestamp of the current
+	 * playback position plus the ring size, so they are rendered with a
+	 * constant delay and their relative timing stays sample-accurate.
+	 */
+	Common::Thread _renderThread;
+	Common::Semaphore *_renderSemaphore;
+	Common::Mutex _ringMutex;
+	int16 *_ringBuffer;
+	uint32 _ringSize;
+	uint32 _ringRead;
+	uint32 _ringFill;
+	uint32 _playedFrames;
+	uint32 _underruns;
+	bool _renderQuit;
+
+	void startRenderThread(uint32 frames);
+	void stopRenderThread();
+	static void renderThreadProc(void *param);
+	void renderAhead();
+	uint32 getEventTimestamp();
+	void writeSysex(byte device, const byte *data, uint16 length);
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -133,6 +159,7 @@ public:
 	// AudioStream API
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
+	bool supportsParallelRendering() const { return !hasTimerCallback(); }
 };
 
 ////////////////////////////////////////
@@ -150,6 +177,11 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderSemaphore = nullptr;
+	_ringBuffer = nullptr;
+	_ringSize = _ringRead = _ringFill = 0;
+	_playedFrames = _underruns = 0;
+	_renderQuit = false;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -221,14 +253,130 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	const int renderAhead = CLIP<int>(ConfMan.getInt("mt32_render_ahead"), 0, 1000);
+	if (renderAhead > 0)
+		startRenderThread(renderAhead * _outputRate / 1000);
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
 }
 
+void MidiDriver_MT32::startRenderThread(uint32 frames) {
+	enum {
+		kMinRenderAhead = 2 * 256
+	};
+
+	_renderSemaphore = new Common::Semaphore();
+	if (!_renderSemaphore->isValid()) {
+		warning("MT32emu: Threads are not supported, disabling render-ahead");
+		delete _renderSemaphore;
+		_renderSemaphore = nullptr;
+		return;
+	}
+
+	_ringSize = MAX<uint32>(frames, kMinRenderAhead);
+	_ringBuffer = new int16[2 * _ringSize];
+	_ringRead = _ringFill = 0;
+	_playedFrames = _underruns = 0;
+	_renderQuit = false;
+
+	// Everything rendered ahead may still be waiting in the MIDI queue
+	_service.setMIDIEventQueueSize(4096);
+
+	if (!_renderThread.start(renderThreadProc, this)) {
+		warning("MT32emu: Could not create render thread, disabling render-ahead");
+		stopRenderThread();
+		return;
+	}
+
+	debug(1, "MT32emu: Rendering %u frames ahead", _ringSize);
+}
+
+void MidiDriver_MT32::stopRenderThread() {
+	if (_renderThread.isRunning()) {
+		_renderQuit = true;
+		_renderSemaphore->post();
+		_renderThread.join();
+	}
+
+	delete _renderSemaphore;
+	_renderSemaphore = nullptr;
+	delete[] _ringBuffer;
+	_ringBuffer = nullptr;
+	_ringSize = 0;
+}
+
+void MidiDriver_MT32::renderThreadProc(void *param) {
+	((MidiDriver_MT32 *)param)->renderAhead();
+}
+
+void MidiDriver_MT32::renderAhead() {
+	enum {
+		kRenderChunk = 256
+	};
+
+	while (!_renderQuit) {
+		uint32 writePos, space;
+		{
+			Common::StackLock lock(_ringMutex);
+			writePos = (_ringRead + _ringFill) % _ringSize;
+			space = _ringSize - _ringFill;
+		}
+
+		if (space < kRenderChunk) {
+			_renderSemaphore->wait();
+			continue;
+		}
+
+		// The synth does not need to be locked here: MIDI events only ever
+		// reach it through its thread-safe event queue in this mode.
+		const uint32 frames = MIN<uint32>(kRenderChunk, _ringSize - writePos);
+		_service.renderBit16s(_ringBuffer + 2 * writePos, frames);
+
+		Common::StackLock lock(_ringMutex);
+		_ringFill += frames;
+	}
+}
+
+uint32 MidiDriver_MT32::getEventTimestamp() {
+	Common::StackLock lock(_ringMutex);
+	return _service.convertOutputToSynthTimestamp(_playedFrames + _ringSize);
+}
+
+void MidiDriver_MT32::writeSysex(byte device, const byte *data, uint16 length) {
+	if (!_ringBuffer) {
+		_service.writeSysex(device, data, length);
+		return;
+	}
+
+	// There is no timestamped variant of writeSysex(), so wrap the data up
+	// in a complete DT1 message which the synth will then unwrap again.
+	byte *sysex = new byte[length + 7];
+	byte checksum = 0;
+
+	sysex[0] = 0xF0;
+	sysex[1] = 0x41;
+	sysex[2] = device;
+	sysex[3] = 0x16;
+	sysex[4] = 0x12;
+	for (uint16 i = 0; i < length; ++i) {
+		sysex[5 + i] = data[i];
+		checksum += data[i];
+	}
+	sysex[5 + length] = (128 - (checksum & 0x7F)) & 0x7F;
+	sysex[6 + length] = 0xF7;
+
+	_service.playSysexAt(sysex, length + 7, getEventTimestamp());
+	delete[] sysex;
+}
+
 void MidiDriver_MT32::send(uint32 b) {
 	Common::StackLock lock(_mutex);
-	_service.playMsg(b);
+	if (_ringBuffer)
+		_service.playMsgAt(b, getEventTimestamp());
+	else
+		_service.playMsg(b);
 }
 
 // Indiana Jones and the Fate of Atlantis (including the demo) uses
@@ -239,13 +387,16 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	}
 	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
 	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	writeSysex(channel, benderRangeSysex, 4);
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
-		_service.playSysex(msg, length);
+		if (_ringBuffer)
+			_service.playSysexAt(msg, length, getEventTimestamp());
+		else
+			_service.playSysex(msg, length);
 	} else {
 		enum {
 			SYSEX_CMD_DT1 = 0x12,
@@ -254,7 +405,7 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 
 		if (msg[3] == SYSEX_CMD_DT1 || msg[3] == SYSEX_CMD_DAT) {
 			Common::StackLock lock(_mutex);
-			_service.writeSysex(msg[1], msg + 4, length - 5);
+			writeSysex(msg[1], msg + 4, length - 5);
 		} else {
 			warning("Unused sysEx command %d", msg[3]);
 		}
@@ -271,6 +422,8 @@ void MidiDriver_MT32::close() {
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	stopRenderThread();
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -281,8 +434,36 @@ void MidiDriver_MT32::close() {
 }
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
-	Common::StackLock lock(_mutex);
-	_service.renderBit16s(data, len);
+	if (!_ringBuffer) {
+		Common::StackLock lock(_mutex);
+		_service.renderBit16s(data, len);
+		return;
+	}
+
+	uint32 frames;
+	{
+		Common::StackLock lock(_ringMutex);
+		frames = MIN<uint32>(len, _ringFill);
+
+		const uint32 first = MIN<uint32>(frames, _ringSize - _ringRead);
+		memcpy(data, _ringBuffer + 2 * _ringRead, first * 2 * sizeof(int16));
+		memcpy(data + 2 * first, _ringBuffer, (frames - first) * 2 * sizeof(int16));
+
+		_ringRead = (_ringRead + frames) % _ringSize;
+		_ringFill -= frames;
+		_playedFrames += frames;
+	}
+
+	// The render thread fell behind: play silence instead of waiting for
+	// it. The missing frames do not count towards the playback position, so
+	// MIDI timing stays consistent with what was actually rendered.
+	if (frames < (uint32)len) {
+		memset(data + 2 * frames, 0, (len - frames) * 2 * sizeof(int16));
+		_underruns++;
+		debug(5, "MT32emu: Render-ahead underrun, %u frames missing", (uint32)len - frames);
+	}
+
+	_renderSemaphore->post();
 }
 
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
@@ -290,6 +471,12 @@ uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 	case PROP_CHANNEL_MASK:
 		_channelMask = param & 0xFFFF;
 		return 1;
+	case PROP_MT32_RENDER_AHEAD_DEPTH: {
+		Common::StackLock lock(_ringMutex);
+		return _ringFill;
+	}
+	case PROP_MT32_UNDERRUNS:
+		return _underruns;
 	}
 
 	return 0;
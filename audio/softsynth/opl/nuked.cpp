@@ -379,6 +379,24 @@ static void OPL3_EnvelopeCalc(opl3_slot *slot)
     Bit8u reset = 0;
     slot->eg_out = slot->eg_rout + (slot->reg_tl << 2)
                  + (slot->eg_ksl >> kslshift[slot->reg_ksl]) + *slot->trem;
+    // Fast paths for the common cases in which the envelope cannot change:
+    // a released slot which has faded out completely, and a sustained note
+    // of a sustaining (EG type 1) slot. They give exactly the same result
+    // as the full calculation below.
+    if (!slot->key && slot->eg_gen == envelope_gen_num_release && slot->eg_rout == 0x1ff)
+    {
+        slot->pg_reset = 0;
+        return;
+    }
+    if (slot->key && slot->eg_gen == envelope_gen_num_sustain && slot->reg_type)
+    {
+        slot->pg_reset = 0;
+        if ((slot->eg_rout & 0x1f8) == 0x1f8)
+        {
+            slot->eg_rout = 0x1ff;
+        }
+        return;
+    }
     if (slot->key && slot->eg_gen == envelope_gen_num_release)
     {
         reset = 1;
@@ -1384,6 +1402,7 @@ void OPL3_GenerateStream(opl3_chip *chip, Bit16s *sndptr, Bit32u numsamples)
 }
 
 OPL::OPL(Config::OplType type) : _type(type), _rate(0) {
+	enableWriteQueue();
 }
 
 OPL::~OPL() {
@@ -1402,10 +1421,16 @@ bool OPL::init() {
 }
 
 void OPL::reset() {
+	if (queueReset())
+		return;
+
 	OPL3_Reset(&chip, _rate);
 }
 
 void OPL::write(int port, int val) {
+	if (queueWrite(false, port, val))
+		return;
+
 	if (port & 1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -1450,6 +1475,9 @@ void OPL::write(int port, int val) {
 
 
 void OPL::writeReg(int r, int v) {
+	if (queueWrite(true, r, v))
+		return;
+
 	OPL3_WriteRegBuffered(&chip, (Bit16u)r, (Bit8u)v);
 }
 
@@ -1478,7 +1506,7 @@ byte OPL::read(int port) {
 }
 
 void OPL::generateSamples(int16*buffer, int length) {
-	OPL3_GenerateStream(&chip, (Bit16s*)buffer, (Bit16u)length / 2);
+	OPL3_GenerateStream(&chip, (Bit16s*)buffer, (Bit32u)length / 2);
 }
 
 }
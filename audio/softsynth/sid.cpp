@@ -96,6 +96,7 @@ reg8 WaveformGenerator::readOSC() {
 void WaveformGenerator::reset() {
 	accumulator = 0;
 	shift_register = 0x7ffff8;
+	accumulator_step = 0;
 	freq = 0;
 	pw = 0;
 
@@ -158,6 +159,38 @@ RESID_INLINE void WaveformGenerator::updateClock(cycle_count delta_t) {
 	}
 }
 
+/**
+ * Clock the oscillator in one step, as used by the fast mode. The noise
+ * register is shifted the right number of times, but hard sync is only
+ * checked at the end of the step.
+ */
+RESID_INLINE void WaveformGenerator::updateClockFast(cycle_count delta_t) {
+	accumulator_step = 0;
+
+	// No operation if test bit is set.
+	if (test) {
+		return;
+	}
+
+	reg24 accumulator_prev = accumulator;
+
+	accumulator_step = delta_t*freq;
+	accumulator += accumulator_step;
+	accumulator &= 0xffffff;
+
+	msb_rising = !(accumulator_prev & 0x800000) && (accumulator & 0x800000);
+
+	// Count the number of times bit 19 was set high during the step.
+	reg24 shifts = ((accumulator_prev + accumulator_step + 0x080000) >> 20)
+		- ((accumulator_prev + 0x080000) >> 20);
+
+	while (shifts--) {
+		reg24 bit0 = ((shift_register >> 22) ^ (shift_register >> 17)) & 0x1;
+		shift_register <<= 1;
+		shift_register &= 0x7fffff;
+		shift_register |= bit0;
+	}
+}
 
 /**
  * Synchronize oscillators.
@@ -307,6 +340,53 @@ RESID_INLINE reg12 WaveformGenerator::output() {
 	}
 }
 
+/**
+ * PolyBLEP correction for a falling edge of the full 12-bit range at the
+ * given accumulator value. Only the clock steps directly before and after
+ * the edge are affected.
+ */
+sound_sample WaveformGenerator::blep(reg24 edge) const {
+	const reg24 phase = (accumulator - edge) & 0xffffff;
+	const reg24 step = accumulator_step;
+
+	if (!step || step >= 0x800000) {
+		return 0;
+	}
+
+	// x is the distance to the edge in steps, with 16 fractional bits.
+	if (phase < step) {
+		const int64 x = ((int64)phase << 16) / step;
+		return (sound_sample)(((2*x - (x*x >> 16) - 0x10000) * 2048) >> 16);
+	}
+	if (phase > 0x1000000 - step) {
+		const int64 x = -(((int64)(0x1000000 - phase) << 16) / step);
+		return (sound_sample)((((x*x >> 16) + 2*x + 0x10000) * 2048) >> 16);
+	}
+	return 0;
+}
+
+sound_sample WaveformGenerator::outputBandlimited() {
+	sound_sample out = output();
+
+	if (test) {
+		return out;
+	}
+
+	// The other waveforms are either continuous or too irregular to
+	// benefit from this.
+	switch (waveform) {
+	case 0x2:
+		out -= blep(0);
+		break;
+	case 0x4:
+		out += blep(pw << 12) - blep(0);
+		break;
+	default:
+		break;
+	}
+	return out;
+}
+
 /*
  * Our objective is to construct a smooth interpolating single-valued function
  * y = f(x).
@@ -492,6 +572,7 @@ Filter::Filter() {
 	Vnf = 0;
 
 	enable_filter(true);
+	enable_fast_mode(false);
 
 	// Create mappings from FC to cutoff frequency.
 	interpolate(f0_points_6581, f0_points_6581
@@ -512,6 +593,10 @@ void Filter::enable_filter(bool enable) {
 	enabled = enable;
 }
 
+void Filter::enable_fast_mode(bool enable) {
+	fast = enable;
+}
+
 void Filter::reset() {
 	fc = 0;
 
@@ -694,7 +779,8 @@ RESID_INLINE void Filter::updateClock(cycle_count delta_t,
 
 	// Maximum delta cycles for the filter to work satisfactorily under current
 	// cutoff frequency and resonance constraints is approximately 8.
-	cycle_count delta_t_flt = 8;
+	// The fast mode integrates over the whole of delta_t at once instead.
+	cycle_count delta_t_flt = fast ? delta_t : 8;
 
 	while (delta_t) {
 		if (delta_t < delta_t_flt) {
@@ -711,6 +797,12 @@ RESID_INLINE void Filter::updateClock(cycle_count delta_t,
 		// dVlp = -w0*Vbp*dt;
 		sound_sample w0_delta_t = w0_ceil_dt*delta_t_flt >> 6;
 
+		// Limit w0*dt to 0.75 to keep the filter stable for long steps.
+		// This is never reached with 8 cycle steps.
+		if (w0_delta_t > 0x3000) {
+			w0_delta_t = 0x3000;
+		}
+
 		sound_sample dVbp = (w0_delta_t*Vhp >> 14);
 		sound_sample dVlp = (w0_delta_t*Vbp >> 14);
 		Vbp -= dVbp;
@@ -999,6 +1091,7 @@ RESID_INLINE reg8 EnvelopeGenerator::output() {
 ExternalFilter::ExternalFilter() {
 	reset();
 	enable_filter(true);
+	enable_fast_mode(false);
 	set_sampling_parameter(15915.6);
 	mixer_DC = ((((0x800 - 0x380) + 0x800)*0xff*3 - 0xfff*0xff/18) >> 7)*0x0f;
 }
@@ -1007,6 +1100,10 @@ void ExternalFilter::enable_filter(bool enable) {
 	enabled = enable;
 }
 
+void ExternalFilter::enable_fast_mode(bool enable) {
+	fast = enable;
+}
+
 void ExternalFilter::set_sampling_parameter(double pass_freq) {
 	static const double pi = 3.1415926535897932385;
 
@@ -1032,6 +1129,15 @@ RESID_INLINE void ExternalFilter::updateClock(cycle_count delta_t, sound_sample
 		return;
 	}
 
+	// In fast mode, the low-pass cutoff lies close to the Nyquist frequency
+	// of the output, so only the high-pass (DC blocking) part is modelled.
+	if (fast) {
+		Vo = Vlp - Vhp;
+		Vhp += (w0hp*delta_t >> 3)*(Vlp - Vhp) >> 17;
+		Vlp = Vi;
+		return;
+	}
+
 	// Maximum delta cycles for the external filter to work satisfactorily
 	// is approximately 8.
 	cycle_count delta_t_flt = 8;
@@ -1101,6 +1207,7 @@ SID::SID() {
 
 	bus_value = 0;
 	bus_value_ttl = 0;
+	fast_mode = false;
 }
 
 SID::~SID() {}
@@ -1254,6 +1361,18 @@ void SID::enable_external_filter(bool enable) {
 	extfilt.enable_filter(enable);
 }
 
+/**
+ * The fast mode clocks the chip once per output sample instead of splitting
+ * the clock steps for hard sync and filter stability. The sawtooth and pulse
+ * waveforms are bandlimited to make up for the coarser steps. This costs
+ * some accuracy, most notably for hard sync at high frequencies.
+ */
+void SID::enable_fast_mode(bool enable) {
+	fast_mode = enable;
+	filter.enable_fast_mode(enable);
+	extfilt.enable_fast_mode(enable);
+}
+
 
 /**
  * Setting of SID sampling parameters.
@@ -1327,6 +1446,11 @@ void SID::updateClock(cycle_count delta_t) {
 		bus_value_ttl = 0;
 	}
 
+	if (fast_mode) {
+		updateClockFast(delta_t);
+		return;
+	}
+
 	// Clock amplitude modulators.
 	for (i = 0; i < 3; i++) {
 		voice[i].envelope.updateClock(delta_t);
@@ -1388,6 +1512,27 @@ void SID::updateClock(cycle_count delta_t) {
 	extfilt.updateClock(delta_t, filter.output());
 }
 
+void SID::updateClockFast(cycle_count delta_t) {
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		voice[i].envelope.updateClock(delta_t);
+	}
+
+	for (i = 0; i < 3; i++) {
+		voice[i].wave.updateClockFast(delta_t);
+	}
+
+	for (i = 0; i < 3; i++) {
+		voice[i].wave.synchronize();
+	}
+
+	filter.updateClock(delta_t, voice[0].outputBandlimited(),
+		voice[1].outputBandlimited(), voice[2].outputBandlimited());
+
+	extfilt.updateClock(delta_t, filter.output());
+}
+
 
 /**
  * SID clocking with audio sampling.
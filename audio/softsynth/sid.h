@@ -58,6 +58,7 @@ public:
 	void set_sync_source(WaveformGenerator *);
 
 	void updateClock(cycle_count delta_t);
+	void updateClockFast(cycle_count delta_t);
 	void synchronize();
 	void reset();
 
@@ -71,6 +72,10 @@ public:
 	// 12-bit waveform output.
 	reg12 output();
 
+	// Waveform output with the discontinuities of the sawtooth and pulse
+	// waveforms smoothed out over the last clock step (fast mode only).
+	sound_sample outputBandlimited();
+
 protected:
 	const WaveformGenerator* sync_source;
 	WaveformGenerator* sync_dest;
@@ -81,6 +86,12 @@ protected:
 	reg24 accumulator;
 	reg24 shift_register;
 
+	// Accumulator increment of the last updateClockFast() call.
+	reg24 accumulator_step;
+
+	// Correction for a discontinuity at the given accumulator value.
+	sound_sample blep(reg24 edge) const;
+
 	// Fout  = (Fn*Fclk/16777216)Hz
 	reg16 freq;
 	// PWout = (PWn/40.95)%
@@ -129,6 +140,7 @@ public:
 	Filter();
 
 	void enable_filter(bool enable);
+	void enable_fast_mode(bool enable);
 
 	void updateClock(cycle_count delta_t,
 		sound_sample voice1, sound_sample voice2, sound_sample voice3);
@@ -150,6 +162,9 @@ protected:
 	// Filter enabled.
 	bool enabled;
 
+	// Integrate once per clock call instead of every 8 cycles.
+	bool fast;
+
 	// Filter cutoff frequency.
 	reg12 fc;
 
@@ -241,6 +256,7 @@ public:
 	ExternalFilter();
 
 	void enable_filter(bool enable);
+	void enable_fast_mode(bool enable);
 	void set_sampling_parameter(double pass_freq);
 
 	void updateClock(cycle_count delta_t, sound_sample Vi);
@@ -253,6 +269,9 @@ protected:
 	// Filter enabled.
 	bool enabled;
 
+	// Integrate once per clock call instead of every 8 cycles.
+	bool fast;
+
 	// Maximum mixer DC offset.
 	sound_sample mixer_DC;
 
@@ -284,6 +303,11 @@ public:
 		return (wave.output() - wave_zero)*envelope.output() + voice_DC;
 	}
 
+	// Same as output(), using the bandlimited waveform (fast mode only).
+	sound_sample outputBandlimited() {
+		return (wave.outputBandlimited() - wave_zero)*envelope.output() + voice_DC;
+	}
+
 protected:
 	WaveformGenerator wave;
 	EnvelopeGenerator envelope;
@@ -305,6 +329,7 @@ public:
 
 	void enable_filter(bool enable);
 	void enable_external_filter(bool enable);
+	void enable_fast_mode(bool enable);
 	bool set_sampling_parameters(double clock_freq,
 		double sample_freq, double pass_freq = -1,
 		double filter_scale = 0.97);
@@ -321,6 +346,8 @@ public:
 	int output();
 
 protected:
+	void updateClockFast(cycle_count delta_t);
+
 	Voice voice[3];
 	Filter filter;
 	ExternalFilter extfilt;
@@ -328,6 +355,9 @@ protected:
 	reg8 bus_value;
 	cycle_count bus_value_ttl;
 
+	// Clock once per output sample instead of cycle exact.
+	bool fast_mode;
+
 	double clock_frequency;
 
 	// Fixpoint constants.
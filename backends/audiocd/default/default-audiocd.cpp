@@ -76,6 +76,10 @@ bool DefaultAudioCDManager::play(int track, int numLoops, int startFrame, int du
 			stream = Audio::SeekableAudioStream::openStreamFile(trackName[i]);
 
 		if (stream != 0) {
+			// Decode the track on a separate thread, so the mixer does not
+			// have to do it
+			stream = Audio::makeDecodeAheadStream(stream);
+
 			Audio::Timestamp start = Audio::Timestamp(0, startFrame, 75);
 			Audio::Timestamp end = duration ? Audio::Timestamp(0, startFrame + duration, 75) : stream->getLength();
 
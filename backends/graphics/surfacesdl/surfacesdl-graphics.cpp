@@ -1068,6 +1068,8 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	else
 		InitScalers(565);
 
+	InitScalerThreads(CLIP<int>(ConfMan.getInt("scaler_threads"), 0, 15));
+
 	return true;
 }
 
@@ -1334,7 +1336,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+				ScaleParallel(scalerProc, scale1, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, dst_w, dst_h);
 			}
 
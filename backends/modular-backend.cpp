@@ -263,6 +263,36 @@ void ModularBackend::deleteMutex(MutexRef mutex) {
 	_mutexManager->deleteMutex(mutex);
 }
 
+OSystem::ThreadRef ModularBackend::createThread(ThreadProc proc, void *param) {
+	assert(_mutexManager);
+	return _mutexManager->createThread(proc, param);
+}
+
+void ModularBackend::joinThread(ThreadRef thread) {
+	assert(_mutexManager);
+	_mutexManager->joinThread(thread);
+}
+
+OSystem::SemaphoreRef ModularBackend::createSemaphore(uint initialValue) {
+	assert(_mutexManager);
+	return _mutexManager->createSemaphore(initialValue);
+}
+
+void ModularBackend::waitSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->waitSemaphore(semaphore);
+}
+
+void ModularBackend::postSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->postSemaphore(semaphore);
+}
+
+void ModularBackend::deleteSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->deleteSemaphore(semaphore);
+}
+
 Audio::Mixer *ModularBackend::getMixer() {
 	assert(_mixer);
 	return (Audio::Mixer *)_mixer;
@@ -122,6 +122,13 @@ public:
 	virtual void unlockMutex(MutexRef mutex) override;
 	virtual void deleteMutex(MutexRef mutex) override;
 
+	virtual ThreadRef createThread(ThreadProc proc, void *param) override;
+	virtual void joinThread(ThreadRef thread) override;
+	virtual SemaphoreRef createSemaphore(uint initialValue) override;
+	virtual void waitSemaphore(SemaphoreRef semaphore) override;
+	virtual void postSemaphore(SemaphoreRef semaphore) override;
+	virtual void deleteSemaphore(SemaphoreRef semaphore) override;
+
 	//@}
 
 	/** @name Sound */
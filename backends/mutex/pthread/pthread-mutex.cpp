@@ -67,4 +67,99 @@ void PthreadMutexManager::deleteMutex(OSystem::MutexRef mutex) {
 		delete m;
 }
 
+namespace {
+
+struct PthreadThreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+void *pthreadThreadEntry(void *data) {
+	PthreadThreadStart start = *(PthreadThreadStart *)data;
+	delete (PthreadThreadStart *)data;
+	start.proc(start.param);
+	return NULL;
+}
+
+// pthreads has no portable counting semaphore (sem_init is unavailable on
+// iOS), so build one from a mutex and a condition variable.
+struct PthreadSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint count;
+};
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef PthreadMutexManager::createThread(OSystem::ThreadProc proc, void *param) {
+	PthreadThreadStart *start = new PthreadThreadStart;
+	start->proc = proc;
+	start->param = param;
+
+	pthread_t *thread = new pthread_t;
+	if (pthread_create(thread, NULL, pthreadThreadEntry, start) != 0) {
+		warning("pthread_create() failed");
+		delete start;
+		delete thread;
+		return NULL;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void PthreadMutexManager::joinThread(OSystem::ThreadRef thread) {
+	pthread_t *t = (pthread_t *)thread;
+
+	if (pthread_join(*t, NULL) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+OSystem::SemaphoreRef PthreadMutexManager::createSemaphore(uint initialValue) {
+	PthreadSemaphore *sem = new PthreadSemaphore;
+
+	if (pthread_mutex_init(&sem->mutex, NULL) != 0) {
+		warning("pthread_mutex_init() failed");
+		delete sem;
+		return NULL;
+	}
+
+	if (pthread_cond_init(&sem->cond, NULL) != 0) {
+		warning("pthread_cond_init() failed");
+		pthread_mutex_destroy(&sem->mutex);
+		delete sem;
+		return NULL;
+	}
+
+	sem->count = initialValue;
+	return (OSystem::SemaphoreRef)sem;
+}
+
+void PthreadMutexManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	while (sem->count == 0)
+		pthread_cond_wait(&sem->cond, &sem->mutex);
+	sem->count--;
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadMutexManager::postSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	sem->count++;
+	pthread_cond_signal(&sem->cond);
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadMutexManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_cond_destroy(&sem->cond);
+	pthread_mutex_destroy(&sem->mutex);
+	delete sem;
+}
+
 #endif
@@ -44,4 +44,58 @@ void SdlMutexManager::deleteMutex(OSystem::MutexRef mutex) {
 	SDL_DestroyMutex((SDL_mutex *)mutex);
 }
 
+namespace {
+
+struct SdlThreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+int SDLCALL sdlThreadEntry(void *data) {
+	SdlThreadStart start = *(SdlThreadStart *)data;
+	delete (SdlThreadStart *)data;
+	start.proc(start.param);
+	return 0;
+}
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef SdlMutexManager::createThread(OSystem::ThreadProc proc, void *param) {
+	SdlThreadStart *start = new SdlThreadStart;
+	start->proc = proc;
+	start->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_Thread *thread = SDL_CreateThread(sdlThreadEntry, "ScummVM worker", start);
+#else
+	SDL_Thread *thread = SDL_CreateThread(sdlThreadEntry, start);
+#endif
+	if (!thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete start;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void SdlMutexManager::joinThread(OSystem::ThreadRef thread) {
+	SDL_WaitThread((SDL_Thread *)thread, NULL);
+}
+
+OSystem::SemaphoreRef SdlMutexManager::createSemaphore(uint initialValue) {
+	return (OSystem::SemaphoreRef)SDL_CreateSemaphore(initialValue);
+}
+
+void SdlMutexManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_SemWait((SDL_sem *)semaphore);
+}
+
+void SdlMutexManager::postSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_SemPost((SDL_sem *)semaphore);
+}
+
+void SdlMutexManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_DestroySemaphore((SDL_sem *)semaphore);
+}
+
 #endif
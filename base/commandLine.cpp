@@ -215,6 +215,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("render_mode", "default");
 	ConfMan.registerDefault("desired_screen_aspect_ratio", "auto");
 	ConfMan.registerDefault("stretch_mode", "default");
+	ConfMan.registerDefault("scaler_threads", 0);
 
 	// Sound & Music
 	ConfMan.registerDefault("music_volume", 192);
@@ -233,8 +234,12 @@ void registerDefaults() {
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
+	ConfMan.registerDefault("mt32_render_ahead", 0);
 	ConfMan.registerDefault("gm_device", "null");
 	ConfMan.registerDefault("opl2lpt_parport", "null");
+	ConfMan.registerDefault("audio_resampler", "default");
+	ConfMan.registerDefault("audio_render_threads", 0);
+	ConfMan.registerDefault("sid_mode", "accurate");
 
 	ConfMan.registerDefault("cdrom", 0);
 
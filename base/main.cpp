@@ -59,6 +59,7 @@
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
+#include "audio/pcmcache.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
@@ -288,6 +289,10 @@ static Common::Error runGame(const Plugin *plugin, OSystem &system, const Common
 	// Free up memory
 	delete engine;
 
+	// Drop the sounds the engine decoded, they are of no use to other games
+	if (Audio::PCMCache::hasInstance())
+		Audio::PCMCache::instance().clear();
+
 	// We clear all debug levels again even though the engine should do it
 	DebugMan.clearAllDebugChannels();
 
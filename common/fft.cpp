@@ -28,6 +28,7 @@
 
 #include "common/cosinetables.h"
 #include "common/fft.h"
+#include "common/simd.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -176,10 +177,104 @@ static void name(Complex *z, const float *wre, unsigned int n) { \
 	} while(--n);\
 }
 
+#ifndef SCUMMVM_SIMD
 PASS(pass)
+#endif
 #undef BUTTERFLIES
 #define BUTTERFLIES BUTTERFLIES_BIG
+
+#ifndef SCUMMVM_SIMD
 PASS(pass_big)
+#else
+
+// Vectorised version of pass_big(). Each vector holds two consecutive complex
+// values, so the regular part of the loop handles two TRANSFORMs at a time.
+// The arithmetic is performed in the same order as in the scalar code.
+static void pass_simd(Complex *z, const float *wre, unsigned int n) {
+	float t1, t2, t3, t4, t5, t6;
+	const int o1 = 2 * n;
+	const int o2 = 4 * n;
+	const int o3 = 6 * n;
+	const float *wim = wre + o1;
+
+	TRANSFORM_ZERO(z[0], z[o1], z[o2], z[o3]);
+	TRANSFORM(z[1], z[o1 + 1], z[o2 + 1], z[o3 + 1], wre[1], wim[-1]);
+
+#if defined(SCUMMVM_SSE2)
+	const __m128 signLow = _mm_castsi128_ps(_mm_set_epi32(0, 0x80000000, 0, 0x80000000));
+	const __m128 signHigh = _mm_castsi128_ps(_mm_set_epi32(0x80000000, 0, 0x80000000, 0));
+
+	for (int k = 2; k < o1; k += 2) {
+		float *p0 = &z[k].re;
+		float *p1 = &z[o1 + k].re;
+		float *p2 = &z[o2 + k].re;
+		float *p3 = &z[o3 + k].re;
+
+		// Twiddles: wr = { wre[k], wre[k], wre[k + 1], wre[k + 1] },
+		//           wi = { wim[-k], wim[-k], wim[-k - 1], wim[-k - 1] }
+		__m128 wr = _mm_castpd_ps(_mm_load_sd((const double *)(wre + k)));
+		wr = _mm_unpacklo_ps(wr, wr);
+		__m128 wi = _mm_castpd_ps(_mm_load_sd((const double *)(wim - k - 1)));
+		wi = _mm_shuffle_ps(wi, wi, _MM_SHUFFLE(0, 0, 1, 1));
+
+		const __m128 a0 = _mm_loadu_ps(p0);
+		const __m128 a1 = _mm_loadu_ps(p1);
+		const __m128 a2 = _mm_loadu_ps(p2);
+		const __m128 a3 = _mm_loadu_ps(p3);
+
+		// { t1, t2 } and { t5, t6 }
+		const __m128 a2Swap = _mm_shuffle_ps(a2, a2, _MM_SHUFFLE(2, 3, 0, 1));
+		const __m128 a3Swap = _mm_shuffle_ps(a3, a3, _MM_SHUFFLE(2, 3, 0, 1));
+		const __m128 u = _mm_add_ps(_mm_mul_ps(a2, wr), _mm_xor_ps(_mm_mul_ps(a2Swap, wi), signHigh));
+		const __m128 v = _mm_add_ps(_mm_mul_ps(a3, wr), _mm_xor_ps(_mm_mul_ps(a3Swap, wi), signLow));
+
+		// { t5 + t1, t2 + t6 } and { t5 - t1, t2 - t6 } = { t3, t4 }
+		const __m128 sum = _mm_add_ps(v, u);
+		__m128 diff = _mm_xor_ps(_mm_sub_ps(v, u), signHigh);
+		diff = _mm_shuffle_ps(diff, diff, _MM_SHUFFLE(2, 3, 0, 1));
+
+		_mm_storeu_ps(p0, _mm_add_ps(a0, sum));
+		_mm_storeu_ps(p2, _mm_sub_ps(a0, sum));
+		_mm_storeu_ps(p1, _mm_add_ps(a1, diff));
+		_mm_storeu_ps(p3, _mm_sub_ps(a1, diff));
+	}
+#elif defined(SCUMMVM_NEON)
+	static const float signLowValues[4] = { -1.0f, 1.0f, -1.0f, 1.0f };
+	static const float signHighValues[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+	const float32x4_t signLow = vld1q_f32(signLowValues);
+	const float32x4_t signHigh = vld1q_f32(signHighValues);
+
+	for (int k = 2; k < o1; k += 2) {
+		float *p0 = &z[k].re;
+		float *p1 = &z[o1 + k].re;
+		float *p2 = &z[o2 + k].re;
+		float *p3 = &z[o3 + k].re;
+
+		const float32x2_t wr2 = vld1_f32(wre + k);
+		const float32x2_t wi2 = vld1_f32(wim - k - 1);
+		const float32x4_t wr = vcombine_f32(vdup_lane_f32(wr2, 0), vdup_lane_f32(wr2, 1));
+		const float32x4_t wi = vcombine_f32(vdup_lane_f32(wi2, 1), vdup_lane_f32(wi2, 0));
+
+		const float32x4_t a0 = vld1q_f32(p0);
+		const float32x4_t a1 = vld1q_f32(p1);
+		const float32x4_t a2 = vld1q_f32(p2);
+		const float32x4_t a3 = vld1q_f32(p3);
+
+		const float32x4_t u = vaddq_f32(vmulq_f32(a2, wr), vmulq_f32(vmulq_f32(vrev64q_f32(a2), wi), signHigh));
+		const float32x4_t v = vaddq_f32(vmulq_f32(a3, wr), vmulq_f32(vmulq_f32(vrev64q_f32(a3), wi), signLow));
+
+		const float32x4_t sum = vaddq_f32(v, u);
+		const float32x4_t diff = vrev64q_f32(vmulq_f32(vsubq_f32(v, u), signHigh));
+
+		vst1q_f32(p0, vaddq_f32(a0, sum));
+		vst1q_f32(p2, vsubq_f32(a0, sum));
+		vst1q_f32(p1, vaddq_f32(a1, diff));
+		vst1q_f32(p3, vsubq_f32(a1, diff));
+	}
+#endif
+}
+
+#endif // SCUMMVM_SIMD
 
 void FFT::fft4(Complex *z) {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
@@ -245,10 +340,14 @@ void FFT::fft(int n, int logn, Complex *z) {
 		fft((n / 4), logn - 2, z + (n / 4) * 2);
 		fft((n / 4), logn - 2, z + (n / 4) * 3);
 		assert(_cosTables[logn - 4]);
+#ifdef SCUMMVM_SIMD
+		pass_simd(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
+#else
 		if (n > 1024)
 			pass_big(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
 		else
 			pass(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
+#endif
 	}
 }
 
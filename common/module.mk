@@ -33,6 +33,7 @@ MODULE_OBJS := \
 	stream.o \
 	system.o \
 	textconsole.o \
+	thread.o \
 	tokenizer.o \
 	translation.o \
 	unarj.o \
@@ -23,8 +23,10 @@
 #ifndef COMMON_SERIALIZER_H
 #define COMMON_SERIALIZER_H
 
+#include "common/endian.h"
 #include "common/stream.h"
 #include "common/str.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -37,13 +39,58 @@ namespace Common {
 			return; \
 		if (_loadStream) \
 			val = static_cast<T>(_loadStream->read ## SUFFIX()); \
-		else { \
+		else if (_saveStream) { \
 			TYPE tmp = val; \
 			_saveStream->write ## SUFFIX(tmp); \
 		} \
 		_bytesSynced += SIZE; \
 	}
 
+/**
+ * Bulk counterpart of SYNC_AS. When the element type has the same size as the
+ * serialized type and the stream byte order matches the host, the array is
+ * transferred with a single read/write. Otherwise elements are converted
+ * through a small stack buffer, so there is still only one stream call per
+ * chunk instead of one per element.
+ */
+#define SYNC_ARRAY_AS(SUFFIX,TYPE,SIZE,READ,WRITE,NATIVE) \
+	template<typename T> \
+	void syncArrayAs ## SUFFIX(T *arr, size_t entries, Version minVersion = 0, Version maxVersion = kLastVersion) { \
+		if (_version < minVersion || _version > maxVersion) \
+			return; \
+		if (NATIVE && sizeof(T) == SIZE) { \
+			syncRawBytes(arr, entries * SIZE); \
+			return; \
+		} \
+		byte buf[kBulkBufferSize]; \
+		while (entries > 0) { \
+			const size_t count = MIN<size_t>(entries, kBulkBufferSize / SIZE); \
+			if (_loadStream) { \
+				_loadStream->read(buf, count * SIZE); \
+				for (size_t i = 0; i < count; ++i) \
+					arr[i] = static_cast<T>((TYPE)READ(buf + i * SIZE)); \
+			} else if (_saveStream) { \
+				for (size_t i = 0; i < count; ++i) \
+					WRITE(buf + i * SIZE, (TYPE)arr[i]); \
+				_saveStream->write(buf, count * SIZE); \
+			} \
+			_bytesSynced += count * SIZE; \
+			arr += count; \
+			entries -= count; \
+		} \
+	}
+
+#define SYNC_READ_BYTE(ptr) (*(const byte *)(ptr))
+#define SYNC_WRITE_BYTE(ptr, value) (*(byte *)(ptr) = (value))
+
+#if defined(SCUMM_LITTLE_ENDIAN)
+#define SYNC_NATIVE_LE true
+#define SYNC_NATIVE_BE false
+#else
+#define SYNC_NATIVE_LE false
+#define SYNC_NATIVE_BE true
+#endif
+
 #define SYNC_PRIMITIVE(suffix) \
 	template <typename T> \
 	static inline void suffix(Serializer &s, T &value) { \
@@ -61,9 +108,15 @@ namespace Common {
  *
  * @todo Maybe rename this to Synchronizer?
  *
+ * Arrays of integers can be synced in bulk with the syncArrayAs* methods,
+ * which avoid the per-element stream overhead of syncArray().
+ *
+ * A serializer constructed without any stream runs in size-only mode: nothing
+ * is read or written, but bytesSynced() reports how large the data would be.
+ * Client code sees such a serializer as saving.
+ *
  * @todo One feature the SCUMM code has but that is missing here: Support for
- *       syncing arrays of a given type and *fixed* size; and also support
- *       for when the array size changed between versions. Also, support for
+ *       when the array size changed between versions. Also, support for
  *       2D-arrays.
  *
  * @todo Proper error handling!
@@ -85,6 +138,9 @@ public:
 	SYNC_PRIMITIVE(SByte)
 
 protected:
+	/** Size of the stack buffer used to convert arrays in bulk. */
+	static const size_t kBulkBufferSize = 512;
+
 	SeekableReadStream *_loadStream;
 	WriteStream *_saveStream;
 
@@ -97,10 +153,20 @@ public:
 		: _loadStream(in), _saveStream(out), _bytesSynced(0), _version(0) {
 		assert(in || out);
 	}
+
+	/**
+	 * Create a serializer in size-only mode. It behaves like a saving
+	 * serializer which discards its output, so the same sync code can be used
+	 * to compute the size of a savestate before writing it.
+	 */
+	Serializer()
+		: _loadStream(0), _saveStream(0), _bytesSynced(0), _version(0) {
+	}
 	virtual ~Serializer() {}
 
-	inline bool isSaving() { return (_saveStream != 0); }
+	inline bool isSaving() { return (_loadStream == 0); }
 	inline bool isLoading() { return (_loadStream != 0); }
+	inline bool isSizeOnly() const { return (_loadStream == 0 && _saveStream == 0); }
 
 	// WORKAROUND for bugs #2892515 "BeOS: tinsel does not compile" and
 	// #2892510 "BeOS: Cruise does not compile". gcc 2.95.3, which is used
@@ -123,6 +189,19 @@ public:
 	SYNC_AS(Sint32LE, int32, 4)
 	SYNC_AS(Sint32BE, int32, 4)
 
+	SYNC_ARRAY_AS(Byte, byte, 1, SYNC_READ_BYTE, SYNC_WRITE_BYTE, true)
+	SYNC_ARRAY_AS(SByte, int8, 1, SYNC_READ_BYTE, SYNC_WRITE_BYTE, true)
+
+	SYNC_ARRAY_AS(Uint16LE, uint16, 2, READ_LE_UINT16, WRITE_LE_UINT16, SYNC_NATIVE_LE)
+	SYNC_ARRAY_AS(Uint16BE, uint16, 2, READ_BE_UINT16, WRITE_BE_UINT16, SYNC_NATIVE_BE)
+	SYNC_ARRAY_AS(Sint16LE, int16, 2, READ_LE_UINT16, WRITE_LE_UINT16, SYNC_NATIVE_LE)
+	SYNC_ARRAY_AS(Sint16BE, int16, 2, READ_BE_UINT16, WRITE_BE_UINT16, SYNC_NATIVE_BE)
+
+	SYNC_ARRAY_AS(Uint32LE, uint32, 4, READ_LE_UINT32, WRITE_LE_UINT32, SYNC_NATIVE_LE)
+	SYNC_ARRAY_AS(Uint32BE, uint32, 4, READ_BE_UINT32, WRITE_BE_UINT32, SYNC_NATIVE_BE)
+	SYNC_ARRAY_AS(Sint32LE, int32, 4, READ_LE_UINT32, WRITE_LE_UINT32, SYNC_NATIVE_LE)
+	SYNC_ARRAY_AS(Sint32BE, int32, 4, READ_BE_UINT32, WRITE_BE_UINT32, SYNC_NATIVE_BE)
+
 	/**
 	 * Returns true if an I/O failure occurred.
 	 * This flag is never cleared automatically. In order to clear it,
@@ -131,8 +210,10 @@ public:
 	bool err() const {
 		if (_saveStream)
 			return _saveStream->err();
-		else
+		else if (_loadStream)
 			return _loadStream->err();
+		else
+			return false;
 	}
 
 	/**
@@ -141,7 +222,7 @@ public:
 	void clearErr() {
 		if (_saveStream)
 			_saveStream->clearErr();
-		else
+		else if (_loadStream)
 			_loadStream->clearErr();
 	}
 
@@ -183,7 +264,7 @@ public:
 		_bytesSynced += size;
 		if (isLoading())
 			_loadStream->skip(size);
-		else {
+		else if (_saveStream) {
 			while (size--)
 				_saveStream->writeByte(0);
 		}
@@ -196,11 +277,7 @@ public:
 		if (_version < minVersion || _version > maxVersion)
 			return; // Ignore anything which is not supposed to be present in this save game version
 
-		if (isLoading())
-			_loadStream->read(buf, size);
-		else
-			_saveStream->write(buf, size);
-		_bytesSynced += size;
+		syncRawBytes(buf, size);
 	}
 
 	/**
@@ -221,7 +298,8 @@ public:
 
 		bool match;
 		if (isSaving()) {
-			_saveStream->write(magic, size);
+			if (_saveStream)
+				_saveStream->write(magic, size);
 			match = true;
 		} else {
 			char buf[256];
@@ -249,8 +327,10 @@ public:
 			}
 			_bytesSynced++;
 		} else {
-			_saveStream->writeString(str);
-			_saveStream->writeByte(0);
+			if (_saveStream) {
+				_saveStream->writeString(str);
+				_saveStream->writeByte(0);
+			}
 			_bytesSynced += str.size() + 1;
 		}
 	}
@@ -264,10 +344,27 @@ public:
 			serializer(*this, arr[i]);
 		}
 	}
+
+protected:
+	/**
+	 * Transfer a block of memory as-is, without any version check.
+	 */
+	void syncRawBytes(void *buf, size_t size) {
+		if (_loadStream)
+			_loadStream->read(buf, size);
+		else if (_saveStream)
+			_saveStream->write(buf, size);
+		_bytesSynced += size;
+	}
 };
 
 #undef SYNC_PRIMITIVE
 #undef SYNC_AS
+#undef SYNC_ARRAY_AS
+#undef SYNC_READ_BYTE
+#undef SYNC_WRITE_BYTE
+#undef SYNC_NATIVE_LE
+#undef SYNC_NATIVE_BE
 
 
 // Mixin class / interface
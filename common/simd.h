@@ -0,0 +1,57 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_SIMD_H
+#define COMMON_SIMD_H
+
+#include "common/scummsys.h"
+
+/**
+ * @file
+ * Selection of the SIMD instruction set used by the vectorised kernels in
+ * common/, audio/ and graphics/.
+ *
+ * Only instruction sets which are part of the baseline of the target ABI are
+ * used (SSE2 on x86-64 or when the compiler targets it, NEON on AArch64 or
+ * when the compiler targets it), so the choice is made at compile time and
+ * the kernels never need a runtime CPU check. Every kernel keeps its plain C
+ * version, which is used on all other targets and when building with
+ * DISABLE_SIMD defined.
+ *
+ * At most one of SCUMMVM_SSE2 and SCUMMVM_NEON is defined.
+ */
+
+#ifndef DISABLE_SIMD
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define SCUMMVM_SSE2
+		#include <emmintrin.h>
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#define SCUMMVM_NEON
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	#define SCUMMVM_SIMD
+#endif
+
+#endif // COMMON_SIMD_H
@@ -1230,6 +1230,67 @@ public:
 	//@}
 
 
+	/**
+	 * @name Threads
+	 * Optional support for additional threads, used to spread expensive work
+	 * (e.g. audio rendering or image scaling) over several CPU cores.
+	 *
+	 * Backends which do not support threads can simply keep the default
+	 * implementations, which refuse to create any. Client code must always
+	 * be prepared for that case and then do the work on the calling thread.
+	 */
+	//@{
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueSemaphore *SemaphoreRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Create a new thread running the given function.
+	 * @param proc	the function to run in the new thread
+	 * @param param	the parameter passed to the function
+	 * @return the newly created thread, or 0 if threads are not supported or
+	 *         an error occurred.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param) { return 0; }
+
+	/**
+	 * Wait until the given thread has finished and release it.
+	 * @param thread	the thread to wait for.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Create a new counting semaphore.
+	 * @param initialValue	the initial count of the semaphore
+	 * @return the newly created semaphore, or 0 if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual SemaphoreRef createSemaphore(uint initialValue) { return 0; }
+
+	/**
+	 * Wait until the count of the given semaphore is positive, then
+	 * decrement it.
+	 * @param semaphore	the semaphore to wait for.
+	 */
+	virtual void waitSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Increment the count of the given semaphore, waking up one waiting
+	 * thread if there is one.
+	 * @param semaphore	the semaphore to post.
+	 */
+	virtual void postSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Delete the given semaphore. No thread may be waiting for it.
+	 * @param semaphore	the semaphore to delete.
+	 */
+	virtual void deleteSemaphore(SemaphoreRef semaphore) {}
+
+	//@}
+
+
 
 	/** @name Sound */
 	//@{
@@ -0,0 +1,147 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/thread.h"
+#include "common/util.h"
+
+namespace Common {
+
+Semaphore::Semaphore(uint initialValue) {
+	assert(g_system);
+	_semaphore = g_system->createSemaphore(initialValue);
+}
+
+Semaphore::~Semaphore() {
+	if (_semaphore)
+		g_system->deleteSemaphore(_semaphore);
+}
+
+void Semaphore::wait() {
+	assert(_semaphore);
+	g_system->waitSemaphore(_semaphore);
+}
+
+void Semaphore::post() {
+	assert(_semaphore);
+	g_system->postSemaphore(_semaphore);
+}
+
+
+#pragma mark -
+
+
+Thread::Thread() : _thread(0) {
+}
+
+Thread::~Thread() {
+	join();
+}
+
+bool Thread::start(OSystem::ThreadProc proc, void *param) {
+	assert(g_system);
+	assert(!_thread);
+	_thread = g_system->createThread(proc, param);
+	return _thread != 0;
+}
+
+void Thread::join() {
+	if (_thread) {
+		g_system->joinThread(_thread);
+		_thread = 0;
+	}
+}
+
+
+#pragma mark -
+
+
+WorkerPool::WorkerPool(uint numThreads)
+	: _quit(false), _task(0), _param(0), _count(0), _next(0) {
+	if (!_start.isValid() || !_done.isValid())
+		return;
+
+	for (uint i = 0; i < numThreads; ++i) {
+		Thread *thread = new Thread();
+		if (!thread->start(workerProc, this)) {
+			delete thread;
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	_quit = true;
+	for (uint i = 0; i < _threads.size(); ++i)
+		_start.post();
+	for (uint i = 0; i < _threads.size(); ++i)
+		delete _threads[i];
+}
+
+void WorkerPool::run(Task task, void *param, uint count) {
+	if (!count)
+		return;
+
+	_task = task;
+	_param = param;
+	_count = count;
+	_next = 0;
+
+	// Only wake up as many workers as there are tasks left for them
+	const uint workers = MIN<uint>(_threads.size(), count - 1);
+	for (uint i = 0; i < workers; ++i)
+		_start.post();
+
+	processTasks();
+
+	for (uint i = 0; i < workers; ++i)
+		_done.wait();
+}
+
+void WorkerPool::workerProc(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	for (;;) {
+		pool->_start.wait();
+		if (pool->_quit)
+			break;
+
+		pool->processTasks();
+		pool->_done.post();
+	}
+}
+
+void WorkerPool::processTasks() {
+	for (;;) {
+		uint index;
+		{
+			StackLock lock(_mutex);
+			if (_next >= _count)
+				return;
+			index = _next++;
+		}
+
+		_task(_param, index);
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * Wrapper class around the OSystem semaphore functions.
+ *
+ * Threads are optional, so the semaphore may be invalid if the backend does
+ * not support them. Check isValid() before relying on it.
+ */
+class Semaphore : NonCopyable {
+	OSystem::SemaphoreRef _semaphore;
+
+public:
+	explicit Semaphore(uint initialValue = 0);
+	~Semaphore();
+
+	bool isValid() const { return _semaphore != 0; }
+
+	void wait();
+	void post();
+};
+
+/**
+ * Wrapper class around the OSystem thread functions. The thread is joined
+ * when the object is destroyed.
+ */
+class Thread : NonCopyable {
+	OSystem::ThreadRef _thread;
+
+public:
+	Thread();
+	~Thread();
+
+	/**
+	 * Start running the given function in a new thread.
+	 * @return true on success, false if the backend does not support
+	 *         threads or the thread could not be created.
+	 */
+	bool start(OSystem::ThreadProc proc, void *param);
+
+	/** Wait for the thread to finish. Does nothing if it is not running. */
+	void join();
+
+	bool isRunning() const { return _thread != 0; }
+};
+
+/**
+ * A fixed set of worker threads which run batches of independent tasks.
+ *
+ * run() hands out the task indices to the workers and the calling thread
+ * alike and returns once all tasks have completed. If the backend does not
+ * support threads, all the tasks simply run on the calling thread.
+ *
+ * run() must not be called from several threads at once, nor from within a
+ * task.
+ */
+class WorkerPool : NonCopyable {
+public:
+	typedef void (*Task)(void *param, uint index);
+
+	/**
+	 * Create a pool of worker threads.
+	 * @param numThreads	the number of additional threads to create; the
+	 *                      calling thread of run() always helps too.
+	 */
+	explicit WorkerPool(uint numThreads);
+	~WorkerPool();
+
+	/** Return the number of worker threads actually running. */
+	uint getThreadCount() const { return _threads.size(); }
+
+	/** Run task(param, i) for every i in [0, count). */
+	void run(Task task, void *param, uint count);
+
+private:
+	static void workerProc(void *param);
+	void processTasks();
+
+	Array<Thread *> _threads;
+	Semaphore _start;
+	Semaphore _done;
+	Mutex _mutex;
+	bool _quit;
+
+	Task _task;
+	void *_param;
+	uint _count;
+	uint _next;
+};
+
+} // End of namespace Common
+
+#endif
@@ -446,12 +446,12 @@ SaveStateDescriptor AdlMetaEngine::querySaveMetaInfos(const char *target, int sl
 		return SaveStateDescriptor();
 	}
 
-	Graphics::Surface *thumbnail;
-	if (!Graphics::loadThumbnail(*inFile, thumbnail)) {
+	Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*inFile);
+	if (!thumbnail) {
 		delete inFile;
 		return SaveStateDescriptor();
 	}
-	sd.setThumbnail(thumbnail);
+	sd.setThumbnailData(thumbnail);
 
 	delete inFile;
 	return sd;
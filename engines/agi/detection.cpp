@@ -375,13 +375,13 @@ SaveStateDescriptor AgiMetaEngine::querySaveMetaInfos(const char *target, int sl
 
 		char saveVersion = in->readByte();
 		if (saveVersion >= 4) {
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+			if (!thumbnail) {
 				delete in;
 				return SaveStateDescriptor();
 			}
 
-			descriptor.setThumbnail(thumbnail);
+			descriptor.setThumbnailData(thumbnail);
 
 			uint32 saveDate = in->readUint32BE();
 			uint16 saveTime = in->readUint16BE();
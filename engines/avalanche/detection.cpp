@@ -201,13 +201,13 @@ SaveStateDescriptor AvalancheMetaEngine::querySaveMetaInfos(const char *target,
 
 		SaveStateDescriptor desc(slot, description);
 
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*f, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*f);
+		if (!thumbnail) {
 			warning("Cannot read thumbnail data, possibly broken savegame");
 			delete f;
 			return SaveStateDescriptor();
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		delete f;
 		return desc;
@@ -430,12 +430,12 @@ SaveStateDescriptor DrasculaMetaEngine::querySaveMetaInfos(const char *target, i
 			return SaveStateDescriptor();
 		}
 
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*in, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+		if (!thumbnail) {
 			delete in;
 			return SaveStateDescriptor();
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		delete in;
 	}
@@ -198,8 +198,8 @@ SaveStateDescriptor DreamWebMetaEngine::querySaveMetaInfos(const char *target, i
 			uint32 saveDate = in->readUint32LE();
 			uint32 saveTime = in->readUint32LE();
 			uint32 playTime = in->readUint32LE();
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+			if (!thumbnail) {
 				warning("Missing or broken thumbnail - skipping");
 				delete in;
 				return desc;
@@ -214,7 +214,7 @@ SaveStateDescriptor DreamWebMetaEngine::querySaveMetaInfos(const char *target, i
 			desc.setSaveDate(year, month, day);
 			desc.setSaveTime(hour, minutes);
 			desc.setPlayTime(playTime * 1000);
-			desc.setThumbnail(thumbnail);
+			desc.setThumbnailData(thumbnail);
 		}
 
 		delete in;
@@ -174,12 +174,12 @@ SaveStateDescriptor GnapMetaEngine::querySaveMetaInfos(const char *target, int s
 		SaveStateDescriptor desc(slot, saveName);
 
 		if (version != 1) {
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*file, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*file);
+			if (!thumbnail) {
 				delete file;
 				return SaveStateDescriptor();
 			}
-			desc.setThumbnail(thumbnail);
+			desc.setThumbnailData(thumbnail);
 		}
 
 		int year = file->readSint16LE();
@@ -227,12 +227,12 @@ SaveStateList HDBMetaEngine::listSaves(const char *target) const {
 			if (in) {
 				SaveStateDescriptor desc;
 				char mapName[32];
-				Graphics::Surface *thumbnail;
+				Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
 
-				if (!Graphics::loadThumbnail(*in, thumbnail)) {
+				if (!thumbnail) {
 					warning("Error loading thumbnail for %s", file->c_str());
 				}
-				desc.setThumbnail(thumbnail);
+				desc.setThumbnailData(thumbnail);
 
 				uint32 timeSeconds = in->readUint32LE();;
 				in->read(mapName, 32);
@@ -263,12 +263,12 @@ SaveStateDescriptor HDBMetaEngine::querySaveMetaInfos(const char *target, int sl
 	if (in) {
 		SaveStateDescriptor desc;
 		char mapName[32];
-		Graphics::Surface *thumbnail;
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
 
-		if (!Graphics::loadThumbnail(*in, thumbnail)) {
+		if (!thumbnail) {
 			warning("Error loading thumbnail");
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		uint32 timeSeconds = in->readUint32LE();
 		in->read(mapName, 32);
@@ -241,13 +241,13 @@ SaveStateDescriptor HugoMetaEngine::querySaveMetaInfos(const char *target, int s
 
 		SaveStateDescriptor desc(slot, saveName);
 
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*file, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*file);
+		if (!thumbnail) {
 			warning("Missing or broken savegame thumbnail");
 			delete file;
 			return SaveStateDescriptor();
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		uint32 saveDate = file->readUint32BE();
 		uint16 saveTime = file->readUint16BE();
@@ -235,12 +235,12 @@ SaveStateDescriptor LilliputMetaEngine::querySaveMetaInfos(const char *target, i
 
 		SaveStateDescriptor desc(slot, saveName);
 
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*file, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*file);
+		if (!thumbnail) {
 			delete file;
 			return SaveStateDescriptor();
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		desc.setDeletableFlag(true);
 		desc.setWriteProtectedFlag(false);
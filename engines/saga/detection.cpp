@@ -256,12 +256,12 @@ SaveStateDescriptor SagaMetaEngine::querySaveMetaInfos(const char *target, int s
 		}
 
 		if (version >= 6) {
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+			if (!thumbnail) {
 				delete in;
 				return SaveStateDescriptor();
 			}
-			desc.setThumbnail(thumbnail);
+			desc.setThumbnailData(thumbnail);
 
 			uint32 saveDate = in->readUint32BE();
 			uint16 saveTime = in->readUint16BE();
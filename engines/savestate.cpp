@@ -22,17 +22,19 @@
 
 #include "engines/savestate.h"
 #include "graphics/surface.h"
+#include "graphics/thumbnail.h"
+#include "common/stream.h"
 #include "common/textconsole.h"
 
 SaveStateDescriptor::SaveStateDescriptor()
 	// FIXME: default to 0 (first slot) or to -1 (invalid slot) ?
 	: _slot(-1), _description(), _isDeletable(true), _isWriteProtected(false),
-	  _isLocked(false), _saveDate(), _saveTime(), _playTime(), _playTimeMSecs(0), _thumbnail() {
+	  _isLocked(false), _saveDate(), _saveTime(), _playTime(), _playTimeMSecs(0), _thumbnail(), _thumbnailData() {
 }
 
 SaveStateDescriptor::SaveStateDescriptor(int s, const Common::String &d)
 	: _slot(s), _description(d), _isDeletable(true), _isWriteProtected(false),
-	  _isLocked(false), _saveDate(), _saveTime(), _playTime(), _playTimeMSecs(0), _thumbnail() {
+	  _isLocked(false), _saveDate(), _saveTime(), _playTime(), _playTimeMSecs(0), _thumbnail(), _thumbnailData() {
 }
 
 void SaveStateDescriptor::setThumbnail(Graphics::Surface *t) {
@@ -40,6 +42,24 @@ void SaveStateDescriptor::setThumbnail(Graphics::Surface *t) {
 		return;
 
 	_thumbnail = Common::SharedPtr<Graphics::Surface>(t, Graphics::SurfaceDeleter());
+	_thumbnailData.reset();
+}
+
+const Graphics::Surface *SaveStateDescriptor::getThumbnail() const {
+	if (_thumbnailData) {
+		Graphics::Surface *thumbnail;
+		_thumbnailData->seek(0, SEEK_SET);
+		if (Graphics::loadThumbnail(*_thumbnailData, thumbnail))
+			_thumbnail = Common::SharedPtr<Graphics::Surface>(thumbnail, Graphics::SurfaceDeleter());
+		_thumbnailData.reset();
+	}
+
+	return _thumbnail.get();
+}
+
+void SaveStateDescriptor::setThumbnailData(Common::SeekableReadStream *data) {
+	_thumbnail.reset();
+	_thumbnailData = Common::SharedPtr<Common::SeekableReadStream>(data);
 }
 
 void SaveStateDescriptor::setSaveDate(int year, int month, int day) {
@@ -27,6 +27,10 @@
 #include "common/str.h"
 #include "common/ptr.h"
 
+namespace Common {
+class SeekableReadStream;
+}
+
 namespace Graphics {
 struct Surface;
 }
@@ -113,7 +117,7 @@ public:
 	 * should be either 160x100 or 160x120 pixels, depending on the aspect
 	 * ratio of the game. If another ratio is required, contact the core team.
 	 */
-	const Graphics::Surface *getThumbnail() const { return _thumbnail.get(); }
+	const Graphics::Surface *getThumbnail() const;
 
 	/**
 	 * Set a thumbnail graphics surface representing the savestate visually.
@@ -121,7 +125,16 @@ public:
 	 * Hence the caller must not delete the surface.
 	 */
 	void setThumbnail(Graphics::Surface *t);
-	void setThumbnail(Common::SharedPtr<Graphics::Surface> t) { _thumbnail = t; }
+	void setThumbnail(Common::SharedPtr<Graphics::Surface> t) { _thumbnail = t; _thumbnailData.reset(); }
+
+	/**
+	 * Set a thumbnail which is only decoded when getThumbnail() is first
+	 * called, so that querying the meta data of a save state does not cost
+	 * decoding a thumbnail which is never shown. Ownership of the stream,
+	 * as returned by Graphics::readThumbnailData(), is transferred to the
+	 * SaveStateDescriptor.
+	 */
+	void setThumbnailData(Common::SeekableReadStream *data);
 
 	/**
 	 * Sets the date the save state was created.
@@ -236,7 +249,12 @@ private:
 	/**
 	 * The thumbnail of the save state.
 	 */
-	Common::SharedPtr<Graphics::Surface> _thumbnail;
+	mutable Common::SharedPtr<Graphics::Surface> _thumbnail;
+
+	/**
+	 * The encoded thumbnail, until getThumbnail() decodes it.
+	 */
+	mutable Common::SharedPtr<Common::SeekableReadStream> _thumbnailData;
 };
 
 /** List of savestates. */
@@ -887,15 +887,15 @@ SaveStateDescriptor SciMetaEngine::querySaveMetaInfos(const char *target, int sl
 
 		descriptor.setDescription(meta.name);
 
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*in, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+		if (!thumbnail) {
 			// invalid
 			delete in;
 
 			descriptor.setDescription("*Invalid*");
 			return descriptor;
 		}
-		descriptor.setThumbnail(thumbnail);
+		descriptor.setThumbnailData(thumbnail);
 
 		int day = (meta.saveDate >> 24) & 0xFF;
 		int month = (meta.saveDate >> 16) & 0xFF;
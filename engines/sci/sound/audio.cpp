@@ -33,6 +33,7 @@
 #include "common/system.h"
 
 #include "audio/audiostream.h"
+#include "audio/pcmcache.h"
 #include "audio/decoders/aiff.h"
 #include "audio/decoders/flac.h"
 #include "audio/decoders/mac_snd.h"
@@ -359,33 +360,48 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 
 	if (audioCompressionType) {
 #if (defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC))
-		// Compressed audio made by our tool
-		byte *compressedData = (byte *)malloc(audioRes->size());
-		assert(compressedData);
-		// We copy over the compressed data in our own buffer. We have to do
-		// this, because ResourceManager may free the original data late. All
-		// other compression types already decompress completely into an
-		// additional buffer here. MP3/OGG/FLAC decompression works on-the-fly
-		// instead.
-		audioRes->unsafeCopyDataTo(compressedData);
-		Common::SeekableReadStream *compressedStream = new Common::MemoryReadStream(compressedData, audioRes->size(), DisposeAfterUse::YES);
+		// Sound effects (unlike speech) are played over and over again, so
+		// keep them in the PCM cache instead of decoding them every time
+		Common::String cacheKey;
+		if (volume == 65535) {
+			cacheKey = Audio::PCMCache::makeKey(audioRes->getId().toString(), 0, audioRes->size(), audioCompressionType);
+			audioSeekStream = Audio::PCMCache::instance().find(cacheKey);
+		}
 
-		switch (audioCompressionType) {
-		case MKTAG('M','P','3',' '):
+		if (!audioSeekStream) {
+			// Compressed audio made by our tool
+			byte *compressedData = (byte *)malloc(audioRes->size());
+			assert(compressedData);
+			// We copy over the compressed data in our own buffer. We have to do
+			// this, because ResourceManager may free the original data late. All
+			// other compression types already decompress completely into an
+			// additional buffer here. MP3/OGG/FLAC decompression works on-the-fly
+			// instead.
+			audioRes->unsafeCopyDataTo(compressedData);
+			Common::SeekableReadStream *compressedStream = new Common::MemoryReadStream(compressedData, audioRes->size(), DisposeAfterUse::YES);
+
+			switch (audioCompressionType) {
+			case MKTAG('M','P','3',' '):
 #ifdef USE_MAD
-			audioSeekStream = Audio::makeMP3Stream(compressedStream, DisposeAfterUse::YES);
+				audioSeekStream = Audio::makeMP3Stream(compressedStream, DisposeAfterUse::YES);
 #endif
-			break;
-		case MKTAG('O','G','G',' '):
+				break;
+			case MKTAG('O','G','G',' '):
 #ifdef USE_VORBIS
-			audioSeekStream = Audio::makeVorbisStream(compressedStream, DisposeAfterUse::YES);
+				audioSeekStream = Audio::makeVorbisStream(compressedStream, DisposeAfterUse::YES);
 #endif
-			break;
-		case MKTAG('F','L','A','C'):
+				break;
+			case MKTAG('F','L','A','C'):
 #ifdef USE_FLAC
-			audioSeekStream = Audio::makeFLACStream(compressedStream, DisposeAfterUse::YES);
+				audioSeekStream = Audio::makeFLACStream(compressedStream, DisposeAfterUse::YES);
 #endif
-			break;
+				break;
+			}
+
+			if (!cacheKey.empty())
+				audioSeekStream = Audio::PCMCache::instance().insert(cacheKey, audioSeekStream);
+			else
+				audioSeekStream = Audio::makeDecodeAheadStream(audioSeekStream);
 		}
 #else
 		error("Compressed audio file encountered, but no appropriate decoder is compiled in");
@@ -60,6 +60,9 @@ MidiParser_SCI::MidiParser_SCI(SciVersion soundVersion, SciMusic *music) :
 
 	_mainThreadCalled = false;
 
+	// Loops jump back without firing events, let them use the seek index
+	_useSeekIndex = true;
+
 	resetStateTracking();
 }
 
@@ -424,6 +427,7 @@ void MidiParser_SCI::unloadMusic() {
 		resetTracking();
 		allNotesOff();
 	}
+	clearSeekIndex();
 	_numTracks = 0;
 	_activeTrack = 255;
 	_resetOnPause = false;
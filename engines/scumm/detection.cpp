@@ -1319,7 +1319,7 @@ void ScummMetaEngine::removeSaveState(const char *target, int slot) const {
 
 SaveStateDescriptor ScummMetaEngine::querySaveMetaInfos(const char *target, int slot) const {
 	Common::String saveDesc;
-	Graphics::Surface *thumbnail = nullptr;
+	Common::SeekableReadStream *thumbnail = nullptr;
 	SaveStateMetaInfos infos;
 	memset(&infos, 0, sizeof(infos));
 	SaveStateMetaInfos *infoPtr = &infos;
@@ -1338,7 +1338,7 @@ SaveStateDescriptor ScummMetaEngine::querySaveMetaInfos(const char *target, int
 		desc.setDeletableFlag(false);
 	}
 
-	desc.setThumbnail(thumbnail);
+	desc.setThumbnailData(thumbnail);
 
 	if (infoPtr) {
 		int day = (infos.date >> 24) & 0xFF;
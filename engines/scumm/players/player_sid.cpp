@@ -22,6 +22,7 @@
 
 #ifndef DISABLE_SID
 
+#include "common/config-manager.h"
 #include "engines/engine.h"
 #include "scumm/players/player_sid.h"
 #include "scumm/scumm.h"
@@ -1311,6 +1312,7 @@ void Player_SID::initSID() {
 		timingProps[_videoSystem].clockFreq,
 		_sampleRate);
 	_sid->enable_filter(true);
+	_sid->enable_fast_mode(ConfMan.get("sid_mode") == "fast");
 
 	_sid->reset();
 	// Synchronize the waveform generators (must occur after reset)
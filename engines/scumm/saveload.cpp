@@ -177,18 +177,29 @@ static bool saveSaveGameHeader(Common::WriteStream *out, SaveGameHeader &hdr) {
 bool ScummEngine::saveState(Common::WriteStream *out, bool writeHeader) {
 	SaveGameHeader hdr;
 
+#if !defined(__DS__) && !defined(__N64__) /* && !defined(__PLAYSTATION2__) */
+	// The thumbnail is scaled and encoded on a worker thread while the game
+	// state, which follows it in the file, is serialized into memory
+	Graphics::AsyncThumbnail thumbnail;
+	Common::MemoryWriteStreamDynamic state(DisposeAfterUse::YES);
+	Common::WriteStream *stateOut = &state;
+#else
+	Common::WriteStream *stateOut = out;
+#endif
+	saveInfos(stateOut);
+
+	Common::Serializer ser(0, stateOut);
+	ser.setVersion(CURRENT_VER);
+	saveLoadWithSerializer(ser);
+
 	if (writeHeader) {
 		Common::strlcpy(hdr.name, _saveLoadDescription.c_str(), sizeof(hdr.name));
 		saveSaveGameHeader(out, hdr);
 	}
 #if !defined(__DS__) && !defined(__N64__) /* && !defined(__PLAYSTATION2__) */
-	Graphics::saveThumbnail(*out);
+	thumbnail.save(*out);
+	out->write(state.getData(), state.size());
 #endif
-	saveInfos(out);
-
-	Common::Serializer ser(0, out);
-	ser.setVersion(CURRENT_VER);
-	saveLoadWithSerializer(ser);
 	return true;
 }
 
@@ -685,7 +696,7 @@ bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion
 	return true;
 }
 
-bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface *&thumbnail, SaveStateMetaInfos *&timeInfos) {
+bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Common::SeekableReadStream *&thumbnail, SaveStateMetaInfos *&timeInfos) {
 	if (slot < 0) {
 		return false;
 	}
@@ -706,13 +717,16 @@ bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion
 
 	if (hdr.ver > VER(52)) {
 		if (Graphics::checkThumbnailHeader(*in)) {
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			thumbnail = Graphics::readThumbnailData(*in);
+			if (!thumbnail) {
 				return false;
 			}
 		}
 
 		if (hdr.ver > VER(57)) {
 			if (!loadInfos(in.get(), timeInfos)) {
+				delete thumbnail;
+				thumbnail = nullptr;
 				return false;
 			}
 		} else {
@@ -1074,9 +1088,9 @@ void ScummEngine::saveLoadWithSerializer(Common::Serializer &s) {
 	s.syncAsUint16LE(_palManipCounter, VER(10));
 
 	// gfxUsageBits grew from 200 to 410 entries. Then 3 * 410 entries:
-	s.syncArray(gfxUsageBits, 200, Common::Serializer::Uint32LE, VER(8), VER(9));
-	s.syncArray(gfxUsageBits, 410, Common::Serializer::Uint32LE, VER(10), VER(13));
-	s.syncArray(gfxUsageBits, 3 * 410, Common::Serializer::Uint32LE, VER(14));
+	s.syncArrayAsUint32LE(gfxUsageBits, 200, VER(8), VER(9));
+	s.syncArrayAsUint32LE(gfxUsageBits, 410, VER(10), VER(13));
+	s.syncArrayAsUint32LE(gfxUsageBits, 3 * 410, VER(14));
 
 	s.skip(1, VER(8), VER(50)); // _gdi->_transparentColor
 	s.syncBytes(_currentPalette, 768, VER(8));
@@ -1293,7 +1307,7 @@ void ScummEngine::saveLoadWithSerializer(Common::Serializer &s) {
 	// Save/load palette data
 	// Don't save 16 bit palette in FM-Towns and PCE games, since it gets regenerated afterwards anyway.
 	if (_16BitPalette && !(_game.platform == Common::kPlatformFMTowns && s.getVersion() < VER(82)) && !((_game.platform == Common::kPlatformFMTowns || _game.platform == Common::kPlatformPCEngine) && s.getVersion() > VER(87))) {
-		s.syncArray(_16BitPalette, 512, Common::Serializer::Uint16LE);
+		s.syncArrayAsUint16LE(_16BitPalette, 512);
 	}
 
 
@@ -1393,7 +1407,7 @@ void ScummEngine::saveLoadWithSerializer(Common::Serializer &s) {
 	//
 	// Save/load more global object state
 	//
-	s.syncArray(_classData, _numGlobalObjects, Common::Serializer::Uint32LE);
+	s.syncArrayAsUint32LE(_classData, _numGlobalObjects);
 
 
 	//
@@ -1402,13 +1416,13 @@ void ScummEngine::saveLoadWithSerializer(Common::Serializer &s) {
 	var120Backup = _scummVars[120];
 	var98Backup = _scummVars[98];
 
-	s.syncArray(_roomVars, _numRoomVariables, Common::Serializer::Sint32LE, VER(38));
+	s.syncArrayAsSint32LE(_roomVars, _numRoomVariables, VER(38));
 
 	// The variables grew from 16 to 32 bit.
 	if (s.getVersion() < VER(15))
-		s.syncArray(_scummVars, _numVariables, Common::Serializer::Sint16LE);
+		s.syncArrayAsSint16LE(_scummVars, _numVariables);
 	else
-		s.syncArray(_scummVars, _numVariables, Common::Serializer::Sint32LE);
+		s.syncArrayAsSint32LE(_scummVars, _numVariables);
 
 	if (_game.id == GID_TENTACLE)	// Maybe misplaced, but that's the main idea
 		_scummVars[120] = var120Backup;
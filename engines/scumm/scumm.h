@@ -635,7 +635,7 @@ public:
 
 // thumbnail + info stuff
 public:
-	static bool querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface *&thumbnail, SaveStateMetaInfos *&timeInfos);
+	static bool querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Common::SeekableReadStream *&thumbnail, SaveStateMetaInfos *&timeInfos);
 
 protected:
 	void saveInfos(Common::WriteStream *file);
@@ -239,12 +239,12 @@ SaveStateDescriptor SupernovaMetaEngine::querySaveMetaInfos(const char *target,
 		desc.setPlayTime(playTime * 1000);
 
 		if (Graphics::checkThumbnailHeader(*savefile)) {
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*savefile, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*savefile);
+			if (!thumbnail) {
 				delete savefile;
 				return SaveStateDescriptor();
 			}
-			desc.setThumbnail(thumbnail);
+			desc.setThumbnailData(thumbnail);
 		}
 
 		delete savefile;
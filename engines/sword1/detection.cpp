@@ -302,12 +302,12 @@ SaveStateDescriptor SwordMetaEngine::querySaveMetaInfos(const char *target, int
 			in->skip(1);
 
 		if (Graphics::checkThumbnailHeader(*in)) {
-			Graphics::Surface *thumbnail;
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+			if (!thumbnail) {
 				delete in;
 				return SaveStateDescriptor();
 			}
-			desc.setThumbnail(thumbnail);
+			desc.setThumbnailData(thumbnail);
 		}
 
 		uint32 saveDate = in->readUint32BE();
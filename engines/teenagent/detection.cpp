@@ -178,11 +178,11 @@ public:
 		SaveStateDescriptor ssd(slot, desc);
 
 		//checking for the thumbnail
-		Graphics::Surface *thumbnail;
-		if (!Graphics::loadThumbnail(*in, thumbnail)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*in);
+		if (!thumbnail) {
 			return SaveStateDescriptor();
 		}
-		ssd.setThumbnail(thumbnail);
+		ssd.setThumbnailData(thumbnail);
 
 		return ssd;
 	}
@@ -243,12 +243,12 @@ SaveStateDescriptor ToonMetaEngine::querySaveMetaInfos(const char *target, int s
 
 		SaveStateDescriptor desc(slot, saveName);
 
-		Graphics::Surface *thumbnail = nullptr;
-		if (!Graphics::loadThumbnail(*file, thumbnail, false)) {
+		Common::SeekableReadStream *thumbnail = Graphics::readThumbnailData(*file);
+		if (!thumbnail) {
 			delete file;
 			return SaveStateDescriptor();
 		}
-		desc.setThumbnail(thumbnail);
+		desc.setThumbnailData(thumbnail);
 
 		uint32 saveDate = file->readUint32BE();
 		uint16 saveTime = file->readUint16BE();
@@ -907,6 +907,7 @@ void AdObject::talk(const char *text, const char *sound, uint32 duration, const
 	_sentence->_startTime = _gameRef->getTimer()->getTime();
 	_sentence->_currentStance = -1;
 	_sentence->_font = _font == nullptr ? _gameRef->getSystemFont() : _font;
+	_sentence->_font->cacheText((byte *)_sentence->_text);
 	_sentence->_freezable = _freezable;
 
 	// try to locate speech file automatically
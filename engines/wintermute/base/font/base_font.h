@@ -42,6 +42,8 @@ public:
 	virtual int getTextHeight(const byte *text, int width);
 	virtual void drawText(const byte *text, int x, int y, int width, TTextAlign align = TAL_LEFT, int max_height = -1, int maxLength = -1);
 	virtual int getLetterHeight();
+	/** Prepare the characters of a text which is going to be shown, e.g. a new subtitle. */
+	virtual void cacheText(const byte *text) {}
 
 	virtual void initLoop() {}
 	virtual void afterLoad() {}
@@ -131,6 +131,25 @@ int BaseFontTT::getTextWidth(const byte *text, int maxLength) {
 	return textWidth;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void BaseFontTT::cacheText(const byte *text) {
+	if (!_font) {
+		return;
+	}
+
+	WideString textStr;
+
+	if (_gameRef->_textEncoding == TEXT_UTF8) {
+		textStr = StringUtil::utf8ToWide((const char *)text);
+	} else {
+		textStr = StringUtil::ansiToWide((const char *)text, _charset);
+	}
+
+	// Render all the new characters at once, before the text gets measured
+	// and drawn
+	_font->cacheText(textStr);
+}
+
 //////////////////////////////////////////////////////////////////////////
 int BaseFontTT::getTextHeight(const byte *text, int width) {
 	WideString textStr;
@@ -102,6 +102,7 @@ public:
 	virtual int getTextWidth(const byte *text, int maxLength = -1) override;
 	virtual int getTextHeight(const byte *text, int width) override;
 	virtual void drawText(const byte *text, int x, int y, int width, TTextAlign align = TAL_LEFT, int max_height = -1, int maxLength = -1) override;
+	virtual void cacheText(const byte *text) override;
 	virtual int getLetterHeight() override;
 
 	bool loadBuffer(char *buffer);
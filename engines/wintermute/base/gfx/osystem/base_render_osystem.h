@@ -34,6 +34,7 @@
 #include "graphics/surface.h"
 #include "common/list.h"
 #include "graphics/transform_struct.h"
+#include "graphics/transformed_surface_cache.h"
 
 namespace Wintermute {
 class BaseSurfaceOSystem;
@@ -112,6 +113,11 @@ public:
 	void endSaveLoad();
 	void drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
 	BaseSurface *createSurface() override;
+	/**
+	 * Cache of scaled and rotated sprites, which are often drawn with the
+	 * same transformation for many frames in a row.
+	 */
+	Graphics::TransformedSurfaceCache &getTransformedSurfaceCache() { return _transformedSurfaceCache; }
 private:
 	/**
 	 * Mark a specified rect of the screen as dirty.
@@ -147,6 +153,8 @@ private:
 
 	bool _skipThisFrame;
 	int _lastScreenChangeID; // previous value of OSystem::getScreenChangeID()
+
+	Graphics::TransformedSurfaceCache _transformedSurfaceCache;
 };
 
 } // End of namespace Wintermute
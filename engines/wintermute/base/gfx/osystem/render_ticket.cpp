@@ -30,6 +30,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/gfx/osystem/render_ticket.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "graphics/transform_tools.h"
 #include "common/textconsole.h"
 
@@ -58,14 +59,11 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 		// NB: Mirroring and rotation are probably done in the wrong order.
 		// (Mirroring should most likely be done before rotation. See also
 		// TransformTools.)
+		BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(owner->_gameRef->_renderer);
+		Graphics::TFilteringMode filteringMode = owner->_gameRef->getBilinearFiltering() ? Graphics::FILTER_BILINEAR : Graphics::FILTER_NEAREST;
 		if (_transform._angle != Graphics::kDefaultAngle) {
 			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
-			} else {
-				temp = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
-			}
+			Graphics::Surface *temp = renderer->getTransformedSurfaceCache().rotoscale(src, transform, filteringMode);
 			_surface->free();
 			delete _surface;
 			_surface = temp;
@@ -74,11 +72,12 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 					_transform._numTimesX * _transform._numTimesY == 1) {
 			Graphics::TransparentSurface src(*_surface, false);
 			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
-			} else {
-				temp = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
-			}
+			// Looking up the source in the cache costs about as much as a
+			// nearest neighbour scale
+			if (filteringMode == Graphics::FILTER_BILINEAR)
+				temp = renderer->getTransformedSurfaceCache().scale(src, dstRect->width(), dstRect->height(), filteringMode);
+			else
+				temp = src.scale(dstRect->width(), dstRect->height());
 			_surface->free();
 			delete _surface;
 			_surface = temp;
@@ -477,6 +477,34 @@ public:
 	virtual void drawStep(const Common::Rect &area, const DrawStep &step, uint32 extra = 0);
 	virtual void drawStepClip(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
 
+	/**
+	 * Sets up the renderer the way drawStep() does before drawing the step,
+	 * without drawing anything.
+	 *
+	 * This allows to leave the renderer in the same state as if the step was
+	 * drawn, when its result is already known.
+	 */
+	void setStepState(const DrawStep &step, uint32 extra = 0);
+
+	/**
+	 * The colors of the renderer. Draw steps which do not specify some of
+	 * them keep on using the ones set by the previous steps.
+	 */
+	struct ColorState {
+		uint32 fg, bg, bevel, gradientStart, gradientEnd;
+
+		bool operator==(const ColorState &state) const {
+			return fg == state.fg && bg == state.bg && bevel == state.bevel &&
+			       gradientStart == state.gradientStart && gradientEnd == state.gradientEnd;
+		}
+	};
+
+	/**
+	 * Returns the current colors of the renderer, in the format of the
+	 * drawing surface.
+	 */
+	virtual void getColorState(ColorState &state) const = 0;
+
 	/**
 	 * Copies the part of the current frame to the system overlay.
 	 *
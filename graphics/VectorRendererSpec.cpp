@@ -537,7 +537,8 @@ VectorRendererSpec(PixelFormat format) :
 	_redMask((0xFF >> format.rLoss) << format.rShift),
 	_greenMask((0xFF >> format.gLoss) << format.gShift),
 	_blueMask((0xFF >> format.bLoss) << format.bShift),
-	_alphaMask((0xFF >> format.aLoss) << format.aShift) {
+	_alphaMask((0xFF >> format.aLoss) << format.aShift),
+	_fgColor(0), _bgColor(0), _gradientStart(0), _gradientEnd(0), _bevelColor(0) {
 
 	_bitmapAlphaColor = _format.RGBToColor(255, 0, 255);
 	_clippingArea = Common::Rect(0, 0, 32767, 32767);
@@ -564,6 +565,16 @@ setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) {
 	}
 }
 
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+getColorState(ColorState &state) const {
+	state.fg = _fgColor;
+	state.bg = _bgColor;
+	state.bevel = _bevelColor;
+	state.gradientStart = _gradientStart;
+	state.gradientEnd = _gradientEnd;
+}
+
 template<typename PixelType>
 inline PixelType VectorRendererSpec<PixelType>::
 calcGradient(uint32 pos, uint32 max) {
@@ -24,6 +24,7 @@
 #include "graphics/pixelformat.h"
 
 #include "common/endian.h"
+#include "common/simd.h"
 
 namespace Graphics {
 
@@ -31,6 +32,305 @@ namespace Graphics {
 
 namespace {
 
+/**
+ * How the colors of one pixel format map to another one. This gives the same
+ * results as colorToARGB() followed by ARGBToColor(), but with the shifts
+ * worked out beforehand, which makes it possible to convert several colors
+ * at once.
+ *
+ * A converted color is made of parts of the original color, each one moved
+ * by some bits and masked. Components with 4 to 8 bits are expanded to 8 bits
+ * by ColorComponent with one extra part, (value << (8 - bits)) |
+ * (value >> (2 * bits - 8)), and parts moved by the same number of bits are
+ * merged together.
+ */
+struct FormatMapping {
+	struct Part {
+		uint32 left;
+		uint32 right;
+		uint32 mask;
+	};
+
+	Part parts[8];
+	uint numParts;
+	/** The bits which are the same in all converted colors */
+	uint32 constant;
+
+	/** Move count bits of the original color from bit srcBit to bit dstBit */
+	void addPart(uint srcBit, uint count, uint dstBit) {
+		const uint32 left = dstBit > srcBit ? dstBit - srcBit : 0;
+		const uint32 right = srcBit > dstBit ? srcBit - dstBit : 0;
+		const uint32 mask = ((1u << count) - 1) << dstBit;
+
+		for (uint i = 0; i < numParts; i++) {
+			if (parts[i].left == left && parts[i].right == right) {
+				parts[i].mask |= mask;
+				return;
+			}
+		}
+
+		parts[numParts].left = left;
+		parts[numParts].right = right;
+		parts[numParts].mask = mask;
+		numParts++;
+	}
+
+	/**
+	 * Add one color component.
+	 * @param missing the value of the component if srcBits is 0
+	 * @return false if the component cannot be mapped this way
+	 */
+	bool addComponent(uint srcBits, uint srcShift, uint dstLoss, uint dstShift, uint missing) {
+		if (dstLoss >= 8)
+			return true;
+
+		if (srcBits == 0) {
+			constant |= (missing >> dstLoss) << dstShift;
+			return true;
+		}
+
+		// Fewer bits are expanded with more than two parts
+		if (srcBits < 4)
+			return false;
+
+		const uint dstBits = 8 - dstLoss;
+		if (dstBits <= srcBits) {
+			addPart(srcShift + srcBits - dstBits, dstBits, dstShift);
+		} else {
+			addPart(srcShift, srcBits, dstShift + dstBits - srcBits);
+			addPart(srcShift + 2 * srcBits - dstBits, dstBits - srcBits, dstShift);
+		}
+		return true;
+	}
+
+	bool create(const PixelFormat &srcFmt, const PixelFormat &dstFmt) {
+		numParts = 0;
+		constant = 0;
+		return addComponent(srcFmt.aBits(), srcFmt.aShift, dstFmt.aLoss, dstFmt.aShift, 0xFF)
+		    && addComponent(srcFmt.rBits(), srcFmt.rShift, dstFmt.rLoss, dstFmt.rShift, 0)
+		    && addComponent(srcFmt.gBits(), srcFmt.gShift, dstFmt.gLoss, dstFmt.gShift, 0)
+		    && addComponent(srcFmt.bBits(), srcFmt.bShift, dstFmt.bLoss, dstFmt.bShift, 0);
+	}
+
+	inline uint32 map(uint32 color) const {
+		uint32 result = constant;
+		for (uint i = 0; i < numParts; i++)
+			result |= ((color << parts[i].left) >> parts[i].right) & parts[i].mask;
+		return result;
+	}
+};
+
+#if defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define CONVERSION_SIMD
+
+#pragma mark -
+
+#if defined(SCUMMVM_SSE2)
+typedef __m128i Colors;
+
+/** FormatMapping with the shift counts and masks ready for four colors at once */
+struct LaneMapping {
+	struct Part {
+		__m128i left, right, mask;
+	} parts[8];
+	uint numParts;
+	__m128i constant;
+
+	LaneMapping(const FormatMapping &mapping) : numParts(mapping.numParts) {
+		for (uint i = 0; i < numParts; i++) {
+			parts[i].left = _mm_cvtsi32_si128(mapping.parts[i].left);
+			parts[i].right = _mm_cvtsi32_si128(mapping.parts[i].right);
+			parts[i].mask = _mm_set1_epi32(mapping.parts[i].mask);
+		}
+		constant = _mm_set1_epi32(mapping.constant);
+	}
+
+	inline Colors map(Colors colors) const {
+		Colors result = constant;
+		for (uint i = 0; i < numParts; i++)
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srl_epi32(_mm_sll_epi32(colors, parts[i].left), parts[i].right), parts[i].mask));
+		return result;
+	}
+};
+
+inline Colors loadColors(const uint16 *src) {
+	return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+inline Colors loadColors(const uint32 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+inline void storeColors(uint16 *dst, Colors colors) {
+	// Sign extend the low halves, so that they are packed without saturation
+	colors = _mm_srai_epi32(_mm_slli_epi32(colors, 16), 16);
+	_mm_storel_epi64((__m128i *)dst, _mm_packs_epi32(colors, colors));
+}
+
+inline void storeColors(uint32 *dst, Colors colors) {
+	_mm_storeu_si128((__m128i *)dst, colors);
+}
+#elif defined(SCUMMVM_NEON)
+typedef uint32x4_t Colors;
+
+/**
+ * FormatMapping with the shift counts and masks ready for four colors at
+ * once. Right shifts are left shifts by negative counts.
+ */
+struct LaneMapping {
+	struct Part {
+		int32x4_t shift;
+		uint32x4_t mask;
+	} parts[8];
+	uint numParts;
+	uint32x4_t constant;
+
+	LaneMapping(const FormatMapping &mapping) : numParts(mapping.numParts) {
+		for (uint i = 0; i < numParts; i++) {
+			parts[i].shift = vdupq_n_s32((int32)mapping.parts[i].left - (int32)mapping.parts[i].right);
+			parts[i].mask = vdupq_n_u32(mapping.parts[i].mask);
+		}
+		constant = vdupq_n_u32(mapping.constant);
+	}
+
+	inline Colors map(Colors colors) const {
+		Colors result = constant;
+		for (uint i = 0; i < numParts; i++)
+			result = vorrq_u32(result, vandq_u32(vshlq_u32(colors, parts[i].shift), parts[i].mask));
+		return result;
+	}
+};
+
+inline Colors loadColors(const uint16 *src) {
+	return vmovl_u16(vld1_u16(src));
+}
+
+inline Colors loadColors(const uint32 *src) {
+	return vld1q_u32(src);
+}
+
+inline void storeColors(uint16 *dst, Colors colors) {
+	vst1_u16(dst, vmovn_u32(colors));
+}
+
+inline void storeColors(uint32 *dst, Colors colors) {
+	vst1q_u32(dst, colors);
+}
+#endif
+
+#pragma mark -
+#endif
+
+/** Converts colors with a FormatMapping known at run time */
+struct MappedConverter {
+	MappedConverter(const FormatMapping &mapping) : _mapping(mapping) {}
+
+	inline uint32 operator()(uint32 color) const {
+		return _mapping.map(color);
+	}
+
+private:
+	const FormatMapping &_mapping;
+};
+
+/** A pixel format known at compile time, for the most common conversions */
+template<typename ColorType, int aBits, int rBits, int gBits, int bBits, int aShift, int rShift, int gShift, int bShift>
+struct StaticFormat {
+	typedef ColorType Color;
+
+	static PixelFormat format() {
+		return PixelFormat(sizeof(Color), rBits, gBits, bBits, aBits, rShift, gShift, bShift, aShift);
+	}
+
+	static inline void colorToARGB(uint32 color, uint &a, uint &r, uint &g, uint &b) {
+		a = aBits ? ColorComponent<aBits>::expand(color >> aShift) : 0xFF;
+		r = ColorComponent<rBits>::expand(color >> rShift);
+		g = ColorComponent<gBits>::expand(color >> gShift);
+		b = ColorComponent<bBits>::expand(color >> bShift);
+	}
+
+	static inline uint32 ARGBToColor(uint a, uint r, uint g, uint b) {
+		return ((a >> (8 - aBits)) << aShift) |
+		       ((r >> (8 - rBits)) << rShift) |
+		       ((g >> (8 - gBits)) << gShift) |
+		       ((b >> (8 - bBits)) << bShift);
+	}
+};
+
+typedef StaticFormat<uint16, 0, 5, 5, 5, 0, 10, 5, 0> FormatRGB555;
+typedef StaticFormat<uint16, 0, 5, 6, 5, 0, 11, 5, 0> FormatRGB565;
+typedef StaticFormat<uint32, 0, 8, 8, 8, 0, 16, 8, 0> FormatXRGB8888;
+typedef StaticFormat<uint32, 8, 8, 8, 8, 24, 16, 8, 0> FormatARGB8888;
+typedef StaticFormat<uint32, 8, 8, 8, 8, 24, 0, 8, 16> FormatABGR8888;
+
+/** Converts colors between two formats known at compile time */
+template<class SrcFormat, class DstFormat>
+struct StaticConverter {
+	inline uint32 operator()(uint32 color) const {
+		uint a, r, g, b;
+		SrcFormat::colorToARGB(color, a, r, g, b);
+		return DstFormat::ARGBToColor(a, r, g, b);
+	}
+};
+
+/**
+ * Blit with a FormatMapping, converting four colors at a time where
+ * possible. The remaining colors are converted with the given converter,
+ * which gives the same results as the mapping.
+ */
+template<typename SrcColor, typename DstColor, class Converter>
+void crossBlitMapped(byte *dst, const byte *src, const uint w, const uint h,
+                     const FormatMapping &mapping, const Converter &convert,
+                     const uint srcPitch, const uint dstPitch) {
+#ifdef CONVERSION_SIMD
+	const LaneMapping lanes(mapping);
+#endif
+
+	if (sizeof(DstColor) > sizeof(SrcColor)) {
+		// Blit from bottom right to top left, see crossBlit()
+		for (uint y = h; y > 0; --y) {
+			DstColor *dstRow = (DstColor *)(dst + (y - 1) * dstPitch);
+			const SrcColor *srcRow = (const SrcColor *)(src + (y - 1) * srcPitch);
+
+			uint x = w;
+#ifdef CONVERSION_SIMD
+			for (; x >= 4; x -= 4)
+				storeColors(dstRow + x - 4, lanes.map(loadColors(srcRow + x - 4)));
+#endif
+			for (; x > 0; --x)
+				dstRow[x - 1] = convert(srcRow[x - 1]);
+		}
+	} else {
+		for (uint y = 0; y < h; ++y) {
+			DstColor *dstRow = (DstColor *)(dst + y * dstPitch);
+			const SrcColor *srcRow = (const SrcColor *)(src + y * srcPitch);
+
+			uint x = 0;
+#ifdef CONVERSION_SIMD
+			for (; x + 4 <= w; x += 4)
+				storeColors(dstRow + x, lanes.map(loadColors(srcRow + x)));
+#endif
+			for (; x < w; ++x)
+				dstRow[x] = convert(srcRow[x]);
+		}
+	}
+}
+
+/**
+ * Blit with a StaticConverter if the formats match.
+ * @return true if the formats match
+ */
+template<class SrcFormat, class DstFormat>
+bool crossBlitStatic(byte *dst, const byte *src, const uint w, const uint h,
+                     const PixelFormat &srcFmt, const PixelFormat &dstFmt, const FormatMapping &mapping,
+                     const uint srcPitch, const uint dstPitch) {
+	if (srcFmt != SrcFormat::format() || dstFmt != DstFormat::format())
+		return false;
+
+	crossBlitMapped<typename SrcFormat::Color, typename DstFormat::Color>(dst, src, w, h, mapping, StaticConverter<SrcFormat, DstFormat>(), srcPitch, dstPitch);
+	return true;
+}
+
 template<typename SrcColor, typename DstColor, bool backward>
 inline void crossBlitLogic(byte *dst, const byte *src, const uint w, const uint h,
                            const PixelFormat &srcFmt, const PixelFormat &dstFmt,
@@ -126,6 +426,34 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	// Most conversions can be done with precomputed shifts. The most common
+	// ones have specialised versions for the colors which are not converted
+	// several at a time.
+	FormatMapping mapping;
+	if (srcFmt.bytesPerPixel != 3 && mapping.create(srcFmt, dstFmt)) {
+		if (crossBlitStatic<FormatRGB565, FormatXRGB8888>(dst, src, w, h, srcFmt, dstFmt, mapping, srcPitch, dstPitch)
+		 || crossBlitStatic<FormatXRGB8888, FormatRGB565>(dst, src, w, h, srcFmt, dstFmt, mapping, srcPitch, dstPitch)
+		 || crossBlitStatic<FormatARGB8888, FormatABGR8888>(dst, src, w, h, srcFmt, dstFmt, mapping, srcPitch, dstPitch)
+		 || crossBlitStatic<FormatABGR8888, FormatARGB8888>(dst, src, w, h, srcFmt, dstFmt, mapping, srcPitch, dstPitch)
+		 || crossBlitStatic<FormatRGB555, FormatRGB565>(dst, src, w, h, srcFmt, dstFmt, mapping, srcPitch, dstPitch))
+			return true;
+
+		const MappedConverter convert(mapping);
+		if (dstFmt.bytesPerPixel == 2) {
+			if (srcFmt.bytesPerPixel == 2)
+				crossBlitMapped<uint16, uint16>(dst, src, w, h, mapping, convert, srcPitch, dstPitch);
+			else
+				crossBlitMapped<uint32, uint16>(dst, src, w, h, mapping, convert, srcPitch, dstPitch);
+			return true;
+		} else if (dstFmt.bytesPerPixel == 4) {
+			if (srcFmt.bytesPerPixel == 2)
+				crossBlitMapped<uint16, uint32>(dst, src, w, h, mapping, convert, srcPitch, dstPitch);
+			else
+				crossBlitMapped<uint32, uint32>(dst, src, w, h, mapping, convert, srcPitch, dstPitch);
+			return true;
+		}
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -167,4 +495,38 @@ bool crossBlit(byte *dst, const byte *src,
 	return true;
 }
 
+bool crossBlitMap(byte *dst, const byte *src,
+                  const uint dstPitch, const uint srcPitch,
+                  const uint w, const uint h,
+                  const uint bytesPerPixel, const uint32 *map) {
+	if (bytesPerPixel < 2 || bytesPerPixel > 4)
+		return false;
+
+	// Blit from bottom right to top left, so that this works in place
+	for (uint y = h; y > 0; --y) {
+		const byte *srcRow = src + (y - 1) * srcPitch;
+		byte *dstRow = dst + (y - 1) * dstPitch;
+
+		if (bytesPerPixel == 2) {
+			for (uint x = w; x > 0; --x)
+				((uint16 *)dstRow)[x - 1] = map[srcRow[x - 1]];
+		} else if (bytesPerPixel == 3) {
+			for (uint x = w; x > 0; --x)
+				WRITE_UINT24(dstRow + (x - 1) * 3, map[srcRow[x - 1]]);
+		} else {
+			for (uint x = w; x > 0; --x)
+				((uint32 *)dstRow)[x - 1] = map[srcRow[x - 1]];
+		}
+	}
+
+	return true;
+}
+
+void convertPaletteToMap(uint32 *dst, const byte *palette, const uint colors, const Graphics::PixelFormat &format) {
+	for (uint i = 0; i < colors; i++) {
+		dst[i] = format.RGBToColor(palette[0], palette[1], palette[2]);
+		palette += 3;
+	}
+}
+
 } // End of namespace Graphics
@@ -72,6 +72,40 @@ bool crossBlit(byte *dst, const byte *src,
                const uint w, const uint h,
                const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt);
 
+/**
+ * Blits a rectangle from a paletted (CLUT8) format to a high color format,
+ * looking up the color of each pixel in a map.
+ *
+ * @param dst			the buffer which will recieve the converted graphics data
+ * @param src			the buffer containing the original graphics data
+ * @param dstPitch		width in bytes of one full line of the dest buffer
+ * @param srcPitch		width in bytes of one full line of the source buffer
+ * @param w				the width of the graphics data
+ * @param h				the height of the graphics data
+ * @param bytesPerPixel	the number of bytes per pixel of the destination
+ * @param map			the 256 colors of the palette in the destination format
+ * @return				true if conversion completes successfully,
+ *						false if there is an error.
+ *
+ * @note This can convert a surface in place, as long as the dstPitch is
+ *       at least srcPitch * bytesPerPixel.
+ * @see convertPaletteToMap
+ */
+bool crossBlitMap(byte *dst, const byte *src,
+                  const uint dstPitch, const uint srcPitch,
+                  const uint w, const uint h,
+                  const uint bytesPerPixel, const uint32 *map);
+
+/**
+ * Convert the colors of a palette to a pixel format, for crossBlitMap().
+ *
+ * @param dst		the buffer which will receive the colors
+ * @param palette	the palette, with three bytes per color (RGB)
+ * @param colors	the number of colors to convert
+ * @param format	the pixel format of the colors
+ */
+void convertPaletteToMap(uint32 *dst, const byte *palette, const uint colors, const Graphics::PixelFormat &format);
+
 } // End of namespace Graphics
 
 #endif // GRAPHICS_CONVERSION_H
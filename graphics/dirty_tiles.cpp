@@ -0,0 +1,162 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirty_tiles.h"
+
+#include "common/util.h"
+
+namespace Graphics {
+
+DirtyTiles::DirtyTiles() : _width(0), _height(0), _tilesW(0), _tilesH(0) {
+}
+
+DirtyTiles::DirtyTiles(int width, int height) : _width(0), _height(0), _tilesW(0), _tilesH(0) {
+	resize(width, height);
+}
+
+void DirtyTiles::resize(int width, int height) {
+	if (width == _width && height == _height)
+		return;
+
+	Common::Array<Common::Rect> rects;
+	getRects(rects);
+
+	_width = width;
+	_height = height;
+	_tilesW = (width + kTileSize - 1) / kTileSize;
+	_tilesH = (height + kTileSize - 1) / kTileSize;
+
+	const Tile empty = { 0, 0, 0, 0 };
+	_tiles.resize(_tilesW * _tilesH);
+	for (uint i = 0; i < _tiles.size(); i++)
+		_tiles[i] = empty;
+	_dirtyTiles = Common::Rect();
+
+	for (uint i = 0; i < rects.size(); i++)
+		addRect(rects[i]);
+}
+
+void DirtyTiles::addRect(const Common::Rect &r) {
+	Common::Rect bounds(r);
+	bounds.clip(Common::Rect(_width, _height));
+	if (bounds.isEmpty())
+		return;
+
+	const int tileLeft = bounds.left / kTileSize;
+	const int tileTop = bounds.top / kTileSize;
+	const int tileRight = (bounds.right - 1) / kTileSize + 1;
+	const int tileBottom = (bounds.bottom - 1) / kTileSize + 1;
+
+	for (int ty = tileTop; ty < tileBottom; ty++) {
+		const int top = MAX(bounds.top - ty * kTileSize, 0);
+		const int bottom = MIN(bounds.bottom - ty * kTileSize, (int)kTileSize);
+
+		for (int tx = tileLeft; tx < tileRight; tx++) {
+			const int left = MAX(bounds.left - tx * kTileSize, 0);
+			const int right = MIN(bounds.right - tx * kTileSize, (int)kTileSize);
+
+			Tile &tile = tileAt(tx, ty);
+			if (tile.isEmpty()) {
+				tile.left = left;
+				tile.top = top;
+				tile.right = right;
+				tile.bottom = bottom;
+			} else {
+				tile.left = MIN<int>(tile.left, left);
+				tile.top = MIN<int>(tile.top, top);
+				tile.right = MAX<int>(tile.right, right);
+				tile.bottom = MAX<int>(tile.bottom, bottom);
+			}
+		}
+	}
+
+	const Common::Rect tiles(tileLeft, tileTop, tileRight, tileBottom);
+	if (_dirtyTiles.isEmpty())
+		_dirtyTiles = tiles;
+	else
+		_dirtyTiles.extend(tiles);
+}
+
+void DirtyTiles::addAll() {
+	addRect(Common::Rect(_width, _height));
+}
+
+void DirtyTiles::clear() {
+	const Tile empty = { 0, 0, 0, 0 };
+	for (int ty = _dirtyTiles.top; ty < _dirtyTiles.bottom; ty++)
+		for (int tx = _dirtyTiles.left; tx < _dirtyTiles.right; tx++)
+			tileAt(tx, ty) = empty;
+
+	_dirtyTiles = Common::Rect();
+}
+
+void DirtyTiles::getRects(Common::Array<Common::Rect> &rects) const {
+	// The rectangles ending at the bottom of the previous row of tiles,
+	// which may still grow downwards, and those of the current row. Both
+	// are sorted from left to right.
+	Common::Array<Common::Rect> rows[2];
+	int previous = 0;
+
+	for (int ty = _dirtyTiles.top; ty < _dirtyTiles.bottom; ty++) {
+		const Common::Array<Common::Rect> &above = rows[previous];
+		Common::Array<Common::Rect> &current = rows[1 - previous];
+		current.resize(0);
+
+		const int y = ty * kTileSize;
+		uint next = 0;
+		int tx = _dirtyTiles.left;
+		while (tx < _dirtyTiles.right) {
+			const Tile &tile = tileAt(tx, ty);
+			if (tile.isEmpty()) {
+				tx++;
+				continue;
+			}
+
+			// Merge the tiles to the right, as long as they line up
+			Common::Rect run(tx * kTileSize + tile.left, y + tile.top, tx * kTileSize + tile.right, y + tile.bottom);
+			for (tx++; tx < _dirtyTiles.right && run.right == tx * kTileSize; tx++) {
+				const Tile &nextTile = tileAt(tx, ty);
+				if (nextTile.isEmpty() || nextTile.left != 0 || y + nextTile.top != run.top || y + nextTile.bottom != run.bottom)
+					break;
+				run.right = tx * kTileSize + nextTile.right;
+			}
+
+			// Merge with the rectangle above, if it has the same width
+			while (next < above.size() && above[next].left < run.left)
+				rects.push_back(above[next++]);
+			if (next < above.size() && above[next].left == run.left && above[next].right == run.right && above[next].bottom == run.top)
+				run.top = above[next++].top;
+
+			current.push_back(run);
+		}
+
+		while (next < above.size())
+			rects.push_back(above[next++]);
+
+		previous = 1 - previous;
+	}
+
+	for (uint i = 0; i < rows[previous].size(); i++)
+		rects.push_back(rows[previous][i]);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_TILES_H
+#define GRAPHICS_DIRTY_TILES_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * Keeps track of the areas of a surface which need to be updated.
+ *
+ * The surface is split into a grid of tiles, each one with the bounding box
+ * of its dirty pixels. Adding a rectangle only updates the tiles it covers,
+ * no matter how many rectangles were added before, and the dirty areas come
+ * out as the bounding boxes of the tiles, merged horizontally and then
+ * vertically wherever they line up. This keeps both the number of
+ * rectangles and the area drawn needlessly small.
+ */
+class DirtyTiles {
+public:
+	enum {
+		kTileSize = 32
+	};
+
+	DirtyTiles();
+	DirtyTiles(int width, int height);
+
+	/**
+	 * Set the size of the tracked area. Dirty areas outside of it are
+	 * forgotten.
+	 */
+	void resize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+	/**
+	 * Mark an area as dirty. It is clipped to the tracked area.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Mark the whole tracked area as dirty.
+	 */
+	void addAll();
+
+	/**
+	 * Mark everything as clean.
+	 */
+	void clear();
+
+	/**
+	 * Returns true if no area is dirty.
+	 */
+	bool isEmpty() const { return _dirtyTiles.isEmpty(); }
+
+	/**
+	 * Append a list of disjoint rectangles covering all dirty areas.
+	 */
+	void getRects(Common::Array<Common::Rect> &rects) const;
+
+private:
+	/** The bounding box of the dirty pixels of a tile, relative to the tile */
+	struct Tile {
+		byte left, top, right, bottom;
+
+		bool isEmpty() const { return right == 0; }
+	};
+
+	Common::Array<Tile> _tiles;
+	int _width, _height;
+	int _tilesW, _tilesH;
+
+	/** The tiles which may be dirty, in tile coordinates */
+	Common::Rect _dirtyTiles;
+
+	Tile &tileAt(int x, int y) { return _tiles[y * _tilesW + x]; }
+	const Tile &tileAt(int x, int y) const { return _tiles[y * _tilesW + x]; }
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -144,6 +144,19 @@ public:
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const = 0;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Prepare all the characters of a text for drawing.
+	 *
+	 * Fonts which render their characters on demand, like TTF fonts, render
+	 * the missing ones in one go. Calling this when a new text is known, e.g.
+	 * a new subtitle, avoids doing it bit by bit while the text is measured
+	 * and drawn. This is never required, the default implementation does
+	 * nothing.
+	 *
+	 * @param text The text which is going to be drawn.
+	 */
+	virtual void cacheText(const Common::U32String &text) const {}
+
 	// TODO: Add doxygen comments to this
 	void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = true) const;
 	void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0) const;
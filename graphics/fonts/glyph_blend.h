@@ -0,0 +1,212 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_FONTS_GLYPH_BLEND_H
+#define GRAPHICS_FONTS_GLYPH_BLEND_H
+
+#include "graphics/pixelformat.h"
+
+#include "common/simd.h"
+
+namespace Graphics {
+
+/**
+ * Blend a color into the pixels of a surface, weighted by the 8-bit coverage
+ * values of an anti-aliased glyph image.
+ */
+template<typename ColorType>
+inline void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
+	uint8 sR, sG, sB;
+	dstFormat.colorToRGB(color, sR, sG, sB);
+
+	for (int y = 0; y < h; ++y) {
+		ColorType *rDst = (ColorType *)dstPos;
+		const uint8 *src = srcPos;
+
+		for (int x = 0; x < w; ++x) {
+			if (*src == 255) {
+				*rDst = color;
+			} else if (*src) {
+				const uint8 a = *src;
+
+				uint8 dR, dG, dB;
+				dstFormat.colorToRGB(*rDst, dR, dG, dB);
+
+				dR = ((255 - a) * dR + a * sR) / 255;
+				dG = ((255 - a) * dG + a * sG) / 255;
+				dB = ((255 - a) * dB + a * sB) / 255;
+
+				*rDst = dstFormat.RGBToColor(dR, dG, dB);
+			}
+
+			++rDst;
+			++src;
+		}
+
+		dstPos += dstPitch;
+		srcPos += srcPitch;
+	}
+}
+
+#if defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define GLYPH_BLEND_SIMD
+
+/**
+ * Blends a color into the pixels of a 32bpp format with 8 bits per color
+ * component, four pixels at a time. The results are the same as the ones of
+ * renderGlyph().
+ */
+class CoverageBlender {
+public:
+	CoverageBlender(uint32 color, const PixelFormat &format) {
+		const uint32 rgbMask = (0xFFu << format.rShift) | (0xFFu << format.gShift) | (0xFFu << format.bShift);
+		const uint32 alpha = (0xFF >> format.aLoss) << format.aShift;
+
+#ifdef SCUMMVM_SSE2
+		_color = _mm_set1_epi32(color);
+		_color16 = _mm_unpacklo_epi8(_color, _mm_setzero_si128());
+		_rgbMask = _mm_set1_epi32(rgbMask);
+		_alpha = _mm_set1_epi32(alpha);
+#else
+		_color = vreinterpretq_u8_u32(vdupq_n_u32(color));
+		_rgbMask = vreinterpretq_u8_u32(vdupq_n_u32(rgbMask));
+		_alpha = vreinterpretq_u8_u32(vdupq_n_u32(alpha));
+#endif
+	}
+
+	/** Whether the pixels of the given format can be blended */
+	static bool supports(const PixelFormat &format) {
+		return format.bytesPerPixel == 4 && !format.rLoss && !format.gLoss && !format.bLoss &&
+		       !(format.rShift % 8) && !(format.gShift % 8) && !(format.bShift % 8) &&
+		       (format.aLoss == 8 || (!format.aLoss && !(format.aShift % 8)));
+	}
+
+	void blend4(uint32 *dst, const uint8 *coverage) const {
+		uint32 covered;
+		memcpy(&covered, coverage, sizeof(covered));
+
+		// Most pixels of a glyph are either empty or fully covered
+		if (!covered)
+			return;
+
+#ifdef SCUMMVM_SSE2
+		if (covered == 0xFFFFFFFF) {
+			_mm_storeu_si128((__m128i *)dst, _color);
+			return;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+
+		// Repeat the coverage of each pixel for its four components
+		__m128i a = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)covered), zero);
+		a = _mm_unpacklo_epi16(a, a);
+		const __m128i aLo = _mm_unpacklo_epi32(a, a);
+		const __m128i aHi = _mm_unpackhi_epi32(a, a);
+
+		const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+		const __m128i max = _mm_set1_epi16(255);
+		const __m128i one = _mm_set1_epi16(1);
+
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(max, aLo)), _mm_mullo_epi16(_color16, aLo));
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(max, aHi)), _mm_mullo_epi16(_color16, aHi));
+
+		// Exact division by 255, for values up to 255 * 255
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), one), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), one), 8);
+
+		__m128i result = _mm_packus_epi16(lo, hi);
+		result = _mm_or_si128(_mm_and_si128(result, _rgbMask), _alpha);
+
+		// Fully covered pixels get the color as is, empty ones are kept
+		const __m128i a8 = _mm_packus_epi16(aLo, aHi);
+		const __m128i full = _mm_cmpeq_epi8(a8, _mm_set1_epi8((char)0xFF));
+		const __m128i none = _mm_cmpeq_epi8(a8, zero);
+		result = _mm_or_si128(_mm_and_si128(full, _color), _mm_andnot_si128(full, result));
+		result = _mm_or_si128(_mm_and_si128(none, d), _mm_andnot_si128(none, result));
+
+		_mm_storeu_si128((__m128i *)dst, result);
+#else
+		if (covered == 0xFFFFFFFF) {
+			vst1q_u32(dst, vreinterpretq_u32_u8(_color));
+			return;
+		}
+
+		// Repeat the coverage of each pixel for its four components
+		const uint8x8_t coverage8 = vreinterpret_u8_u32(vdup_n_u32(covered));
+		const uint8x16_t a = vcombine_u8(vtbl1_u8(coverage8, vcreate_u8(0x0101010100000000ULL)),
+		                                 vtbl1_u8(coverage8, vcreate_u8(0x0303030302020202ULL)));
+		const uint8x16_t inv = vmvnq_u8(a);
+
+		const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+
+		uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(d), vget_low_u8(inv)), vget_low_u8(_color), vget_low_u8(a));
+		uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(d), vget_high_u8(inv)), vget_high_u8(_color), vget_high_u8(a));
+
+		// Exact division by 255, for values up to 255 * 255
+		lo = vaddq_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), vdupq_n_u16(1));
+		hi = vaddq_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), vdupq_n_u16(1));
+
+		uint8x16_t result = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+		result = vorrq_u8(vandq_u8(result, _rgbMask), _alpha);
+
+		// Fully covered pixels get the color as is, empty ones are kept
+		result = vbslq_u8(vceqq_u8(a, vdupq_n_u8(255)), _color, result);
+		result = vbslq_u8(vceqq_u8(a, vdupq_n_u8(0)), d, result);
+
+		vst1q_u32(dst, vreinterpretq_u32_u8(result));
+#endif
+	}
+
+private:
+#ifdef SCUMMVM_SSE2
+	__m128i _color, _color16, _rgbMask, _alpha;
+#else
+	uint8x16_t _color, _rgbMask, _alpha;
+#endif
+};
+
+/**
+ * Same as renderGlyph<uint32>(), for the formats supported by CoverageBlender.
+ */
+inline void renderGlyphSIMD(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, uint32 color, const PixelFormat &dstFormat) {
+	const CoverageBlender blender(color, dstFormat);
+
+	for (int y = 0; y < h; ++y) {
+		uint32 *rDst = (uint32 *)dstPos;
+		int x = 0;
+
+		for (; x + 4 <= w; x += 4)
+			blender.blend4(rDst + x, srcPos + x);
+
+		// The remaining pixels are blended like renderGlyph() does
+		if (x < w)
+			renderGlyph<uint32>((uint8 *)(rDst + x), dstPitch, srcPos + x, srcPitch, w - x, 1, color, dstFormat);
+
+		dstPos += dstPitch;
+		srcPos += srcPitch;
+	}
+}
+#endif
+
+} // End of namespace Graphics
+
+#endif
@@ -28,6 +28,7 @@
 #ifdef USE_FREETYPE2
 
 #include "graphics/fonts/ttf.h"
+#include "graphics/fonts/glyph_blend.h"
 #include "graphics/font.h"
 #include "graphics/surface.h"
 
@@ -37,7 +38,10 @@
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/md5.h"
 #include "common/ptr.h"
+#include "common/simd.h"
 #include "common/unzip.h"
 
 #include <ft2build.h>
@@ -60,6 +64,152 @@ inline int divRoundToNearest(int dividend, int divisor) {
 
 } // End of anonymous namespace
 
+/**
+ * The glyphs of a face rendered at a given size. The glyph images are packed
+ * into a few large atlas pages instead of being allocated one by one.
+ *
+ * Fonts loaded from the same file with the same parameters share their cache
+ * through TTFLibrary, so every glyph is only rendered once.
+ */
+class TTFGlyphCache {
+public:
+	struct Glyph {
+		Surface image; ///< Area of an atlas page
+		int xOffset, yOffset;
+		int advance;
+		FT_UInt slot;
+	};
+
+	TTFGlyphCache(const Common::String &key);
+	~TTFGlyphCache();
+
+	const Common::String &getKey() const { return _key; }
+
+	bool contains(uint32 chr) const { return _glyphs.contains(chr); }
+	uint size() const { return _glyphs.size(); }
+
+	const Glyph *getGlyph(uint32 chr) const {
+		GlyphMap::const_iterator glyphEntry = _glyphs.find(chr);
+		return glyphEntry != _glyphs.end() ? &glyphEntry->_value : 0;
+	}
+
+	/**
+	 * Adds a glyph, copying the bitmap rendered by FreeType into the atlas.
+	 *
+	 * @return false if the format of the bitmap is not supported.
+	 */
+	bool addGlyph(uint32 chr, const Glyph &glyph, const FT_Bitmap &bitmap);
+
+	int _refCount;
+
+private:
+	enum {
+		kPageSize = 256
+	};
+
+	Surface allocateImage(int w, int h);
+
+	Common::String _key;
+
+	Common::Array<Surface *> _pages;
+	int _pageX, _pageY, _rowHeight;
+
+	typedef Common::HashMap<uint32, Glyph> GlyphMap;
+	GlyphMap _glyphs;
+};
+
+TTFGlyphCache::TTFGlyphCache(const Common::String &key)
+    : _refCount(1), _key(key), _pageX(0), _pageY(0), _rowHeight(0) {
+}
+
+TTFGlyphCache::~TTFGlyphCache() {
+	for (uint i = 0; i < _pages.size(); ++i) {
+		_pages[i]->free();
+		delete _pages[i];
+	}
+}
+
+Surface TTFGlyphCache::allocateImage(int w, int h) {
+	Surface image;
+	if (!w || !h) {
+		image.init(w, h, 0, 0, PixelFormat::createFormatCLUT8());
+		return image;
+	}
+
+	// Big glyphs get a page of their own
+	if (w > kPageSize || h > kPageSize) {
+		Surface *page = new Surface();
+		page->create(w, h, PixelFormat::createFormatCLUT8());
+		_pages.insert_at(0, page);
+		return *page;
+	}
+
+	// Fill the last page row by row
+	if (_pageX + w > kPageSize) {
+		_pageX = 0;
+		_pageY += _rowHeight;
+		_rowHeight = 0;
+	}
+
+	if (_pages.empty() || _pages.back()->w != kPageSize || _pages.back()->h != kPageSize || _pageY + h > kPageSize) {
+		Surface *page = new Surface();
+		page->create(kPageSize, kPageSize, PixelFormat::createFormatCLUT8());
+		_pages.push_back(page);
+		_pageX = _pageY = _rowHeight = 0;
+	}
+
+	image = _pages.back()->getSubArea(Common::Rect(_pageX, _pageY, _pageX + w, _pageY + h));
+	_pageX += w;
+	_rowHeight = MAX(_rowHeight, h);
+	return image;
+}
+
+bool TTFGlyphCache::addGlyph(uint32 chr, const Glyph &glyph, const FT_Bitmap &bitmap) {
+	if (bitmap.pixel_mode != FT_PIXEL_MODE_MONO && bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFGlyphCache::addGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
+		return false;
+	}
+
+	Glyph &newGlyph = _glyphs[chr];
+	newGlyph = glyph;
+	newGlyph.image = allocateImage(bitmap.width, bitmap.rows);
+
+	const uint8 *src = bitmap.buffer;
+	int srcPitch = bitmap.pitch;
+	if (srcPitch < 0) {
+		src += (bitmap.rows - 1) * srcPitch;
+		srcPitch = -srcPitch;
+	}
+
+	uint8 *dst = (uint8 *)newGlyph.image.getPixels();
+
+	if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+		for (int y = 0; y < (int)bitmap.rows; ++y) {
+			const uint8 *curSrc = src;
+			uint8 mask = 0;
+
+			for (int x = 0; x < (int)bitmap.width; ++x) {
+				if ((x % 8) == 0)
+					mask = *curSrc++;
+
+				dst[x] = (mask & 0x80) ? 255 : 0;
+				mask <<= 1;
+			}
+
+			dst += newGlyph.image.pitch;
+			src += srcPitch;
+		}
+	} else {
+		for (int y = 0; y < (int)bitmap.rows; ++y) {
+			memcpy(dst, src, bitmap.width);
+			dst += newGlyph.image.pitch;
+			src += srcPitch;
+		}
+	}
+
+	return true;
+}
+
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
 public:
 	TTFLibrary();
@@ -72,9 +222,20 @@ public:
 
 	bool loadFont(const uint8 *file, const uint32 size, FT_Face &face);
 	void closeFont(FT_Face &face);
+
+	/**
+	 * Returns the glyph cache shared by all the fonts with the given key,
+	 * creating it if needed. An empty key gives a new cache which is not
+	 * shared. Every call needs a matching releaseGlyphCache().
+	 */
+	TTFGlyphCache *getGlyphCache(const Common::String &key);
+	void releaseGlyphCache(TTFGlyphCache *cache);
 private:
 	FT_Library _library;
 	bool _initialized;
+
+	typedef Common::HashMap<Common::String, TTFGlyphCache *> GlyphCacheMap;
+	GlyphCacheMap _glyphCaches;
 };
 
 void shutdownTTF() {
@@ -107,6 +268,30 @@ void TTFLibrary::closeFont(FT_Face &face) {
 	FT_Done_Face(face);
 }
 
+TTFGlyphCache *TTFLibrary::getGlyphCache(const Common::String &key) {
+	if (key.empty())
+		return new TTFGlyphCache(key);
+
+	GlyphCacheMap::iterator i = _glyphCaches.find(key);
+	if (i != _glyphCaches.end()) {
+		i->_value->_refCount++;
+		return i->_value;
+	}
+
+	TTFGlyphCache *cache = new TTFGlyphCache(key);
+	_glyphCaches[key] = cache;
+	return cache;
+}
+
+void TTFLibrary::releaseGlyphCache(TTFGlyphCache *cache) {
+	if (--cache->_refCount)
+		return;
+
+	if (!cache->getKey().empty())
+		_glyphCaches.erase(cache->getKey());
+	delete cache;
+}
+
 class TTFFont : public Font {
 public:
 	TTFFont();
@@ -125,6 +310,8 @@ public:
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
+
+	virtual void cacheText(const Common::U32String &text) const;
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -135,18 +322,12 @@ private:
 	int _width, _height;
 	int _ascent, _descent;
 
-	struct Glyph {
-		Surface image;
-		int xOffset, yOffset;
-		int advance;
-		FT_UInt slot;
-	};
+	typedef TTFGlyphCache::Glyph Glyph;
 
-	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
-	typedef Common::HashMap<uint32, Glyph> GlyphCache;
-	mutable GlyphCache _glyphs;
+	bool cacheGlyph(uint32 chr, uint32 code) const;
+	TTFGlyphCache *_glyphs;
 	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+	const Glyph *getGlyph(uint32 chr) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -161,20 +342,22 @@ private:
 
 TTFFont::TTFFont()
     : _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
-      _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-      _hasKerning(false), _allowLateCaching(false) {
+      _descent(0), _glyphs(0), _allowLateCaching(false), _loadFlags(FT_LOAD_TARGET_NORMAL),
+      _renderMode(FT_RENDER_MODE_NORMAL), _hasKerning(false) {
 }
 
 TTFFont::~TTFFont() {
+	if (_glyphs) {
+		g_ttf.releaseGlyphCache(_glyphs);
+		_glyphs = 0;
+	}
+
 	if (_initialized) {
 		g_ttf.closeFont(_face);
 
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
 }
@@ -217,7 +400,8 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode siz
 	// Check whether we have kerning support
 	_hasKerning = (FT_HAS_KERNING(_face) != 0);
 
-	if (FT_Set_Char_Size(_face, 0, computePointSize(size, sizeMode) * 64, dpi, dpi)) {
+	const int pointSize = computePointSize(size, sizeMode);
+	if (FT_Set_Char_Size(_face, 0, pointSize * 64, dpi, dpi)) {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
@@ -252,30 +436,38 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode siz
 		// Allow loading of all unicode characters.
 		_allowLateCaching = true;
 
+		// Share the glyphs with the other fonts using the same file and
+		// parameters. Like the game detection, only hash the start of the
+		// file: it holds the table directory with the checksums of all the
+		// tables, and hashing whole fonts on every load would be costly.
+		Common::MemoryReadStream fileStream(_ttfFile, _size);
+		const Common::String key = Common::String::format("%s-%u-%d-%u-%d", Common::computeStreamMD5AsString(fileStream, 5000).c_str(),
+		                                                  _size, pointSize, dpi, (int)renderMode);
+		_glyphs = g_ttf.getGlyphCache(key);
+
 		// Load all ISO-8859-1 characters.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
-			}
+			if (!_glyphs->contains(i))
+				cacheGlyph(i, i);
 		}
 	} else {
 		// We have a fixed map of characters do not load more later.
 		_allowLateCaching = false;
+		_glyphs = g_ttf.getGlyphCache(Common::String());
 
 		for (uint i = 0; i < 256; ++i) {
 			const uint32 unicode = mapping[i] & 0x7FFFFFFF;
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
+			if (!cacheGlyph(i, unicode)) {
 				if (isRequired)
 					return false;
 			}
 		}
 	}
 
-	_initialized = (_glyphs.size() != 0);
+	_initialized = (_glyphs->size() != 0);
 	return _initialized;
 }
 
@@ -408,34 +600,30 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
 	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
+	const Glyph *glyph;
 
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
+	glyph = getGlyph(left);
+	if (glyph) {
+		leftGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
+	glyph = getGlyph(right);
+	if (glyph) {
+		rightGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
@@ -449,63 +637,23 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
+		const int xOffset = glyph->xOffset;
+		const int yOffset = glyph->yOffset;
+		const Graphics::Surface &image = glyph->image;
 		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
 	}
 }
 
-namespace {
-
-template<typename ColorType>
-void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
-	uint8 sR, sG, sB;
-	dstFormat.colorToRGB(color, sR, sG, sB);
-
-	for (int y = 0; y < h; ++y) {
-		ColorType *rDst = (ColorType *)dstPos;
-		const uint8 *src = srcPos;
-
-		for (int x = 0; x < w; ++x) {
-			if (*src == 255) {
-				*rDst = color;
-			} else if (*src) {
-				const uint8 a = *src;
-
-				uint8 dR, dG, dB;
-				dstFormat.colorToRGB(*rDst, dR, dG, dB);
-
-				dR = ((255 - a) * dR + a * sR) / 255;
-				dG = ((255 - a) * dG + a * sG) / 255;
-				dB = ((255 - a) * dB + a * sB) / 255;
-
-				*rDst = dstFormat.RGBToColor(dR, dG, dB);
-			}
-
-			++rDst;
-			++src;
-		}
-
-		dstPos += dstPitch;
-		srcPos += srcPitch;
-	}
-}
-
-} // End of anonymous namespace
-
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyphEntry = getGlyph(chr);
+	if (!glyphEntry)
 		return;
 
-	const Glyph &glyph = glyphEntry->_value;
+	const Glyph &glyph = *glyphEntry;
 
 	x += glyph.xOffset;
 	y += glyph.yOffset;
@@ -568,17 +716,21 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 	} else if (dst->format.bytesPerPixel == 2) {
 		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
 	} else if (dst->format.bytesPerPixel == 4) {
+#ifdef GLYPH_BLEND_SIMD
+		if (CoverageBlender::supports(dst->format)) {
+			renderGlyphSIMD(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+			return;
+		}
+#endif
 		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
 	}
 }
 
-bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
-	FT_UInt slot = FT_Get_Char_Index(_face, chr);
+bool TTFFont::cacheGlyph(uint32 chr, uint32 code) const {
+	FT_UInt slot = FT_Get_Char_Index(_face, code);
 	if (!slot)
 		return false;
 
-	glyph.slot = slot;
-
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
@@ -591,70 +743,33 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	if (_face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
 		return false;
 
+	Glyph glyph;
+	glyph.slot = slot;
 	glyph.xOffset = _face->glyph->bitmap_left;
 	glyph.yOffset = _ascent - _face->glyph->bitmap_top;
-
 	glyph.advance = ftCeil26_6(_face->glyph->advance.x);
 
-	const FT_Bitmap &bitmap = _face->glyph->bitmap;
-	glyph.image.create(bitmap.width, bitmap.rows, PixelFormat::createFormatCLUT8());
-
-	const uint8 *src = bitmap.buffer;
-	int srcPitch = bitmap.pitch;
-	if (srcPitch < 0) {
-		src += (bitmap.rows - 1) * srcPitch;
-		srcPitch = -srcPitch;
-	}
-
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
-
-	switch (bitmap.pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
-		for (int y = 0; y < (int)bitmap.rows; ++y) {
-			const uint8 *curSrc = src;
-			uint8 mask = 0;
-
-			for (int x = 0; x < (int)bitmap.width; ++x) {
-				if ((x % 8) == 0)
-					mask = *curSrc++;
-
-				if (mask & 0x80)
-					*dst = 255;
-
-				mask <<= 1;
-				++dst;
-			}
-
-			src += srcPitch;
-		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
-		for (int y = 0; y < (int)bitmap.rows; ++y) {
-			memcpy(dst, src, bitmap.width);
-			dst += glyph.image.pitch;
-			src += srcPitch;
-		}
-		break;
+	return _glyphs->addGlyph(chr, glyph, _face->glyph->bitmap);
+}
 
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
-		glyph.image.free();
-		return false;
-	}
+const TTFFont::Glyph *TTFFont::getGlyph(uint32 chr) const {
+	const Glyph *glyph = _glyphs->getGlyph(chr);
+	if (!glyph && chr && _allowLateCaching && cacheGlyph(chr, chr))
+		glyph = _glyphs->getGlyph(chr);
 
-	return true;
+	return glyph;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
+void TTFFont::cacheText(const Common::U32String &text) const {
+	if (!_allowLateCaching)
 		return;
-	}
 
-	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
+	// Render all the missing glyphs now rather than one by one while the
+	// text is measured and drawn
+	for (uint i = 0; i < text.size(); ++i) {
+		const uint32 chr = text[i];
+		if (chr && !_glyphs->contains(chr))
+			cacheGlyph(chr, chr);
 	}
 }
 
@@ -238,6 +238,7 @@ void MacText::reallocSurface() {
 
 	if (!_surface) {
 		_surface = new ManagedSurface(_textMaxWidth, _textMaxHeight);
+		addDirtyRect(0, _surface->h);
 
 		return;
 	}
@@ -250,9 +251,19 @@ void MacText::reallocSurface() {
 
 		delete _surface;
 		_surface = n;
+		addDirtyRect(0, _surface->h);
 	}
 }
 
+void MacText::addDirtyRect(int top, int bottom) {
+	Common::Rect r(0, top, _surface->w, MAX(top, bottom));
+
+	if (_dirtyRect.isEmpty())
+		_dirtyRect = r;
+	else
+		_dirtyRect.extend(r);
+}
+
 void MacText::render() {
 	if (_fullRefresh) {
 		render(0, _textLines.size());
@@ -269,6 +280,7 @@ void MacText::render(int from, int to) {
 
 	// Clear the screen
 	_surface->fillRect(Common::Rect(0, _textLines[from].y, _surface->w, _textLines[to].y + getLineHeight(to)), _bgcolor);
+	addDirtyRect(_textLines[from].y, _textLines[to].y + getLineHeight(to));
 
 	for (int i = from; i <= to; i++) {
 		int xOffset = 0;
@@ -339,18 +351,32 @@ void MacText::setInterLinear(int interLinear) {
 	recalcDims();
 }
 
-void MacText::recalcDims() {
+void MacText::recalcDims(int from) {
+	// The lines above the first changed one keep their position and size
+	from = CLIP<int>(from, 0, _textLines.size());
+
 	int y = 0;
+	if (from > 0)
+		y = _textLines[from - 1].y + getLineHeight(from - 1) + _interLinear;
+
+	int oldMaxWidth = _textMaxWidth;
 	_textMaxWidth = 0;
 
-	for (uint i = 0; i < _textLines.size(); i++) {
+	for (int i = 0; i < from; i++)
+		_textMaxWidth = MAX(_textMaxWidth, getLineWidth(i));
+
+	for (uint i = from; i < _textLines.size(); i++) {
 		_textLines[i].y = y;
 
-		y += getLineHeight(i) + _interLinear;
 		_textMaxWidth = MAX(_textMaxWidth, getLineWidth(i, true));
+		y += getLineHeight(i) + _interLinear;
 	}
 
 	_textMaxHeight = y - _interLinear;
+
+	// Lines which are not left aligned move with the width of the text
+	if (_textAlignment != kTextAlignLeft && _textMaxWidth != oldMaxWidth)
+		_fullRefresh = true;
 }
 
 void MacText::draw(ManagedSurface *g, int x, int y, int w, int h, int xoff, int yoff) {
@@ -393,7 +419,7 @@ void MacText::appendText(Common::String str, int fontId, int fontSize, int fontS
 	}
 
 	splitString(str);
-	recalcDims();
+	recalcDims(oldLen - 1);
 
 	render(oldLen - 1, _textLines.size());
 }
@@ -409,7 +435,7 @@ void MacText::appendTextDefault(Common::String str, bool skipAdd) {
 	}
 
 	splitString(str);
-	recalcDims();
+	recalcDims(oldLen - 1);
 
 	render(oldLen - 1, _textLines.size());
 }
@@ -418,8 +444,10 @@ void MacText::clearText() {
 	_textLines.clear();
 	_str.clear();
 
-	if (_surface)
+	if (_surface) {
 		_surface->clear(_bgcolor);
+		addDirtyRect(0, _surface->h);
+	}
 
 	recalcDims();
 }
@@ -433,7 +461,7 @@ void MacText::replaceLastLine(Common::String str) {
 		_textLines.pop_back();
 
 	splitString(str);
-	recalcDims();
+	recalcDims(oldLen);
 
 	render(oldLen, _textLines.size());
 }
@@ -445,6 +473,7 @@ void MacText::removeLastLine() {
 	int h = getLineHeight(_textLines.size() - 1) + _interLinear;
 
 	_surface->fillRect(Common::Rect(0, _textMaxHeight - h, _surface->w, _textMaxHeight), _bgcolor);
+	addDirtyRect(_textMaxHeight - h, _textMaxHeight);
 
 	_textLines.pop_back();
 	_textMaxHeight -= h;
@@ -114,6 +114,13 @@ public:
 	void render();
 	Graphics::ManagedSurface *getSurface() { return _surface; }
 
+	/**
+	 * Area of getSurface() rendered since the last call to clearDirtyRect(),
+	 * for drawing only the lines which changed.
+	 */
+	const Common::Rect &getDirtyRect() { return _dirtyRect; }
+	void clearDirtyRect() { _dirtyRect = Common::Rect(); }
+
 	void getRowCol(int x, int y, int *sx, int *sy, int *row, int *col);
 
 	Common::String getTextChunk(int startRow, int startCol, int endRow, int endCol, bool formatted = false, bool newlines = true);
@@ -121,8 +128,9 @@ public:
 private:
 	void splitString(Common::String &s);
 	void render(int from, int to);
-	void recalcDims();
+	void recalcDims(int from = 0);
 	void reallocSurface();
+	void addDirtyRect(int top, int bottom);
 	int getLineWidth(int line, bool enforce = false);
 
 private:
@@ -140,6 +148,7 @@ private:
 
 	Graphics::ManagedSurface *_surface;
 	bool _fullRefresh;
+	Common::Rect _dirtyRect;
 
 	TextAlign _textAlignment;
 
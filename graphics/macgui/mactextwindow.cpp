@@ -89,12 +89,17 @@ void MacTextWindow::resize(int w, int h) {
 }
 
 void MacTextWindow::appendText(Common::String str, const MacFont *macFont, bool skipAdd) {
-	_mactext->appendText(str, macFont->getId(), macFont->getSize(), macFont->getSlant(), skipAdd);
+	int oldScrollPos = _scrollPos;
 
-	_contentIsDirty = true;
+	_mactext->appendText(str, macFont->getId(), macFont->getSize(), macFont->getSlant(), skipAdd);
 
 	_scrollPos = MAX(0, _mactext->getTextHeight() - getInnerDimensions().height());
 
+	// Unless the text scrolled, only the new lines need to be redrawn, which
+	// draw() finds out from _mactext
+	if (_scrollPos != oldScrollPos)
+		_contentIsDirty = true;
+
 	updateCursorPos();
 }
 
@@ -128,9 +133,14 @@ const MacFont *MacTextWindow::getTextWindowFont() {
 }
 
 bool MacTextWindow::draw(ManagedSurface *g, bool forceRedraw) {
-	if (!_borderIsDirty && !_contentIsDirty && !_cursorDirty && !_inputIsDirty && !forceRedraw)
+	if (!_borderIsDirty && !_contentIsDirty && !_cursorDirty && !_inputIsDirty && _dirtyRect.isEmpty() && !forceRedraw &&
+			_mactext->getDirtyRect().isEmpty())
 		return false;
 
+	// The selection is inverted over whatever is composed, so it can only be
+	// drawn over the whole text
+	bool fullRedraw = _borderIsDirty || _contentIsDirty || forceRedraw || _selectedText.endY != -1;
+
 	if (_borderIsDirty || forceRedraw) {
 		drawBorder();
 
@@ -142,10 +152,50 @@ bool MacTextWindow::draw(ManagedSurface *g, bool forceRedraw) {
 		_inputIsDirty = false;
 	}
 
+	// drawInput() may have scrolled the text
+	fullRedraw = fullRedraw || _contentIsDirty;
 	_contentIsDirty = false;
 
 	// Compose
-	_mactext->draw(&_composeSurface, 0, _scrollPos, _surface.w - 2, _scrollPos + _surface.h - 2, kConWOverlap - 2, kConWOverlap - 2);
+	_mactext->render();
+
+	if (!fullRedraw) {
+		// Only the lines of text which changed, and the cursor where it was
+		// and where it is now. The window surface starts 2 pixels into
+		// _composeSurface.
+		Common::Rect text = _mactext->getDirtyRect();
+		if (!text.isEmpty()) {
+			text.translate(kConWOverlap - 4, kConHOverlap - 4 - _scrollPos);
+			addDirtyRect(text);
+		}
+
+		if (_cursorDirty) {
+			Common::Rect cursor = getCursorArea();
+			cursor.translate(-2, -2);
+			addDirtyRect(cursor);
+			addDirtyRect(_lastCursorArea);
+		}
+	}
+
+	_mactext->clearDirtyRect();
+	_cursorDirty = false;
+
+	Common::Rect area = getComposeArea(fullRedraw);
+
+	if (fullRedraw) {
+		_mactext->draw(&_composeSurface, 0, _scrollPos, _surface.w - 2, _scrollPos + _surface.h - 2, kConWOverlap - 2, kConWOverlap - 2);
+	} else if (!area.isEmpty()) {
+		Common::Rect text(area);
+		text.translate(2 - kConWOverlap, _scrollPos + 2 - kConHOverlap);
+		text.clip(_mactext->getSurface()->getBounds());
+
+		_composeSurface.fillRect(area, _wm->_colorWhite);
+		if (!text.isEmpty())
+			_composeSurface.blitFrom(*_mactext->getSurface(), text, Common::Point(text.left + kConWOverlap - 2, text.top - _scrollPos + kConHOverlap - 2));
+	}
+
+	_lastCursorArea = getCursorArea();
+	_lastCursorArea.translate(-2, -2);
 
 	if (_cursorState)
 		_composeSurface.blitFrom(*_cursorSurface, *_cursorRect, Common::Point(_cursorX + kConWOverlap - 2, _cursorY + kConHOverlap - 2));
@@ -153,13 +203,17 @@ bool MacTextWindow::draw(ManagedSurface *g, bool forceRedraw) {
 	if (_selectedText.endY != -1)
 		drawSelection();
 
-	_composeSurface.transBlitFrom(_borderSurface, kColorGreen);
-
-	g->transBlitFrom(_composeSurface, _composeSurface.getBounds(), Common::Point(_dims.left - 2, _dims.top - 2), kColorGreen2);
+	blitComposeArea(g, area);
 
 	return true;
 }
 
+Common::Rect MacTextWindow::getCursorArea() {
+	Common::Rect area(*_cursorRect);
+	area.translate(_cursorX + kConWOverlap - 2, _cursorY + kConHOverlap - 2);
+	return area;
+}
+
 void MacTextWindow::drawSelection() {
 	if (_selectedText.endY == -1)
 		return;
@@ -456,8 +510,6 @@ void MacTextWindow::drawInput() {
 	_cursorX = _inputText.empty() ? 0 : _fontRef->getStringWidth(text[_inputTextHeight - 1]);
 
 	updateCursorPos();
-
-	_contentIsDirty = true;
 }
 
 void MacTextWindow::clearInput() {
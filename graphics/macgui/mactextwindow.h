@@ -83,6 +83,7 @@ private:
 	void drawInput();
 	void drawSelection();
 	void updateCursorPos();
+	Common::Rect getCursorArea();
 
 	void startMarking(int x, int y);
 	void updateTextSelection(int x, int y);
@@ -103,6 +104,7 @@ private:
 	const Font *_fontRef;
 
 	ManagedSurface *_cursorSurface;
+	Common::Rect _lastCursorArea;
 
 	bool _inTextSelection;
 	SelectedText _selectedText;
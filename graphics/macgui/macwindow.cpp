@@ -40,6 +40,13 @@ BaseMacWindow::BaseMacWindow(int id, bool editable, MacWindowManager *wm) :
 	_type = kWindowUnknown;
 }
 
+void BaseMacWindow::addDirtyRect(const Common::Rect &r) {
+	if (_dirtyRect.isEmpty())
+		_dirtyRect = r;
+	else
+		_dirtyRect.extend(r);
+}
+
 MacWindow::MacWindow(int id, bool scrollable, bool resizable, bool editable, MacWindowManager *wm) :
 		BaseMacWindow(id, editable, wm), _scrollable(scrollable), _resizable(resizable) {
 	_active = false;
@@ -131,23 +138,56 @@ void MacWindow::setBackgroundPattern(int pattern) {
 }
 
 bool MacWindow::draw(ManagedSurface *g, bool forceRedraw) {
-	if (!_borderIsDirty && !_contentIsDirty && !forceRedraw)
+	if (!_borderIsDirty && !_contentIsDirty && _dirtyRect.isEmpty() && !forceRedraw)
 		return false;
 
+	bool fullRedraw = _borderIsDirty || _contentIsDirty || forceRedraw;
+
 	if (_borderIsDirty || forceRedraw)
 		drawBorder();
 
 	_contentIsDirty = false;
 
 	// Compose
-	_composeSurface.blitFrom(_surface, Common::Rect(0, 0, _surface.w - 2, _surface.h - 2), Common::Point(2, 2));
-	_composeSurface.transBlitFrom(_borderSurface, kColorGreen);
+	Common::Rect area = getComposeArea(fullRedraw);
+	Common::Rect content(area.left - 2, area.top - 2, area.right - 2, area.bottom - 2);
+	content.clip(Common::Rect(0, 0, _surface.w - 2, _surface.h - 2));
+
+	if (!content.isEmpty())
+		_composeSurface.blitFrom(_surface, content, Common::Point(content.left + 2, content.top + 2));
 
-	g->transBlitFrom(_composeSurface, _composeSurface.getBounds(), Common::Point(_dims.left - 2, _dims.top - 2), kColorGreen2);
+	blitComposeArea(g, area);
 
 	return true;
 }
 
+Common::Rect MacWindow::getComposeArea(bool fullRedraw) {
+	Common::Rect area = _composeSurface.getBounds();
+
+	// The window surface starts 2 pixels into _composeSurface
+	if (!fullRedraw) {
+		Common::Rect dirty = _dirtyRect;
+		dirty.translate(2, 2);
+		area.clip(dirty);
+	}
+
+	_dirtyRect = Common::Rect();
+
+	return area;
+}
+
+void MacWindow::blitComposeArea(ManagedSurface *g, const Common::Rect &area) {
+	_drawnRect = area;
+	_drawnRect.translate(_dims.left - 2, _dims.top - 2);
+
+	if (area.isEmpty())
+		return;
+
+	_composeSurface.transBlitFrom(_borderSurface, area, Common::Point(area.left, area.top), kColorGreen);
+
+	g->transBlitFrom(_composeSurface, area, Common::Point(_dims.left - 2 + area.left, _dims.top - 2 + area.top), kColorGreen2);
+}
+
 
 #define ARROW_W 12
 #define ARROW_H 6
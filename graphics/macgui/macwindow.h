@@ -121,6 +121,20 @@ public:
 	 */
 	void setDirty(bool dirty) { _contentIsDirty = dirty; }
 
+	/**
+	 * Method for marking only an area of the window for redraw.
+	 * Unlike setDirty(true), the next draw() then only composes this area
+	 * and the WM only copies it to the screen.
+	 * @param r The area to redraw, relative to the window's surface.
+	 */
+	void addDirtyRect(const Common::Rect &r);
+
+	/**
+	 * Accessor method for the area updated by the last draw().
+	 * @return The area relative to the WM's screen.
+	 */
+	const Common::Rect &getDrawnRect() { return _drawnRect; }
+
 	/**
 	 * Method called to draw the window into the target surface.
 	 * This method is most often called by the WM, and relies on
@@ -159,6 +173,9 @@ protected:
 	ManagedSurface _surface;
 	bool _contentIsDirty;
 
+	Common::Rect _dirtyRect;
+	Common::Rect _drawnRect;
+
 	Common::Rect _dims;
 
 	bool (*_callback)(WindowClick, Common::Event &, void *);
@@ -303,6 +320,9 @@ protected:
 	void drawBorder();
 	WindowClick isInBorder(int x, int y);
 
+	Common::Rect getComposeArea(bool fullRedraw);
+	void blitComposeArea(ManagedSurface *g, const Common::Rect &area);
+
 protected:
 	ManagedSurface _borderSurface;
 	ManagedSurface _composeSurface;
@@ -314,17 +314,39 @@ void MacWindowManager::draw() {
 	if (_fullRefresh && !(_mode & kWMModeNoDesktop))
 		drawDesktop();
 
+	// The screen area redrawn so far, which the windows above have to be
+	// redrawn over
+	Common::Rect damage;
+
 	for (Common::List<BaseMacWindow *>::const_iterator it = _windowStack.begin(); it != _windowStack.end(); it++) {
 		BaseMacWindow *w = *it;
+
+		if (!_fullRefresh && !damage.isEmpty()) {
+			const Common::Rect &dims = w->getDimensions();
+			Common::Rect overlap(dims.left - 2, dims.top - 2, dims.right - 2, dims.bottom - 2);
+			overlap = overlap.findIntersectingRect(damage);
+
+			if (!overlap.isEmpty()) {
+				overlap.translate(-dims.left, -dims.top);
+				w->addDirtyRect(overlap);
+			}
+		}
+
 		if (w->draw(_screen, _fullRefresh)) {
 			w->setDirty(false);
 
-			Common::Rect clip(w->getDimensions().left - 2, w->getDimensions().top - 2, w->getDimensions().right - 2, w->getDimensions().bottom - 2);
+			Common::Rect clip = w->getDrawnRect();
 			clip.clip(_screen->getBounds());
 			clip.clip(Common::Rect(0, 0, g_system->getWidth() - 1, g_system->getHeight() - 1));
 
-			if (!clip.isEmpty())
+			if (!clip.isEmpty()) {
 				g_system->copyRectToScreen(_screen->getBasePtr(clip.left, clip.top), _screen->pitch, clip.left, clip.top, clip.width(), clip.height());
+
+				if (damage.isEmpty())
+					damage = clip;
+				else
+					damage.extend(clip);
+			}
 		}
 	}
 
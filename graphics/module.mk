@@ -3,6 +3,7 @@ MODULE := graphics
 MODULE_OBJS := \
 	conversion.o \
 	cursorman.o \
+	dirty_tiles.o \
 	font.o \
 	fontman.o \
 	fonts/bdf.o \
@@ -32,6 +33,7 @@ MODULE_OBJS := \
 	surface.o \
 	transform_struct.o \
 	transform_tools.o \
+	transformed_surface_cache.o \
 	transparent_surface.o \
 	thumbnail.o \
 	VectorRenderer.o \
@@ -20,11 +20,14 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
+#include "common/simd.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 
 int gBitFormat = 565;
 
@@ -117,6 +120,76 @@ void InitLUT(Graphics::PixelFormat format) {
 	hqx_green_redBlue_Mask = (hqx_greenMask << 16) | hqx_redBlueMask;
 #endif
 }
+
+#ifdef HQ_PATTERNS_SIMD
+void computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int count, uint8 *patterns) {
+	assert(count <= kHQPatternChunk);
+
+	// The YUV values of the three rows, including the pixels on both sides
+	uint32 yuvRows[3][kHQPatternChunk + 2];
+	for (int y = 0; y < 3; ++y) {
+		const uint16 *src = p + (y - 1) * (int)nextlineSrc - 1;
+		for (int x = 0; x < count + 2; ++x)
+			yuvRows[y][x] = RGBtoYUV[src[x]];
+	}
+
+	// The neighbours w1 to w9, without w5, relative to yuvRows[1] + 1
+	const uint32 *neighbours[8] = {
+		yuvRows[0], yuvRows[0] + 1, yuvRows[0] + 2,
+		yuvRows[1], yuvRows[1] + 2,
+		yuvRows[2], yuvRows[2] + 1, yuvRows[2] + 2
+	};
+	const uint32 *center = yuvRows[1] + 1;
+
+	int x = 0;
+
+	// Four pixels at a time. Y, U and V are one byte each, so the absolute
+	// differences of all three are computed at once and then compared with
+	// the thresholds of diffYUV() through a saturating subtraction; the
+	// fourth byte is always zero and never exceeds its threshold.
+#if defined(SCUMMVM_SSE2)
+	const __m128i thresholds = _mm_set1_epi32((int)0xFF300706);
+	const __m128i zero = _mm_setzero_si128();
+	for (; x + 4 <= count; x += 4) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(center + x));
+		__m128i pattern = zero;
+		for (int n = 0; n < 8; ++n) {
+			const __m128i w = _mm_loadu_si128((const __m128i *)(neighbours[n] + x));
+			const __m128i diff = _mm_or_si128(_mm_subs_epu8(c, w), _mm_subs_epu8(w, c));
+			const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(diff, thresholds), zero);
+			pattern = _mm_or_si128(pattern, _mm_andnot_si128(same, _mm_set1_epi32(1 << n)));
+		}
+		pattern = _mm_packs_epi32(pattern, pattern);
+		pattern = _mm_packus_epi16(pattern, pattern);
+		const uint32 packed = _mm_cvtsi128_si32(pattern);
+		memcpy(patterns + x, &packed, 4);
+	}
+#elif defined(SCUMMVM_NEON)
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(0xFF300706));
+	for (; x + 4 <= count; x += 4) {
+		const uint8x16_t c = vreinterpretq_u8_u32(vld1q_u32(center + x));
+		uint32x4_t pattern = vdupq_n_u32(0);
+		for (int n = 0; n < 8; ++n) {
+			const uint8x16_t w = vreinterpretq_u8_u32(vld1q_u32(neighbours[n] + x));
+			const uint32x4_t excess = vreinterpretq_u32_u8(vqsubq_u8(vabdq_u8(c, w), thresholds));
+			pattern = vorrq_u32(pattern, vandq_u32(vtstq_u32(excess, excess), vdupq_n_u32(1 << n)));
+		}
+		const uint16x4_t narrow = vmovn_u32(pattern);
+		const uint32 packed = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+		memcpy(patterns + x, &packed, 4);
+	}
+#endif
+
+	for (; x < count; ++x) {
+		uint8 pattern = 0;
+		for (int n = 0; n < 8; ++n) {
+			if (diffYUV(center[x], neighbours[n][x]))
+				pattern |= 1 << n;
+		}
+		patterns[x] = pattern;
+	}
+}
+#endif
 #endif
 
 
@@ -157,6 +230,98 @@ void DestroyScalers() {
 	free(RGBtoYUV);
 	RGBtoYUV = 0;
 #endif
+
+	InitScalerThreads(0);
+	freeThumbnailBuffers();
+}
+
+namespace {
+
+/** Worker threads of ScaleParallel(), or 0 to scale on the calling thread. */
+Common::WorkerPool *g_scalerPool = 0;
+
+enum {
+	/** Areas are not split in stripes with fewer rows than this. */
+	kMinStripeHeight = 16
+};
+
+struct ScalerStripes {
+	ScalerProc *scaler;
+	int scaleFactor;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height;
+	uint count;
+};
+
+void scaleStripe(void *param, uint index) {
+	const ScalerStripes &stripes = *(const ScalerStripes *)param;
+
+	// Stripes start on even rows, for the scalers which work on pairs of
+	// rows or whose output depends on the parity of the row
+	const int top = (stripes.height * index / stripes.count) & ~1;
+	const int bottom = (index + 1 == stripes.count) ? stripes.height : (stripes.height * (index + 1) / stripes.count) & ~1;
+
+	stripes.scaler(stripes.srcPtr + top * stripes.srcPitch, stripes.srcPitch,
+	               stripes.dstPtr + top * stripes.scaleFactor * stripes.dstPitch, stripes.dstPitch,
+	               stripes.width, bottom - top);
+}
+
+bool isReentrant(ScalerProc *scaler) {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly versions keep their state in global variables
+	if (scaler == HQ2x || scaler == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+} // End of anonymous namespace
+
+void InitScalerThreads(uint numThreads) {
+	if (g_scalerPool && g_scalerPool->getThreadCount() == numThreads)
+		return;
+
+	delete g_scalerPool;
+	g_scalerPool = 0;
+
+	if (numThreads > 0) {
+		g_scalerPool = new Common::WorkerPool(numThreads);
+		if (!g_scalerPool->getThreadCount()) {
+			warning("InitScalerThreads: Could not create any scaler threads");
+			delete g_scalerPool;
+			g_scalerPool = 0;
+		}
+	}
+}
+
+void ScaleParallel(ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	const uint count = g_scalerPool ? MIN<uint>(g_scalerPool->getThreadCount() + 1, height / kMinStripeHeight) : 0;
+	if (count < 2 || !isReentrant(scaler)) {
+		scaler(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	ScaleStripes(*g_scalerPool, count, scaler, scaleFactor, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
+
+void ScaleStripes(Common::WorkerPool &pool, uint count, ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	ScalerStripes stripes;
+	stripes.scaler = scaler;
+	stripes.scaleFactor = scaleFactor;
+	stripes.srcPtr = srcPtr;
+	stripes.srcPitch = srcPitch;
+	stripes.dstPtr = dstPtr;
+	stripes.dstPitch = dstPitch;
+	stripes.width = width;
+	stripes.height = height;
+	stripes.count = count;
+
+	pool.run(scaleStripe, &stripes, count);
 }
 
 
@@ -26,12 +26,50 @@
 #include "common/scummsys.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 extern void InitScalers(uint32 BitFormat);
 extern void DestroyScalers();
 
 typedef void ScalerProc(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height);
 
+/**
+ * Set the number of worker threads used by ScaleParallel(). With 0, which
+ * is the default, all scaling happens on the calling thread.
+ */
+extern void InitScalerThreads(uint numThreads);
+
+/**
+ * Run a scaler over an area, split into horizontal stripes which are scaled
+ * on the scaler worker threads in parallel. The result is exactly the same
+ * as calling the scaler directly: the stripes all read the pixels around
+ * them from the shared source, which is why the source must stay unchanged
+ * until this returns.
+ *
+ * Small areas, and areas scaled by scalers which are not reentrant, are
+ * simply scaled on the calling thread.
+ *
+ * @param scaler		the scaler to use; it must scale by an integer factor
+ * @param scaleFactor	the scale factor of the scaler
+ */
+extern void ScaleParallel(ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
+/**
+ * Run a scaler over an area split into a given number of horizontal stripes,
+ * which are scaled by the tasks of a worker pool. This is what ScaleParallel()
+ * does with the scaler threads; the scaler must be reentrant. Some scalers
+ * need at least two rows, so every stripe should get at least as many.
+ *
+ * @param pool			the worker pool to scale the stripes with
+ * @param count			the number of stripes
+ */
+extern void ScaleStripes(Common::WorkerPool &pool, uint count, ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
 #define DECLARE_SCALER(x)	\
 	extern void x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, \
 					uint32 dstPitch, int width, int height)
@@ -90,4 +128,26 @@ extern bool createThumbnailFromScreen(Graphics::Surface *surf);
  */
 extern bool createThumbnail(Graphics::Surface *surf, const uint8 *pixels, int w, int h, const uint8 *palette);
 
+/**
+ * Grabs the current screen (without overlay) for createThumbnail(), which
+ * does not access the screen and can thus run on any thread.
+ *
+ * @param surf	a surface (will always have 16 bpp after this for now)
+ * @return		false if a error occurred
+ */
+extern bool grabScreenForThumbnail(Graphics::Surface *surf);
+
+/**
+ * Creates a thumbnail from a screen grab.
+ *
+ * @param surf      destination surface (will always have 16 bpp after this for now)
+ * @param screen    the screen grab; its pixels are overwritten
+ */
+extern bool createThumbnail(Graphics::Surface *surf, Graphics::Surface &screen);
+
+/**
+ * Frees the screen grab kept by createThumbnailFromScreen().
+ */
+extern void freeThumbnailBuffers();
+
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "graphics/scaler/intern.h"
+#include "common/util.h"
 
 #ifdef USE_NASM
 // Assembly version of HQ2x
@@ -131,14 +132,30 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
+#ifdef HQ_PATTERNS_SIMD
+		uint8 patterns[kHQPatternChunk];
+		int patternIndex = kHQPatternChunk;
+#endif
+
 		int tmpWidth = width;
 		while (tmpWidth--) {
+#ifdef HQ_PATTERNS_SIMD
+			// Compare the pixels with their neighbours a chunk at a time
+			if (patternIndex == kHQPatternChunk) {
+				computeHQPatterns(p, nextlineSrc, MIN<int>(tmpWidth + 1, kHQPatternChunk), patterns);
+				patternIndex = 0;
+			}
+#endif
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+#ifdef HQ_PATTERNS_SIMD
+			const int pattern = patterns[patternIndex++];
+#else
 			int pattern = 0;
 			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
@@ -149,6 +166,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
 			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
 			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#endif
 
 			switch (pattern) {
 			case 0:
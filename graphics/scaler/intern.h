@@ -24,6 +24,7 @@
 #define GRAPHICS_SCALER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/simd.h"
 #include "graphics/colormasks.h"
 
 
@@ -524,4 +525,26 @@ static inline bool diffYUV(int yuv1, int yuv2) {
 */
 }
 
+#if defined(USE_HQ_SCALERS) && defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define HQ_PATTERNS_SIMD
+
+enum {
+	/** Maximal number of pixels handled by one call of computeHQPatterns(). */
+	kHQPatternChunk = 64
+};
+
+/**
+ * Compute the patterns the hq scaler family selects its interpolation with,
+ * for a run of pixels of a row, comparing several pixels at once. Bits 0 to
+ * 7 of a pattern are set if diffYUV() tells the pixel (w5) apart from w1, w2,
+ * w3, w4, w6, w7, w8 and w9 respectively.
+ *
+ * @param p				the first pixel; the pixels around the run must be readable
+ * @param nextlineSrc	the pitch of the source, in pixels
+ * @param count			the number of pixels, at most kHQPatternChunk
+ * @param patterns		receives the pattern of each pixel
+ */
+void computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int count, uint8 *patterns);
+#endif
+
 #endif
@@ -22,13 +22,19 @@
 
 #include "common/endian.h"
 #include "common/scummsys.h"
+#include "common/simd.h"
 #include "common/system.h"
 
 #include "graphics/colormasks.h"
+#include "graphics/conversion.h"
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/palette.h"
 
+#if defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define THUMBNAIL_SIMD
+#endif
+
 template<int bitFormat>
 uint16 quadBlockInterpolate(const uint8 *src, uint32 srcPitch) {
 	uint16 colorx1y1 = *(((const uint16 *)src));
@@ -40,21 +46,6 @@ uint16 quadBlockInterpolate(const uint8 *src, uint32 srcPitch) {
 	return interpolate16_1_1_1_1<Graphics::ColorMasks<bitFormat> >(colorx1y1, colorx2y1, colorx1y2, colorx2y2);
 }
 
-template<int bitFormat>
-void createThumbnail_2(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	// Make sure the width and height is a multiple of 2.
-	width &= ~1;
-	height &= ~1;
-
-	for (int y = 0; y < height; y += 2) {
-		for (int x = 0; x < width; x += 2, dstPtr += 2) {
-			*((uint16 *)dstPtr) = quadBlockInterpolate<bitFormat>(src + 2 * x, srcPitch);
-		}
-		dstPtr += (dstPitch - 2 * width / 2);
-		src += 2 * srcPitch;
-	}
-}
-
 template<int bitFormat>
 void createThumbnail_4(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	// Make sure the width and height is a multiple of 4
@@ -75,15 +66,97 @@ void createThumbnail_4(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32
 	}
 }
 
+#ifdef THUMBNAIL_SIMD
+#if defined(SCUMMVM_SSE2)
+/** Adds up the 2x2 blocks of one channel of 16 pixels of two lines. */
+static inline __m128i sumBlocks(__m128i a0, __m128i a1, __m128i b0, __m128i b1) {
+	// Add the two lines, then the horizontal pairs into 32 bit lanes
+	const __m128i ones = _mm_set1_epi16(1);
+	return _mm_packs_epi32(_mm_madd_epi16(_mm_add_epi16(a0, b0), ones),
+	                       _mm_madd_epi16(_mm_add_epi16(a1, b1), ones));
+}
+
+static inline void halveBlocks565(const uint8 *src, uint32 srcPitch, uint16 *dst) {
+	const __m128i a0 = _mm_loadu_si128((const __m128i *)src);
+	const __m128i a1 = _mm_loadu_si128((const __m128i *)(src + 16));
+	const __m128i b0 = _mm_loadu_si128((const __m128i *)(src + srcPitch));
+	const __m128i b1 = _mm_loadu_si128((const __m128i *)(src + srcPitch + 16));
+	const __m128i mask5 = _mm_set1_epi16(0x1F);
+	const __m128i mask6 = _mm_set1_epi16(0x3F);
+
+	const __m128i r = sumBlocks(_mm_srli_epi16(a0, 11), _mm_srli_epi16(a1, 11),
+	                            _mm_srli_epi16(b0, 11), _mm_srli_epi16(b1, 11));
+	const __m128i g = sumBlocks(_mm_and_si128(_mm_srli_epi16(a0, 5), mask6), _mm_and_si128(_mm_srli_epi16(a1, 5), mask6),
+	                            _mm_and_si128(_mm_srli_epi16(b0, 5), mask6), _mm_and_si128(_mm_srli_epi16(b1, 5), mask6));
+	const __m128i b = sumBlocks(_mm_and_si128(a0, mask5), _mm_and_si128(a1, mask5),
+	                            _mm_and_si128(b0, mask5), _mm_and_si128(b1, mask5));
+
+	const __m128i color = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(r, 2), 11),
+	                                                _mm_slli_epi16(_mm_srli_epi16(g, 2), 5)),
+	                                   _mm_srli_epi16(b, 2));
+	_mm_storeu_si128((__m128i *)dst, color);
+}
+#elif defined(SCUMMVM_NEON)
+static inline void halveBlocks565(const uint8 *src, uint32 srcPitch, uint16 *dst) {
+	// Split the even and the odd pixels of both lines
+	const uint16x8x2_t a = vld2q_u16((const uint16 *)src);
+	const uint16x8x2_t b = vld2q_u16((const uint16 *)(src + srcPitch));
+	const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+	const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+
+	const uint16x8_t r = vaddq_u16(vaddq_u16(vshrq_n_u16(a.val[0], 11), vshrq_n_u16(a.val[1], 11)),
+	                               vaddq_u16(vshrq_n_u16(b.val[0], 11), vshrq_n_u16(b.val[1], 11)));
+	const uint16x8_t g = vaddq_u16(vaddq_u16(vandq_u16(vshrq_n_u16(a.val[0], 5), mask6), vandq_u16(vshrq_n_u16(a.val[1], 5), mask6)),
+	                               vaddq_u16(vandq_u16(vshrq_n_u16(b.val[0], 5), mask6), vandq_u16(vshrq_n_u16(b.val[1], 5), mask6)));
+	const uint16x8_t bl = vaddq_u16(vaddq_u16(vandq_u16(a.val[0], mask5), vandq_u16(a.val[1], mask5)),
+	                                vaddq_u16(vandq_u16(b.val[0], mask5), vandq_u16(b.val[1], mask5)));
+
+	vst1q_u16(dst, vorrq_u16(vorrq_u16(vshlq_n_u16(vshrq_n_u16(r, 2), 11), vshlq_n_u16(vshrq_n_u16(g, 2), 5)),
+	                         vshrq_n_u16(bl, 2)));
+}
+#endif
+#endif
+
+/**
+ * Halves a RGB565 surface in place, replacing each 2x2 block of pixels by
+ * their average. Sixteen pixels of each line pair are done at once where SIMD
+ * is available.
+ */
+static void halveThumbnail565(uint8 *pixels, uint32 pitch, int width, int height) {
+	// Make sure the width and height is a multiple of 2.
+	width &= ~1;
+	height &= ~1;
+
+	for (int y = 0; y < height; y += 2) {
+		const uint8 *src = pixels + y * pitch;
+		uint16 *dst = (uint16 *)(pixels + y / 2 * pitch);
+		int x = 0;
+
+#ifdef THUMBNAIL_SIMD
+		// The output trails the input, so even the first line is safe to
+		// overwrite once a block has been loaded.
+		for (; x + 16 <= width; x += 16)
+			halveBlocks565(src + 2 * x, pitch, dst + x / 2);
+#endif
+
+		for (; x < width; x += 2)
+			dst[x / 2] = quadBlockInterpolate<565>(src + 2 * x, pitch);
+	}
+}
+
 static void scaleThumbnail(Graphics::Surface &in, Graphics::Surface &out) {
+#ifndef THUMBNAIL_SIMD
 	while (in.w / out.w >= 4 || in.h / out.h >= 4) {
 		createThumbnail_4<565>((const uint8 *)in.getPixels(), in.pitch, (uint8 *)in.getPixels(), in.pitch, in.w, in.h);
 		in.w /= 4;
 		in.h /= 4;
 	}
+#endif
 
+	// With SIMD, 4x4 blocks are averaged as 2x2 blocks twice instead, which
+	// gives the same result since each channel is rounded down both times.
 	while (in.w / out.w >= 2 || in.h / out.h >= 2) {
-		createThumbnail_2<565>((const uint8 *)in.getPixels(), in.pitch, (uint8 *)in.getPixels(), in.pitch, in.w, in.h);
+		halveThumbnail565((uint8 *)in.getPixels(), in.pitch, in.w, in.h);
 		in.w /= 2;
 		in.h /= 2;
 	}
@@ -160,8 +233,18 @@ static void scaleThumbnail(Graphics::Surface &in, Graphics::Surface &out) {
 }
 
 
+namespace {
 /**
- * Copies the current screen contents to a new surface, using RGB565 format.
+ * The screen grab of the last thumbnail, kept to avoid allocating it again
+ * for each save. It is only used by createThumbnailFromScreen().
+ */
+Graphics::Surface *s_screenBuffer = 0;
+} // End of anonymous namespace
+
+/**
+ * Copies the current screen contents to a surface, using RGB565 format. The
+ * surface is only reallocated when it does not have the size of the screen
+ * already.
  * WARNING: surf->free() must be called by the user to avoid leaking.
  *
  * @param surf      the surface to store the data in it
@@ -176,44 +259,32 @@ static bool grabScreen565(Graphics::Surface *surf) {
 	assert(screen->getPixels() != 0);
 
 	Graphics::PixelFormat screenFormat = g_system->getScreenFormat();
+	const Graphics::PixelFormat format565(2, 5, 6, 5, 0, 11, 5, 0, 0);
 
-	surf->create(screen->w, screen->h, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	if (!surf->getPixels() || surf->w != screen->w || surf->h != screen->h || surf->format != format565)
+		surf->create(screen->w, screen->h, format565);
 
-	byte *palette = 0;
 	if (screenFormat.bytesPerPixel == 1) {
-		palette = new byte[256 * 3];
-		assert(palette);
+		byte palette[256 * 3];
+		uint32 map[256];
 		g_system->getPaletteManager()->grabPalette(palette, 0, 256);
+		Graphics::convertPaletteToMap(map, palette, 256, format565);
+		Graphics::crossBlitMap((byte *)surf->getPixels(), (const byte *)screen->getPixels(), surf->pitch, screen->pitch,
+		                       screen->w, screen->h, 2, map);
+	} else {
+		Graphics::crossBlit((byte *)surf->getPixels(), (const byte *)screen->getPixels(), surf->pitch, screen->pitch,
+		                    screen->w, screen->h, format565, screenFormat);
 	}
 
-	for (uint y = 0; y < screen->h; ++y) {
-		for (uint x = 0; x < screen->w; ++x) {
-			byte r = 0, g = 0, b = 0;
-
-			if (screenFormat.bytesPerPixel == 1) {
-				uint8 pixel = *(uint8 *)screen->getBasePtr(x, y);
-				r = palette[pixel * 3 + 0];
-				g = palette[pixel * 3 + 1];
-				b = palette[pixel * 3 + 2];
-			} else if (screenFormat.bytesPerPixel == 2) {
-				uint16 col = READ_UINT16(screen->getBasePtr(x, y));
-				screenFormat.colorToRGB(col, r, g, b);
-			} else if (screenFormat.bytesPerPixel == 4) {
-				uint32 col = READ_UINT32(screen->getBasePtr(x, y));
-				screenFormat.colorToRGB(col, r, g, b);
-			}
-
-			*((uint16 *)surf->getBasePtr(x, y)) = Graphics::RGBToColor<Graphics::ColorMasks<565> >(r, g, b);
-		}
-	}
-
-	delete[] palette;
-
 	g_system->unlockScreen();
 	return true;
 }
 
-static bool createThumbnail(Graphics::Surface &out, Graphics::Surface &in) {
+/**
+ * Scales a RGB565 screen grab down to a thumbnail. The pixels of the grab
+ * are used as scratch space, but it keeps its size.
+ */
+static bool scaleScreenGrab(Graphics::Surface &out, Graphics::Surface &in) {
 	int height;
 	if ((in.w == 320 && in.h == 200) || (in.w == 640 && in.h == 400)) {
 		height = kThumbnailHeight1;
@@ -222,20 +293,33 @@ static bool createThumbnail(Graphics::Surface &out, Graphics::Surface &in) {
 	}
 
 	out.create(kThumbnailWidth, height, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
-	scaleThumbnail(in, out);
-	in.free();
+	Graphics::Surface scratch = in;
+	scaleThumbnail(scratch, out);
 	return true;
 }
 
 bool createThumbnailFromScreen(Graphics::Surface *surf) {
 	assert(surf);
 
-	Graphics::Surface screen;
+	if (!s_screenBuffer)
+		s_screenBuffer = new Graphics::Surface();
 
-	if (!grabScreen565(&screen))
+	if (!grabScreen565(s_screenBuffer))
 		return false;
 
-	return createThumbnail(*surf, screen);
+	return scaleScreenGrab(*surf, *s_screenBuffer);
+}
+
+bool grabScreenForThumbnail(Graphics::Surface *surf) {
+	assert(surf);
+
+	return grabScreen565(surf);
+}
+
+bool createThumbnail(Graphics::Surface *surf, Graphics::Surface &screen) {
+	assert(surf);
+
+	return scaleScreenGrab(*surf, screen);
 }
 
 bool createThumbnail(Graphics::Surface *surf, const uint8 *pixels, int w, int h, const uint8 *palette) {
@@ -244,18 +328,21 @@ bool createThumbnail(Graphics::Surface *surf, const uint8 *pixels, int w, int h,
 	Graphics::Surface screen;
 	screen.create(w, h, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
 
-	for (uint y = 0; y < screen.h; ++y) {
-		for (uint x = 0; x < screen.w; ++x) {
-			byte r, g, b;
-			r = palette[pixels[y * w + x] * 3];
-			g = palette[pixels[y * w + x] * 3 + 1];
-			b = palette[pixels[y * w + x] * 3 + 2];
+	uint32 map[256];
+	Graphics::convertPaletteToMap(map, palette, 256, screen.format);
+	Graphics::crossBlitMap((byte *)screen.getPixels(), pixels, screen.pitch, w, w, h, 2, map);
 
-			*((uint16 *)screen.getBasePtr(x, y)) = Graphics::RGBToColor<Graphics::ColorMasks<565> >(r, g, b);
-		}
-	}
+	bool success = scaleScreenGrab(*surf, screen);
+	screen.free();
+	return success;
+}
 
-	return createThumbnail(*surf, screen);
+void freeThumbnailBuffers() {
+	if (s_screenBuffer) {
+		s_screenBuffer->free();
+		delete s_screenBuffer;
+		s_screenBuffer = 0;
+	}
 }
 
 // this is somewhat awkward, but createScreenShot should logically be in graphics,
@@ -40,13 +40,13 @@ Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface()
 }
 
 void Screen::update() {
-	// Merge the dirty rects
-	mergeDirtyRects();
+	// Get the dirty areas, merged into as few rects as possible
+	Common::Array<Common::Rect> dirtyRects;
+	_dirtyTiles.getRects(dirtyRects);
 
 	// Loop through copying dirty areas to the physical screen
-	Common::List<Common::Rect>::iterator i;
-	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
-		const Common::Rect &r = *i;
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &r = dirtyRects[i];
 		const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
 		g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
 			r.width(), r.height());
@@ -54,7 +54,7 @@ void Screen::update() {
 
 	// Signal the physical screen to update
 	g_system->updateScreen();
-	_dirtyRects.clear();
+	_dirtyTiles.clear();
 }
 
 
@@ -63,41 +63,17 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.clip(getBounds());
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
-	if (bounds.width() > 0 && bounds.height() > 0)
-		_dirtyRects.push_back(bounds);
-}
-
-void Screen::makeAllDirty() {
-	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
-}
-
-void Screen::mergeDirtyRects() {
-	Common::List<Common::Rect>::iterator rOuter, rInner;
+	if (bounds.width() > 0 && bounds.height() > 0) {
+		// The screen may have been recreated with a different size
+		if (bounds.right > _dirtyTiles.getWidth() || bounds.bottom > _dirtyTiles.getHeight())
+			_dirtyTiles.resize(MAX<int>(bounds.right, _dirtyTiles.getWidth()), MAX<int>(bounds.bottom, _dirtyTiles.getHeight()));
 
-	// Process the dirty rect list to find any rects to merge
-	for (rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
-		rInner = rOuter;
-		while (++rInner != _dirtyRects.end()) {
-
-			if ((*rOuter).intersects(*rInner)) {
-				// These two rectangles overlap, so merge them
-				unionRectangle(*rOuter, *rOuter, *rInner);
-
-				// remove the inner rect from the list
-				_dirtyRects.erase(rInner);
-
-				// move back to beginning of list
-				rInner = rOuter;
-			}
-		}
+		_dirtyTiles.addRect(bounds);
 	}
 }
 
-bool Screen::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
-	destRect = src1;
-	destRect.extend(src2);
-
-	return !destRect.isEmpty();
+void Screen::makeAllDirty() {
+	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
 }
 
 void Screen::getPalette(byte palette[PALETTE_SIZE]) {
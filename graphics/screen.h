@@ -23,6 +23,7 @@
 #ifndef GRAPHICS_SCREEN_H
 #define GRAPHICS_SCREEN_H
 
+#include "graphics/dirty_tiles.h"
 #include "graphics/managed_surface.h"
 #include "graphics/pixelformat.h"
 #include "common/list.h"
@@ -42,19 +43,9 @@ namespace Graphics {
 class Screen : public ManagedSurface {
 private:
 	/**
-	 * List of affected areas of the screen
+	 * Affected areas of the screen
 	 */
-	Common::List<Common::Rect> _dirtyRects;
-private:
-	/**
-	* Merges together overlapping dirty areas of the screen
-	*/
-	void mergeDirtyRects();
-
-	/**
-	* Returns the union of two dirty area rectangles
-	*/
-	bool unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2);
+	DirtyTiles _dirtyTiles;
 protected:
 	/**
 	 * Adds a rectangle to the list of modified areas of the screen during the
@@ -69,7 +60,7 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyTiles.isEmpty(); }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -78,9 +69,9 @@ public:
 	void makeAllDirty();
 
 	/**
-	 * Clear the current dirty rects list
+	 * Clear the current dirty areas
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects() { _dirtyTiles.clear(); }
 
 	/**
 	 * Updates the screen by copying any affected areas to the system
@@ -25,6 +25,7 @@
 #include "graphics/colormasks.h"
 #include "common/endian.h"
 #include "common/algorithm.h"
+#include "common/memstream.h"
 #include "common/system.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -179,27 +180,51 @@ bool loadThumbnail(Common::SeekableReadStream &in, Graphics::Surface *&thumbnail
 	thumbnail = new Graphics::Surface();
 	thumbnail->create(header.width, header.height, header.format);
 
-	for (int y = 0; y < thumbnail->h; ++y) {
-		switch (header.format.bytesPerPixel) {
-		case 2: {
-			uint16 *pixels = (uint16 *)thumbnail->getBasePtr(0, y);
-			for (uint x = 0; x < thumbnail->w; ++x) {
-				*pixels++ = in.readUint16BE();
-			}
-			} break;
+	// Read all the pixels at once and swap them in place
+	const uint count = thumbnail->w * thumbnail->h;
+	in.read(thumbnail->getPixels(), count * header.format.bytesPerPixel);
+
+	switch (header.format.bytesPerPixel) {
+	case 2: {
+		uint16 *pixels = (uint16 *)thumbnail->getPixels();
+		for (uint i = 0; i < count; ++i)
+			pixels[i] = FROM_BE_16(pixels[i]);
+		} break;
+
+	case 4: {
+		uint32 *pixels = (uint32 *)thumbnail->getPixels();
+		for (uint i = 0; i < count; ++i)
+			pixels[i] = FROM_BE_32(pixels[i]);
+		} break;
+
+	default:
+		assert(0);
+	}
+	return true;
+}
 
-		case 4: {
-			uint32 *pixels = (uint32 *)thumbnail->getBasePtr(0, y);
-			for (uint x = 0; x < thumbnail->w; ++x) {
-				*pixels++ = in.readUint32BE();
-			}
-			} break;
+Common::SeekableReadStream *readThumbnailData(Common::SeekableReadStream &in) {
+	const uint32 position = in.pos();
+	ThumbnailHeader header;
+	HeaderState headerState = loadHeader(in, header, true);
 
-		default:
-			assert(0);
-		}
+	// Leave the stream as loadThumbnail() would, but only keep thumbnails
+	// which it can decode.
+	if (headerState == kHeaderNone) {
+		in.seek(position, SEEK_SET);
+		return nullptr;
+	} else if (headerState == kHeaderUnsupported) {
+		in.seek(header.size - (in.pos() - position), SEEK_CUR);
+		return nullptr;
 	}
-	return true;
+
+	if (header.format.bytesPerPixel != 2 && header.format.bytesPerPixel != 4) {
+		warning("trying to load thumbnail with unsupported bit depth %d", header.format.bytesPerPixel);
+		return nullptr;
+	}
+
+	in.seek(position, SEEK_SET);
+	return in.readStream(header.size);
 }
 
 bool saveThumbnail(Common::WriteStream &out) {
@@ -246,28 +271,89 @@ bool saveThumbnail(Common::WriteStream &out, const Graphics::Surface &thumb) {
 	out.writeByte(thumb.format.bShift);
 	out.writeByte(thumb.format.aShift);
 
-	// Serialize the pixel data
+	// Serialize the pixel data, a line at a time
+	const uint lineSize = thumb.w * thumb.format.bytesPerPixel;
+	byte *line = new byte[lineSize];
+
 	for (uint y = 0; y < thumb.h; ++y) {
 		switch (thumb.format.bytesPerPixel) {
 		case 2: {
 			const uint16 *pixels = (const uint16 *)thumb.getBasePtr(0, y);
 			for (uint x = 0; x < thumb.w; ++x) {
-				out.writeUint16BE(*pixels++);
+				WRITE_BE_UINT16(line + x * 2, pixels[x]);
 			}
 			} break;
 
 		case 4: {
 			const uint32 *pixels = (const uint32 *)thumb.getBasePtr(0, y);
 			for (uint x = 0; x < thumb.w; ++x) {
-				out.writeUint32BE(*pixels++);
+				WRITE_BE_UINT32(line + x * 4, pixels[x]);
 			}
 			} break;
 
 		default:
 			assert(0);
 		}
+
+		out.write(line, lineSize);
 	}
 
+	delete[] line;
+	return true;
+}
+
+AsyncThumbnail::AsyncThumbnail() : _encoded(nullptr), _success(false), _done(false) {
+	_grabbed = grabScreenForThumbnail(&_screen);
+	start();
+}
+
+AsyncThumbnail::AsyncThumbnail(const Surface &screen) : _encoded(nullptr), _success(false), _done(false) {
+	_screen.copyFrom(screen);
+	_grabbed = true;
+	start();
+}
+
+AsyncThumbnail::~AsyncThumbnail() {
+	_thread.join();
+	_screen.free();
+	delete _encoded;
+}
+
+void AsyncThumbnail::start() {
+	if (_grabbed)
+		_thread.start(&encodeProc, this);
+}
+
+void AsyncThumbnail::encodeProc(void *param) {
+	((AsyncThumbnail *)param)->encode();
+}
+
+void AsyncThumbnail::encode() {
+	Graphics::Surface thumb;
+
+	_encoded = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	_success = createThumbnail(&thumb, _screen) && saveThumbnail(*_encoded, thumb);
+
+	thumb.free();
+	_screen.free();
+	_done = true;
+}
+
+bool AsyncThumbnail::save(Common::WriteStream &out) {
+	if (!_grabbed) {
+		warning("Couldn't create thumbnail from screen, aborting thumbnail save");
+		return false;
+	}
+
+	// Finish here if the worker thread could not be started
+	_thread.join();
+	if (!_done)
+		encode();
+
+	if (!_success)
+		return false;
+
+	out.write(_encoded->getData(), _encoded->size());
 	return true;
 }
 
@@ -24,8 +24,11 @@
 #define GRAPHICS_THUMBNAIL_H
 
 #include "common/scummsys.h"
+#include "common/thread.h"
+#include "graphics/surface.h"
 
 namespace Common{
+class MemoryWriteStreamDynamic;
 class SeekableReadStream;
 class WriteStream;
 }
@@ -54,6 +57,15 @@ bool skipThumbnail(Common::SeekableReadStream &in);
  */
 bool loadThumbnail(Common::SeekableReadStream &in, Graphics::Surface *&thumbnail, bool skipThumbnail = false);
 
+/**
+ * Reads a thumbnail from the given input stream without decoding it, for
+ * loadThumbnail() to decode it only once it is actually needed.
+ *
+ * @return	the raw thumbnail, or 0 if there is none or it could not be
+ *			loaded; the input stream is left as loadThumbnail() leaves it
+ */
+Common::SeekableReadStream *readThumbnailData(Common::SeekableReadStream &in);
+
 /**
  * Saves a thumbnail to the given write stream.
  * Automatically creates a thumbnail from screen contents.
@@ -65,6 +77,48 @@ bool saveThumbnail(Common::WriteStream &out);
  */
 bool saveThumbnail(Common::WriteStream &out, const Graphics::Surface &thumb);
 
+/**
+ * Saves a thumbnail of the screen, scaling it down and encoding it on a
+ * worker thread.
+ *
+ * Only the screen is grabbed on construction. The engine can then serialize
+ * the rest of its save in the meantime, and call save() to write the
+ * thumbnail out, exactly as saveThumbnail() would. Without thread support,
+ * all the work is done by save().
+ */
+class AsyncThumbnail : Common::NonCopyable {
+public:
+	AsyncThumbnail();
+
+	/**
+	 * Same, but for the given screen contents, in the RGB565 format
+	 * grabScreenForThumbnail() produces.
+	 */
+	explicit AsyncThumbnail(const Surface &screen);
+
+	~AsyncThumbnail();
+
+	/**
+	 * Saves the thumbnail to the given write stream, waiting for it to be
+	 * encoded if need be. Must be called at most once.
+	 */
+	bool save(Common::WriteStream &out);
+
+private:
+	static void encodeProc(void *param);
+	void start();
+	void encode();
+
+	Surface _screen;
+	bool _grabbed;
+
+	Common::MemoryWriteStreamDynamic *_encoded;
+	bool _success;
+	bool _done;
+
+	Common::Thread _thread;
+};
+
 /**
  * Grabs framebuffer into surface
  *
@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transformed_surface_cache.h"
+
+namespace Graphics {
+
+TransformedSurfaceCache::TransformedSurfaceCache(uint32 maxSize) : _size(0), _maxSize(maxSize) {
+}
+
+TransformedSurfaceCache::~TransformedSurfaceCache() {
+	clear();
+}
+
+TransparentSurface *TransformedSurfaceCache::scale(const TransparentSurface &source, uint16 newWidth, uint16 newHeight, TFilteringMode filteringMode) {
+	Entry key = createKey(source, filteringMode);
+	key.width = newWidth;
+	key.height = newHeight;
+
+	TransparentSurface *result = find(key);
+	if (!result) {
+		if (filteringMode == FILTER_BILINEAR)
+			result = source.scaleT<FILTER_BILINEAR>(newWidth, newHeight);
+		else
+			result = source.scaleT<FILTER_NEAREST>(newWidth, newHeight);
+		insert(key, result);
+	}
+	return result;
+}
+
+TransparentSurface *TransformedSurfaceCache::rotoscale(const TransparentSurface &source, const TransformStruct &transform, TFilteringMode filteringMode) {
+	Entry key = createKey(source, filteringMode);
+	key.rotated = true;
+	key.angle = transform._angle;
+	key.zoom = transform._zoom;
+	key.hotspot = transform._hotspot;
+
+	TransparentSurface *result = find(key);
+	if (!result) {
+		if (filteringMode == FILTER_BILINEAR)
+			result = source.rotoscaleT<FILTER_BILINEAR>(transform);
+		else
+			result = source.rotoscaleT<FILTER_NEAREST>(transform);
+		insert(key, result);
+	}
+	return result;
+}
+
+void TransformedSurfaceCache::clear() {
+	for (Common::List<Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		freeEntry(*i);
+	_entries.clear();
+	_size = 0;
+}
+
+bool TransformedSurfaceCache::Entry::matches(const Entry &key) const {
+	if (source->w != key.source->w || source->h != key.source->h ||
+	    format != key.format || filteringMode != key.filteringMode || rotated != key.rotated)
+		return false;
+
+	if (rotated) {
+		if (angle != key.angle || zoom != key.zoom || hotspot != key.hotspot)
+			return false;
+	} else {
+		if (width != key.width || height != key.height)
+			return false;
+	}
+
+	// Only now compare the pixels, which is by far the most expensive part
+	return equals(*source, *key.source);
+}
+
+bool TransformedSurfaceCache::equals(const Surface &a, const Surface &b) {
+	const uint rowSize = a.w * a.format.bytesPerPixel;
+	for (int y = 0; y < a.h; y++) {
+		if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), rowSize))
+			return false;
+	}
+	return true;
+}
+
+TransformedSurfaceCache::Entry TransformedSurfaceCache::createKey(const TransparentSurface &source, TFilteringMode filteringMode) {
+	Entry key;
+	key.source = &source;
+	key.format = source.format;
+	key.filteringMode = filteringMode;
+	key.rotated = false;
+	key.width = key.height = 0;
+	key.angle = 0;
+	key.surface = nullptr;
+	return key;
+}
+
+uint32 TransformedSurfaceCache::getEntrySize(const Entry &entry) {
+	return entry.surface->h * entry.surface->pitch + entry.source->h * entry.source->pitch;
+}
+
+void TransformedSurfaceCache::freeEntry(Entry &entry) {
+	Surface *source = const_cast<Surface *>(entry.source);
+	source->free();
+	delete source;
+	entry.surface->free();
+	delete entry.surface;
+}
+
+TransparentSurface *TransformedSurfaceCache::find(const Entry &key) {
+	for (Common::List<Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (i->matches(key)) {
+			const Entry entry = *i;
+			if (i != _entries.begin()) {
+				_entries.erase(i);
+				_entries.push_front(entry);
+			}
+
+			TransparentSurface *result = new TransparentSurface();
+			result->copyFrom(*entry.surface);
+			return result;
+		}
+	}
+	return nullptr;
+}
+
+void TransformedSurfaceCache::insert(Entry &key, const TransparentSurface *surface) {
+	const uint32 size = surface->h * surface->pitch + key.source->h * key.source->pitch;
+	if (size > _maxSize)
+		return;
+
+	while (_size + size > _maxSize) {
+		Entry &oldest = _entries.back();
+		_size -= getEntrySize(oldest);
+		freeEntry(oldest);
+		_entries.pop_back();
+	}
+
+	Surface *source = new Surface();
+	source->copyFrom(*key.source);
+	key.source = source;
+	key.surface = new TransparentSurface();
+	key.surface->copyFrom(*surface);
+	_entries.push_front(key);
+	_size += size;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,109 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+#define GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+
+#include "common/list.h"
+#include "graphics/transparent_surface.h"
+
+namespace Graphics {
+
+/**
+ * A size-bounded cache of scaled and rotated surfaces.
+ *
+ * Sprites are often drawn with the same zoom or rotation for many frames in
+ * a row, e.g. a character walking into the distance. The cache keeps the
+ * most recently used results of TransparentSurface::scaleT() and
+ * TransparentSurface::rotoscaleT(), keyed by the contents of the source
+ * surface and the transformation, so they only need to be copied instead of
+ * being resampled again.
+ *
+ * Every entry keeps a copy of its source, which is compared to the source
+ * of a lookup once the size, format and transformation match. Comparing is
+ * much cheaper than the transformation itself, and gives up at the first
+ * difference, so callers do not have to track changes to the source.
+ */
+class TransformedSurfaceCache {
+public:
+	/**
+	 * @param maxSize the maximum size of all cached surfaces, in bytes
+	 */
+	TransformedSurfaceCache(uint32 maxSize = 8 * 1024 * 1024);
+	~TransformedSurfaceCache();
+
+	/**
+	 * Same as TransparentSurface::scaleT(). The returned surface belongs to
+	 * the caller.
+	 *
+	 * Nearest neighbour scaling is about as cheap as comparing the source,
+	 * so only bilinear scaling is worth caching.
+	 */
+	TransparentSurface *scale(const TransparentSurface &source, uint16 newWidth, uint16 newHeight, TFilteringMode filteringMode);
+
+	/**
+	 * Same as TransparentSurface::rotoscaleT(). The returned surface belongs
+	 * to the caller.
+	 */
+	TransparentSurface *rotoscale(const TransparentSurface &source, const TransformStruct &transform, TFilteringMode filteringMode);
+
+	/** Drop all cached surfaces. */
+	void clear();
+
+	/** Return the size of all cached surfaces and their sources, in bytes. */
+	uint32 getSize() const { return _size; }
+
+private:
+	struct Entry {
+		const Surface *source;      ///< the source of a lookup, or a copy of it
+		PixelFormat format;
+		TFilteringMode filteringMode;
+		bool rotated;
+		uint16 width;               ///< scaled surfaces only
+		uint16 height;              ///< scaled surfaces only
+		int32 angle;                ///< rotated surfaces only
+		Common::Point zoom;         ///< rotated surfaces only
+		Common::Point hotspot;      ///< rotated surfaces only
+		TransparentSurface *surface;
+
+		bool matches(const Entry &key) const;
+	};
+
+	/** Most recently used entries first */
+	Common::List<Entry> _entries;
+	uint32 _size;
+	const uint32 _maxSize;
+
+	static bool equals(const Surface &a, const Surface &b);
+	static Entry createKey(const TransparentSurface &source, TFilteringMode filteringMode);
+	static uint32 getEntrySize(const Entry &entry);
+	static void freeEntry(Entry &entry);
+
+	/** Look up an entry, and return a copy of its surface if found. */
+	TransparentSurface *find(const Entry &key);
+	/** Store a copy of the given surface under key, if it fits. */
+	void insert(Entry &key, const TransparentSurface *surface);
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -32,6 +32,7 @@
 #include "common/util.h"
 #include "common/rect.h"
 #include "common/math.h"
+#include "common/simd.h"
 #include "common/textconsole.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
@@ -64,6 +65,264 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
+#if defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define TRANSPARENT_SURFACE_SIMD
+
+#pragma mark -
+
+/*
+ * The blenders below process four pixels at a time with SSE2 or NEON. Each
+ * half of the 16 bytes is widened to a PixelPair: two pixels with one 16-bit
+ * lane per channel, in memory order (A, B, G, R). All the products of the
+ * scalar code fit into 16 bits, or are taken from the high half of a 16x16
+ * multiplication, so the results are exactly the same.
+ */
+
+#if defined(SCUMMVM_SSE2)
+typedef __m128i PixelPair;
+
+static inline PixelPair vMul(PixelPair a, PixelPair b) { return _mm_mullo_epi16(a, b); }
+static inline PixelPair vMulHi(PixelPair a, PixelPair b) { return _mm_mulhi_epu16(a, b); }
+static inline PixelPair vShr8(PixelPair a) { return _mm_srli_epi16(a, 8); }
+static inline PixelPair vAdd(PixelPair a, PixelPair b) { return _mm_add_epi16(a, b); }
+static inline PixelPair vSub(PixelPair a, PixelPair b) { return _mm_sub_epi16(a, b); }
+static inline PixelPair vSplat(uint16 a) { return _mm_set1_epi16(a); }
+static inline PixelPair vIsZero(PixelPair a) { return _mm_cmpeq_epi16(a, _mm_setzero_si128()); }
+
+static inline PixelPair vChannels(uint16 a, uint16 b, uint16 g, uint16 r) {
+	return _mm_setr_epi16(a, b, g, r, a, b, g, r);
+}
+
+/** Take the lanes of a where mask is set, and those of b elsewhere. */
+static inline PixelPair vSelect(PixelPair mask, PixelPair a, PixelPair b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** Copy the alpha value of each pixel to all its lanes. */
+static inline PixelPair vAlpha(PixelPair a) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0), 0);
+}
+
+/** Load four pixels, walking backwards from in when inStep is negative. */
+static inline void loadPixels(const byte *in, int32 inStep, PixelPair &lo, PixelPair &hi) {
+	__m128i pixels;
+	if (inStep > 0)
+		pixels = _mm_loadu_si128((const __m128i *)in);
+	else
+		pixels = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+
+	lo = _mm_unpacklo_epi8(pixels, _mm_setzero_si128());
+	hi = _mm_unpackhi_epi8(pixels, _mm_setzero_si128());
+}
+
+static inline void storePixels(byte *out, PixelPair lo, PixelPair hi) {
+	_mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+}
+
+#elif defined(SCUMMVM_NEON)
+typedef uint16x8_t PixelPair;
+
+static inline PixelPair vMul(PixelPair a, PixelPair b) { return vmulq_u16(a, b); }
+static inline PixelPair vShr8(PixelPair a) { return vshrq_n_u16(a, 8); }
+static inline PixelPair vAdd(PixelPair a, PixelPair b) { return vaddq_u16(a, b); }
+static inline PixelPair vSub(PixelPair a, PixelPair b) { return vsubq_u16(a, b); }
+static inline PixelPair vSplat(uint16 a) { return vdupq_n_u16(a); }
+static inline PixelPair vIsZero(PixelPair a) { return vceqq_u16(a, vdupq_n_u16(0)); }
+
+static inline PixelPair vMulHi(PixelPair a, PixelPair b) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+}
+
+static inline PixelPair vChannels(uint16 a, uint16 b, uint16 g, uint16 r) {
+	const uint16 lanes[8] = { a, b, g, r, a, b, g, r };
+	return vld1q_u16(lanes);
+}
+
+/** Take the lanes of a where mask is set, and those of b elsewhere. */
+static inline PixelPair vSelect(PixelPair mask, PixelPair a, PixelPair b) {
+	return vbslq_u16(mask, a, b);
+}
+
+/** Copy the alpha value of each pixel to all its lanes. */
+static inline PixelPair vAlpha(PixelPair a) {
+	return vcombine_u16(vdup_lane_u16(vget_low_u16(a), 0), vdup_lane_u16(vget_high_u16(a), 0));
+}
+
+/** Load four pixels, walking backwards from in when inStep is negative. */
+static inline void loadPixels(const byte *in, int32 inStep, PixelPair &lo, PixelPair &hi) {
+	uint8x16_t pixels;
+	if (inStep > 0) {
+		pixels = vld1q_u8(in);
+	} else {
+		const uint32x4_t reversed = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(in - 12)));
+		pixels = vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(reversed), vget_low_u32(reversed)));
+	}
+
+	lo = vmovl_u8(vget_low_u8(pixels));
+	hi = vmovl_u8(vget_high_u8(pixels));
+}
+
+static inline void storePixels(byte *out, PixelPair lo, PixelPair hi) {
+	vst1q_u8(out, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+}
+#endif
+
+/**
+ * Blend as many pixels of a row as possible four at a time, and advance in
+ * and out past them. The remaining ones are left to the scalar code.
+ * @return the number of pixels blended
+ */
+template<class Blender>
+static inline uint32 blendPixels(const Blender &blender, byte *&in, byte *&out, uint32 width, int32 inStep) {
+	uint32 j = 0;
+	if (inStep != 4 && inStep != -4)
+		return j;
+
+	for (; j + 4 <= width; j += 4) {
+		PixelPair inLo, inHi, outLo, outHi;
+		loadPixels(in, inStep, inLo, inHi);
+		loadPixels(out, 4, outLo, outHi);
+		storePixels(out, blender.blend(inLo, outLo), blender.blend(inHi, outHi));
+
+		in += inStep * 4;
+		out += 16;
+	}
+	return j;
+}
+
+/** Lanes holding the alpha channel */
+static inline PixelPair alphaLanes() {
+	return vChannels(0xFFFF, 0, 0, 0);
+}
+
+/** Lanes of the color channels which are not modulated (255) */
+static inline PixelPair unmodulatedLanes(byte cr, byte cg, byte cb) {
+	return vChannels(0, cb == 255 ? 0xFFFF : 0, cg == 255 ? 0xFFFF : 0, cr == 255 ? 0xFFFF : 0);
+}
+
+struct BinaryBlender {
+	const PixelPair _alphaLanes;
+
+	BinaryBlender() : _alphaLanes(alphaLanes()) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair result = vSelect(_alphaLanes, vSplat(255), in);
+		return vSelect(vIsZero(vAlpha(in)), out, result);
+	}
+};
+
+struct AlphaBlender {
+	const PixelPair _alphaLanes;
+
+	AlphaBlender() : _alphaLanes(alphaLanes()) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair a = vAlpha(in);
+		PixelPair result = vShr8(vAdd(vMul(in, a), vMul(out, vSub(vSplat(255), a))));
+		result = vSelect(_alphaLanes, vSplat(255), result);
+		return vSelect(vIsZero(a), out, result);
+	}
+};
+
+struct TintedAlphaBlender {
+	const PixelPair _alphaLanes;
+	const PixelPair _ca;
+	const PixelPair _color;
+
+	TintedAlphaBlender(byte ca, byte cr, byte cg, byte cb) : _alphaLanes(alphaLanes()), _ca(vSplat(ca)), _color(vChannels(0, cb, cg, cr)) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair ina = vAlpha(vShr8(vMul(in, _ca)));
+		PixelPair result = vAdd(vShr8(vMul(out, vSub(vSplat(255), ina))), vMulHi(vMul(in, _color), ina));
+		result = vSelect(_alphaLanes, vSplat(255), result);
+		return vSelect(vIsZero(ina), out, result);
+	}
+};
+
+struct AdditiveBlender {
+	const PixelPair _alphaLanes;
+
+	AdditiveBlender() : _alphaLanes(alphaLanes()) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		// Storing the pixels saturates the sums to 255
+		const PixelPair result = vAdd(out, vShr8(vMul(in, vAlpha(in))));
+		return vSelect(_alphaLanes, out, result);
+	}
+};
+
+struct TintedAdditiveBlender {
+	const PixelPair _alphaLanes;
+	const PixelPair _unmodulated;
+	const PixelPair _ca;
+	const PixelPair _color;
+
+	TintedAdditiveBlender(byte ca, byte cr, byte cg, byte cb) : _alphaLanes(alphaLanes()), _unmodulated(unmodulatedLanes(cr, cg, cb)), _ca(vSplat(ca)), _color(vChannels(0, cb, cg, cr)) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair ina = vAlpha(vShr8(vMul(in, _ca)));
+		const PixelPair add = vSelect(_unmodulated, vShr8(vMul(in, ina)), vMulHi(vMul(in, _color), ina));
+		return vSelect(_alphaLanes, out, vAdd(out, add));
+	}
+};
+
+struct SubtractiveBlender {
+	const PixelPair _alphaLanes;
+
+	SubtractiveBlender() : _alphaLanes(alphaLanes()) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		// The subtrahend never exceeds out, so there is nothing to clip
+		const PixelPair result = vSub(out, vMulHi(vMul(in, out), vAlpha(in)));
+		return vSelect(_alphaLanes, out, result);
+	}
+};
+
+struct TintedSubtractiveBlender {
+	const PixelPair _alphaLanes;
+	const PixelPair _unmodulated;
+	const PixelPair _color;
+
+	TintedSubtractiveBlender(byte cr, byte cg, byte cb) : _alphaLanes(alphaLanes()), _unmodulated(unmodulatedLanes(cr, cg, cb)), _color(vChannels(0, cb, cg, cr)) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair a = vAlpha(in);
+		const PixelPair sub = vSelect(_unmodulated, vMulHi(vMul(in, out), a), vShr8(vMulHi(vMul(in, _color), vMul(out, a))));
+		return vSelect(_alphaLanes, vSplat(255), vSub(out, sub));
+	}
+};
+
+struct MultiplyBlender {
+	const PixelPair _alphaLanes;
+
+	MultiplyBlender() : _alphaLanes(alphaLanes()) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair a = vAlpha(in);
+		const PixelPair result = vShr8(vMul(vShr8(vMul(in, a)), out));
+		return vSelect(_alphaLanes, out, vSelect(vIsZero(a), out, result));
+	}
+};
+
+struct TintedMultiplyBlender {
+	const PixelPair _alphaLanes;
+	const PixelPair _unmodulated;
+	const PixelPair _ca;
+	const PixelPair _color;
+
+	TintedMultiplyBlender(byte ca, byte cr, byte cg, byte cb) : _alphaLanes(alphaLanes()), _unmodulated(unmodulatedLanes(cr, cg, cb)), _ca(vSplat(ca)), _color(vChannels(0, cb, cg, cr)) {}
+
+	PixelPair blend(PixelPair in, PixelPair out) const {
+		const PixelPair ina = vAlpha(vShr8(vMul(in, _ca)));
+		const PixelPair factor = vSelect(_unmodulated, vShr8(vMul(in, ina)), vMulHi(vMul(in, _color), ina));
+		return vSelect(_alphaLanes, out, vShr8(vMul(out, factor)));
+	}
+};
+
+#pragma mark -
+#endif
+
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -113,7 +372,11 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		for (uint32 j = 0; j < width; j++) {
+		uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+		j = blendPixels(BinaryBlender(), in, out, width, inStep);
+#endif
+		for (; j < width; j++) {
 			uint32 pix = *(uint32 *)in;
 			int a = in[kAIndex];
 
@@ -149,7 +412,11 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(AlphaBlender(), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -174,7 +441,11 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(TintedAlphaBlender(ca, cr, cg, cb), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -210,7 +481,11 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(AdditiveBlender(), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
@@ -234,7 +509,11 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(TintedAdditiveBlender(ca, cr, cg, cb), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -277,7 +556,11 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(SubtractiveBlender(), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
@@ -300,23 +583,28 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(TintedSubtractiveBlender(cr, cg, cb), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				out[kAIndex] = 255;
+				// The product of four bytes does not fit in an int
 				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
+					out[kBIndex] = MAX(out[kBIndex] - (int)(((uint32)in[kBIndex] * cb * out[kBIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
+					out[kGIndex] = MAX(out[kGIndex] - (int)(((uint32)in[kGIndex] * cg * out[kGIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
+					out[kRIndex] = MAX(out[kRIndex] - (int)(((uint32)in[kRIndex] * cr * out[kRIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
 				}
@@ -341,7 +629,11 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(MultiplyBlender(), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
@@ -364,7 +656,11 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			j = blendPixels(TintedMultiplyBlender(ca, cr, cg, cb), in, out, width, inStep);
+#endif
+			for (; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -774,6 +1070,79 @@ systems.
 
 struct tColorRGBA { byte r; byte g; byte b; byte a; };
 
+#ifdef TRANSPARENT_SURFACE_SIMD
+#if defined(SCUMMVM_SSE2)
+/**
+ * (a * b) >> 16 for signed a and unsigned 16-bit b. _mm_mulhi_epi16() takes
+ * b as signed, which makes the result smaller by a where b >= 0x8000.
+ */
+static inline __m128i mulFraction(__m128i a, __m128i b) {
+	return _mm_add_epi16(_mm_mulhi_epi16(a, b), _mm_and_si128(a, _mm_srai_epi16(b, 15)));
+}
+
+/**
+ * Interpolate two pixels between their four neighbours each, rounding like
+ * the scalar code. top points to the upper left and bottom to the lower
+ * left neighbour, which are followed by the right ones. ex and ey are the
+ * 16-bit fractional parts of the source position.
+ */
+static inline void interpolatePixels(const byte *top0, const byte *bottom0, int ex0, int ey0,
+                                     const byte *top1, const byte *bottom1, int ex1, int ey1, byte *out) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	// The left neighbours of both pixels end up in the low half, the right
+	// ones in the high half
+	const __m128i top = _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i *)top0), _mm_loadl_epi64((const __m128i *)top1));
+	const __m128i bottom = _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i *)bottom0), _mm_loadl_epi64((const __m128i *)bottom1));
+	const __m128i c00 = _mm_unpacklo_epi8(top, zero);
+	const __m128i c01 = _mm_unpackhi_epi8(top, zero);
+	const __m128i c10 = _mm_unpacklo_epi8(bottom, zero);
+	const __m128i c11 = _mm_unpackhi_epi8(bottom, zero);
+
+	const __m128i ex = _mm_setr_epi16(ex0, ex0, ex0, ex0, ex1, ex1, ex1, ex1);
+	const __m128i ey = _mm_setr_epi16(ey0, ey0, ey0, ey0, ey1, ey1, ey1, ey1);
+
+	const __m128i t1 = _mm_and_si128(_mm_add_epi16(mulFraction(_mm_sub_epi16(c01, c00), ex), c00), mask);
+	const __m128i t2 = _mm_and_si128(_mm_add_epi16(mulFraction(_mm_sub_epi16(c11, c10), ex), c10), mask);
+	const __m128i result = _mm_and_si128(_mm_add_epi16(mulFraction(_mm_sub_epi16(t2, t1), ey), t1), mask);
+
+	_mm_storel_epi64((__m128i *)out, _mm_packus_epi16(result, result));
+}
+
+#elif defined(SCUMMVM_NEON)
+static inline void interpolatePixel(const byte *top, const byte *bottom, int ex, int ey, byte *out) {
+	const int16x8_t t = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(top)));
+	const int16x8_t b = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(bottom)));
+	const int32x4_t c00 = vmovl_s16(vget_low_s16(t));
+	const int32x4_t c01 = vmovl_s16(vget_high_s16(t));
+	const int32x4_t c10 = vmovl_s16(vget_low_s16(b));
+	const int32x4_t c11 = vmovl_s16(vget_high_s16(b));
+	const int32x4_t mask = vdupq_n_s32(0xFF);
+
+	const int32x4_t t1 = vandq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(c01, c00), ex), 16), c00), mask);
+	const int32x4_t t2 = vandq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(c11, c10), ex), 16), c10), mask);
+	const int32x4_t result = vaddq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(t2, t1), ey), 16), t1);
+
+	// Narrowing keeps the low byte of each channel, like the scalar code
+	const uint8x8_t pixel = vreinterpret_u8_s8(vmovn_s16(vcombine_s16(vmovn_s32(result), vdup_n_s16(0))));
+	vst1_lane_u32((uint32_t *)out, vreinterpret_u32_u8(pixel), 0);
+}
+
+/**
+ * Interpolate two pixels between their four neighbours each, rounding like
+ * the scalar code. top points to the upper left and bottom to the lower
+ * left neighbour, which are followed by the right ones. ex and ey are the
+ * 16-bit fractional parts of the source position.
+ */
+static inline void interpolatePixels(const byte *top0, const byte *bottom0, int ex0, int ey0,
+                                     const byte *top1, const byte *bottom1, int ex1, int ey1, byte *out) {
+	interpolatePixel(top0, bottom0, ex0, ey0, out);
+	interpolatePixel(top1, bottom1, ex1, ey1, out + 4);
+}
+#endif
+#endif
+
 template <TFilteringMode filteringMode>
 TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transform) const {
 
@@ -838,6 +1207,24 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 			}
 
 			if (filteringMode == FILTER_BILINEAR) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+				// Interpolate two pixels at once when both are inside
+				if (!flipx && !flipy && x + 1 < dstW) {
+					const int dx1 = (sdx + icosx) >> 16;
+					const int dy1 = (sdy + isiny) >> 16;
+					if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh) &&
+					    (dx1 > -1) && (dy1 > -1) && (dx1 < sw) && (dy1 < sh)) {
+						interpolatePixels((const byte *)getBasePtr(dx, dy), (const byte *)getBasePtr(dx, dy + 1), sdx & 0xffff, sdy & 0xffff,
+						                  (const byte *)getBasePtr(dx1, dy1), (const byte *)getBasePtr(dx1, dy1 + 1), (sdx + icosx) & 0xffff, (sdy + isiny) & 0xffff,
+						                  (byte *)pc);
+						sdx += 2 * icosx;
+						sdy += 2 * isiny;
+						pc += 2;
+						x++;
+						continue;
+					}
+				}
+#endif
 				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
 					const tColorRGBA *sp = (const tColorRGBA *)getBasePtr(dx, dy);
 					tColorRGBA c00, c01, c10, c11, cswap;
@@ -966,7 +1353,26 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 		for (int y = 0; y < dstH; y++) {
 			const tColorRGBA *csp = sp;
 			csax = sax;
-			for (int x = 0; x < dstW; x++) {
+			int x = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			// Interpolate two pixels at once, as long as they have a right
+			// neighbour
+			if (!flipx && !flipy) {
+				const tColorRGBA *bottom = csp + ((*csay >> 16) < spixelh ? spixelgap : 0);
+				const int ey = *csay & 0xffff;
+				for (; x + 1 < dstW && (sax[x + 1] >> 16) < spixelw; x += 2) {
+					const int cx0 = sax[x] >> 16;
+					const int cx1 = sax[x + 1] >> 16;
+					interpolatePixels((const byte *)(csp + cx0), (const byte *)(bottom + cx0), sax[x] & 0xffff, ey,
+					                  (const byte *)(csp + cx1), (const byte *)(bottom + cx1), sax[x + 1] & 0xffff, ey,
+					                  (byte *)dp);
+					dp += 2;
+				}
+				sp = csp + (sax[x] >> 16);
+				csax = sax + x;
+			}
+#endif
+			for (; x < dstW; x++) {
 				/*
 				* Setup color source pointers
 				*/
@@ -83,6 +83,9 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/endian.h"
+#include "common/simd.h"
+#include "common/util.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -196,37 +199,317 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
-template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+#if defined(SCUMMVM_SIMD) && defined(SCUMM_LITTLE_ENDIAN)
+#define YUV_TO_RGB_SIMD
+
+#pragma mark -
+
+/*
+ * The SIMD kernels convert eight pixels at a time. Instead of looking up the
+ * chroma contributions and the clipped color components in the tables, they
+ * compute them with fixed point math, which gives the same results as the
+ * tables for all possible inputs.
+ */
+
+// Fractional parts of the chroma factors (1.401, 0.714, 0.344 and 1.773),
+// scaled by 2^16
+static const uint16 kCrRFraction = 26302;
+static const uint16 kCrGFraction = 46767;
+static const uint16 kCbGFraction = 22571;
+static const uint16 kCbBFraction = 50686;
+
+// Slightly more than 36 / 219 scaled by 2^16, so that t + t * 36 / 219
+// rounds down like t * 255 / 219 for all t in [0, 219]
+static const uint16 kITUFraction = 10775;
+
+#if defined(SCUMMVM_SSE2)
+typedef __m128i Lanes;
+
+static inline Lanes vSplat(int16 a) { return _mm_set1_epi16(a); }
+static inline Lanes vAdd(Lanes a, Lanes b) { return _mm_add_epi16(a, b); }
+static inline Lanes vSub(Lanes a, Lanes b) { return _mm_sub_epi16(a, b); }
+static inline Lanes vMin(Lanes a, Lanes b) { return _mm_min_epi16(a, b); }
+static inline Lanes vMax(Lanes a, Lanes b) { return _mm_max_epi16(a, b); }
+
+/** (a * b) >> 16 for unsigned a */
+static inline Lanes vMulFraction(Lanes a, uint16 b) {
+	return _mm_mulhi_epu16(a, _mm_set1_epi16((int16)b));
+}
+
+/** Negate the lanes where sign is -1 */
+static inline Lanes vApplySign(Lanes a, Lanes sign) {
+	return _mm_sub_epi16(_mm_xor_si128(a, sign), sign);
+}
+
+static inline Lanes vSign(Lanes a) { return _mm_srai_epi16(a, 15); }
+
+/** Load eight bytes */
+static inline Lanes loadBytes(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+/** Repeat each lane twice, giving the first and the last four lanes as eight */
+static inline void vDuplicate(Lanes a, Lanes &low, Lanes &high) {
+	low = _mm_unpacklo_epi16(a, a);
+	high = _mm_unpackhi_epi16(a, a);
+}
+
+/**
+ * Shift counts and alpha bits for storing pixels in a given format. 32-bit
+ * pixels are put together as two 16-bit halves, since shifting a component
+ * to the left by more than 15 bits, or to the right, moves it entirely into,
+ * or partially out of, the high half. Shifting by 16 or more gives zero.
+ */
+struct PixelPacker {
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;
+	__m128i rHighLeft, gHighLeft, bHighLeft;
+	__m128i rHighRight, gHighRight, bHighRight;
+	__m128i alpha16, alphaLow, alphaHigh;
+
+	static __m128i highLeft(int shift) { return _mm_cvtsi32_si128(shift >= 16 ? shift - 16 : 16); }
+	static __m128i highRight(int shift) { return _mm_cvtsi32_si128(shift >= 16 ? 16 : 16 - shift); }
+
+	PixelPacker(const PixelFormat &format) :
+		rLoss(_mm_cvtsi32_si128(format.rLoss)), gLoss(_mm_cvtsi32_si128(format.gLoss)), bLoss(_mm_cvtsi32_si128(format.bLoss)),
+		rShift(_mm_cvtsi32_si128(format.rShift)), gShift(_mm_cvtsi32_si128(format.gShift)), bShift(_mm_cvtsi32_si128(format.bShift)),
+		rHighLeft(highLeft(format.rShift)), gHighLeft(highLeft(format.gShift)), bHighLeft(highLeft(format.bShift)),
+		rHighRight(highRight(format.rShift)), gHighRight(highRight(format.gShift)), bHighRight(highRight(format.bShift)) {
+		const uint32 alpha = format.RGBToColor(0, 0, 0);
+		alpha16 = _mm_set1_epi16((int16)alpha);
+		alphaLow = _mm_set1_epi16((int16)(alpha & 0xFFFF));
+		alphaHigh = _mm_set1_epi16((int16)(alpha >> 16));
+	}
+};
+
+static inline void storePixels(uint16 *dst, Lanes r, Lanes g, Lanes b, const PixelPacker &packer) {
+	__m128i pixels = packer.alpha16;
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(r, packer.rLoss), packer.rShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(g, packer.gLoss), packer.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, packer.bLoss), packer.bShift));
+	_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+static inline void storePixels(uint32 *dst, Lanes r, Lanes g, Lanes b, const PixelPacker &packer) {
+	r = _mm_srl_epi16(r, packer.rLoss);
+	g = _mm_srl_epi16(g, packer.gLoss);
+	b = _mm_srl_epi16(b, packer.bLoss);
+
+	__m128i low = packer.alphaLow;
+	low = _mm_or_si128(low, _mm_sll_epi16(r, packer.rShift));
+	low = _mm_or_si128(low, _mm_sll_epi16(g, packer.gShift));
+	low = _mm_or_si128(low, _mm_sll_epi16(b, packer.bShift));
+
+	__m128i high = packer.alphaHigh;
+	high = _mm_or_si128(high, _mm_or_si128(_mm_sll_epi16(r, packer.rHighLeft), _mm_srl_epi16(r, packer.rHighRight)));
+	high = _mm_or_si128(high, _mm_or_si128(_mm_sll_epi16(g, packer.gHighLeft), _mm_srl_epi16(g, packer.gHighRight)));
+	high = _mm_or_si128(high, _mm_or_si128(_mm_sll_epi16(b, packer.bHighLeft), _mm_srl_epi16(b, packer.bHighRight)));
+
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(low, high));
+}
+
+#elif defined(SCUMMVM_NEON)
+typedef int16x8_t Lanes;
+
+static inline Lanes vSplat(int16 a) { return vdupq_n_s16(a); }
+static inline Lanes vAdd(Lanes a, Lanes b) { return vaddq_s16(a, b); }
+static inline Lanes vSub(Lanes a, Lanes b) { return vsubq_s16(a, b); }
+static inline Lanes vMin(Lanes a, Lanes b) { return vminq_s16(a, b); }
+static inline Lanes vMax(Lanes a, Lanes b) { return vmaxq_s16(a, b); }
+
+/** (a * b) >> 16 for unsigned a */
+static inline Lanes vMulFraction(Lanes a, uint16 b) {
+	const uint16x8_t ua = vreinterpretq_u16_s16(a);
+	const uint16x4_t ub = vdup_n_u16(b);
+	return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(ua), ub), 16),
+	                                          vshrn_n_u32(vmull_u16(vget_high_u16(ua), ub), 16)));
+}
+
+/** Negate the lanes where sign is -1 */
+static inline Lanes vApplySign(Lanes a, Lanes sign) {
+	return vsubq_s16(veorq_s16(a, sign), sign);
+}
+
+static inline Lanes vSign(Lanes a) { return vshrq_n_s16(a, 15); }
+
+/** Load eight bytes */
+static inline Lanes loadBytes(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+/** Repeat each lane twice, giving the first and the last four lanes as eight */
+static inline void vDuplicate(Lanes a, Lanes &low, Lanes &high) {
+	const int16x8x2_t zipped = vzipq_s16(a, a);
+	low = zipped.val[0];
+	high = zipped.val[1];
+}
+
+/** Shift counts and alpha bits for storing pixels in a given format */
+struct PixelPacker {
+	int16x8_t rLoss16, gLoss16, bLoss16;
+	int16x8_t rShift16, gShift16, bShift16;
+	int32x4_t rLoss32, gLoss32, bLoss32;
+	int32x4_t rShift32, gShift32, bShift32;
+	uint16x8_t alpha16;
+	uint32x4_t alpha32;
+
+	// Right shifts are left shifts by negative counts
+	PixelPacker(const PixelFormat &format) :
+		rLoss16(vdupq_n_s16(-format.rLoss)), gLoss16(vdupq_n_s16(-format.gLoss)), bLoss16(vdupq_n_s16(-format.bLoss)),
+		rShift16(vdupq_n_s16(format.rShift)), gShift16(vdupq_n_s16(format.gShift)), bShift16(vdupq_n_s16(format.bShift)),
+		rLoss32(vdupq_n_s32(-format.rLoss)), gLoss32(vdupq_n_s32(-format.gLoss)), bLoss32(vdupq_n_s32(-format.bLoss)),
+		rShift32(vdupq_n_s32(format.rShift)), gShift32(vdupq_n_s32(format.gShift)), bShift32(vdupq_n_s32(format.bShift)),
+		alpha16(vdupq_n_u16(format.RGBToColor(0, 0, 0))), alpha32(vdupq_n_u32(format.RGBToColor(0, 0, 0))) {}
+};
+
+static inline void storePixels(uint16 *dst, Lanes r, Lanes g, Lanes b, const PixelPacker &packer) {
+	uint16x8_t pixels = packer.alpha16;
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(r), packer.rLoss16), packer.rShift16));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(g), packer.gLoss16), packer.gShift16));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(b), packer.bLoss16), packer.bShift16));
+	vst1q_u16(dst, pixels);
+}
+
+static inline uint32x4_t packPixels32(uint16x4_t r, uint16x4_t g, uint16x4_t b, const PixelPacker &packer) {
+	uint32x4_t pixels = packer.alpha32;
+	pixels = vorrq_u32(pixels, vshlq_u32(vshlq_u32(vmovl_u16(r), packer.rLoss32), packer.rShift32));
+	pixels = vorrq_u32(pixels, vshlq_u32(vshlq_u32(vmovl_u16(g), packer.gLoss32), packer.gShift32));
+	pixels = vorrq_u32(pixels, vshlq_u32(vshlq_u32(vmovl_u16(b), packer.bLoss32), packer.bShift32));
+	return pixels;
+}
+
+static inline void storePixels(uint32 *dst, Lanes r, Lanes g, Lanes b, const PixelPacker &packer) {
+	const uint16x8_t ur = vreinterpretq_u16_s16(r);
+	const uint16x8_t ug = vreinterpretq_u16_s16(g);
+	const uint16x8_t ub = vreinterpretq_u16_s16(b);
+	vst1q_u32(dst, packPixels32(vget_low_u16(ur), vget_low_u16(ug), vget_low_u16(ub), packer));
+	vst1q_u32(dst + 4, packPixels32(vget_high_u16(ur), vget_high_u16(ug), vget_high_u16(ub), packer));
+}
+#endif
+
+/**
+ * The chroma contribution (int16)(factor * c), like in the color tables, with
+ * factor = whole + fraction / 2^16.
+ */
+static inline Lanes chromaContribution(Lanes c, uint16 fraction, bool whole) {
+	const Lanes sign = vSign(c);
+	const Lanes magnitude = vApplySign(c, sign);
+	Lanes product = vMulFraction(magnitude, fraction);
+	if (whole)
+		product = vAdd(product, magnitude);
+	return vApplySign(product, sign);
+}
+
+/**
+ * The color component for luminance y, like in the rgbToPix tables. With the
+ * ITU luminance scale, the chroma contribution must already be reduced by 16.
+ */
+static inline Lanes colorComponent(Lanes y, Lanes chroma, bool itu) {
+	const Lanes c = vAdd(y, chroma);
+	if (itu) {
+		const Lanes t = vMin(vMax(c, vSplat(0)), vSplat(219));
+		return vAdd(t, vMulFraction(t, kITUFraction));
+	}
+	return vMin(vMax(c, vSplat(0)), vSplat(255));
+}
+
+/** Convert eight pixels with the given chroma contributions */
+template<typename PixelInt, bool itu>
+static inline void convertPixels(PixelInt *dst, const byte *ySrc, Lanes r, Lanes g, Lanes b, const PixelPacker &packer) {
+	const Lanes y = loadBytes(ySrc);
+	storePixels(dst, colorComponent(y, r, itu), colorComponent(y, g, itu), colorComponent(y, b, itu), packer);
+}
+
+/**
+ * Convert as many pixels as possible of one or two rows sharing the same
+ * chroma values, eight chroma values at a time.
+ * @return the number of pixels converted in each row
+ */
+template<typename PixelInt, bool halfChroma, bool itu>
+static int convertRowsSIMD(byte *dstPtr, int dstPitch, const PixelFormat &format, const byte *ySrc, int yPitch, int rows, const byte *uSrc, const byte *vSrc, int width) {
+	const PixelPacker packer(format);
+	const int step = halfChroma ? 16 : 8;
+
+	int x = 0;
+	for (; x + step <= width; x += step) {
+		const Lanes cb = vSub(loadBytes(uSrc + x / (step / 8)), vSplat(128));
+		const Lanes cr = vSub(loadBytes(vSrc + x / (step / 8)), vSplat(128));
+
+		const Lanes bias = vSplat(itu ? 16 : 0);
+		const Lanes r = vSub(chromaContribution(cr, kCrRFraction, true), bias);
+		const Lanes g = vSub(vSub(vSplat(0), bias), vAdd(chromaContribution(cr, kCrGFraction, false), chromaContribution(cb, kCbGFraction, false)));
+		const Lanes b = vSub(chromaContribution(cb, kCbBFraction, true), bias);
+
+		if (halfChroma) {
+			Lanes rLow, rHigh, gLow, gHigh, bLow, bHigh;
+			vDuplicate(r, rLow, rHigh);
+			vDuplicate(g, gLow, gHigh);
+			vDuplicate(b, bLow, bHigh);
+
+			for (int row = 0; row < rows; row++) {
+				PixelInt *dst = (PixelInt *)(dstPtr + row * dstPitch) + x;
+				const byte *y = ySrc + row * yPitch + x;
+				convertPixels<PixelInt, itu>(dst, y, rLow, gLow, bLow, packer);
+				convertPixels<PixelInt, itu>(dst + 8, y + 8, rHigh, gHigh, bHigh, packer);
+			}
+		} else {
+			for (int row = 0; row < rows; row++)
+				convertPixels<PixelInt, itu>((PixelInt *)(dstPtr + row * dstPitch) + x, ySrc + row * yPitch + x, r, g, b, packer);
+		}
+	}
+	return x;
+}
+
+#pragma mark -
+#endif
+
+/**
+ * Convert one row, or two rows sharing the same chroma values.
+ *
+ * @param halfChroma whether there is one chroma value for every two pixels
+ */
+template<typename PixelInt, bool halfChroma>
+static void convertYUVRows(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, int yPitch, int rows, const byte *uSrc, const byte *vSrc, int width) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const int step = halfChroma ? 2 : 1;
 
-	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
+	int x = 0;
+#ifdef YUV_TO_RGB_SIMD
+	if (lookup->getScale() == YUVToRGBManager::kScaleITU)
+		x = convertRowsSIMD<PixelInt, halfChroma, true>(dstPtr, dstPitch, lookup->getFormat(), ySrc, yPitch, rows, uSrc, vSrc, width);
+	else
+		x = convertRowsSIMD<PixelInt, halfChroma, false>(dstPtr, dstPitch, lookup->getFormat(), ySrc, yPitch, rows, uSrc, vSrc, width);
+#endif
+
+	for (; x < width; x += step) {
+		const uint32 *L;
+
+		const byte u = uSrc[x / step];
+		const byte v = vSrc[x / step];
+		int16 cr_r  = Cr_r_tab[v];
+		int16 crb_g = Cr_g_tab[v] + Cb_g_tab[u];
+		int16 cb_b  = Cb_b_tab[u];
+
+		for (int row = 0; row < rows; row++) {
+			for (int i = 0; i < step; i++) {
+				PUT_PIXEL(ySrc[row * yPitch + x + i], dstPtr + row * dstPitch + (x + i) * sizeof(PixelInt));
+			}
 		}
-
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
-		uSrc += uvPitch - yWidth;
-		vSrc += uvPitch - yWidth;
 	}
 }
 
+template<typename PixelInt>
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h++)
+		convertYUVRows<PixelInt, false>(dstPtr + h * dstPitch, dstPitch, lookup, colorTab, ySrc + h * yPitch, yPitch, 1, uSrc + h * uvPitch, vSrc + h * uvPitch, yWidth);
+}
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -244,40 +527,11 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 template<typename PixelInt>
 void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
-
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-		}
-
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+	// Each row of chroma values is shared by two rows of pixels, which are
+	// converted together
+	for (int h = 0; h < yHeight; h += 2) {
+		const int uvOffset = (h >> 1) * uvPitch;
+		convertYUVRows<PixelInt, true>(dstPtr + h * dstPitch, dstPitch, lookup, colorTab, ySrc + h * yPitch, yPitch, 2, uSrc + uvOffset, vSrc + uvOffset, yWidth);
 	}
 }
 
@@ -304,67 +558,46 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	byte prefix##C = ptr[index + uvPitch]; \
 	byte prefix##D = ptr[index + uvPitch + 1]
 
-#define DO_INTERPOLATION(out) \
-	out = (out##A * (4 - xDiff) * (4 - yDiff) + out##B * xDiff * (4 - yDiff) + \
-			out##C * yDiff * (4 - xDiff) + out##D * xDiff * yDiff) >> 4
-
-#define DO_YUV410_PIXEL() \
-	DO_INTERPOLATION(u); \
-	DO_INTERPOLATION(v); \
-	\
-	cr_r  = Cr_r_tab[v]; \
-	crb_g = Cr_g_tab[v] + Cb_g_tab[u]; \
-	cb_b  = Cb_b_tab[u]; \
-	\
-	PUT_PIXEL(*ySrc, dstPtr); \
-	dstPtr += sizeof(PixelInt); \
-	\
-	ySrc++; \
-	xDiff++
+#define DO_INTERPOLATION(prefix) \
+	((prefix##A * (4 - xDiff) * (4 - yDiff) + prefix##B * xDiff * (4 - yDiff) + \
+	  prefix##C * yDiff * (4 - xDiff) + prefix##D * xDiff * yDiff) >> 4)
 
 template<typename PixelInt>
 void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	int quarterWidth = yWidth >> 2;
+	// The chroma values are interpolated into these buffers, and converted
+	// like YUV444 afterwards
+	enum { kChunkSize = 256 };
+	byte uChunk[kChunkSize];
+	byte vChunk[kChunkSize];
 
 	for (int y = 0; y < yHeight; y++) {
-		for (int x = 0; x < quarterWidth; x++) {
-			// Perform bilinear interpolation on the the chroma values
-			// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
-			// Feel free to optimize further
-			int targetY = y >> 2;
-			int xDiff = 0;
-			int yDiff = y & 3;
-			int index = targetY * uvPitch + x;
-
-			// Declare some variables for the following macros
-			byte u, v;
-			int16 cr_r, crb_g, cb_b;
-			const uint32 *L;
-
-			READ_QUAD(uSrc, u);
-			READ_QUAD(vSrc, v);
-
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-		}
+		// Perform bilinear interpolation on the the chroma values
+		// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
+		const int targetY = y >> 2;
+		const int yDiff = y & 3;
 
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
+		for (int chunk = 0; chunk < yWidth; chunk += kChunkSize) {
+			const int chunkWidth = MIN<int>(kChunkSize, yWidth - chunk);
+
+			for (int i = 0; i < chunkWidth; i += 4) {
+				const int index = targetY * uvPitch + (chunk + i) / 4;
+
+				READ_QUAD(uSrc, u);
+				READ_QUAD(vSrc, v);
+
+				for (int xDiff = 0; xDiff < 4; xDiff++) {
+					uChunk[i + xDiff] = DO_INTERPOLATION(u);
+					vChunk[i + xDiff] = DO_INTERPOLATION(v);
+				}
+			}
+
+			convertYUVRows<PixelInt, false>(dstPtr + y * dstPitch + chunk * sizeof(PixelInt), dstPitch, lookup, colorTab, ySrc + y * yPitch + chunk, yPitch, 1, uChunk, vChunk, chunkWidth);
+		}
 	}
 }
 
 #undef READ_QUAD
 #undef DO_INTERPOLATION
-#undef DO_YUV410_PIXEL
 
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
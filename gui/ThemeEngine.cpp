@@ -162,13 +162,37 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 	{kDDSeparator,                  "separator",    kDrawLayerBackground,   kDDNone},
 };
 
+struct ThemeEngine::RenderCacheEntry {
+	Graphics::VectorRenderer::ColorState colors; ///< Colors of the renderer before drawing
+	Graphics::Surface background;                ///< Pixels before drawing the steps
+	Graphics::Surface rendered;                  ///< Pixels after drawing the steps
+};
+
+/** Maximum size of the pixels kept by ThemeEngine::drawDDSteps(), in bytes */
+static const uint kMaxRenderCacheSize = 4 * 1024 * 1024;
+
+static bool equalPixels(const Graphics::Surface &a, const Graphics::Surface &b) {
+	const byte *pixelsA = (const byte *)a.getPixels();
+	const byte *pixelsB = (const byte *)b.getPixels();
+	const uint rowSize = a.w * a.format.bytesPerPixel;
+
+	for (int y = 0; y < a.h; y++) {
+		if (memcmp(pixelsA, pixelsB, rowSize))
+			return false;
+		pixelsA += a.pitch;
+		pixelsB += b.pitch;
+	}
+
+	return true;
+}
+
 /**********************************************************
  * ThemeEngine class
  *********************************************************/
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(0), _vectorRenderer(0),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_font(0), _renderCacheSize(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(0) {
 
 	_system = g_system;
@@ -216,6 +240,8 @@ ThemeEngine::~ThemeEngine() {
 	_vectorRenderer = 0;
 	_screen.free();
 	_backBuffer.free();
+	_savedBackBuffer.free();
+	clearRenderCache();
 
 	unloadTheme();
 
@@ -435,6 +461,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_screen.free();
 	_screen.create(width, height, _overlayFormat);
 
+	_savedBackBuffer.free();
+	clearRenderCache();
+
 	delete _vectorRenderer;
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
@@ -727,6 +756,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	clearRenderCache();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = 0;
@@ -865,6 +896,8 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		extendedRect.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
 	}
 
+	const Common::Rect cacheArea = extendedRect;
+
 	if (!_clip.isEmpty()) {
 		extendedRect.clip(_clip);
 	}
@@ -873,13 +906,88 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
+		drawDDSteps(type, area, cacheArea, dynamic);
+		addDirtyRect(extendedRect);
+	}
+}
+
+void ThemeEngine::drawDDSteps(DrawData type, const Common::Rect &area, const Common::Rect &cacheArea, uint32 dynamic) {
+	const WidgetDrawData *drawData = _widgets[type];
+	Graphics::TransparentSurface *surface = _vectorRenderer->getActiveSurface();
+	Common::List<Graphics::DrawStep>::const_iterator step;
+
+	// The result of the steps only depends on the size of the area, the
+	// colors they do not set themselves and the pixels they are drawn over,
+	// as long as they are not clipped.
+	bool cacheable = !cacheArea.isEmpty() && Common::Rect(surface->w, surface->h).contains(cacheArea) &&
+	                 (_clip.isEmpty() || _clip.contains(cacheArea));
+
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end() && cacheable; ++step) {
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE)
+			cacheable = false;
+	}
+
+	const uint size = cacheArea.width() * cacheArea.height() * surface->format.bytesPerPixel * 2;
+	if (!cacheable || size > kMaxRenderCacheSize / 4) {
 		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
 			_vectorRenderer->drawStepClip(area, _clip, *step, dynamic);
 		}
+		return;
+	}
 
-		addDirtyRect(extendedRect);
+	RenderCacheKey key;
+	key.type = type;
+	key.width = cacheArea.width();
+	key.height = cacheArea.height();
+	key.xParity = cacheArea.left & 1;
+	key.dynamic = dynamic;
+
+	Graphics::VectorRenderer::ColorState colors;
+	_vectorRenderer->getColorState(colors);
+
+	const Graphics::Surface pixels = surface->getSubArea(cacheArea);
+	RenderCacheEntry *entry = _renderCache.getVal(key, 0);
+
+	if (entry && entry->colors == colors && equalPixels(pixels, entry->background)) {
+		surface->copyRectToSurface(entry->rendered, cacheArea.left, cacheArea.top, Common::Rect(entry->rendered.w, entry->rendered.h));
+
+		// Leave the renderer as if the steps had been drawn
+		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+			_vectorRenderer->setStepState(*step, dynamic);
+		}
+		return;
+	}
+
+	if (entry) {
+		_renderCacheSize -= size;
+	} else {
+		if (_renderCacheSize + size > kMaxRenderCacheSize)
+			clearRenderCache();
+
+		entry = new RenderCacheEntry();
+		_renderCache[key] = entry;
+	}
+
+	entry->colors = colors;
+	entry->background.copyFrom(pixels);
+
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+		_vectorRenderer->drawStepClip(area, _clip, *step, dynamic);
+	}
+
+	entry->rendered.copyFrom(pixels);
+	_renderCacheSize += size;
+}
+
+void ThemeEngine::clearRenderCache() {
+	for (RenderCache::iterator i = _renderCache.begin(); i != _renderCache.end(); ++i) {
+		RenderCacheEntry *entry = i->_value;
+		entry->background.free();
+		entry->rendered.free();
+		delete entry;
 	}
+	_renderCache.clear();
+	_renderCacheSize = 0;
 }
 
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::String &text,
@@ -1293,6 +1401,18 @@ void ThemeEngine::copyBackBufferToScreen() {
 	memcpy(_screen.getPixels(), _backBuffer.getPixels(), _screen.pitch * _screen.h);
 }
 
+void ThemeEngine::saveBackBuffer() {
+	_savedBackBuffer.copyFrom(_backBuffer);
+}
+
+bool ThemeEngine::restoreBackBuffer() {
+	if (!_savedBackBuffer.getPixels() || _savedBackBuffer.w != _backBuffer.w || _savedBackBuffer.h != _backBuffer.h)
+		return false;
+
+	memcpy(_backBuffer.getPixels(), _savedBackBuffer.getPixels(), _backBuffer.pitch * _backBuffer.h);
+	return true;
+}
+
 void ThemeEngine::updateScreen() {
 #ifdef LAYOUT_DEBUG_DIALOG
 	_vectorRenderer->fillSurface();
@@ -155,6 +155,28 @@ protected:
 	typedef Common::HashMap<Common::String, Graphics::Surface *> ImagesMap;
 	typedef Common::HashMap<Common::String, Graphics::TransparentSurface *> AImagesMap;
 
+	/** Identifies a rendering of a DrawData, which can be reused by drawDD(). */
+	struct RenderCacheKey {
+		DrawData type;
+		int width, height;
+		int xParity;        ///< Gradients are dithered depending on the x position
+		uint32 dynamic;
+
+		bool operator==(const RenderCacheKey &key) const {
+			return type == key.type && width == key.width && height == key.height &&
+			       xParity == key.xParity && dynamic == key.dynamic;
+		}
+	};
+
+	struct RenderCacheKey_Hash {
+		uint operator()(const RenderCacheKey &key) const {
+			return key.type ^ (key.width << 8) ^ (key.height << 20) ^ ((uint)key.xParity << 31) ^ (key.dynamic * 0x9E3779B1);
+		}
+	};
+
+	struct RenderCacheEntry;
+	typedef Common::HashMap<RenderCacheKey, RenderCacheEntry *, RenderCacheKey_Hash> RenderCache;
+
 	friend class GUI::Dialog;
 	friend class GUI::GuiObject;
 
@@ -350,6 +372,20 @@ public:
 	 */
 	void copyBackBufferToScreen();
 
+	/**
+	 * Keeps a copy of the backbuffer surface, so it can be brought back
+	 * with restoreBackBuffer() instead of drawing it again.
+	 */
+	void saveBackBuffer();
+
+	/**
+	 * Restores the backbuffer surface from the copy kept by saveBackBuffer().
+	 *
+	 * @return false if there is no copy, e.g. because the screen changed
+	 *         since then.
+	 */
+	bool restoreBackBuffer();
+
 
 	/** @name FONT MANAGEMENT METHODS */
 	//@{
@@ -635,6 +671,17 @@ protected:
 	                const Common::Rect &drawableTextArea = Common::Rect(0, 0, 0, 0));
 	void drawBitmap(const Graphics::Surface *bitmap, const Common::Rect &clippingRect, bool alpha);
 
+	/**
+	 * Draws the steps of a DrawData into the given area of the active surface,
+	 * reusing the pixels of a previous identical rendering when possible.
+	 *
+	 * @param cacheArea Area of the surface affected by the steps.
+	 */
+	void drawDDSteps(DrawData type, const Common::Rect &area, const Common::Rect &cacheArea, uint32 dynamic);
+
+	/** Flushes all the renderings kept by drawDDSteps(). */
+	void clearRenderCache();
+
 	/**
 	 * DEBUG: Draws a white square and writes some text next to it.
 	 */
@@ -718,6 +765,16 @@ protected:
 	/** List of all the dirty screens that must be blitted to the overlay. */
 	Common::List<Common::Rect> _dirtyScreen;
 
+	/**
+	 * Renderings of DrawData steps kept for drawDDSteps(), flushed whenever
+	 * the theme or the screen surfaces change.
+	 */
+	RenderCache _renderCache;
+	uint _renderCacheSize; ///< Size of all the pixels in _renderCache, in bytes
+
+	/** Copy of the backbuffer, see saveBackBuffer() */
+	Graphics::Surface _savedBackBuffer;
+
 	bool _initOk;  ///< Class and renderer properly initialized
 	bool _themeOk; ///< Theme data successfully loaded.
 	bool _enabled; ///< Whether the Theme is currently shown on the overlay
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/file.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
@@ -34,6 +35,8 @@
 #include "common/stream.h"
 #endif
 
+#include "audio/mixer.h"
+
 #include "engines/engine.h"
 
 #include "gui/debugger.h"
@@ -77,6 +80,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("audio_stats",		WRAP_METHOD(Debugger, cmdAudioStats));
 }
 
 Debugger::~Debugger() {
@@ -606,6 +611,68 @@ bool Debugger::cmdOpenLog(int argc, const char **argv) {
 	return true;
 }
 
+static const char *const soundTypeNames[] = { "plain", "music", "sfx", "speech" };
+
+bool Debugger::cmdAudioStats(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+	if (!mixer) {
+		debugPrintf("No mixer\n");
+		return true;
+	}
+
+	if (argc >= 2 && (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))) {
+		mixer->enableChannelStats(!strcmp(argv[1], "on"));
+		debugPrintf("Audio statistics %s\n", mixer->isChannelStatsEnabled() ? "enabled" : "disabled");
+		return true;
+	}
+
+	if (!mixer->isChannelStatsEnabled())
+		debugPrintf("Audio statistics are disabled, enable them with 'audio_stats on'\n");
+
+	Audio::Mixer::ChannelStats stats[32];
+	const uint count = mixer->getChannelStats(stats, ARRAYSIZE(stats));
+
+	if (argc >= 2) {
+		// Dump the statistics as CSV, for processing with external tools
+		Common::DumpFile out;
+		if (!out.open(argv[1])) {
+			debugPrintf("Could not open '%s' for writing\n", argv[1]);
+			return true;
+		}
+
+		out.writeString("id,type,rate,channels,paused,render_ms,samples,underruns\n");
+		for (uint i = 0; i < count; i++) {
+			const Audio::Mixer::ChannelStats &s = stats[i];
+			out.writeString(Common::String::format("%d,%s,%u,%d,%d,%u,%u,%u\n",
+				s.id, soundTypeNames[s.type], s.rate, s.stereo ? 2 : 1, s.paused ? 1 : 0,
+				s.renderTime, s.samplesRead, s.underruns));
+		}
+		out.finalize();
+		out.close();
+
+		debugPrintf("Wrote statistics of %u channels to '%s'\n", count, argv[1]);
+		return true;
+	}
+
+	if (!count) {
+		debugPrintf("No active audio channels\n");
+		return true;
+	}
+
+	// The cost is the render time per second of audio produced
+	debugPrintf("   id  type    rate ch  render ms   samples  underruns  cost\n");
+	for (uint i = 0; i < count; i++) {
+		const Audio::Mixer::ChannelStats &s = stats[i];
+		const uint32 frames = s.samplesRead / (s.stereo ? 2 : 1);
+		const uint32 cost = frames ? (uint32)((uint64)s.renderTime * s.rate / frames) : 0;
+		debugPrintf("%5d  %-6s %5u %2d  %9u  %8u  %9u  %u ms/s%s\n",
+			s.id, soundTypeNames[s.type], s.rate, s.stereo ? 2 : 1,
+			s.renderTime, s.samplesRead, s.underruns, cost,
+			s.paused ? " (paused)" : "");
+	}
+	return true;
+}
+
 #ifndef DISABLE_MD5
 struct ArchiveMemberLess {
 	bool operator()(const Common::ArchiveMemberPtr &x, const Common::ArchiveMemberPtr &y) const {
@@ -69,6 +69,7 @@ public:
 	virtual int runModal();
 
 	bool	isVisible() const	{ return _visible; }
+	Dialog	*getDialog()		{ return this; }
 
 	void	releaseFocus();
 	void	setFocusWidget(Widget *widget);
@@ -54,7 +54,7 @@ enum {
 };
 
 // Constructor
-GuiManager::GuiManager() : _redrawStatus(kRedrawDisabled), _stateIsSaved(false),
+GuiManager::GuiManager() : _redrawStatus(kRedrawDisabled), _savedBackgroundDialog(0), _stateIsSaved(false),
     _cursorAnimateCounter(0), _cursorAnimateTimer(0) {
 	_theme = 0;
 	_useStdCursor = false;
@@ -223,16 +223,30 @@ void GuiManager::redraw() {
 	if (_redrawStatus == kRedrawOpenDialog && _dialogStack.size() > 3)
 		shading = ThemeEngine::kShadingNone;
 
+	bool backgroundRestored = false;
+
 	switch (_redrawStatus) {
 		case kRedrawCloseDialog:
 		case kRedrawFull:
 		case kRedrawTopDialog:
-			_theme->clearAll();
-			_theme->drawToBackbuffer();
-
-			for (DialogStack::size_type i = 0; i < _dialogStack.size() - 1; i++) {
-				_dialogStack[i]->drawDialog(kDrawLayerBackground);
-				_dialogStack[i]->drawDialog(kDrawLayerForeground);
+			// When only the top dialog changed, the dialogs below it are
+			// brought back as saved by the last full redraw instead of
+			// being drawn again. Only the area of the top dialog then ends
+			// up being dirty.
+			if (_redrawStatus == kRedrawTopDialog && _savedBackgroundDialog == _dialogStack.top())
+				backgroundRestored = _theme->restoreBackBuffer();
+
+			if (backgroundRestored) {
+				// The shading is part of the saved background already
+				shading = ThemeEngine::kShadingNone;
+			} else {
+				_theme->clearAll();
+				_theme->drawToBackbuffer();
+
+				for (DialogStack::size_type i = 0; i < _dialogStack.size() - 1; i++) {
+					_dialogStack[i]->drawDialog(kDrawLayerBackground);
+					_dialogStack[i]->drawDialog(kDrawLayerForeground);
+				}
 			}
 
 			// fall through
@@ -249,6 +263,14 @@ void GuiManager::redraw() {
 			}
 
 			_theme->applyScreenShading(shading);
+
+			if (_redrawStatus == kRedrawOpenDialog) {
+				_savedBackgroundDialog = 0;
+			} else if (!backgroundRestored) {
+				_theme->saveBackBuffer();
+				_savedBackgroundDialog = _dialogStack.top();
+			}
+
 			_dialogStack.top()->drawDialog(kDrawLayerBackground);
 
 			_theme->drawToScreen();
@@ -453,6 +475,7 @@ void GuiManager::openDialog(Dialog *dialog) {
 		getTopDialog()->lostFocus();
 
 	_dialogStack.push(dialog);
+	_savedBackgroundDialog = 0;
 	if (_redrawStatus != kRedrawFull)
 		_redrawStatus = kRedrawOpenDialog;
 
@@ -610,6 +633,20 @@ void GuiManager::scheduleTopDialogRedraw() {
 	_redrawStatus = kRedrawTopDialog;
 }
 
+void GuiManager::markDialogAsDirty(const Dialog *dialog) {
+	if (!_savedBackgroundDialog || _dialogStack.empty() || dialog == _dialogStack.top())
+		return;
+
+	// Changes to the dialogs below the top one only show up when they are
+	// drawn again by a full redraw
+	for (DialogStack::size_type i = 0; i < _dialogStack.size() - 1; i++) {
+		if (_dialogStack[i] == dialog) {
+			_savedBackgroundDialog = 0;
+			return;
+		}
+	}
+}
+
 void GuiManager::giveFocusToDialog(Dialog *dialog) {
 	int16 dialogX = _globalMousePosition.x - dialog->_x;
 	int16 dialogY = _globalMousePosition.y - dialog->_y;
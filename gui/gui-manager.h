@@ -77,6 +77,12 @@ public:
 	void processEvent(const Common::Event &event, Dialog *const activeDialog);
 	void scheduleTopDialogRedraw();
 
+	/**
+	 * Tell the GuiManager that the given dialog has to be drawn again, so
+	 * that it does not restore it from the saved background.
+	 */
+	void markDialogAsDirty(const Dialog *dialog);
+
 	bool isActive() const	{ return ! _dialogStack.empty(); }
 
 	bool loadNewTheme(Common::String id, ThemeEngine::GraphicsMode gfx = ThemeEngine::kGfxDisabled, bool force = false);
@@ -126,6 +132,7 @@ protected:
 
 //	bool		_needRedraw;
 	RedrawStatus _redrawStatus;
+	Dialog		*_savedBackgroundDialog; ///< Top dialog when the dialogs below it were saved, see redraw()
 	int			_lastScreenChangeID;
 	int			_width, _height;
 	DialogStack	_dialogStack;
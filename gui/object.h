@@ -56,6 +56,7 @@ public:
 	}
 };
 
+class Dialog;
 class Widget;
 
 class GuiObject : public CommandReceiver {
@@ -87,6 +88,9 @@ public:
 
 	virtual bool	isVisible() const = 0;
 
+	/** Returns the dialog this object is part of */
+	virtual Dialog	*getDialog() = 0;
+
 	virtual void	reflowLayout();
 
 	virtual void	removeWidget(Widget *widget);
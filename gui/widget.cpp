@@ -90,6 +90,7 @@ void Widget::updateState(int oldFlags, int newFlags) {
 
 void Widget::markAsDirty() {
 	_needsRedraw = true;
+	g_gui.markDialogAsDirty(getDialog());
 
 	Widget *w = _firstWidget;
 	while (w) {
@@ -124,6 +124,8 @@ public:
 	void setNext(Widget *w) { _next = w; }
 	Widget *next() { return _next; }
 
+	virtual Dialog *getDialog() { return _boss->getDialog(); }
+
 	virtual int16	getAbsX() const	{ return _x + _boss->getChildX(); }
 	virtual int16	getAbsY() const	{ return _y + _boss->getChildY(); }
 
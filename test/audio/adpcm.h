@@ -0,0 +1,353 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/adpcm.h"
+#include "audio/audiostream.h"
+
+#include "test/random.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/util.h"
+
+// The ADPCM streams decode whole chunks of data at once. These simple
+// decoders work one nibble at a time, the way the streams used to, and
+// serve as the reference for them.
+
+static const int16 refStepAdjust[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int16 refImaTable[89] = {
+	    7,     8,     9,    10,    11,    12,    13,    14,
+	   16,    17,    19,    21,    23,    25,    28,    31,
+	   34,    37,    41,    45,    50,    55,    60,    66,
+	   73,    80,    88,    97,   107,   118,   130,   143,
+	  157,   173,   190,   209,   230,   253,   279,   307,
+	  337,   371,   408,   449,   494,   544,   598,   658,
+	  724,   796,   876,   963,  1060,  1166,  1282,  1411,
+	 1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,
+	 3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,
+	 7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+	32767
+};
+
+struct RefIMAStatus {
+	RefIMAStatus() : last(0), stepIndex(0) {}
+
+	int32 last;
+	int32 stepIndex;
+
+	int16 decode(byte code) {
+		int32 E = (2 * (code & 0x7) + 1) * refImaTable[stepIndex] / 8;
+		int32 diff = (code & 0x08) ? -E : E;
+		last = CLIP<int32>(last + diff, -32768, 32767);
+		stepIndex = CLIP<int32>(stepIndex + refStepAdjust[code], 0, 88);
+		return last;
+	}
+
+	int16 decodeOKI(byte code) {
+		// The OKI step table is the IMA one starting at 16, up to 1552
+		int16 E = (2 * (code & 0x7) + 1) * refImaTable[stepIndex + 8] / 8;
+		int16 diff = (code & 0x08) ? -E : E;
+		int16 samp = CLIP<int16>(last + diff, -2048, 2047);
+		last = samp;
+		stepIndex = CLIP<int32>(stepIndex + refStepAdjust[code], 0, 48);
+		return samp * 16;
+	}
+};
+
+struct RefMSStatus {
+	int16 delta;
+	int16 coeff1;
+	int16 coeff2;
+	int16 sample1;
+	int16 sample2;
+
+	int16 decode(byte code) {
+		static const int adaptationTable[] = {
+			230, 230, 230, 230, 307, 409, 512, 614,
+			768, 614, 512, 409, 307, 230, 230, 230
+		};
+
+		int32 predictor = (sample1 * coeff1 + sample2 * coeff2) / 256;
+		predictor += (signed)((code & 0x08) ? (code - 0x10) : (code)) * delta;
+		predictor = CLIP<int32>(predictor, -32768, 32767);
+
+		sample2 = sample1;
+		sample1 = predictor;
+		delta = (adaptationTable[(int)code] * delta) >> 8;
+		if (delta < 16)
+			delta = 16;
+
+		return predictor;
+	}
+};
+
+class ADPCMTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	byte *createData(uint32 size) {
+		byte *data = (byte *)malloc(size);
+		_rnd.fill(data, size);
+		return data;
+	}
+
+	/**
+	 * Decode data with the given stream type, reading chunks of varying
+	 * size, and compare the result with the reference.
+	 */
+	void compareTemplate(Audio::ADPCMType type, byte *data, uint32 size, int channels, uint32 blockAlign, const Common::Array<int16> &reference) {
+		static const int chunkSizes[] = { 1, 2, 3, 7, 16, 64, 250, 500, 1024, 4096 };
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+		Audio::SeekableAudioStream *s = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+
+		// Some decoders require whole frames, DK3 even two of them
+		const int frameSize = (type == Audio::kADPCMDK3) ? 4 : channels;
+
+		Common::Array<int16> output;
+		int16 buffer[4096];
+		for (int i = 0; !s->endOfData(); i++) {
+			int chunk = chunkSizes[i % ARRAYSIZE(chunkSizes)];
+			chunk -= chunk % frameSize;
+			if (!chunk)
+				chunk = frameSize;
+
+			const int samples = s->readBuffer(buffer, chunk);
+			TS_ASSERT(samples <= chunk);
+			if (samples <= 0)
+				break;
+
+			for (int j = 0; j < samples; j++)
+				output.push_back(buffer[j]);
+		}
+
+		TS_ASSERT_EQUALS(output.size(), reference.size());
+		TS_ASSERT(output == reference);
+
+		delete s;
+	}
+
+	void okiTemplate(uint32 size) {
+		_rnd.setSeed(size);
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		RefIMAStatus status;
+		for (uint32 i = 0; i < size; i++) {
+			reference.push_back(status.decodeOKI(data[i] >> 4));
+			reference.push_back(status.decodeOKI(data[i] & 0x0f));
+		}
+
+		compareTemplate(Audio::kADPCMOki, data, size, 1, 0, reference);
+	}
+
+	void dviTemplate(uint32 size, int channels) {
+		_rnd.setSeed(size + channels);
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		RefIMAStatus status[2];
+		for (uint32 i = 0; i < size; i++) {
+			reference.push_back(status[0].decode(data[i] >> 4));
+			reference.push_back(status[channels - 1].decode(data[i] & 0x0f));
+		}
+
+		compareTemplate(Audio::kADPCMDVI, data, size, channels, 0, reference);
+	}
+
+	void msImaTemplate(uint32 blocks, int channels, uint32 blockAlign) {
+		_rnd.setSeed(blocks + channels);
+		const uint32 size = blocks * blockAlign;
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		RefIMAStatus status[2];
+		for (uint32 block = 0; block < blocks; block++) {
+			byte *src = data + block * blockAlign;
+			for (int i = 0; i < channels; i++) {
+				WRITE_LE_UINT16(src + 2, _rnd.getRandomNumber(88));
+				status[i].last = (int16)READ_LE_UINT16(src);
+				status[i].stepIndex = READ_LE_UINT16(src + 2);
+				src += 4;
+			}
+
+			for (; src < data + (block + 1) * blockAlign; src += channels * 4) {
+				int16 samples[2][8];
+				for (int i = 0; i < channels; i++) {
+					for (int j = 0; j < 4; j++) {
+						samples[i][j * 2] = status[i].decode(src[i * 4 + j] & 0x0f);
+						samples[i][j * 2 + 1] = status[i].decode(src[i * 4 + j] >> 4);
+					}
+				}
+
+				for (int j = 0; j < 8; j++)
+					for (int i = 0; i < channels; i++)
+						reference.push_back(samples[i][j]);
+			}
+		}
+
+		compareTemplate(Audio::kADPCMMSIma, data, size, channels, blockAlign, reference);
+	}
+
+	void msTemplate(uint32 blocks, int channels, uint32 blockAlign) {
+		static const int16 coeff1[] = { 256, 512, 0, 192, 240, 460, 392 };
+		static const int16 coeff2[] = { 0, -256, 0, 64, 0, -208, -232 };
+
+		_rnd.setSeed(blocks + channels);
+		const uint32 size = blocks * blockAlign;
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		RefMSStatus status[2];
+		for (uint32 block = 0; block < blocks; block++) {
+			byte *src = data + block * blockAlign;
+			for (int i = 0; i < channels; i++) {
+				const byte predictor = CLIP<byte>(src[i], 0, 6);
+				status[i].coeff1 = coeff1[predictor];
+				status[i].coeff2 = coeff2[predictor];
+				WRITE_LE_UINT16(src + channels + i * 2, 16 + _rnd.getRandomNumber(255));
+				status[i].delta = READ_LE_UINT16(src + channels + i * 2);
+				status[i].sample1 = READ_LE_UINT16(src + channels * 3 + i * 2);
+				status[i].sample2 = READ_LE_UINT16(src + channels * 5 + i * 2);
+			}
+
+			for (int i = 0; i < channels; i++)
+				reference.push_back(status[i].sample2);
+			for (int i = 0; i < channels; i++)
+				reference.push_back(status[i].sample1);
+
+			for (src += channels * 7; src < data + (block + 1) * blockAlign; src++) {
+				reference.push_back(status[0].decode(*src >> 4));
+				reference.push_back(status[channels - 1].decode(*src & 0x0f));
+			}
+		}
+
+		compareTemplate(Audio::kADPCMMS, data, size, channels, blockAlign, reference);
+	}
+
+	void appleTemplate(uint32 blocks, int channels, uint32 blockAlign) {
+		_rnd.setSeed(blocks + channels);
+		const uint32 size = blocks * channels * blockAlign;
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		reference.resize(blocks * (blockAlign - 2) * 2 * channels);
+
+		for (int i = 0; i < channels; i++) {
+			RefIMAStatus status;
+			uint32 sample = 0;
+
+			for (uint32 block = 0; block < blocks; block++) {
+				const byte *src = data + (block * channels + i) * blockAlign;
+				const uint16 header = READ_BE_UINT16(src);
+				status.last = (int16)(header & 0xFF80);
+				status.stepIndex = CLIP(header & 0x7F, 0, 88);
+
+				for (uint32 j = 2; j < blockAlign; j++) {
+					reference[channels * sample++ + i] = status.decode(src[j] & 0x0f);
+					reference[channels * sample++ + i] = status.decode(src[j] >> 4);
+				}
+			}
+		}
+
+		compareTemplate(Audio::kADPCMApple, data, size, channels, blockAlign, reference);
+	}
+
+	void dk3Template(uint32 blocks, uint32 blockAlign) {
+		_rnd.setSeed(blockAlign);
+		const uint32 size = blocks * blockAlign;
+		byte *data = createData(size);
+
+		Common::Array<int16> reference;
+		for (uint32 block = 0; block < blocks; block++) {
+			byte *src = data + block * blockAlign;
+			WRITE_LE_UINT16(src + 2, 22050);
+			src[14] = _rnd.getRandomNumber(88);
+			src[15] = _rnd.getRandomNumber(88);
+
+			// A sum and a difference channel, which make up the left and
+			// right channels
+			RefIMAStatus sum, diff;
+			sum.last = (int16)READ_LE_UINT16(src + 10);
+			diff.last = (int16)READ_LE_UINT16(src + 12);
+			sum.stepIndex = src[14];
+			diff.stepIndex = src[15];
+
+			// Every two frames take three nibbles: two sum ones around
+			// a difference one
+			uint32 pos = 16;
+			bool topNibble = false;
+			while (pos + (topNibble ? 1 : 0) < blockAlign) {
+				for (int i = 0; i < 3; i++) {
+					RefIMAStatus &status = (i == 1) ? diff : sum;
+					status.decode(topNibble ? src[pos++] >> 4 : src[pos] & 0x0f);
+					topNibble = !topNibble;
+
+					if (i > 0) {
+						reference.push_back((int16)(sum.last + diff.last));
+						reference.push_back((int16)(sum.last - diff.last));
+					}
+				}
+
+				// A single byte left over in the block only pads it
+				if (!topNibble && pos == blockAlign - 1)
+					pos++;
+			}
+		}
+
+		compareTemplate(Audio::kADPCMDK3, data, size, 2, blockAlign, reference);
+	}
+
+public:
+	void test_oki() {
+		okiTemplate(1);
+		okiTemplate(5000);
+	}
+
+	void test_dvi_mono() {
+		dviTemplate(1, 1);
+		dviTemplate(5000, 1);
+	}
+
+	void test_dvi_stereo() {
+		dviTemplate(5000, 2);
+	}
+
+	void test_ms_ima_mono() {
+		msImaTemplate(10, 1, 512);
+	}
+
+	void test_ms_ima_stereo() {
+		msImaTemplate(10, 2, 1024);
+	}
+
+	void test_ms_mono() {
+		msTemplate(10, 1, 256);
+	}
+
+	void test_ms_stereo() {
+		msTemplate(10, 2, 512);
+	}
+
+	void test_apple_mono() {
+		appleTemplate(20, 1, 34);
+	}
+
+	void test_apple_stereo() {
+		appleTemplate(20, 2, 34);
+	}
+
+	void test_dk3() {
+		// Blocks which end on a whole byte, with a padding byte, and in the
+		// middle of a byte
+		dk3Template(10, 1024);
+		dk3Template(10, 1025);
+		dk3Template(10, 1026);
+	}
+};
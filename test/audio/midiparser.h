@@ -0,0 +1,163 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+
+#include "common/array.h"
+
+class MidiParserTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kPPQN = 96,
+		kTimerRate = 4000,
+		kEvents = 2000,
+		kTimerCalls = 300
+	};
+
+	// Records the events sent
+	class RecordingDriver : public MidiDriver_BASE {
+	public:
+		Common::Array<uint32> _events;
+
+		virtual void send(uint32 b) { _events.push_back(b); }
+	};
+
+	Common::Array<byte> _smf;
+	Common::Array<uint32> _eventTicks;
+	uint32 _lastTick;
+
+	void writeVLQ(uint32 value) {
+		byte bytes[4];
+		int count = 0;
+		do {
+			bytes[count++] = value & 0x7F;
+			value >>= 7;
+		} while (value);
+		while (count--)
+			_smf.push_back(bytes[count] | (count ? 0x80 : 0));
+	}
+
+	void writeTempo(uint32 tempo) {
+		_smf.push_back(0xFF);
+		_smf.push_back(0x51);
+		_smf.push_back(0x03);
+		_smf.push_back(tempo >> 16);
+		_smf.push_back((tempo >> 8) & 0xFF);
+		_smf.push_back(tempo & 0xFF);
+	}
+
+	// A type 0 SMF with notes in running status, controller changes which
+	// break the running status, and tempo changes well after the first
+	// seek checkpoint
+	void createSMF() {
+		static const byte header[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, kPPQN, 'M', 'T', 'r', 'k', 0, 0, 0, 0 };
+		_smf.clear();
+		for (uint i = 0; i < ARRAYSIZE(header); i++)
+			_smf.push_back(header[i]);
+
+		_eventTicks.clear();
+		_lastTick = 0;
+		byte status = 0;
+		for (int i = 0; i < kEvents; i++) {
+			const uint32 delta = (i * 7) % 13;
+			writeVLQ(delta);
+			_lastTick += delta;
+			_eventTicks.push_back(_lastTick);
+
+			if (i == 700) {
+				writeTempo(400000);
+			} else if (i == 1500) {
+				writeTempo(600000);
+			} else if (i % 37 == 0) {
+				_smf.push_back(0xB0 | (i % 3));
+				_smf.push_back(7);
+				_smf.push_back(i % 128);
+				status = 0xB0 | (i % 3);
+			} else {
+				const byte noteOn = 0x90 | (i % 3);
+				if (status != noteOn)
+					_smf.push_back(noteOn);
+				status = noteOn;
+				_smf.push_back(40 + (i / 2) % 40);
+				// Every other event turns the note off again
+				_smf.push_back((i & 1) ? 0 : 100);
+			}
+		}
+
+		writeVLQ(0);
+		_smf.push_back(0xFF);
+		_smf.push_back(0x2F);
+		_smf.push_back(0x00);
+
+		const uint32 trackSize = _smf.size() - ARRAYSIZE(header);
+		WRITE_BE_UINT32(&_smf[ARRAYSIZE(header) - 4], trackSize);
+	}
+
+	MidiParser *createParser(RecordingDriver *driver) {
+		MidiParser *parser = MidiParser::createParser_SMF();
+		TS_ASSERT(parser->loadMusic(&_smf[0], _smf.size()));
+		parser->setMidiDriver(driver);
+		parser->setTimerRate(kTimerRate);
+		return parser;
+	}
+
+	// Jumps to the tick, and records whether that worked, the tick, and the
+	// events which follow, with a 0 after every timer call
+	static bool jumpAndPlay(MidiParser *parser, RecordingDriver *driver, uint32 tempo, uint32 tick, Common::Array<uint32> &result) {
+		parser->setTempo(tempo);
+		const bool jumped = parser->jumpToTick(tick);
+
+		driver->_events.clear();
+		driver->_events.push_back(jumped);
+		driver->_events.push_back(parser->getTick());
+		for (int i = 0; i < kTimerCalls; i++) {
+			parser->onTimer();
+			driver->_events.push_back(0);
+		}
+		result = driver->_events;
+		return jumped;
+	}
+
+public:
+	void test_jump_to_tick_seek_index() {
+		createSMF();
+
+		// Jumps before the first checkpoint, between and onto events, onto
+		// the events with checkpoints, around the tempo changes, backwards,
+		// and past the end
+		const uint32 ticks[] = {
+			_lastTick - 1, 1, 100, 1000, 1001, 4200, 3000, 4300, 9000,
+			_eventTicks[255], _eventTicks[1023], _eventTicks[1023] + 1,
+			_lastTick, 8000, 2, 6000, _lastTick + 1, 5000, 1000
+		};
+		// Tempos in effect when jumping, since events before the first
+		// tempo event of the track are timed by it
+		const uint32 tempos[] = { 500000, 250000 };
+
+		RecordingDriver indexedDriver;
+		MidiParser *indexed = createParser(&indexedDriver);
+
+		for (uint i = 0; i < ARRAYSIZE(ticks); i++) {
+			for (uint j = 0; j < ARRAYSIZE(tempos); j++) {
+				// A new parser has no seek index, so it replays the
+				// track from its start
+				RecordingDriver driver;
+				MidiParser *parser = createParser(&driver);
+				Common::Array<uint32> expected;
+				const bool jumped = jumpAndPlay(parser, &driver, tempos[j], ticks[i], expected);
+				TS_ASSERT_EQUALS(jumped, ticks[i] <= _lastTick);
+				delete parser;
+
+				// Failed jumps keep the state from before, which is not
+				// the same for both parsers
+				Common::Array<uint32> result;
+				TS_ASSERT_EQUALS(jumpAndPlay(indexed, &indexedDriver, tempos[j], ticks[i], result), jumped);
+				if (jumped)
+					TS_ASSERT(result == expected);
+			}
+		}
+
+		delete indexed;
+	}
+};
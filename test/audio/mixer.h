@@ -0,0 +1,143 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+
+#include "test/system.h"
+
+#include "common/util.h"
+
+// A mono stream of silence, which returns at most maxRead samples per read,
+// as if its decoder could not keep up
+class StarvingStream : public Audio::AudioStream {
+public:
+	StarvingStream(int rate, int samples, int maxRead) : _rate(rate), _left(samples), _maxRead(maxRead) {}
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = MIN(MIN(numSamples, _maxRead), _left);
+		memset(buffer, 0, samples * sizeof(int16));
+		_left -= samples;
+		return samples;
+	}
+
+	virtual bool isStereo() const { return false; }
+	virtual int getRate() const { return _rate; }
+	virtual bool endOfData() const { return _left == 0; }
+
+private:
+	const int _rate;
+	int _left;
+	const int _maxRead;
+};
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kRate = 11025,
+		// Sample pairs mixed per pass
+		kPassLength = 100
+	};
+
+	// The mixer locks its mutex and times the channels
+	ScopedTestSystem *_system;
+	Audio::MixerImpl *_mixer;
+
+	void mixPasses(int count) {
+		int16 buffer[kPassLength * 2];
+		for (int i = 0; i < count; i++)
+			_mixer->mixCallback((byte *)buffer, sizeof(buffer));
+	}
+
+	Audio::SoundHandle play(Audio::Mixer::SoundType type, int id, int samples, int maxRead) {
+		// MixerImpl hides the default arguments of Mixer
+		Audio::Mixer &mixer = *_mixer;
+		Audio::SoundHandle handle;
+		mixer.playStream(type, &handle, new StarvingStream(kRate, samples, maxRead), id);
+		return handle;
+	}
+
+public:
+	void setUp() {
+		_system = new ScopedTestSystem();
+		_mixer = new Audio::MixerImpl(kRate);
+		_mixer->setReady(true);
+	}
+
+	void tearDown() {
+		delete _mixer;
+		delete _system;
+	}
+
+	void test_stats() {
+#ifndef ENABLE_EVENTRECORDER
+		TS_ASSERT(!_mixer->isChannelStatsEnabled());
+		play(Audio::Mixer::kMusicSoundType, 3, 10000, 10000);
+		const Audio::SoundHandle speech = play(Audio::Mixer::kSpeechSoundType, 7, 10000, 60);
+
+		// Nothing is gathered while the statistics are disabled
+		mixPasses(2);
+		Audio::Mixer::ChannelStats stats[4];
+		TS_ASSERT_EQUALS(_mixer->getChannelStats(stats, ARRAYSIZE(stats)), 2u);
+		for (int i = 0; i < 2; i++) {
+			TS_ASSERT_EQUALS(stats[i].renderTime, 0u);
+			TS_ASSERT_EQUALS(stats[i].samplesRead, 0u);
+			TS_ASSERT_EQUALS(stats[i].underruns, 0u);
+		}
+
+		_mixer->enableChannelStats(true);
+		TS_ASSERT(_mixer->isChannelStatsEnabled());
+		_mixer->pauseHandle(speech, true);
+		mixPasses(3);
+		_mixer->pauseHandle(speech, false);
+		mixPasses(2);
+
+		TS_ASSERT_EQUALS(_mixer->getChannelStats(stats, ARRAYSIZE(stats)), 2u);
+		const Audio::Mixer::ChannelStats &m = stats[0].id == 3 ? stats[0] : stats[1];
+		const Audio::Mixer::ChannelStats &s = stats[0].id == 3 ? stats[1] : stats[0];
+
+		TS_ASSERT_EQUALS(_mixer->getSoundID(m.handle), 3);
+		TS_ASSERT_EQUALS(m.type, Audio::Mixer::kMusicSoundType);
+		TS_ASSERT_EQUALS(m.rate, (uint32)kRate);
+		TS_ASSERT(!m.stereo);
+		TS_ASSERT(!m.paused);
+		TS_ASSERT_EQUALS(m.samplesRead, 5u * kPassLength);
+		TS_ASSERT_EQUALS(m.underruns, 0u);
+		// The test clock ticks once at either end of each pass
+		TS_ASSERT_EQUALS(m.renderTime, 5u);
+
+		// The paused channel is not mixed, and its stream cannot keep up
+		TS_ASSERT_EQUALS(_mixer->getSoundID(s.handle), 7);
+		TS_ASSERT_EQUALS(s.type, Audio::Mixer::kSpeechSoundType);
+		TS_ASSERT_EQUALS(s.samplesRead, 2u * 60);
+		TS_ASSERT_EQUALS(s.underruns, 2u);
+		TS_ASSERT_EQUALS(s.renderTime, 2u);
+
+		// The statistics stay as they are while disabled, and start over
+		// when enabled again
+		_mixer->enableChannelStats(false);
+		mixPasses(2);
+		TS_ASSERT_EQUALS(_mixer->getChannelStats(stats, ARRAYSIZE(stats)), 2u);
+		TS_ASSERT_EQUALS(stats[0].samplesRead + stats[1].samplesRead, 5u * kPassLength + 2u * 60);
+
+		_mixer->enableChannelStats(true);
+		TS_ASSERT_EQUALS(_mixer->getChannelStats(stats, 1), 1u);
+		TS_ASSERT_EQUALS(stats[0].samplesRead, 0u);
+		TS_ASSERT_EQUALS(stats[0].renderTime, 0u);
+#endif
+	}
+
+	void test_end_of_stream() {
+#ifndef ENABLE_EVENTRECORDER
+		// Reads which are short because the stream ends are no underruns
+		_mixer->enableChannelStats(true);
+		play(Audio::Mixer::kSFXSoundType, 1, kPassLength + 30, kPassLength);
+		mixPasses(2);
+
+		Audio::Mixer::ChannelStats stats;
+		TS_ASSERT_EQUALS(_mixer->getChannelStats(&stats, 1), 1u);
+		TS_ASSERT_EQUALS(stats.samplesRead, (uint32)kPassLength + 30);
+		TS_ASSERT_EQUALS(stats.underruns, 0u);
+#endif
+	}
+};
@@ -0,0 +1,171 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/pcmcache.h"
+
+#include "common/memstream.h"
+
+#include "test/system.h"
+
+#include "helper.h"
+
+class PCMCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kRate = 1000,
+		// One second of mono 16-bit samples, so that the cache holds four of them
+		kSoundSize = kRate * 2,
+		kMaxSize = 4 * kSoundSize
+	};
+
+	// The cache locks its mutex
+	ScopedTestSystem *_system;
+
+	static Audio::PCMCache &cache() {
+		return Audio::PCMCache::instance();
+	}
+
+	static Audio::SeekableAudioStream *createSound(int seconds, int16 **comp = 0) {
+		return createSineStream<int16>(kRate, seconds, comp, false, false);
+	}
+
+	static bool playEquals(Audio::SeekableAudioStream *stream, const int16 *comp, int samples) {
+		int16 *buffer = new int16[samples];
+		const int read = stream->readBuffer(buffer, samples);
+		const bool equal = read == samples && stream->endOfData() && !memcmp(buffer, comp, samples * sizeof(int16));
+		delete[] buffer;
+		return equal;
+	}
+
+	static void play(Audio::SeekableAudioStream *stream) {
+		int16 buffer[256];
+		while (!stream->endOfData())
+			stream->readBuffer(buffer, ARRAYSIZE(buffer));
+	}
+
+	static void addSound(const char *key) {
+		Audio::SeekableAudioStream *stream = cache().insert(key, createSound(1));
+		play(stream);
+		delete stream;
+	}
+
+	static bool isCached(const char *key) {
+		Audio::SeekableAudioStream *stream = cache().find(key);
+		delete stream;
+		return stream != 0;
+	}
+
+public:
+	void setUp() {
+		_system = new ScopedTestSystem();
+		cache().setMaxSize(kMaxSize);
+	}
+
+	void tearDown() {
+		// The mutex of the cache must go before the system does
+		Audio::PCMCache::destroy();
+		delete _system;
+	}
+
+	void test_hit_miss() {
+		int16 *comp;
+		Audio::SeekableAudioStream *stream = cache().insert("sound", createSound(1, &comp));
+		TS_ASSERT(!isCached("sound"));
+
+		// The sound is only cached once it has been played to its end
+		int16 buffer[100];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, ARRAYSIZE(buffer)), 100);
+		TS_ASSERT(!memcmp(buffer, comp, sizeof(buffer)));
+		TS_ASSERT(!isCached("sound"));
+		TS_ASSERT(playEquals(stream, comp + 100, kRate - 100));
+		delete stream;
+		TS_ASSERT_EQUALS(cache().getSize(), (uint32)kSoundSize);
+
+		for (int i = 0; i < 2; i++) {
+			stream = cache().find("sound");
+			TS_ASSERT(stream);
+			TS_ASSERT_EQUALS(stream->getRate(), kRate);
+			TS_ASSERT(!stream->isStereo());
+			TS_ASSERT(playEquals(stream, comp, kRate));
+			delete stream;
+		}
+
+		TS_ASSERT(!isCached("other"));
+		TS_ASSERT_EQUALS(cache().getSize(), (uint32)kSoundSize);
+		delete[] comp;
+	}
+
+	void test_seek() {
+		// Seeking into the middle of the sound cancels caching it
+		Audio::SeekableAudioStream *stream = cache().insert("sound", createSound(1));
+		int16 buffer[100];
+		stream->readBuffer(buffer, ARRAYSIZE(buffer));
+		stream->rewind();
+		play(stream);
+		delete stream;
+		TS_ASSERT(!isCached("sound"));
+		TS_ASSERT_EQUALS(cache().getSize(), 0u);
+
+		// Sounds which are not played to their end are not cached either
+		stream = cache().insert("sound", createSound(1));
+		stream->readBuffer(buffer, ARRAYSIZE(buffer));
+		delete stream;
+		TS_ASSERT(!isCached("sound"));
+	}
+
+	void test_eviction() {
+		addSound("a");
+		addSound("b");
+		addSound("c");
+		addSound("d");
+		TS_ASSERT_EQUALS(cache().getSize(), (uint32)kMaxSize);
+
+		// Looking up "a" makes "b" the least recently used sound
+		TS_ASSERT(isCached("a"));
+		addSound("e");
+		TS_ASSERT_EQUALS(cache().getSize(), (uint32)kMaxSize);
+		TS_ASSERT(!isCached("b"));
+		TS_ASSERT(isCached("a"));
+		TS_ASSERT(isCached("c"));
+		TS_ASSERT(isCached("d"));
+		TS_ASSERT(isCached("e"));
+
+		// Shrinking the cache drops the least recently used sounds first
+		cache().setMaxSize(2 * kSoundSize);
+		TS_ASSERT_EQUALS(cache().getSize(), (uint32)(2 * kSoundSize));
+		TS_ASSERT(!isCached("a"));
+		TS_ASSERT(!isCached("c"));
+		TS_ASSERT(isCached("d"));
+		TS_ASSERT(isCached("e"));
+	}
+
+	void test_refcount() {
+		int16 *comp;
+		Audio::SeekableAudioStream *stream = cache().insert("sound", createSound(1, &comp));
+		play(stream);
+		delete stream;
+
+		// A sound which is being played survives being evicted
+		stream = cache().find("sound");
+		TS_ASSERT(stream);
+		cache().clear();
+		TS_ASSERT_EQUALS(cache().getSize(), 0u);
+		TS_ASSERT(!isCached("sound"));
+		TS_ASSERT(playEquals(stream, comp, kRate));
+		delete stream;
+
+		delete[] comp;
+	}
+
+	void test_long_sound() {
+		// Sounds taking up more than a quarter of the cache are returned as is
+		Audio::SeekableAudioStream *original = createSound(2);
+		Audio::SeekableAudioStream *stream = cache().insert("long", original);
+		TS_ASSERT_EQUALS(stream, original);
+		play(stream);
+		delete stream;
+		TS_ASSERT(!isCached("long"));
+		TS_ASSERT_EQUALS(cache().getSize(), 0u);
+	}
+};
@@ -0,0 +1,274 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/audiostream.h"
+
+#include "common/config-manager.h"
+#include "common/memstream.h"
+
+#include "test/system.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	// The sinc filters are kept in a cache which locks a mutex, and which
+	// lives for as long as the process does
+	ScopedTestSystem _system;
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	static const int16 kSilence = (int16)0x8000;
+#else
+	static const int16 kSilence = 0;
+#endif
+
+	// flowAccumulate() into a 32-bit bus must produce the same samples as
+	// flow() into a silent 16-bit buffer, as long as nothing clips.
+	void accumulateTestTemplate(const int sampleRate, const bool isStereo, const bool reverseStereo) {
+		const int outputRate = 44100;
+		const int len = 1000;
+
+		Audio::SeekableAudioStream *s16 = createSineStream<int16>(sampleRate, 1, 0, true, isStereo);
+		Audio::SeekableAudioStream *s32 = createSineStream<int16>(sampleRate, 1, 0, true, isStereo);
+
+		Audio::RateConverter *conv16 = Audio::makeRateConverter(sampleRate, outputRate, isStereo, reverseStereo);
+		Audio::RateConverter *conv32 = Audio::makeRateConverter(sampleRate, outputRate, isStereo, reverseStereo);
+
+		int16 *buffer16 = new int16[len * 2];
+		int32 *buffer32 = new int32[len * 2];
+
+		int written16, written32;
+		do {
+			for (int i = 0; i < len * 2; ++i)
+				buffer16[i] = kSilence;
+			memset(buffer32, 0, len * 2 * sizeof(int32));
+
+			written16 = conv16->flow(*s16, buffer16, len, 200, 256);
+			written32 = conv32->flowAccumulate(*s32, buffer32, len, 200, 256);
+			TS_ASSERT_EQUALS(written16, written32);
+
+			// The bus is always signed
+			for (int i = 0; i < written16 * 2; ++i)
+				TS_ASSERT_EQUALS((int16)(buffer16[i] ^ kSilence), buffer32[i]);
+		} while (written16 == len);
+
+		delete[] buffer32;
+		delete[] buffer16;
+		delete conv32;
+		delete conv16;
+		delete s32;
+		delete s16;
+	}
+
+	// Leaves flowAccumulate() to the RateConverter default, which mixes
+	// through flow()
+	class FlowOnlyConverter : public Audio::RateConverter {
+	public:
+		FlowOnlyConverter(Audio::RateConverter *converter) : _converter(converter) {}
+		~FlowOnlyConverter() { delete _converter; }
+
+		int flow(Audio::AudioStream &input, Audio::st_sample_t *obuf, Audio::st_size_t osamp, Audio::st_volume_t vol_l, Audio::st_volume_t vol_r) {
+			return _converter->flow(input, obuf, osamp, vol_l, vol_r);
+		}
+
+		int drain(Audio::st_sample_t *obuf, Audio::st_size_t osamp, Audio::st_volume_t vol) {
+			return _converter->drain(obuf, osamp, vol);
+		}
+
+	private:
+		Audio::RateConverter *_converter;
+	};
+
+	// The default flowAccumulate() must add the same signed samples to the
+	// bus as the converters' own.
+	void defaultAccumulateTestTemplate(const int sampleRate, const bool isStereo) {
+		const int outputRate = 44100;
+		// More than the default converts at once
+		const int len = 1000;
+
+		Audio::SeekableAudioStream *sDefault = createSineStream<int16>(sampleRate, 1, 0, true, isStereo);
+		Audio::SeekableAudioStream *sOwn = createSineStream<int16>(sampleRate, 1, 0, true, isStereo);
+
+		Audio::RateConverter *convDefault = new FlowOnlyConverter(Audio::makeRateConverter(sampleRate, outputRate, isStereo));
+		Audio::RateConverter *convOwn = Audio::makeRateConverter(sampleRate, outputRate, isStereo);
+
+		int32 *bufferDefault = new int32[len * 2];
+		int32 *bufferOwn = new int32[len * 2];
+
+		int writtenDefault, writtenOwn;
+		do {
+			// Something is already on the bus
+			for (int i = 0; i < len * 2; ++i)
+				bufferDefault[i] = bufferOwn[i] = (i % 7) * 1000 - 3000;
+
+			writtenDefault = convDefault->flowAccumulate(*sDefault, bufferDefault, len, 200, 256);
+			writtenOwn = convOwn->flowAccumulate(*sOwn, bufferOwn, len, 200, 256);
+			TS_ASSERT_EQUALS(writtenDefault, writtenOwn);
+			TS_ASSERT(!memcmp(bufferDefault, bufferOwn, len * 2 * sizeof(int32)));
+		} while (writtenOwn == len);
+
+		delete[] bufferOwn;
+		delete[] bufferDefault;
+		delete convOwn;
+		delete convDefault;
+		delete sOwn;
+		delete sDefault;
+	}
+
+	static Audio::RateConverter *makeSincConverter(const int inputRate, const int outputRate, const bool isStereo) {
+		ConfMan.set("audio_resampler", "sinc");
+		Audio::RateConverter *converter = Audio::makeRateConverter(inputRate, outputRate, isStereo);
+		ConfMan.removeKey("audio_resampler", Common::ConfigManager::kApplicationDomain);
+		return converter;
+	}
+
+	// Convert the whole stream, in blocks of an odd size, into signed
+	// samples and return the number of output frames.
+	static int convertAll(Audio::RateConverter *converter, Audio::AudioStream &stream, int16 *buffer, const int maxFrames) {
+		const int blockSize = 333;
+		int done = 0;
+
+		for (int i = 0; i < maxFrames * 2; ++i)
+			buffer[i] = kSilence;
+		while (done < maxFrames) {
+			const int request = MIN(blockSize, maxFrames - done);
+			const int written = converter->flow(stream, buffer + done * 2, request, 256, 256);
+			done += written;
+			if (written < request)
+				break;
+		}
+
+		for (int i = 0; i < maxFrames * 2; ++i)
+			buffer[i] ^= kSilence;
+		return done;
+	}
+
+	void sincLengthTestTemplate(const int inputRate, const int outputRate, const bool isStereo) {
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(inputRate, 1, 0, true, isStereo);
+		Audio::RateConverter *converter = makeSincConverter(inputRate, outputRate, isStereo);
+
+		// There is an output frame for every output position before the
+		// end of the input
+		const int expected = (int)(((int64)inputRate * outputRate + inputRate - 1) / inputRate);
+		const int maxFrames = expected + 100;
+		int16 *buffer = new int16[maxFrames * 2];
+		TS_ASSERT_EQUALS(convertAll(converter, *stream, buffer, maxFrames), expected);
+
+		// Nothing is left once the input has been flushed
+		TS_ASSERT_EQUALS(converter->flow(*stream, buffer, maxFrames, 256, 256), 0);
+
+		delete[] buffer;
+		delete converter;
+		delete stream;
+	}
+
+	// A tone below both Nyquist frequencies must come out unchanged, apart
+	// from its first and last milliseconds, where the filter reaches past the
+	// input. The right channel is a quarter period ahead of the left one.
+	void sincToneTestTemplate(const int inputRate, const int outputRate, const bool isStereo, const int frequency) {
+		const int channels = isStereo ? 2 : 1;
+		const int frames = inputRate / 4;
+		const double amplitude = 10000.0;
+
+		int16 *data = (int16 *)malloc(frames * channels * sizeof(int16));
+		for (int i = 0; i < frames; i++) {
+			for (int c = 0; c < channels; c++) {
+				const double phase = 2.0 * M_PI * frequency * i / inputRate + c * M_PI / 2.0;
+				WRITE_LE_UINT16(&data[i * channels + c], (int16)floor(amplitude * sin(phase) + 0.5));
+			}
+		}
+		Common::SeekableReadStream *dataStream = new Common::MemoryReadStream((const byte *)data, frames * channels * sizeof(int16), DisposeAfterUse::YES);
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(dataStream, inputRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (isStereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = makeSincConverter(inputRate, outputRate, isStereo);
+
+		const int outputFrames = (int)(((int64)frames * outputRate + inputRate - 1) / inputRate);
+		int16 *buffer = new int16[(outputFrames + 100) * 2];
+		TS_ASSERT_EQUALS(convertAll(converter, *stream, buffer, outputFrames + 100), outputFrames);
+
+		int maxError = 0;
+		const int margin = outputRate / 1000;
+		for (int j = margin; j < outputFrames - margin; j++) {
+			for (int c = 0; c < 2; c++) {
+				const double phase = 2.0 * M_PI * frequency * j / outputRate + (isStereo ? c : 0) * M_PI / 2.0;
+				const int expected = (int)floor(amplitude * sin(phase) + 0.5);
+				maxError = MAX(maxError, ABS(buffer[j * 2 + c] - expected));
+			}
+		}
+		// Linear interpolation is off by more than a tenth of the amplitude
+		TS_ASSERT_LESS_THAN(maxError, 100);
+
+		delete[] buffer;
+		delete converter;
+		delete stream;
+	}
+
+public:
+	void test_accumulate_copy() {
+		accumulateTestTemplate(44100, false, false);
+		accumulateTestTemplate(44100, true, false);
+		accumulateTestTemplate(44100, true, true);
+	}
+
+	void test_accumulate_linear() {
+		accumulateTestTemplate(11025, false, false);
+		accumulateTestTemplate(22050, true, false);
+		accumulateTestTemplate(22050, true, true);
+	}
+
+	void test_accumulate_simple() {
+		accumulateTestTemplate(88200, false, false);
+		accumulateTestTemplate(88200, true, true);
+	}
+
+	void test_accumulate_default() {
+		defaultAccumulateTestTemplate(44100, false);
+		defaultAccumulateTestTemplate(22050, true);
+		defaultAccumulateTestTemplate(88200, true);
+	}
+
+	void test_sinc_tone() {
+		// Upsampling
+		sincToneTestTemplate(11025, 22050, false, 3000);
+		sincToneTestTemplate(22050, 44100, true, 6000);
+		sincToneTestTemplate(32000, 44100, true, 9000);
+
+		// Downsampling
+		sincToneTestTemplate(44100, 22050, false, 6000);
+		sincToneTestTemplate(48000, 11025, true, 3000);
+	}
+
+	void test_sinc_length() {
+		// Upsampling
+		sincLengthTestTemplate(11025, 44100, false);
+		sincLengthTestTemplate(22050, 48000, true);
+		sincLengthTestTemplate(8000, 22050, false);
+		sincLengthTestTemplate(32000, 44100, true);
+
+		// Downsampling
+		sincLengthTestTemplate(48000, 22050, false);
+		sincLengthTestTemplate(44100, 11025, true);
+	}
+
+	void test_sinc_tail() {
+		// Silence followed by a single loud frame at the very end
+		const int frames = 1000;
+		int16 *data = (int16 *)calloc(frames, sizeof(int16));
+		WRITE_LE_UINT16(&data[frames - 1], 16000);
+		Common::SeekableReadStream *dataStream = new Common::MemoryReadStream((const byte *)data, frames * sizeof(int16), DisposeAfterUse::YES);
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(dataStream, 11025, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = makeSincConverter(11025, 22050, false);
+
+		const int maxFrames = 2 * frames + 100;
+		int16 *buffer = new int16[maxFrames * 2];
+		TS_ASSERT_EQUALS(convertAll(converter, *stream, buffer, maxFrames), 2 * frames);
+
+		// The next to last output frame is centred on the last input frame
+		TS_ASSERT_LESS_THAN(12000, buffer[(2 * frames - 2) * 2]);
+		TS_ASSERT_LESS_THAN(12000, buffer[(2 * frames - 2) * 2 + 1]);
+
+		delete[] buffer;
+		delete converter;
+		delete stream;
+	}
+};
@@ -0,0 +1,250 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth_intern.h"
+
+#include "test/random.h"
+
+#include "common/array.h"
+#include "common/util.h"
+
+// The FM channels are rendered in blocks, one operator after another. This
+// is the way they used to be rendered, one sample at a time, and serves as
+// the reference for renderFmChannelBlock().
+class RefFmSynthOperator : public TownsPC98_FmSynthOperator {
+public:
+	RefFmSynthOperator(const uint32 tickLength, const uint32 envduration, const uint8 *rateTable, const uint8 *shiftTable,
+		const uint8 *attackDecayTable, const uint32 *frqTable, const uint32 *sineTable, const int32 *tlevelOut, const int32 *detuneTable)
+		: TownsPC98_FmSynthOperator(tickLength, envduration, rateTable, shiftTable, attackDecayTable, frqTable, sineTable, tlevelOut, detuneTable) {}
+
+	void generateOutput(int32 phasebuf, int32 *feed, int32 &out) {
+		uint32 lvlout;
+		if (!updateEnvelope(lvlout))
+			return;
+
+		int32 outp = 0;
+		int32 *i = &outp, *o = &outp;
+		int32 phaseShift = 0;
+
+		if (feed) {
+			o = &feed[0];
+			i = &feed[1];
+			phaseShift = _feedbackLevel ? ((*o + *i) << _feedbackLevel) : 0;
+			*o = *i;
+		} else {
+			phaseShift = phasebuf << 15;
+		}
+
+		if (lvlout < 832) {
+			uint32 index = (lvlout << 3) + _sinTbl[(((_phase & ~0xffff) + (uint32)phaseShift) >> 16) & 0x3ff];
+			*i = ((index < 6656) ? _tLvlTbl[index] : 0);
+		} else {
+			*i = 0;
+		}
+
+		_phase += _phaseIncrement;
+		out += *o;
+	}
+};
+
+static void refRenderChannel(RefFmSynthOperator *const *o, uint8 algorithm, int32 *feed, int32 *out, uint32 count) {
+	for (uint32 ii = 0; ii < count; ii++) {
+		int32 phbuf1, phbuf2, output;
+		phbuf1 = phbuf2 = output = 0;
+
+		int32 *del = &feed[2];
+
+		switch (algorithm) {
+		case 0:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			*del = 0;
+			o[1]->generateOutput(phbuf1, 0, *del);
+			o[3]->generateOutput(phbuf2, 0, output);
+			break;
+		case 1:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			o[1]->generateOutput(0, 0, phbuf1);
+			o[3]->generateOutput(phbuf2, 0, output);
+			*del = phbuf1;
+			break;
+		case 2:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(*del, 0, phbuf2);
+			o[1]->generateOutput(0, 0, phbuf1);
+			o[3]->generateOutput(phbuf2, 0, output);
+			*del = phbuf1;
+			break;
+		case 3:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(0, 0, *del);
+			o[1]->generateOutput(phbuf2, 0, phbuf1);
+			o[3]->generateOutput(*del, 0, output);
+			*del = phbuf1;
+			break;
+		case 4:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, 0, phbuf2);
+			o[1]->generateOutput(phbuf1, 0, output);
+			o[3]->generateOutput(phbuf2, 0, output);
+			*del = 0;
+			break;
+		case 5:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, 0, output);
+			o[1]->generateOutput(phbuf1, 0, output);
+			o[3]->generateOutput(phbuf1, 0, output);
+			*del = phbuf1;
+			break;
+		case 6:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, 0, output);
+			o[1]->generateOutput(phbuf1, 0, output);
+			o[3]->generateOutput(0, 0, output);
+			*del = 0;
+			break;
+		case 7:
+			o[0]->generateOutput(0, feed, output);
+			o[2]->generateOutput(0, 0, output);
+			o[1]->generateOutput(0, 0, output);
+			o[3]->generateOutput(0, 0, output);
+			*del = 0;
+			break;
+		}
+
+		out[ii] = output;
+	}
+}
+
+class TownsPC98FmSynthTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	// Random tables, within the ranges the operators rely on
+	uint8 _rates[130];
+	uint8 _rateShift[130];
+	uint8 _attackDecay[152];
+	uint32 _frq[0x1000];
+	uint32 _sin[1024];
+	int32 _levelOut[0x1a00];
+	int32 _detune[256];
+
+	void createTables() {
+		static const uint8 steps[] = { 0, 1, 2, 4, 8, 16 };
+
+		for (int i = 0; i < 130; i++) {
+			_rates[i] = _rnd.getRandomNumber(144);
+			_rateShift[i] = _rnd.getRandomNumber(11);
+		}
+		for (int i = 0; i < 152; i++)
+			_attackDecay[i] = steps[_rnd.getRandomNumber(ARRAYSIZE(steps) - 1)];
+		for (int i = 0; i < 0x1000; i++)
+			_frq[i] = _rnd.getRandomNumber((1 << 23) - 1);
+		for (int i = 0; i < 1024; i++)
+			_sin[i] = _rnd.getRandomNumber(6655);
+		for (int i = 0; i < 0x1a00; i++)
+			_levelOut[i] = _rnd.getRandomNumber(16383) - 8192;
+		for (int i = 0; i < 256; i++)
+			_detune[i] = _rnd.getRandomNumber(127) - 64;
+	}
+
+	TownsPC98_FmSynthOperator *createOperator() {
+		return new TownsPC98_FmSynthOperator(48, 0x90, _rates, _rateShift, _attackDecay, _frq, _sin, _levelOut, _detune);
+	}
+
+	RefFmSynthOperator *createRefOperator() {
+		return new RefFmSynthOperator(48, 0x90, _rates, _rateShift, _attackDecay, _frq, _sin, _levelOut, _detune);
+	}
+
+	// Program the same random parameters into two operators
+	void setupOperators(TownsPC98_FmSynthOperator *a, TownsPC98_FmSynthOperator *b, bool first) {
+		static const uint32 maxValues[] = {
+			7, 15, 31, 3, 31, 31, 15, 15, 15, 127, 7, 0x3F, 0xFF
+		};
+		uint32 values[ARRAYSIZE(maxValues)];
+		for (int i = 0; i < ARRAYSIZE(maxValues); i++)
+			values[i] = _rnd.getRandomNumber(maxValues[i]);
+
+		TownsPC98_FmSynthOperator *o[2] = { a, b };
+		for (int i = 0; i < 2; i++) {
+			o[i]->detune(values[0]);
+			o[i]->multiple(values[1]);
+			o[i]->attackRate(values[2]);
+			o[i]->scaleRate(values[3]);
+			o[i]->decayRate(values[4]);
+			o[i]->sustainRate(values[5]);
+			o[i]->sustainLevel(values[6]);
+			o[i]->releaseRate(values[7]);
+			o[i]->envelopeShape(values[8]);
+			// Keep the level audible most of the time
+			o[i]->totalLevel(values[9] >> 2);
+			if (first)
+				o[i]->feedbackLevel(values[10]);
+			o[i]->frequencyHi(values[11]);
+			o[i]->frequencyLo(values[12]);
+			o[i]->updatePhaseIncrement();
+		}
+	}
+
+	void algorithmTemplate(uint8 algorithm) {
+		static const uint32 blockSizes[] = { 1, 3, 17, 64, 100, 256 };
+
+		_rnd.setSeed(algorithm + 1);
+		createTables();
+
+		RefFmSynthOperator *ref[4];
+		TownsPC98_FmSynthOperator *opr[4];
+		for (int i = 0; i < 4; i++) {
+			ref[i] = createRefOperator();
+			opr[i] = createOperator();
+		}
+
+		int32 refFeed[3] = { 0, 0, 0 };
+		int32 feed[3] = { 0, 0, 0 };
+		int32 refOut[TownsPC98_FmSynthOperator::kBlockSize];
+		int32 out[TownsPC98_FmSynthOperator::kBlockSize];
+
+		bool equal = true;
+		for (int note = 0; note < 20 && equal; note++) {
+			for (int i = 0; i < 4; i++) {
+				setupOperators(ref[i], opr[i], i == 0);
+				ref[i]->keyOn();
+				opr[i]->keyOn();
+			}
+
+			// Render the note, then its release, in blocks of varying size
+			for (int block = 0; block < 40 && equal; block++) {
+				if (block == 30) {
+					for (int i = 0; i < 4; i++) {
+						ref[i]->keyOff();
+						opr[i]->keyOff();
+					}
+				}
+
+				const uint32 count = blockSizes[(note + block) % ARRAYSIZE(blockSizes)];
+				refRenderChannel(ref, algorithm, refFeed, refOut, count);
+				renderFmChannelBlock(opr, algorithm, feed, out, count);
+
+				equal = !memcmp(refOut, out, count * sizeof(int32)) && !memcmp(refFeed, feed, sizeof(feed));
+			}
+		}
+
+		TS_ASSERT(equal);
+
+		for (int i = 0; i < 4; i++) {
+			delete ref[i];
+			delete opr[i];
+		}
+	}
+
+public:
+	void test_algorithm_0() { algorithmTemplate(0); }
+	void test_algorithm_1() { algorithmTemplate(1); }
+	void test_algorithm_2() { algorithmTemplate(2); }
+	void test_algorithm_3() { algorithmTemplate(3); }
+	void test_algorithm_4() { algorithmTemplate(4); }
+	void test_algorithm_5() { algorithmTemplate(5); }
+	void test_algorithm_6() { algorithmTemplate(6); }
+	void test_algorithm_7() { algorithmTemplate(7); }
+};
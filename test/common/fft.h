@@ -0,0 +1,60 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fft.h"
+#include "common/math.h"
+
+#include "test/random.h"
+
+class FFTTestSuite : public CxxTest::TestSuite {
+	// Compare the FFT of pseudo-random data against a direct DFT
+	void checkTransform(int bits) {
+		const int n = 1 << bits;
+
+		Common::Complex *data = new Common::Complex[n];
+		Common::Complex *input = new Common::Complex[n];
+		double *cosTab = new double[n];
+		double *sinTab = new double[n];
+
+		TestRandomSource rnd(0x12345678);
+		for (int i = 0; i < n; i++) {
+			input[i].re = rnd.getRandomNumber(0xFFFF) / 32768.0f - 1.0f;
+			input[i].im = rnd.getRandomNumber(0xFFFF) / 32768.0f - 1.0f;
+			data[i] = input[i];
+
+			cosTab[i] = cos(2 * M_PI * i / n);
+			sinTab[i] = -sin(2 * M_PI * i / n);
+		}
+
+		Common::FFT fft(bits, 0);
+		fft.permute(data);
+		fft.calc(data);
+
+		for (int k = 0; k < n; k++) {
+			double re = 0.0, im = 0.0;
+			for (int j = 0; j < n; j++) {
+				const int idx = (j * k) & (n - 1);
+				re += input[j].re * cosTab[idx] - input[j].im * sinTab[idx];
+				im += input[j].re * sinTab[idx] + input[j].im * cosTab[idx];
+			}
+
+			TS_ASSERT_DELTA(data[k].re, re, 1e-3);
+			TS_ASSERT_DELTA(data[k].im, im, 1e-3);
+		}
+
+		delete[] sinTab;
+		delete[] cosTab;
+		delete[] input;
+		delete[] data;
+	}
+
+public:
+	void test_small_sizes() {
+		for (int bits = 2; bits <= 7; bits++)
+			checkTransform(bits);
+	}
+
+	void test_large_sizes() {
+		for (int bits = 8; bits <= 12; bits++)
+			checkTransform(bits);
+	}
+};
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/serializer.h"
+#include "common/memstream.h"
 #include "common/stream.h"
 
 class SerializerTestSuite : public CxxTest::TestSuite {
@@ -108,4 +109,65 @@ public:
 	void test_read_v2_as_v2() {
 		readVersioned_v2(_inStreamV2, 2);
 	}
+
+	void test_sync_array() {
+		int32 values32[300];
+		uint16 values16[300];
+		for (int i = 0; i < 300; ++i) {
+			values32[i] = i * -123457;
+			values16[i] = i * 211;
+		}
+
+		// Bulk syncing must produce the same bytes as syncing element by element
+		Common::MemoryWriteStreamDynamic bulkStream(DisposeAfterUse::YES);
+		Common::Serializer bulk(0, &bulkStream);
+		bulk.syncArrayAsSint32LE(values32, 300);
+		bulk.syncArrayAsUint16BE(values16, 300);
+		bulk.syncArrayAsSint16LE(values32, 300);
+
+		Common::MemoryWriteStreamDynamic refStream(DisposeAfterUse::YES);
+		Common::Serializer ref(0, &refStream);
+		for (int i = 0; i < 300; ++i)
+			ref.syncAsSint32LE(values32[i]);
+		for (int i = 0; i < 300; ++i)
+			ref.syncAsUint16BE(values16[i]);
+		for (int i = 0; i < 300; ++i)
+			ref.syncAsSint16LE(values32[i]);
+
+		TS_ASSERT_EQUALS(bulk.bytesSynced(), ref.bytesSynced());
+		TS_ASSERT_EQUALS(bulkStream.size(), refStream.size());
+		TS_ASSERT_EQUALS(memcmp(bulkStream.getData(), refStream.getData(), refStream.size()), 0);
+
+		Common::MemoryReadStream inStream(bulkStream.getData(), bulkStream.size());
+		Common::Serializer load(&inStream, 0);
+		int32 loaded32[300];
+		uint16 loaded16[300];
+		int32 loadedSmall[300];
+		load.syncArrayAsSint32LE(loaded32, 300);
+		load.syncArrayAsUint16BE(loaded16, 300);
+		load.syncArrayAsSint16LE(loadedSmall, 300);
+		for (int i = 0; i < 300; ++i) {
+			TS_ASSERT_EQUALS(loaded32[i], values32[i]);
+			TS_ASSERT_EQUALS(loaded16[i], values16[i]);
+			TS_ASSERT_EQUALS(loadedSmall[i], (int16)values32[i]);
+		}
+	}
+
+	void test_size_only() {
+		uint16 values[10] = { 0 };
+		Common::String str("test");
+		uint32 tmp = 5;
+
+		Common::Serializer ser;
+		TS_ASSERT(ser.isSaving());
+		TS_ASSERT(ser.isSizeOnly());
+		TS_ASSERT(ser.matchBytes("MAGI", 4));
+		TS_ASSERT(ser.syncVersion(2));
+		ser.syncAsUint32LE(tmp);
+		ser.syncArrayAsUint16LE(values, 10);
+		ser.syncString(str);
+		ser.skip(3);
+		TS_ASSERT_EQUALS(ser.bytesSynced(), 4u + 4 + 4 + 20 + 5 + 3);
+		TS_ASSERT(!ser.err());
+	}
 };
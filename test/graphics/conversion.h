@@ -0,0 +1,169 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/conversion.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+#include "test/random.h"
+
+#include "common/endian.h"
+
+// crossBlit() converts most format pairs with precomputed shifts, several
+// pixels at a time. This is the way it used to convert all of them, one
+// color component after another, and serves as the reference.
+static uint32 refConvertColor(uint32 color, const Graphics::PixelFormat &srcFmt, const Graphics::PixelFormat &dstFmt) {
+	byte a, r, g, b;
+	srcFmt.colorToARGB(color, a, r, g, b);
+	return dstFmt.ARGBToColor(a, r, g, b);
+}
+
+static uint32 readColor(const byte *src, int bytesPerPixel) {
+	if (bytesPerPixel == 2)
+		return READ_UINT16(src);
+	else if (bytesPerPixel == 3)
+		return READ_UINT24(src);
+	return READ_UINT32(src);
+}
+
+class ConversionTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	Graphics::Surface *createSurface(int w, int h, const Graphics::PixelFormat &format) {
+		Graphics::Surface *surface = new Graphics::Surface();
+		surface->create(w, h, format);
+		_rnd.fill(surface->getPixels(), surface->pitch * h);
+		return surface;
+	}
+
+	bool compareConverted(const Graphics::Surface &src, const Graphics::Surface &dst) {
+		for (int y = 0; y < src.h; y++) {
+			for (int x = 0; x < src.w; x++) {
+				const uint32 srcColor = readColor((const byte *)src.getBasePtr(x, y), src.format.bytesPerPixel);
+				const uint32 dstColor = readColor((const byte *)dst.getBasePtr(x, y), dst.format.bytesPerPixel);
+				if (dstColor != refConvertColor(srcColor, src.format, dst.format))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void convertTemplate(const Graphics::PixelFormat &srcFmt, const Graphics::PixelFormat &dstFmt) {
+		static const int widths[] = { 1, 3, 4, 7, 64, 101 };
+
+		for (int i = 0; i < ARRAYSIZE(widths); i++) {
+			_rnd.setSeed(widths[i]);
+			Graphics::Surface *src = createSurface(widths[i], 5, srcFmt);
+
+			// crossBlit() into a buffer with a larger pitch
+			const uint dstPitch = (widths[i] + 3) * dstFmt.bytesPerPixel;
+			byte *dstPixels = new byte[dstPitch * src->h];
+			TS_ASSERT(Graphics::crossBlit(dstPixels, (const byte *)src->getPixels(), dstPitch, src->pitch, src->w, src->h, dstFmt, srcFmt));
+
+			Graphics::Surface dst;
+			dst.init(src->w, src->h, dstPitch, dstPixels, dstFmt);
+			TS_ASSERT(compareConverted(*src, dst));
+
+			// Surface::convertTo()
+			Graphics::Surface *converted = src->convertTo(dstFmt);
+			TS_ASSERT(compareConverted(*src, *converted));
+
+			// Surface::convertToInPlace()
+			Graphics::Surface *inPlace = new Graphics::Surface();
+			inPlace->copyFrom(*src);
+			inPlace->convertToInPlace(dstFmt);
+			TS_ASSERT(compareConverted(*src, *inPlace));
+
+			inPlace->free();
+			delete inPlace;
+			converted->free();
+			delete converted;
+			delete[] dstPixels;
+			src->free();
+			delete src;
+		}
+	}
+
+	void paletteTemplate(const Graphics::PixelFormat &dstFmt) {
+		byte palette[256 * 3];
+		_rnd.setSeed(dstFmt.bytesPerPixel);
+		_rnd.fill(palette, sizeof(palette));
+
+		Graphics::Surface *src = createSurface(37, 5, Graphics::PixelFormat::createFormatCLUT8());
+
+		Graphics::Surface *converted = src->convertTo(dstFmt, palette);
+		Graphics::Surface *inPlace = new Graphics::Surface();
+		inPlace->copyFrom(*src);
+		inPlace->convertToInPlace(dstFmt, palette);
+
+		bool equal = true;
+		for (int y = 0; y < src->h; y++) {
+			for (int x = 0; x < src->w; x++) {
+				const byte *color = palette + *(const byte *)src->getBasePtr(x, y) * 3;
+				const uint32 expected = dstFmt.RGBToColor(color[0], color[1], color[2]);
+				equal = equal && readColor((const byte *)converted->getBasePtr(x, y), dstFmt.bytesPerPixel) == expected;
+				equal = equal && readColor((const byte *)inPlace->getBasePtr(x, y), dstFmt.bytesPerPixel) == expected;
+			}
+		}
+		TS_ASSERT(equal);
+
+		inPlace->free();
+		delete inPlace;
+		converted->free();
+		delete converted;
+		src->free();
+		delete src;
+	}
+
+public:
+	void test_rgb565_xrgb8888() {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat xrgb8888(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		convertTemplate(rgb565, xrgb8888);
+		convertTemplate(xrgb8888, rgb565);
+	}
+
+	void test_rgb565_rgba8888() {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat rgba8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		convertTemplate(rgb565, rgba8888);
+		convertTemplate(rgba8888, rgb565);
+	}
+
+	void test_argb8888_abgr8888() {
+		const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const Graphics::PixelFormat abgr8888(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		convertTemplate(argb8888, abgr8888);
+		convertTemplate(abgr8888, argb8888);
+	}
+
+	void test_rgb555_rgb565() {
+		const Graphics::PixelFormat rgb555(2, 5, 5, 5, 0, 10, 5, 0, 0);
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		convertTemplate(rgb555, rgb565);
+		convertTemplate(rgb565, rgb555);
+	}
+
+	void test_argb4444_rgba8888() {
+		const Graphics::PixelFormat argb4444(2, 4, 4, 4, 4, 8, 4, 0, 12);
+		const Graphics::PixelFormat rgba8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		convertTemplate(argb4444, rgba8888);
+		convertTemplate(rgba8888, argb4444);
+	}
+
+	void test_generic() {
+		// Neither 1 bit alpha nor 3 byte colors can be converted with shifts
+		const Graphics::PixelFormat rgba5551(2, 5, 5, 5, 1, 11, 6, 1, 0);
+		const Graphics::PixelFormat rgb888(3, 8, 8, 8, 0, 16, 8, 0, 0);
+		const Graphics::PixelFormat rgba8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		convertTemplate(rgba5551, rgba8888);
+		convertTemplate(rgb888, rgba8888);
+	}
+
+	void test_clut8() {
+		paletteTemplate(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		paletteTemplate(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+		paletteTemplate(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+};
@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_tiles.h"
+
+#include "test/random.h"
+
+#include "common/array.h"
+
+class DirtyTilesTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	/**
+	 * Check that the rectangles are disjoint, cover all the given dirty
+	 * pixels, and do not go beyond the tiles containing them.
+	 */
+	bool checkRects(const Common::Array<Common::Rect> &rects, const Common::Array<bool> &dirty, int width, int height) {
+		const int tileSize = Graphics::DirtyTiles::kTileSize;
+		Common::Array<int> covered;
+		covered.resize(width * height);
+
+		for (uint i = 0; i < rects.size(); i++) {
+			const Common::Rect &r = rects[i];
+			if (r.isEmpty() || r.left < 0 || r.top < 0 || r.right > width || r.bottom > height)
+				return false;
+
+			for (int y = r.top; y < r.bottom; y++)
+				for (int x = r.left; x < r.right; x++)
+					covered[y * width + x]++;
+		}
+
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				if (covered[y * width + x] > 1 || (dirty[y * width + x] && !covered[y * width + x]))
+					return false;
+
+				if (!covered[y * width + x])
+					continue;
+
+				// Some pixel of the same tile must be dirty
+				bool tileDirty = false;
+				const int tileX = x / tileSize * tileSize;
+				const int tileY = y / tileSize * tileSize;
+				for (int ty = tileY; ty < MIN(tileY + tileSize, height) && !tileDirty; ty++)
+					for (int tx = tileX; tx < MIN(tileX + tileSize, width) && !tileDirty; tx++)
+						tileDirty = dirty[ty * width + tx];
+				if (!tileDirty)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+public:
+	void test_empty() {
+		Graphics::DirtyTiles tiles(320, 200);
+		TS_ASSERT(tiles.isEmpty());
+
+		tiles.addRect(Common::Rect(400, 10, 500, 20));
+		tiles.addRect(Common::Rect(10, 10, 10, 20));
+		TS_ASSERT(tiles.isEmpty());
+
+		Common::Array<Common::Rect> rects;
+		tiles.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 0U);
+	}
+
+	void test_single_rect() {
+		Graphics::DirtyTiles tiles(320, 200);
+		tiles.addRect(Common::Rect(10, 20, 110, 120));
+		TS_ASSERT(!tiles.isEmpty());
+
+		Common::Array<Common::Rect> rects;
+		tiles.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT(rects[0] == Common::Rect(10, 20, 110, 120));
+
+		tiles.clear();
+		TS_ASSERT(tiles.isEmpty());
+	}
+
+	void test_all() {
+		Graphics::DirtyTiles tiles(321, 199);
+
+		// Many small rectangles still give a single one in the end
+		for (int y = 0; y < 199; y += 3)
+			for (int x = 0; x < 321; x += 5)
+				tiles.addRect(Common::Rect(x, y, x + 5, y + 3));
+
+		Common::Array<Common::Rect> rects;
+		tiles.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT(rects[0] == Common::Rect(321, 199));
+
+		tiles.clear();
+		tiles.addAll();
+		rects.clear();
+		tiles.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT(rects[0] == Common::Rect(321, 199));
+	}
+
+	void test_random() {
+		const int width = 200, height = 150;
+		Graphics::DirtyTiles tiles(width, height);
+
+		_rnd.setSeed(1);
+		for (int iteration = 0; iteration < 50; iteration++) {
+			Common::Array<bool> dirty;
+			dirty.resize(width * height);
+
+			const int count = 1 + _rnd.getRandomNumber(29);
+			for (int i = 0; i < count; i++) {
+				const int x = _rnd.getRandomNumber(width - 1), y = _rnd.getRandomNumber(height - 1);
+				const Common::Rect r(x, y, x + 1 + _rnd.getRandomNumber(59), y + 1 + _rnd.getRandomNumber(59));
+				tiles.addRect(r);
+
+				for (int py = r.top; py < MIN<int>(r.bottom, height); py++)
+					for (int px = r.left; px < MIN<int>(r.right, width); px++)
+						dirty[py * width + px] = true;
+			}
+
+			Common::Array<Common::Rect> rects;
+			tiles.getRects(rects);
+			TS_ASSERT(checkRects(rects, dirty, width, height));
+			TS_ASSERT(rects.size() <= (uint)(((width + 31) / 32) * ((height + 31) / 32)));
+
+			tiles.clear();
+		}
+	}
+
+	void test_resize() {
+		Graphics::DirtyTiles tiles(100, 100);
+		tiles.addRect(Common::Rect(10, 10, 20, 20));
+		tiles.addRect(Common::Rect(90, 90, 100, 100));
+
+		// Shrinking forgets what is outside, growing keeps the rest
+		tiles.resize(50, 50);
+		tiles.resize(200, 200);
+		tiles.addRect(Common::Rect(150, 150, 160, 160));
+
+		Common::Array<Common::Rect> rects;
+		tiles.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 2U);
+		TS_ASSERT(rects[0] == Common::Rect(10, 10, 20, 20));
+		TS_ASSERT(rects[1] == Common::Rect(150, 150, 160, 160));
+	}
+};
@@ -0,0 +1,89 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/fonts/glyph_blend.h"
+#include "graphics/surface.h"
+
+#include "test/random.h"
+
+#include "common/util.h"
+
+class GlyphBlendTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	// Glyphs are mostly empty or fully covered, with anti-aliased edges
+	void createCoverage(Graphics::Surface &coverage, int w, int h) {
+		coverage.create(w, h, Graphics::PixelFormat::createFormatCLUT8());
+		for (int y = 0; y < h; y++) {
+			byte *ptr = (byte *)coverage.getBasePtr(0, y);
+			for (int x = 0; x < w; x++) {
+				switch (_rnd.getRandomNumber(3)) {
+				case 0:
+					ptr[x] = 0;
+					break;
+				case 1:
+					ptr[x] = 255;
+					break;
+				default:
+					ptr[x] = _rnd.getRandomNumber(255);
+					break;
+				}
+			}
+		}
+	}
+
+public:
+	void test_supports() {
+#ifdef GLYPH_BLEND_SIMD
+		TS_ASSERT(!Graphics::CoverageBlender::supports(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)));
+		TS_ASSERT(!Graphics::CoverageBlender::supports(Graphics::PixelFormat(4, 7, 8, 8, 0, 16, 8, 0, 0)));
+		TS_ASSERT(!Graphics::CoverageBlender::supports(Graphics::PixelFormat(4, 8, 8, 8, 2, 22, 12, 2, 0)));
+		TS_ASSERT(Graphics::CoverageBlender::supports(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)));
+		TS_ASSERT(Graphics::CoverageBlender::supports(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)));
+#endif
+	}
+
+	void test_blend() {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		// Odd widths for the pixels left over by the blocks of four
+		static const int sizes[][2] = { { 1, 1 }, { 3, 5 }, { 4, 4 }, { 7, 3 }, { 16, 9 }, { 37, 21 } };
+
+		_rnd.setSeed(1);
+		for (int i = 0; i < ARRAYSIZE(formats); i++) {
+			const Graphics::PixelFormat &format = formats[i];
+
+			for (int j = 0; j < ARRAYSIZE(sizes); j++) {
+				const int w = sizes[j][0];
+				const int h = sizes[j][1];
+
+				Graphics::Surface coverage, reference, result;
+				createCoverage(coverage, w, h);
+				reference.create(w, h, format);
+				_rnd.fill(reference.getPixels(), reference.pitch * h);
+				result.copyFrom(reference);
+
+				const uint32 color = format.ARGBToColor(255, _rnd.getRandomNumber(255), _rnd.getRandomNumber(255), _rnd.getRandomNumber(255));
+
+				Graphics::renderGlyph<uint32>((uint8 *)reference.getPixels(), reference.pitch, (const uint8 *)coverage.getPixels(), coverage.pitch, w, h, color, format);
+#ifdef GLYPH_BLEND_SIMD
+				TS_ASSERT(Graphics::CoverageBlender::supports(format));
+				Graphics::renderGlyphSIMD((uint8 *)result.getPixels(), result.pitch, (const uint8 *)coverage.getPixels(), coverage.pitch, w, h, color, format);
+#else
+				Graphics::renderGlyph<uint32>((uint8 *)result.getPixels(), result.pitch, (const uint8 *)coverage.getPixels(), coverage.pitch, w, h, color, format);
+#endif
+
+				TS_ASSERT(!memcmp(result.getPixels(), reference.getPixels(), reference.pitch * h));
+
+				coverage.free();
+				reference.free();
+				result.free();
+			}
+		}
+	}
+};
@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/intern.h"
+
+#include "test/random.h"
+#include "test/system.h"
+
+#include "common/thread.h"
+#include "common/util.h"
+
+#ifdef USE_HQ_SCALERS
+// Set up by InitScalers(), see graphics/scaler.cpp
+extern "C" uint32 *RGBtoYUV;
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Source area with a border of one pixel around it, which the
+		// scalers read too
+		kWidth = 66,
+		kHeight = 101,
+		kPitch = kWidth + 2,
+		kMaxFactor = 3
+	};
+
+	TestRandomSource _rnd;
+	// The worker pools need a system for their semaphores
+	ScopedTestSystem *_system;
+	uint16 _src[kPitch * (kHeight + 2)];
+	// Some scalers write pairs of pixels at once
+	uint32 _reference[kWidth * kMaxFactor * kHeight * kMaxFactor / 2];
+	uint32 _result[kWidth * kMaxFactor * kHeight * kMaxFactor / 2];
+
+	const uint8 *srcPixels() const {
+		return (const uint8 *)(_src + kPitch + 1);
+	}
+
+	// Areas of similar colors, so that the hq scalers find both similar and
+	// different neighbours, with some noise
+	void fillSource() {
+		for (int i = 0; i < ARRAYSIZE(_src); i++) {
+			if (!_rnd.getRandomNumber(7)) {
+				_src[i] = _rnd.getRandomNumber(0xFFFF);
+			} else {
+				const int shade = (i / 5) % 3;
+				_src[i] = ((8 + shade * 6 + _rnd.getRandomNumber(3)) << 11) |
+				          ((20 + shade * 10 + _rnd.getRandomNumber(7)) << 5) |
+				          (6 + shade * 8 + _rnd.getRandomNumber(3));
+			}
+		}
+	}
+
+	bool equalsScaled(ScalerProc *scaler, int factor, int height, uint stripes) {
+		const uint32 dstPitch = kWidth * factor * sizeof(uint16);
+		memset(_reference, 0, sizeof(_reference));
+		memset(_result, 0, sizeof(_result));
+
+		scaler(srcPixels(), kPitch * sizeof(uint16), (uint8 *)_reference, dstPitch, kWidth, height);
+
+		// The test system has no threads, so the pool scales all the stripes
+		// on this thread
+		Common::WorkerPool pool(stripes - 1);
+		ScaleStripes(pool, stripes, scaler, factor, srcPixels(), kPitch * sizeof(uint16), (uint8 *)_result, dstPitch, kWidth, height);
+
+		return !memcmp(_result, _reference, sizeof(_reference));
+	}
+
+public:
+	void setUp() {
+		_system = new ScopedTestSystem();
+		InitScalers(565);
+	}
+
+	void tearDown() {
+		DestroyScalers();
+		delete _system;
+	}
+
+	void test_hq_patterns() {
+#ifdef HQ_PATTERNS_SIMD
+		_rnd.setSeed(1);
+		fillSource();
+
+		const uint16 *p = _src + kPitch + 1;
+		const int offsets[8] = { -kPitch - 1, -kPitch, -kPitch + 1, -1, 1, kPitch - 1, kPitch, kPitch + 1 };
+
+		bool equal = true;
+		for (int y = 0; y < kHeight; y++) {
+			// Runs of all lengths, for the pixels left over by the vectors
+			for (int x = 0; x < kWidth; ) {
+				const int count = MIN<int>(_rnd.getRandomNumber(kHQPatternChunk - 1) + 1, kWidth - x);
+				const uint16 *run = p + y * kPitch + x;
+
+				uint8 patterns[kHQPatternChunk];
+				computeHQPatterns(run, kPitch, count, patterns);
+
+				for (int i = 0; i < count; i++) {
+					uint8 expected = 0;
+					for (int n = 0; n < 8; n++) {
+						if (diffYUV(RGBtoYUV[run[i]], RGBtoYUV[run[i + offsets[n]]]))
+							expected |= 1 << n;
+					}
+					equal = equal && patterns[i] == expected;
+				}
+				x += count;
+			}
+		}
+		TS_ASSERT(equal);
+#endif
+	}
+
+	void test_stripes() {
+#ifdef USE_SCALERS
+		struct {
+			ScalerProc *scaler;
+			int factor;
+		} scalers[] = {
+#ifdef USE_HQ_SCALERS
+			{ HQ2x, 2 },
+			{ HQ3x, 3 },
+#endif
+			{ Normal2x, 2 },
+			{ AdvMame3x, 3 },
+			{ TV2x, 2 },
+			{ DotMatrix, 2 }
+		};
+		// Odd heights, and stripe counts which do not divide them
+		static const int heights[] = { 33, 47, 64, kHeight };
+		static const uint stripes[] = { 2, 3, 4, 7 };
+
+		_rnd.setSeed(2);
+		fillSource();
+
+		for (int i = 0; i < ARRAYSIZE(scalers); i++) {
+			for (int j = 0; j < ARRAYSIZE(heights); j++) {
+				for (int k = 0; k < ARRAYSIZE(stripes); k++)
+					TS_ASSERT(equalsScaled(scalers[i].scaler, scalers[i].factor, heights[j], stripes[k]));
+			}
+		}
+#endif
+	}
+
+	void test_parallel() {
+#ifdef USE_SCALERS
+		_rnd.setSeed(3);
+		fillSource();
+
+		// Without scaler threads, the area is scaled in one go
+		const uint32 dstPitch = kWidth * 2 * sizeof(uint16);
+		memset(_reference, 0, sizeof(_reference));
+		memset(_result, 0, sizeof(_result));
+		Normal2x(srcPixels(), kPitch * sizeof(uint16), (uint8 *)_reference, dstPitch, kWidth, kHeight);
+		ScaleParallel(Normal2x, 2, srcPixels(), kPitch * sizeof(uint16), (uint8 *)_result, dstPitch, kWidth, kHeight);
+		TS_ASSERT(!memcmp(_result, _reference, sizeof(_reference)));
+#endif
+	}
+};
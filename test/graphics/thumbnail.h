@@ -0,0 +1,96 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+#include "graphics/surface.h"
+#include "graphics/thumbnail.h"
+
+#include "test/random.h"
+#include "test/system.h"
+
+#include "common/memstream.h"
+
+class ThumbnailTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Checks that all the pixels of the thumbnail are the given RGB565 color
+	bool checkColor(const Graphics::Surface &thumb, uint16 color) {
+		for (int y = 0; y < thumb.h; y++)
+			for (int x = 0; x < thumb.w; x++)
+				if (*(const uint16 *)thumb.getBasePtr(x, y) != color)
+					return false;
+		return true;
+	}
+
+	uint16 color565(const byte *rgb) {
+		return ((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3);
+	}
+
+public:
+	void test_uniform() {
+		// createThumbnail() converts the whole palette
+		static const byte palette[256 * 3] = { 0x00, 0x00, 0x00, 0xC8, 0x64, 0x32 };
+		byte *pixels = new byte[640 * 400];
+		memset(pixels, 1, 640 * 400);
+
+		Graphics::Surface thumb;
+		TS_ASSERT(createThumbnail(&thumb, pixels, 640, 400, palette));
+		TS_ASSERT_EQUALS(thumb.w, 160);
+		TS_ASSERT_EQUALS(thumb.h, 100);
+		TS_ASSERT(checkColor(thumb, color565(palette + 3)));
+
+		thumb.free();
+		delete[] pixels;
+	}
+
+	void test_average() {
+		// Stripes of two colors, whose channels all differ by an odd amount,
+		// average to the lower halves of their sums.
+		static const byte palette[256 * 3] = { 0x08, 0x04, 0x08, 0xF8, 0xFC, 0xF0 };
+		byte *pixels = new byte[640 * 480];
+		for (int i = 0; i < 640 * 480; i++)
+			pixels[i] = i & 1;
+
+		Graphics::Surface thumb;
+		TS_ASSERT(createThumbnail(&thumb, pixels, 640, 480, palette));
+		TS_ASSERT_EQUALS(thumb.w, 160);
+		TS_ASSERT_EQUALS(thumb.h, 120);
+
+		const uint16 expected = (((0x01 + 0x1F) / 2) << 11) | (((0x01 + 0x3F) / 2) << 5) | ((0x01 + 0x1E) / 2);
+		TS_ASSERT(checkColor(thumb, expected));
+
+		thumb.free();
+		delete[] pixels;
+	}
+
+	void test_async() {
+		// AsyncThumbnail must write what saveThumbnail() writes for the same
+		// screen contents. The test system has no threads, so it encodes the
+		// thumbnail in save().
+		ScopedTestSystem system;
+		static const int sizes[][2] = { { 320, 200 }, { 640, 480 }, { 333, 251 } };
+		TestRandomSource rnd;
+
+		for (int i = 0; i < ARRAYSIZE(sizes); i++) {
+			Graphics::Surface screen;
+			screen.create(sizes[i][0], sizes[i][1], Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+			rnd.fill(screen.getPixels(), screen.pitch * screen.h);
+
+			Common::MemoryWriteStreamDynamic result(DisposeAfterUse::YES);
+			{
+				Graphics::AsyncThumbnail thumbnail(screen);
+				TS_ASSERT(thumbnail.save(result));
+			}
+
+			Graphics::Surface thumb;
+			Common::MemoryWriteStreamDynamic reference(DisposeAfterUse::YES);
+			TS_ASSERT(createThumbnail(&thumb, screen));
+			TS_ASSERT(Graphics::saveThumbnail(reference, thumb));
+
+			TS_ASSERT_EQUALS(result.size(), reference.size());
+			TS_ASSERT(result.size() == reference.size() && !memcmp(result.getData(), reference.getData(), result.size()));
+
+			thumb.free();
+			screen.free();
+		}
+	}
+};
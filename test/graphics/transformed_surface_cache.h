@@ -0,0 +1,233 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transformed_surface_cache.h"
+#include "graphics/transform_tools.h"
+
+#include "test/random.h"
+
+#include "common/math.h"
+
+// TransparentSurface interpolates several pixels at a time where possible.
+// These references interpolate one pixel at a time, the way scaleT() and
+// rotoscaleT() used to, and serve as the reference for both the cache and
+// the transformations themselves.
+
+static void refInterpolate(const byte *c00, const byte *c01, const byte *c10, const byte *c11, int ex, int ey, byte *out) {
+	for (int k = 0; k < 4; k++) {
+		const int t1 = ((((c01[k] - c00[k]) * ex) >> 16) + c00[k]) & 0xff;
+		const int t2 = ((((c11[k] - c10[k]) * ex) >> 16) + c10[k]) & 0xff;
+		out[k] = (((t2 - t1) * ey) >> 16) + t1;
+	}
+}
+
+static Graphics::TransparentSurface *refScale(const Graphics::TransparentSurface &src, int dstW, int dstH) {
+	Graphics::TransparentSurface *target = new Graphics::TransparentSurface();
+	target->create(dstW, dstH, src.format);
+
+	const int sw = src.w - 1;
+	const int sh = src.h - 1;
+	const int sx = (int)(65536.0f * (float)sw / (float)(dstW - 1));
+	const int sy = (int)(65536.0f * (float)sh / (float)(dstH - 1));
+
+	for (int y = 0; y < dstH; y++) {
+		const int csy = MIN<int>(y * sy, (src.h << 16) - 1);
+		const int cy = csy >> 16;
+
+		for (int x = 0; x < dstW; x++) {
+			const int csx = MIN<int>(x * sx, (src.w << 16) - 1);
+			const int cx = csx >> 16;
+			const int nx = (cx < sw) ? cx + 1 : cx;
+			const int ny = (cy < sh) ? cy + 1 : cy;
+
+			refInterpolate((const byte *)src.getBasePtr(cx, cy), (const byte *)src.getBasePtr(nx, cy),
+			               (const byte *)src.getBasePtr(cx, ny), (const byte *)src.getBasePtr(nx, ny),
+			               csx & 0xffff, csy & 0xffff, (byte *)target->getBasePtr(x, y));
+		}
+	}
+
+	return target;
+}
+
+static Graphics::TransparentSurface *refRotoscale(const Graphics::TransparentSurface &src, const Graphics::TransformStruct &transform) {
+	Common::Point newHotspot;
+	const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(src.w, src.h), transform, &newHotspot);
+
+	Graphics::TransparentSurface *target = new Graphics::TransparentSurface();
+	target->create(rect.width(), rect.height(), src.format);
+
+	const float invAngleRad = Common::deg2rad<uint32, float>(360 - (transform._angle % 360));
+	const float invCos = cos(invAngleRad);
+	const float invSin = sin(invAngleRad);
+	const int icosx = (int)(invCos * (65536.0f * Graphics::kDefaultZoomX / transform._zoom.x));
+	const int isinx = (int)(invSin * (65536.0f * Graphics::kDefaultZoomX / transform._zoom.x));
+	const int icosy = (int)(invCos * (65536.0f * Graphics::kDefaultZoomY / transform._zoom.y));
+	const int isiny = (int)(invSin * (65536.0f * Graphics::kDefaultZoomY / transform._zoom.y));
+
+	for (int y = 0; y < target->h; y++) {
+		for (int x = 0; x < target->w; x++) {
+			const int sdx = -icosx * newHotspot.x + isinx * (newHotspot.y - y) + (transform._hotspot.x << 16) + x * icosx;
+			const int sdy = -isiny * newHotspot.x - icosy * (newHotspot.y - y) + (transform._hotspot.y << 16) + x * isiny;
+			const int dx = sdx >> 16;
+			const int dy = sdy >> 16;
+
+			if (dx > -1 && dy > -1 && dx < src.w - 1 && dy < src.h - 1) {
+				refInterpolate((const byte *)src.getBasePtr(dx, dy), (const byte *)src.getBasePtr(dx + 1, dy),
+				               (const byte *)src.getBasePtr(dx, dy + 1), (const byte *)src.getBasePtr(dx + 1, dy + 1),
+				               sdx & 0xffff, sdy & 0xffff, (byte *)target->getBasePtr(x, y));
+			}
+		}
+	}
+
+	return target;
+}
+
+class TransformedSurfaceCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestRandomSource _rnd;
+
+	static bool equals(const Graphics::Surface *a, const Graphics::Surface *b) {
+		return a->w == b->w && a->h == b->h && a->pitch == b->pitch &&
+		       !memcmp(a->getPixels(), b->getPixels(), a->pitch * a->h);
+	}
+
+	static void destroy(Graphics::Surface *surface) {
+		surface->free();
+		delete surface;
+	}
+
+	void createSource(Graphics::TransparentSurface &surface, int width, int height) {
+		surface.create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		_rnd.fill(surface.getPixels(), surface.pitch * surface.h);
+	}
+
+public:
+	void test_scale() {
+		_rnd.setSeed(1);
+		Graphics::TransparentSurface source;
+		createSource(source, 23, 17);
+
+		// Each entry holds the result and a copy of the source
+		const uint32 entrySize = (40 * 9 + 23 * 17) * 4;
+
+		Graphics::TransformedSurfaceCache cache;
+		for (int i = 0; i < 2; i++) {
+			Graphics::TransparentSurface *reference = refScale(source, 40, 9);
+			Graphics::TransparentSurface *result = cache.scale(source, 40, 9, Graphics::FILTER_BILINEAR);
+			TS_ASSERT(equals(result, reference));
+			TS_ASSERT_EQUALS(cache.getSize(), entrySize);
+			destroy(reference);
+			destroy(result);
+		}
+
+		// Other sizes and filters are separate entries
+		Graphics::TransparentSurface *reference = source.scaleT<Graphics::FILTER_NEAREST>(40, 9);
+		Graphics::TransparentSurface *result = cache.scale(source, 40, 9, Graphics::FILTER_NEAREST);
+		TS_ASSERT(equals(result, reference));
+		TS_ASSERT_EQUALS(cache.getSize(), 2 * entrySize);
+		destroy(reference);
+		destroy(result);
+
+		// A copy of the source elsewhere in memory finds the same entry
+		Graphics::TransparentSurface copy;
+		copy.copyFrom(source);
+		reference = refScale(source, 40, 9);
+		result = cache.scale(copy, 40, 9, Graphics::FILTER_BILINEAR);
+		TS_ASSERT(equals(result, reference));
+		TS_ASSERT_EQUALS(cache.getSize(), 2 * entrySize);
+		destroy(reference);
+		destroy(result);
+
+		// Changing a single pixel of the source must not return stale
+		// results
+		*(uint32 *)copy.getBasePtr(copy.w - 1, copy.h - 1) ^= 0x100;
+		reference = refScale(copy, 40, 9);
+		result = cache.scale(copy, 40, 9, Graphics::FILTER_BILINEAR);
+		TS_ASSERT(equals(result, reference));
+		TS_ASSERT_EQUALS(cache.getSize(), 3 * entrySize);
+		destroy(reference);
+		destroy(result);
+		copy.free();
+
+		// The original source still hits its own entry
+		reference = refScale(source, 40, 9);
+		result = cache.scale(source, 40, 9, Graphics::FILTER_BILINEAR);
+		TS_ASSERT(equals(result, reference));
+		TS_ASSERT_EQUALS(cache.getSize(), 3 * entrySize);
+		destroy(reference);
+		destroy(result);
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+		source.free();
+	}
+
+	void test_scale_sizes() {
+		// Upscaling and downscaling, with odd sizes for the scalar tails
+		static const int sizes[][2] = { { 2, 2 }, { 3, 7 }, { 17, 5 }, { 64, 33 }, { 101, 99 } };
+
+		_rnd.setSeed(4);
+		Graphics::TransparentSurface source;
+		createSource(source, 37, 29);
+
+		bool equal = true;
+		for (int i = 0; i < ARRAYSIZE(sizes); i++) {
+			Graphics::TransparentSurface *reference = refScale(source, sizes[i][0], sizes[i][1]);
+			Graphics::TransparentSurface *result = source.scaleT<Graphics::FILTER_BILINEAR>(sizes[i][0], sizes[i][1]);
+			equal = equal && equals(result, reference);
+			destroy(reference);
+			destroy(result);
+		}
+		TS_ASSERT(equal);
+
+		source.free();
+	}
+
+	void test_rotoscale() {
+		_rnd.setSeed(2);
+		Graphics::TransparentSurface source;
+		createSource(source, 31, 20);
+
+		Graphics::TransformedSurfaceCache cache;
+		const Graphics::TransformStruct transforms[] = {
+			Graphics::TransformStruct(100, 100, 30, 15, 10),
+			Graphics::TransformStruct(150, 80, 30, 15, 10),
+			Graphics::TransformStruct(100, 100, 30, 0, 0),
+			Graphics::TransformStruct(100, 100, 200, 15, 10),
+			Graphics::TransformStruct(37, 230, 271, 3, 19)
+		};
+
+		for (int i = 0; i < 2; i++) {
+			for (uint j = 0; j < ARRAYSIZE(transforms); j++) {
+				Graphics::TransparentSurface *reference = refRotoscale(source, transforms[j]);
+				Graphics::TransparentSurface *result = cache.rotoscale(source, transforms[j], Graphics::FILTER_BILINEAR);
+				TS_ASSERT(equals(result, reference));
+				destroy(reference);
+				destroy(result);
+			}
+		}
+
+		source.free();
+	}
+
+	void test_size_limit() {
+		_rnd.setSeed(3);
+		Graphics::TransparentSurface source;
+		createSource(source, 10, 10);
+
+		// Room for two 20x20 surfaces and their sources
+		const uint32 maxSize = 2 * (20 * 20 + 10 * 10) * 4;
+		Graphics::TransformedSurfaceCache cache(maxSize);
+		for (int i = 0; i < 5; i++) {
+			destroy(cache.scale(source, 20, 20 + i, Graphics::FILTER_BILINEAR));
+			TS_ASSERT(cache.getSize() <= maxSize);
+		}
+
+		// Surfaces larger than the cache are not stored at all
+		destroy(cache.scale(source, 100, 100, Graphics::FILTER_BILINEAR));
+		TS_ASSERT(cache.getSize() <= maxSize);
+		TS_ASSERT(cache.getSize() > 0);
+
+		source.free();
+	}
+};
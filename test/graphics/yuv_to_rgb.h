@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/yuv_to_rgb.h"
+
+#include "test/random.h"
+
+#include "common/util.h"
+
+// YUVToRGBManager converts several pixels at a time where possible. This
+// reference converts one pixel at a time, the way the lookup tables do.
+static uint32 refYUVToRGB(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, byte y, byte u, byte v) {
+	const int16 cr = v - 128;
+	const int16 cb = u - 128;
+	const int d[3] = {
+		(int16)((0.419 / 0.299) * cr),
+		(int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb),
+		(int16)((0.587 / 0.331) * cb)
+	};
+
+	byte c[3];
+	for (int i = 0; i < 3; i++) {
+		if (scale == Graphics::YUVToRGBManager::kScaleFull)
+			c[i] = CLIP<int>(y + d[i], 0, 255);
+		else
+			c[i] = (CLIP<int>(y + d[i], 16, 235) - 16) * 255 / 219;
+	}
+
+	return format.RGBToColor(c[0], c[1], c[2]);
+}
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	TestRandomSource _rnd;
+
+	void convertTemplate(Subsampling subsampling, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		_rnd.setSeed(subsampling * 100 + width + format.bytesPerPixel);
+
+		const int shift = (subsampling == k444) ? 0 : (subsampling == k420) ? 1 : 2;
+		const int yPitch = width + 3;
+		// YUV410 needs an extra row and column of chroma values
+		const int uvPitch = (width >> shift) + 5;
+		const int uvHeight = (height >> shift) + 1;
+
+		byte *ySrc = new byte[yPitch * height];
+		byte *uSrc = new byte[uvPitch * uvHeight];
+		byte *vSrc = new byte[uvPitch * uvHeight];
+		_rnd.fill(ySrc, yPitch * height);
+		_rnd.fill(uSrc, uvPitch * uvHeight);
+		_rnd.fill(vSrc, uvPitch * uvHeight);
+
+		Graphics::Surface dst;
+		dst.create(width, height, format);
+
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, ySrc, uSrc, vSrc, width, height, yPitch, uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, ySrc, uSrc, vSrc, width, height, yPitch, uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, ySrc, uSrc, vSrc, width, height, yPitch, uvPitch);
+			break;
+		}
+
+		bool equal = true;
+		for (int y = 0; y < height && equal; y++) {
+			for (int x = 0; x < width && equal; x++) {
+				byte u, v;
+				if (subsampling == k410) {
+					const int index = (y >> 2) * uvPitch + (x >> 2);
+					const int xDiff = x & 3, yDiff = y & 3;
+					u = (uSrc[index] * (4 - xDiff) * (4 - yDiff) + uSrc[index + 1] * xDiff * (4 - yDiff) +
+					     uSrc[index + uvPitch] * yDiff * (4 - xDiff) + uSrc[index + uvPitch + 1] * xDiff * yDiff) >> 4;
+					v = (vSrc[index] * (4 - xDiff) * (4 - yDiff) + vSrc[index + 1] * xDiff * (4 - yDiff) +
+					     vSrc[index + uvPitch] * yDiff * (4 - xDiff) + vSrc[index + uvPitch + 1] * xDiff * yDiff) >> 4;
+				} else {
+					u = uSrc[(y >> shift) * uvPitch + (x >> shift)];
+					v = vSrc[(y >> shift) * uvPitch + (x >> shift)];
+				}
+
+				const uint32 expected = refYUVToRGB(format, scale, ySrc[y * yPitch + x], u, v);
+				const uint32 pixel = (format.bytesPerPixel == 2) ? *(const uint16 *)dst.getBasePtr(x, y) : *(const uint32 *)dst.getBasePtr(x, y);
+				equal = pixel == expected;
+			}
+		}
+		TS_ASSERT(equal);
+
+		dst.free();
+		delete[] ySrc;
+		delete[] uSrc;
+		delete[] vSrc;
+	}
+
+	void formatsTemplate(Subsampling subsampling, int width, int height) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(formats); i++) {
+			convertTemplate(subsampling, formats[i], Graphics::YUVToRGBManager::kScaleFull, width, height);
+			convertTemplate(subsampling, formats[i], Graphics::YUVToRGBManager::kScaleITU, width, height);
+		}
+	}
+
+public:
+	void test_yuv444() {
+		formatsTemplate(k444, 37, 11);
+		formatsTemplate(k444, 64, 16);
+	}
+
+	void test_yuv420() {
+		formatsTemplate(k420, 42, 14);
+		formatsTemplate(k420, 64, 16);
+	}
+
+	void test_yuv410() {
+		formatsTemplate(k410, 36, 12);
+		formatsTemplate(k410, 300, 16);
+	}
+};
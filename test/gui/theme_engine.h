@@ -0,0 +1,140 @@
+#include <cxxtest/TestSuite.h>
+
+#include "gui/ThemeEngine.h"
+
+#include "test/system.h"
+
+class ThemeEngineTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Gives access to the drawing of single DrawData items
+	class TestThemeEngine : public GUI::ThemeEngine {
+	public:
+		TestThemeEngine() : GUI::ThemeEngine("builtin", kGfxStandard) {}
+
+		void draw(GUI::DrawData type, const Common::Rect &r) {
+			_layerToDraw = GUI::kDrawLayerBackground;
+			drawDD(type, r);
+		}
+
+		uint getRenderCacheEntries() const { return _renderCache.size(); }
+		void flushRenderCache() { clearRenderCache(); }
+
+		Graphics::Surface &getBackBuffer() { return _backBuffer; }
+		Graphics::Surface &getScreen() { return _screen; }
+	};
+
+	ScopedTestSystem *_system;
+	TestThemeEngine *_theme;
+
+	void fillBackBuffer(const Common::Rect &r, uint8 r8, uint8 g8, uint8 b8) {
+		Graphics::Surface &backBuffer = _theme->getBackBuffer();
+		backBuffer.fillRect(r, backBuffer.format.RGBToColor(r8, g8, b8));
+	}
+
+	// Draws the items over the background, with or without the renderings
+	// kept from the earlier ones, and returns a copy of the screen
+	Graphics::Surface *drawAll(const Common::Rect *rects, int count, bool cached) {
+		_theme->flushRenderCache();
+		_theme->drawToScreen();
+		_theme->copyBackBufferToScreen();
+
+		for (int i = 0; i < count; i++) {
+			if (!cached)
+				_theme->flushRenderCache();
+			_theme->draw(GUI::kDDButtonIdle, rects[i]);
+		}
+
+		Graphics::Surface *screen = new Graphics::Surface();
+		screen->copyFrom(_theme->getScreen());
+		return screen;
+	}
+
+	bool drawsAsUncached(const Common::Rect *rects, int count) {
+		Graphics::Surface *cached = drawAll(rects, count, true);
+		Graphics::Surface *uncached = drawAll(rects, count, false);
+		const bool equal = !memcmp(cached->getPixels(), uncached->getPixels(), cached->pitch * cached->h);
+
+		cached->free();
+		delete cached;
+		uncached->free();
+		delete uncached;
+		return equal;
+	}
+
+public:
+	void setUp() {
+		_system = new ScopedTestSystem();
+		_theme = new TestThemeEngine();
+		TS_ASSERT(_theme->init());
+	}
+
+	void tearDown() {
+		delete _theme;
+		delete _system;
+	}
+
+	void test_render_cache_hit() {
+		fillBackBuffer(Common::Rect(640, 400), 0x40, 0x60, 0x80);
+
+		// The same button in two places over the same background
+		const Common::Rect rects[] = { Common::Rect(10, 10, 110, 40), Common::Rect(200, 100, 300, 130) };
+		TS_ASSERT(drawsAsUncached(rects, ARRAYSIZE(rects)));
+
+		_theme->flushRenderCache();
+		_theme->draw(GUI::kDDButtonIdle, rects[0]);
+		TS_ASSERT_EQUALS(_theme->getRenderCacheEntries(), 1u);
+		_theme->draw(GUI::kDDButtonIdle, rects[1]);
+		TS_ASSERT_EQUALS(_theme->getRenderCacheEntries(), 1u);
+	}
+
+	void test_render_cache_miss() {
+		fillBackBuffer(Common::Rect(640, 400), 0x40, 0x60, 0x80);
+		fillBackBuffer(Common::Rect(320, 0, 640, 400), 0xC0, 0x20, 0x20);
+
+		const Common::Rect rects[] = {
+			// Over another background
+			Common::Rect(10, 10, 110, 40),
+			Common::Rect(400, 10, 500, 40),
+			// At an odd x position
+			Common::Rect(11, 100, 111, 130),
+			// Half over both backgrounds
+			Common::Rect(270, 200, 370, 230),
+			// Clipped by the screen
+			Common::Rect(590, 380, 690, 410)
+		};
+		TS_ASSERT(drawsAsUncached(rects, ARRAYSIZE(rects)));
+	}
+
+	void test_render_cache_flush() {
+		fillBackBuffer(Common::Rect(640, 400), 0x40, 0x60, 0x80);
+		_theme->drawToScreen();
+		_theme->draw(GUI::kDDButtonIdle, Common::Rect(10, 10, 110, 40));
+		TS_ASSERT_EQUALS(_theme->getRenderCacheEntries(), 1u);
+
+		// Recreating the surfaces drops the renderings
+		_theme->refresh();
+		TS_ASSERT_EQUALS(_theme->getRenderCacheEntries(), 0u);
+	}
+
+	void test_restore_back_buffer() {
+		Graphics::Surface &backBuffer = _theme->getBackBuffer();
+		TS_ASSERT(!_theme->restoreBackBuffer());
+
+		fillBackBuffer(Common::Rect(640, 400), 0x40, 0x60, 0x80);
+		fillBackBuffer(Common::Rect(100, 100, 200, 150), 0xC0, 0x20, 0x20);
+		_theme->saveBackBuffer();
+
+		Graphics::Surface saved;
+		saved.copyFrom(backBuffer);
+
+		fillBackBuffer(Common::Rect(50, 50, 300, 300), 0xFF, 0xFF, 0xFF);
+		TS_ASSERT(_theme->restoreBackBuffer());
+		TS_ASSERT(!memcmp(backBuffer.getPixels(), saved.getPixels(), saved.pitch * saved.h));
+		saved.free();
+
+		// Nothing is restored into new surfaces
+		_theme->refresh();
+		TS_ASSERT(!_theme->restoreBackBuffer());
+	}
+};
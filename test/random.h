@@ -0,0 +1,49 @@
+#ifndef TEST_RANDOM_H
+#define TEST_RANDOM_H
+
+#include "common/scummsys.h"
+
+/**
+ * Reproducible pseudo random numbers for the tests, which fill buffers with
+ * random data and compare the results against a reference.
+ *
+ * Common::RandomSource cannot be used, since it needs g_system.
+ */
+class TestRandomSource {
+public:
+	TestRandomSource(uint32 seed = 1) : _seed(seed) {}
+
+	void setSeed(uint32 seed) { _seed = seed; }
+
+	/**
+	 * Generates a random 32-bit unsigned integer.
+	 */
+	uint32 getRandomNumber() {
+		_seed = _seed * 1103515245 + 12345;
+		// The low bits of the generator have short periods, so move the
+		// high ones down
+		return (_seed >> 16) | (_seed << 16);
+	}
+
+	/**
+	 * Generates a random unsigned integer in the interval [0, max], like
+	 * Common::RandomSource::getRandomNumber().
+	 */
+	uint32 getRandomNumber(uint32 max) {
+		return getRandomNumber() % (max + 1);
+	}
+
+	/**
+	 * Fills a buffer with random bytes.
+	 */
+	void fill(void *data, uint32 size) {
+		byte *ptr = (byte *)data;
+		for (uint32 i = 0; i < size; i++)
+			ptr[i] = getRandomNumber();
+	}
+
+private:
+	uint32 _seed;
+};
+
+#endif
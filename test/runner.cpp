@@ -0,0 +1,2186 @@
+/* Generated file, do not edit */
+
+#ifndef CXXTEST_RUNNING
+#define CXXTEST_RUNNING
+#endif
+
+#define _CXXTEST_HAVE_STD
+#include "./test/cxxtest_mingw.h"
+#include <cxxtest/TestListener.h>
+#include <cxxtest/TestTracker.h>
+#include <cxxtest/TestRunner.h>
+#include <cxxtest/RealDescriptions.h>
+#include <cxxtest/StdioPrinter.h>
+
+int main() {
+ return CxxTest::StdioPrinter().run();
+}
+#include "test/common/algorithm.h"
+
+static AlgorithmTestSuite suite_AlgorithmTestSuite;
+
+static CxxTest::List Tests_AlgorithmTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_AlgorithmTestSuite( "test/common/algorithm.h", 8, "AlgorithmTestSuite", suite_AlgorithmTestSuite, Tests_AlgorithmTestSuite );
+
+static class TestDescription_AlgorithmTestSuite_test_check_sort : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AlgorithmTestSuite_test_check_sort() : CxxTest::RealTestDescription( Tests_AlgorithmTestSuite, suiteDescription_AlgorithmTestSuite, 65, "test_check_sort" ) {}
+ void runTest() { suite_AlgorithmTestSuite.test_check_sort(); }
+} testDescription_AlgorithmTestSuite_test_check_sort;
+
+static class TestDescription_AlgorithmTestSuite_test_pod_sort : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AlgorithmTestSuite_test_pod_sort() : CxxTest::RealTestDescription( Tests_AlgorithmTestSuite, suiteDescription_AlgorithmTestSuite, 76, "test_pod_sort" ) {}
+ void runTest() { suite_AlgorithmTestSuite.test_pod_sort(); }
+} testDescription_AlgorithmTestSuite_test_pod_sort;
+
+static class TestDescription_AlgorithmTestSuite_test_container_sort : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AlgorithmTestSuite_test_container_sort() : CxxTest::RealTestDescription( Tests_AlgorithmTestSuite, suiteDescription_AlgorithmTestSuite, 114, "test_container_sort" ) {}
+ void runTest() { suite_AlgorithmTestSuite.test_container_sort(); }
+} testDescription_AlgorithmTestSuite_test_container_sort;
+
+static class TestDescription_AlgorithmTestSuite_test_string_replace : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AlgorithmTestSuite_test_string_replace() : CxxTest::RealTestDescription( Tests_AlgorithmTestSuite, suiteDescription_AlgorithmTestSuite, 129, "test_string_replace" ) {}
+ void runTest() { suite_AlgorithmTestSuite.test_string_replace(); }
+} testDescription_AlgorithmTestSuite_test_string_replace;
+
+static class TestDescription_AlgorithmTestSuite_test_container_replace : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AlgorithmTestSuite_test_container_replace() : CxxTest::RealTestDescription( Tests_AlgorithmTestSuite, suiteDescription_AlgorithmTestSuite, 139, "test_container_replace" ) {}
+ void runTest() { suite_AlgorithmTestSuite.test_container_replace(); }
+} testDescription_AlgorithmTestSuite_test_container_replace;
+
+#include "test/common/array.h"
+
+static ArrayTestSuite suite_ArrayTestSuite;
+
+static CxxTest::List Tests_ArrayTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ArrayTestSuite( "test/common/array.h", 7, "ArrayTestSuite", suite_ArrayTestSuite, Tests_ArrayTestSuite );
+
+static class TestDescription_ArrayTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 10, "test_empty_clear" ) {}
+ void runTest() { suite_ArrayTestSuite.test_empty_clear(); }
+} testDescription_ArrayTestSuite_test_empty_clear;
+
+static class TestDescription_ArrayTestSuite_test_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_iterator() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 20, "test_iterator" ) {}
+ void runTest() { suite_ArrayTestSuite.test_iterator(); }
+} testDescription_ArrayTestSuite_test_iterator;
+
+static class TestDescription_ArrayTestSuite_test_erase_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_erase_iterator() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 48, "test_erase_iterator" ) {}
+ void runTest() { suite_ArrayTestSuite.test_erase_iterator(); }
+} testDescription_ArrayTestSuite_test_erase_iterator;
+
+static class TestDescription_ArrayTestSuite_test_insert_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_insert_iterator() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 68, "test_insert_iterator" ) {}
+ void runTest() { suite_ArrayTestSuite.test_insert_iterator(); }
+} testDescription_ArrayTestSuite_test_insert_iterator;
+
+static class TestDescription_ArrayTestSuite_test_direct_access : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_direct_access() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 90, "test_direct_access" ) {}
+ void runTest() { suite_ArrayTestSuite.test_direct_access(); }
+} testDescription_ArrayTestSuite_test_direct_access;
+
+static class TestDescription_ArrayTestSuite_test_insert_at : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_insert_at() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 103, "test_insert_at" ) {}
+ void runTest() { suite_ArrayTestSuite.test_insert_at(); }
+} testDescription_ArrayTestSuite_test_insert_at;
+
+static class TestDescription_ArrayTestSuite_test_insert_at_array : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_insert_at_array() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 124, "test_insert_at_array" ) {}
+ void runTest() { suite_ArrayTestSuite.test_insert_at_array(); }
+} testDescription_ArrayTestSuite_test_insert_at_array;
+
+static class TestDescription_ArrayTestSuite_test_self_insert : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_self_insert() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 153, "test_self_insert" ) {}
+ void runTest() { suite_ArrayTestSuite.test_self_insert(); }
+} testDescription_ArrayTestSuite_test_self_insert;
+
+static class TestDescription_ArrayTestSuite_test_remove_at : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_remove_at() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 182, "test_remove_at" ) {}
+ void runTest() { suite_ArrayTestSuite.test_remove_at(); }
+} testDescription_ArrayTestSuite_test_remove_at;
+
+static class TestDescription_ArrayTestSuite_test_push_back : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_push_back() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 203, "test_push_back" ) {}
+ void runTest() { suite_ArrayTestSuite.test_push_back(); }
+} testDescription_ArrayTestSuite_test_push_back;
+
+static class TestDescription_ArrayTestSuite_test_push_back_ex : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_push_back_ex() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 238, "test_push_back_ex" ) {}
+ void runTest() { suite_ArrayTestSuite.test_push_back_ex(); }
+} testDescription_ArrayTestSuite_test_push_back_ex;
+
+static class TestDescription_ArrayTestSuite_test_copy_constructor : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_copy_constructor() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 251, "test_copy_constructor" ) {}
+ void runTest() { suite_ArrayTestSuite.test_copy_constructor(); }
+} testDescription_ArrayTestSuite_test_copy_constructor;
+
+static class TestDescription_ArrayTestSuite_test_equals : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_equals() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 273, "test_equals" ) {}
+ void runTest() { suite_ArrayTestSuite.test_equals(); }
+} testDescription_ArrayTestSuite_test_equals;
+
+static class TestDescription_ArrayTestSuite_test_array_constructor : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_array_constructor() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 290, "test_array_constructor" ) {}
+ void runTest() { suite_ArrayTestSuite.test_array_constructor(); }
+} testDescription_ArrayTestSuite_test_array_constructor;
+
+static class TestDescription_ArrayTestSuite_test_array_constructor_count : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_array_constructor_count() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 314, "test_array_constructor_count" ) {}
+ void runTest() { suite_ArrayTestSuite.test_array_constructor_count(); }
+} testDescription_ArrayTestSuite_test_array_constructor_count;
+
+static class TestDescription_ArrayTestSuite_test_array_constructor_count_copy_value : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_array_constructor_count_copy_value() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 325, "test_array_constructor_count_copy_value" ) {}
+ void runTest() { suite_ArrayTestSuite.test_array_constructor_count_copy_value(); }
+} testDescription_ArrayTestSuite_test_array_constructor_count_copy_value;
+
+static class TestDescription_ArrayTestSuite_test_array_constructor_str : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_array_constructor_str() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 349, "test_array_constructor_str" ) {}
+ void runTest() { suite_ArrayTestSuite.test_array_constructor_str(); }
+} testDescription_ArrayTestSuite_test_array_constructor_str;
+
+static class TestDescription_ArrayTestSuite_test_data : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_data() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 361, "test_data" ) {}
+ void runTest() { suite_ArrayTestSuite.test_data(); }
+} testDescription_ArrayTestSuite_test_data;
+
+static class TestDescription_ArrayTestSuite_test_front_back_push_pop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_front_back_push_pop() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 370, "test_front_back_push_pop" ) {}
+ void runTest() { suite_ArrayTestSuite.test_front_back_push_pop(); }
+} testDescription_ArrayTestSuite_test_front_back_push_pop;
+
+static class TestDescription_ArrayTestSuite_test_resize : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ArrayTestSuite_test_resize() : CxxTest::RealTestDescription( Tests_ArrayTestSuite, suiteDescription_ArrayTestSuite, 389, "test_resize" ) {}
+ void runTest() { suite_ArrayTestSuite.test_resize(); }
+} testDescription_ArrayTestSuite_test_resize;
+
+static SortedArrayTestSuite suite_SortedArrayTestSuite;
+
+static CxxTest::List Tests_SortedArrayTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_SortedArrayTestSuite( "test/common/array.h", 425, "SortedArrayTestSuite", suite_SortedArrayTestSuite, Tests_SortedArrayTestSuite );
+
+static class TestDescription_SortedArrayTestSuite_test_insert : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SortedArrayTestSuite_test_insert() : CxxTest::RealTestDescription( Tests_SortedArrayTestSuite, suiteDescription_SortedArrayTestSuite, 427, "test_insert" ) {}
+ void runTest() { suite_SortedArrayTestSuite.test_insert(); }
+} testDescription_SortedArrayTestSuite_test_insert;
+
+#include "test/common/bitstream.h"
+
+static BitStreamTestSuite suite_BitStreamTestSuite;
+
+static CxxTest::List Tests_BitStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_BitStreamTestSuite( "test/common/bitstream.h", 6, "BitStreamTestSuite", suite_BitStreamTestSuite, Tests_BitStreamTestSuite );
+
+static class TestDescription_BitStreamTestSuite_test_get_bit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_get_bit() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 24, "test_get_bit" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_get_bit(); }
+} testDescription_BitStreamTestSuite_test_get_bit;
+
+static class TestDescription_BitStreamTestSuite_test_get_bits : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_get_bits() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 45, "test_get_bits" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_get_bits(); }
+} testDescription_BitStreamTestSuite_test_get_bits;
+
+static class TestDescription_BitStreamTestSuite_test_skip : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_skip() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 69, "test_skip" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_skip(); }
+} testDescription_BitStreamTestSuite_test_skip;
+
+static class TestDescription_BitStreamTestSuite_test_rewind : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_rewind() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 93, "test_rewind" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_rewind(); }
+} testDescription_BitStreamTestSuite_test_rewind;
+
+static class TestDescription_BitStreamTestSuite_test_peek_bit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_peek_bit() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 116, "test_peek_bit" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_peek_bit(); }
+} testDescription_BitStreamTestSuite_test_peek_bit;
+
+static class TestDescription_BitStreamTestSuite_test_peek_bits : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_peek_bits() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 142, "test_peek_bits" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_peek_bits(); }
+} testDescription_BitStreamTestSuite_test_peek_bits;
+
+static class TestDescription_BitStreamTestSuite_test_eos : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_eos() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 165, "test_eos" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_eos(); }
+} testDescription_BitStreamTestSuite_test_eos;
+
+static class TestDescription_BitStreamTestSuite_test_get_bits_lsb : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_get_bits_lsb() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 186, "test_get_bits_lsb" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_get_bits_lsb(); }
+} testDescription_BitStreamTestSuite_test_get_bits_lsb;
+
+static class TestDescription_BitStreamTestSuite_test_peek_bits_lsb : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_peek_bits_lsb() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 212, "test_peek_bits_lsb" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_peek_bits_lsb(); }
+} testDescription_BitStreamTestSuite_test_peek_bits_lsb;
+
+static class TestDescription_BitStreamTestSuite_test_align : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_align() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 233, "test_align" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_align(); }
+} testDescription_BitStreamTestSuite_test_align;
+
+static class TestDescription_BitStreamTestSuite_test_align_16 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamTestSuite_test_align_16() : CxxTest::RealTestDescription( Tests_BitStreamTestSuite, suiteDescription_BitStreamTestSuite, 254, "test_align_16" ) {}
+ void runTest() { suite_BitStreamTestSuite.test_align_16(); }
+} testDescription_BitStreamTestSuite_test_align_16;
+
+#include "test/common/bufferedreadstream.h"
+
+static BufferedReadStreamTestSuite suite_BufferedReadStreamTestSuite;
+
+static CxxTest::List Tests_BufferedReadStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_BufferedReadStreamTestSuite( "test/common/bufferedreadstream.h", 6, "BufferedReadStreamTestSuite", suite_BufferedReadStreamTestSuite, Tests_BufferedReadStreamTestSuite );
+
+static class TestDescription_BufferedReadStreamTestSuite_test_traverse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BufferedReadStreamTestSuite_test_traverse() : CxxTest::RealTestDescription( Tests_BufferedReadStreamTestSuite, suiteDescription_BufferedReadStreamTestSuite, 8, "test_traverse" ) {}
+ void runTest() { suite_BufferedReadStreamTestSuite.test_traverse(); }
+} testDescription_BufferedReadStreamTestSuite_test_traverse;
+
+static class TestDescription_BufferedReadStreamTestSuite_test_traverse2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BufferedReadStreamTestSuite_test_traverse2() : CxxTest::RealTestDescription( Tests_BufferedReadStreamTestSuite, suiteDescription_BufferedReadStreamTestSuite, 34, "test_traverse2" ) {}
+ void runTest() { suite_BufferedReadStreamTestSuite.test_traverse2(); }
+} testDescription_BufferedReadStreamTestSuite_test_traverse2;
+
+#include "test/common/bufferedseekablereadstream.h"
+
+static BufferedSeekableReadStreamTestSuite suite_BufferedSeekableReadStreamTestSuite;
+
+static CxxTest::List Tests_BufferedSeekableReadStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_BufferedSeekableReadStreamTestSuite( "test/common/bufferedseekablereadstream.h", 6, "BufferedSeekableReadStreamTestSuite", suite_BufferedSeekableReadStreamTestSuite, Tests_BufferedSeekableReadStreamTestSuite );
+
+static class TestDescription_BufferedSeekableReadStreamTestSuite_test_traverse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BufferedSeekableReadStreamTestSuite_test_traverse() : CxxTest::RealTestDescription( Tests_BufferedSeekableReadStreamTestSuite, suiteDescription_BufferedSeekableReadStreamTestSuite, 8, "test_traverse" ) {}
+ void runTest() { suite_BufferedSeekableReadStreamTestSuite.test_traverse(); }
+} testDescription_BufferedSeekableReadStreamTestSuite_test_traverse;
+
+static class TestDescription_BufferedSeekableReadStreamTestSuite_test_seek : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BufferedSeekableReadStreamTestSuite_test_seek() : CxxTest::RealTestDescription( Tests_BufferedSeekableReadStreamTestSuite, suiteDescription_BufferedSeekableReadStreamTestSuite, 33, "test_seek" ) {}
+ void runTest() { suite_BufferedSeekableReadStreamTestSuite.test_seek(); }
+} testDescription_BufferedSeekableReadStreamTestSuite_test_seek;
+
+#include "test/common/endian.h"
+
+static EndianTestSuite suite_EndianTestSuite;
+
+static CxxTest::List Tests_EndianTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_EndianTestSuite( "test/common/endian.h", 4, "EndianTestSuite", suite_EndianTestSuite, Tests_EndianTestSuite );
+
+static class TestDescription_EndianTestSuite_test_MKTAG : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_MKTAG() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 7, "test_MKTAG" ) {}
+ void runTest() { suite_EndianTestSuite.test_MKTAG(); }
+} testDescription_EndianTestSuite_test_MKTAG;
+
+static class TestDescription_EndianTestSuite_test_READ_BE_UINT64 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_BE_UINT64() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 13, "test_READ_BE_UINT64" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_BE_UINT64(); }
+} testDescription_EndianTestSuite_test_READ_BE_UINT64;
+
+static class TestDescription_EndianTestSuite_test_READ_LE_UINT64 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_LE_UINT64() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 19, "test_READ_LE_UINT64" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_LE_UINT64(); }
+} testDescription_EndianTestSuite_test_READ_LE_UINT64;
+
+static class TestDescription_EndianTestSuite_test_READ_BE_UINT32 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_BE_UINT32() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 25, "test_READ_BE_UINT32" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_BE_UINT32(); }
+} testDescription_EndianTestSuite_test_READ_BE_UINT32;
+
+static class TestDescription_EndianTestSuite_test_READ_LE_UINT32 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_LE_UINT32() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 31, "test_READ_LE_UINT32" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_LE_UINT32(); }
+} testDescription_EndianTestSuite_test_READ_LE_UINT32;
+
+static class TestDescription_EndianTestSuite_test_READ_BE_UINT16 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_BE_UINT16() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 37, "test_READ_BE_UINT16" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_BE_UINT16(); }
+} testDescription_EndianTestSuite_test_READ_BE_UINT16;
+
+static class TestDescription_EndianTestSuite_test_READ_LE_UINT16 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_EndianTestSuite_test_READ_LE_UINT16() : CxxTest::RealTestDescription( Tests_EndianTestSuite, suiteDescription_EndianTestSuite, 43, "test_READ_LE_UINT16" ) {}
+ void runTest() { suite_EndianTestSuite.test_READ_LE_UINT16(); }
+} testDescription_EndianTestSuite_test_READ_LE_UINT16;
+
+#include "test/common/fft.h"
+
+static FFTTestSuite suite_FFTTestSuite;
+
+static CxxTest::List Tests_FFTTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_FFTTestSuite( "test/common/fft.h", 6, "FFTTestSuite", suite_FFTTestSuite, Tests_FFTTestSuite );
+
+static class TestDescription_FFTTestSuite_test_small_sizes : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FFTTestSuite_test_small_sizes() : CxxTest::RealTestDescription( Tests_FFTTestSuite, suiteDescription_FFTTestSuite, 51, "test_small_sizes" ) {}
+ void runTest() { suite_FFTTestSuite.test_small_sizes(); }
+} testDescription_FFTTestSuite_test_small_sizes;
+
+static class TestDescription_FFTTestSuite_test_large_sizes : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FFTTestSuite_test_large_sizes() : CxxTest::RealTestDescription( Tests_FFTTestSuite, suiteDescription_FFTTestSuite, 56, "test_large_sizes" ) {}
+ void runTest() { suite_FFTTestSuite.test_large_sizes(); }
+} testDescription_FFTTestSuite_test_large_sizes;
+
+#include "test/common/fixedstack.h"
+
+static FixedStackTestSuite suite_FixedStackTestSuite;
+
+static CxxTest::List Tests_FixedStackTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_FixedStackTestSuite( "test/common/fixedstack.h", 5, "FixedStackTestSuite", suite_FixedStackTestSuite, Tests_FixedStackTestSuite );
+
+static class TestDescription_FixedStackTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FixedStackTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_FixedStackTestSuite, suiteDescription_FixedStackTestSuite, 7, "test_empty_clear" ) {}
+ void runTest() { suite_FixedStackTestSuite.test_empty_clear(); }
+} testDescription_FixedStackTestSuite_test_empty_clear;
+
+static class TestDescription_FixedStackTestSuite_test_size : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FixedStackTestSuite_test_size() : CxxTest::RealTestDescription( Tests_FixedStackTestSuite, suiteDescription_FixedStackTestSuite, 20, "test_size" ) {}
+ void runTest() { suite_FixedStackTestSuite.test_size(); }
+} testDescription_FixedStackTestSuite_test_size;
+
+static class TestDescription_FixedStackTestSuite_test_top_pop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FixedStackTestSuite_test_top_pop() : CxxTest::RealTestDescription( Tests_FixedStackTestSuite, suiteDescription_FixedStackTestSuite, 37, "test_top_pop" ) {}
+ void runTest() { suite_FixedStackTestSuite.test_top_pop(); }
+} testDescription_FixedStackTestSuite_test_top_pop;
+
+static class TestDescription_FixedStackTestSuite_test_assign : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FixedStackTestSuite_test_assign() : CxxTest::RealTestDescription( Tests_FixedStackTestSuite, suiteDescription_FixedStackTestSuite, 55, "test_assign" ) {}
+ void runTest() { suite_FixedStackTestSuite.test_assign(); }
+} testDescription_FixedStackTestSuite_test_assign;
+
+#include "test/common/func.h"
+
+static FuncTestSuite suite_FuncTestSuite;
+
+static CxxTest::List Tests_FuncTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_FuncTestSuite( "test/common/func.h", 8, "FuncTestSuite", suite_FuncTestSuite, Tests_FuncTestSuite );
+
+static class TestDescription_FuncTestSuite_test_bind1st : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FuncTestSuite_test_bind1st() : CxxTest::RealTestDescription( Tests_FuncTestSuite, suiteDescription_FuncTestSuite, 11, "test_bind1st" ) {}
+ void runTest() { suite_FuncTestSuite.test_bind1st(); }
+} testDescription_FuncTestSuite_test_bind1st;
+
+static class TestDescription_FuncTestSuite_test_bind2nd : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FuncTestSuite_test_bind2nd() : CxxTest::RealTestDescription( Tests_FuncTestSuite, suiteDescription_FuncTestSuite, 17, "test_bind2nd" ) {}
+ void runTest() { suite_FuncTestSuite.test_bind2nd(); }
+} testDescription_FuncTestSuite_test_bind2nd;
+
+static class TestDescription_FuncTestSuite_test_mem_fun_ref : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FuncTestSuite_test_mem_fun_ref() : CxxTest::RealTestDescription( Tests_FuncTestSuite, suiteDescription_FuncTestSuite, 33, "test_mem_fun_ref" ) {}
+ void runTest() { suite_FuncTestSuite.test_mem_fun_ref(); }
+} testDescription_FuncTestSuite_test_mem_fun_ref;
+
+static class TestDescription_FuncTestSuite_test_mem_fun : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FuncTestSuite_test_mem_fun() : CxxTest::RealTestDescription( Tests_FuncTestSuite, suiteDescription_FuncTestSuite, 44, "test_mem_fun" ) {}
+ void runTest() { suite_FuncTestSuite.test_mem_fun(); }
+} testDescription_FuncTestSuite_test_mem_fun;
+
+#include "test/common/hash-str.h"
+
+static HashStrTestSuite suite_HashStrTestSuite;
+
+static CxxTest::List Tests_HashStrTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_HashStrTestSuite( "test/common/hash-str.h", 10, "HashStrTestSuite", suite_HashStrTestSuite, Tests_HashStrTestSuite );
+
+static class TestDescription_HashStrTestSuite_test_case_sensitive_string_equal_to : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_case_sensitive_string_equal_to() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 13, "test_case_sensitive_string_equal_to" ) {}
+ void runTest() { suite_HashStrTestSuite.test_case_sensitive_string_equal_to(); }
+} testDescription_HashStrTestSuite_test_case_sensitive_string_equal_to;
+
+static class TestDescription_HashStrTestSuite_test_ignore_case_equal_to : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_ignore_case_equal_to() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 45, "test_ignore_case_equal_to" ) {}
+ void runTest() { suite_HashStrTestSuite.test_ignore_case_equal_to(); }
+} testDescription_HashStrTestSuite_test_ignore_case_equal_to;
+
+static class TestDescription_HashStrTestSuite_test_case_sensitive_string_hash : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_case_sensitive_string_hash() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 76, "test_case_sensitive_string_hash" ) {}
+ void runTest() { suite_HashStrTestSuite.test_case_sensitive_string_hash(); }
+} testDescription_HashStrTestSuite_test_case_sensitive_string_hash;
+
+static class TestDescription_HashStrTestSuite_test_ignore_case_hash : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_ignore_case_hash() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 98, "test_ignore_case_hash" ) {}
+ void runTest() { suite_HashStrTestSuite.test_ignore_case_hash(); }
+} testDescription_HashStrTestSuite_test_ignore_case_hash;
+
+static class TestDescription_HashStrTestSuite_test_cpp_string_hash : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_cpp_string_hash() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 116, "test_cpp_string_hash" ) {}
+ void runTest() { suite_HashStrTestSuite.test_cpp_string_hash(); }
+} testDescription_HashStrTestSuite_test_cpp_string_hash;
+
+static class TestDescription_HashStrTestSuite_test_c_style_string_hash : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashStrTestSuite_test_c_style_string_hash() : CxxTest::RealTestDescription( Tests_HashStrTestSuite, suiteDescription_HashStrTestSuite, 138, "test_c_style_string_hash" ) {}
+ void runTest() { suite_HashStrTestSuite.test_c_style_string_hash(); }
+} testDescription_HashStrTestSuite_test_c_style_string_hash;
+
+#include "test/common/hashmap.h"
+
+static HashMapTestSuite suite_HashMapTestSuite;
+
+static CxxTest::List Tests_HashMapTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_HashMapTestSuite( "test/common/hashmap.h", 6, "HashMapTestSuite", suite_HashMapTestSuite, Tests_HashMapTestSuite );
+
+static class TestDescription_HashMapTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 9, "test_empty_clear" ) {}
+ void runTest() { suite_HashMapTestSuite.test_empty_clear(); }
+} testDescription_HashMapTestSuite_test_empty_clear;
+
+static class TestDescription_HashMapTestSuite_test_contains : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_contains() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 27, "test_contains" ) {}
+ void runTest() { suite_HashMapTestSuite.test_contains(); }
+} testDescription_HashMapTestSuite_test_contains;
+
+static class TestDescription_HashMapTestSuite_test_add_remove : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_add_remove() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 45, "test_add_remove" ) {}
+ void runTest() { suite_HashMapTestSuite.test_add_remove(); }
+} testDescription_HashMapTestSuite_test_add_remove;
+
+static class TestDescription_HashMapTestSuite_test_add_remove_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_add_remove_iterator() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 74, "test_add_remove_iterator" ) {}
+ void runTest() { suite_HashMapTestSuite.test_add_remove_iterator(); }
+} testDescription_HashMapTestSuite_test_add_remove_iterator;
+
+static class TestDescription_HashMapTestSuite_test_lookup : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_lookup() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 103, "test_lookup" ) {}
+ void runTest() { suite_HashMapTestSuite.test_lookup(); }
+} testDescription_HashMapTestSuite_test_lookup;
+
+static class TestDescription_HashMapTestSuite_test_lookup_with_default : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_lookup_with_default() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 118, "test_lookup_with_default" ) {}
+ void runTest() { suite_HashMapTestSuite.test_lookup_with_default(); }
+} testDescription_HashMapTestSuite_test_lookup_with_default;
+
+static class TestDescription_HashMapTestSuite_test_iterator_begin_end : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_iterator_begin_end() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 136, "test_iterator_begin_end" ) {}
+ void runTest() { suite_HashMapTestSuite.test_iterator_begin_end(); }
+} testDescription_HashMapTestSuite_test_iterator_begin_end;
+
+static class TestDescription_HashMapTestSuite_test_hash_map_copy : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_hash_map_copy() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 151, "test_hash_map_copy" ) {}
+ void runTest() { suite_HashMapTestSuite.test_hash_map_copy(); }
+} testDescription_HashMapTestSuite_test_hash_map_copy;
+
+static class TestDescription_HashMapTestSuite_test_collision : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_collision() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 158, "test_collision" ) {}
+ void runTest() { suite_HashMapTestSuite.test_collision(); }
+} testDescription_HashMapTestSuite_test_collision;
+
+static class TestDescription_HashMapTestSuite_test_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HashMapTestSuite_test_iterator() : CxxTest::RealTestDescription( Tests_HashMapTestSuite, suiteDescription_HashMapTestSuite, 200, "test_iterator" ) {}
+ void runTest() { suite_HashMapTestSuite.test_iterator(); }
+} testDescription_HashMapTestSuite_test_iterator;
+
+#include "test/common/huffman.h"
+
+static HuffmanTestSuite suite_HuffmanTestSuite;
+
+static CxxTest::List Tests_HuffmanTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_HuffmanTestSuite( "test/common/huffman.h", 12, "HuffmanTestSuite", suite_HuffmanTestSuite, Tests_HuffmanTestSuite );
+
+static class TestDescription_HuffmanTestSuite_test_get_with_full_symbols : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HuffmanTestSuite_test_get_with_full_symbols() : CxxTest::RealTestDescription( Tests_HuffmanTestSuite, suiteDescription_HuffmanTestSuite, 14, "test_get_with_full_symbols" ) {}
+ void runTest() { suite_HuffmanTestSuite.test_get_with_full_symbols(); }
+} testDescription_HuffmanTestSuite_test_get_with_full_symbols;
+
+static class TestDescription_HuffmanTestSuite_test_get_without_symbols : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HuffmanTestSuite_test_get_without_symbols() : CxxTest::RealTestDescription( Tests_HuffmanTestSuite, suiteDescription_HuffmanTestSuite, 60, "test_get_without_symbols" ) {}
+ void runTest() { suite_HuffmanTestSuite.test_get_without_symbols(); }
+} testDescription_HuffmanTestSuite_test_get_without_symbols;
+
+#include "test/common/list.h"
+
+static ListTestSuite suite_ListTestSuite;
+
+static CxxTest::List Tests_ListTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ListTestSuite( "test/common/list.h", 5, "ListTestSuite", suite_ListTestSuite, Tests_ListTestSuite );
+
+static class TestDescription_ListTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 8, "test_empty_clear" ) {}
+ void runTest() { suite_ListTestSuite.test_empty_clear(); }
+} testDescription_ListTestSuite_test_empty_clear;
+
+static class TestDescription_ListTestSuite_test_size : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_size() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 19, "test_size" ) {}
+ void runTest() { suite_ListTestSuite.test_size(); }
+} testDescription_ListTestSuite_test_size;
+
+static class TestDescription_ListTestSuite_test_iterator_begin_end : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_iterator_begin_end() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 30, "test_iterator_begin_end" ) {}
+ void runTest() { suite_ListTestSuite.test_iterator_begin_end(); }
+} testDescription_ListTestSuite_test_iterator_begin_end;
+
+static class TestDescription_ListTestSuite_test_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_iterator() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 45, "test_iterator" ) {}
+ void runTest() { suite_ListTestSuite.test_iterator(); }
+} testDescription_ListTestSuite_test_iterator;
+
+static class TestDescription_ListTestSuite_test_insert : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_insert() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 89, "test_insert" ) {}
+ void runTest() { suite_ListTestSuite.test_insert(); }
+} testDescription_ListTestSuite_test_insert;
+
+static class TestDescription_ListTestSuite_test_erase : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_erase() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 131, "test_erase" ) {}
+ void runTest() { suite_ListTestSuite.test_erase(); }
+} testDescription_ListTestSuite_test_erase;
+
+static class TestDescription_ListTestSuite_test_remove : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_remove() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 171, "test_remove" ) {}
+ void runTest() { suite_ListTestSuite.test_remove(); }
+} testDescription_ListTestSuite_test_remove;
+
+static class TestDescription_ListTestSuite_test_reverse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_reverse() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 207, "test_reverse" ) {}
+ void runTest() { suite_ListTestSuite.test_reverse(); }
+} testDescription_ListTestSuite_test_reverse;
+
+static class TestDescription_ListTestSuite_test_front_back_push_pop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ListTestSuite_test_front_back_push_pop() : CxxTest::RealTestDescription( Tests_ListTestSuite, suiteDescription_ListTestSuite, 249, "test_front_back_push_pop" ) {}
+ void runTest() { suite_ListTestSuite.test_front_back_push_pop(); }
+} testDescription_ListTestSuite_test_front_back_push_pop;
+
+#include "test/common/math.h"
+
+static MathTestSuite suite_MathTestSuite;
+
+static CxxTest::List Tests_MathTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MathTestSuite( "test/common/math.h", 7, "MathTestSuite", suite_MathTestSuite, Tests_MathTestSuite );
+
+static class TestDescription_MathTestSuite_test_intLog2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MathTestSuite_test_intLog2() : CxxTest::RealTestDescription( Tests_MathTestSuite, suiteDescription_MathTestSuite, 10, "test_intLog2" ) {}
+ void runTest() { suite_MathTestSuite.test_intLog2(); }
+} testDescription_MathTestSuite_test_intLog2;
+
+static class TestDescription_MathTestSuite_test_rad2deg : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MathTestSuite_test_rad2deg() : CxxTest::RealTestDescription( Tests_MathTestSuite, suiteDescription_MathTestSuite, 21, "test_rad2deg" ) {}
+ void runTest() { suite_MathTestSuite.test_rad2deg(); }
+} testDescription_MathTestSuite_test_rad2deg;
+
+static class TestDescription_MathTestSuite_test_deg2rad : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MathTestSuite_test_deg2rad() : CxxTest::RealTestDescription( Tests_MathTestSuite, suiteDescription_MathTestSuite, 34, "test_deg2rad" ) {}
+ void runTest() { suite_MathTestSuite.test_deg2rad(); }
+} testDescription_MathTestSuite_test_deg2rad;
+
+#include "test/common/md5.h"
+
+static MD5TestSuite suite_MD5TestSuite;
+
+static CxxTest::List Tests_MD5TestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MD5TestSuite( "test/common/md5.h", 30, "MD5TestSuite", suite_MD5TestSuite, Tests_MD5TestSuite );
+
+static class TestDescription_MD5TestSuite_test_computeStreamMD5 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MD5TestSuite_test_computeStreamMD5() : CxxTest::RealTestDescription( Tests_MD5TestSuite, suiteDescription_MD5TestSuite, 32, "test_computeStreamMD5" ) {}
+ void runTest() { suite_MD5TestSuite.test_computeStreamMD5(); }
+} testDescription_MD5TestSuite_test_computeStreamMD5;
+
+#include "test/common/memoryreadstream.h"
+
+static MemoryReadStreamTestSuite suite_MemoryReadStreamTestSuite;
+
+static CxxTest::List Tests_MemoryReadStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MemoryReadStreamTestSuite( "test/common/memoryreadstream.h", 5, "MemoryReadStreamTestSuite", suite_MemoryReadStreamTestSuite, Tests_MemoryReadStreamTestSuite );
+
+static class TestDescription_MemoryReadStreamTestSuite_test_seek_set : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_seek_set() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 7, "test_seek_set" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_seek_set(); }
+} testDescription_MemoryReadStreamTestSuite_test_seek_set;
+
+static class TestDescription_MemoryReadStreamTestSuite_test_seek_cur : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_seek_cur() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 24, "test_seek_cur" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_seek_cur(); }
+} testDescription_MemoryReadStreamTestSuite_test_seek_cur;
+
+static class TestDescription_MemoryReadStreamTestSuite_test_seek_end : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_seek_end() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 45, "test_seek_end" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_seek_end(); }
+} testDescription_MemoryReadStreamTestSuite_test_seek_end;
+
+static class TestDescription_MemoryReadStreamTestSuite_test_seek_read_le : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_seek_read_le() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 62, "test_seek_read_le" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_seek_read_le(); }
+} testDescription_MemoryReadStreamTestSuite_test_seek_read_le;
+
+static class TestDescription_MemoryReadStreamTestSuite_test_seek_read_be : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_seek_read_be() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 77, "test_seek_read_be" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_seek_read_be(); }
+} testDescription_MemoryReadStreamTestSuite_test_seek_read_be;
+
+static class TestDescription_MemoryReadStreamTestSuite_test_eos : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamTestSuite_test_eos() : CxxTest::RealTestDescription( Tests_MemoryReadStreamTestSuite, suiteDescription_MemoryReadStreamTestSuite, 92, "test_eos" ) {}
+ void runTest() { suite_MemoryReadStreamTestSuite.test_eos(); }
+} testDescription_MemoryReadStreamTestSuite_test_eos;
+
+#include "test/common/memoryreadstreamendian.h"
+
+static MemoryReadStreamEndianTestSuite suite_MemoryReadStreamEndianTestSuite;
+
+static CxxTest::List Tests_MemoryReadStreamEndianTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MemoryReadStreamEndianTestSuite( "test/common/memoryreadstreamendian.h", 5, "MemoryReadStreamEndianTestSuite", suite_MemoryReadStreamEndianTestSuite, Tests_MemoryReadStreamEndianTestSuite );
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_set : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_set() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 7, "test_seek_set" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_set(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_set;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_cur : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_cur() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 24, "test_seek_cur" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_cur(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_cur;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_end : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_end() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 45, "test_seek_end" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_end(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_end;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 62, "test_seek_read_le" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_read_le(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 77, "test_seek_read_be" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_read_be(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le2() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 92, "test_seek_read_le2" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_read_le2(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_read_le2;
+
+static class TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be2() : CxxTest::RealTestDescription( Tests_MemoryReadStreamEndianTestSuite, suiteDescription_MemoryReadStreamEndianTestSuite, 107, "test_seek_read_be2" ) {}
+ void runTest() { suite_MemoryReadStreamEndianTestSuite.test_seek_read_be2(); }
+} testDescription_MemoryReadStreamEndianTestSuite_test_seek_read_be2;
+
+#include "test/common/memorywritestream.h"
+
+static MemoryWriteStreamTestSuite suite_MemoryWriteStreamTestSuite;
+
+static CxxTest::List Tests_MemoryWriteStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MemoryWriteStreamTestSuite( "test/common/memorywritestream.h", 5, "MemoryWriteStreamTestSuite", suite_MemoryWriteStreamTestSuite, Tests_MemoryWriteStreamTestSuite );
+
+static class TestDescription_MemoryWriteStreamTestSuite_test_err : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryWriteStreamTestSuite_test_err() : CxxTest::RealTestDescription( Tests_MemoryWriteStreamTestSuite, suiteDescription_MemoryWriteStreamTestSuite, 7, "test_err" ) {}
+ void runTest() { suite_MemoryWriteStreamTestSuite.test_err(); }
+} testDescription_MemoryWriteStreamTestSuite_test_err;
+
+static class TestDescription_MemoryWriteStreamTestSuite_test_write : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MemoryWriteStreamTestSuite_test_write() : CxxTest::RealTestDescription( Tests_MemoryWriteStreamTestSuite, suiteDescription_MemoryWriteStreamTestSuite, 22, "test_write" ) {}
+ void runTest() { suite_MemoryWriteStreamTestSuite.test_write(); }
+} testDescription_MemoryWriteStreamTestSuite_test_write;
+
+#include "test/common/pack.h"
+
+static PackTestSuite suite_PackTestSuite;
+
+static CxxTest::List Tests_PackTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_PackTestSuite( "test/common/pack.h", 20, "PackTestSuite", suite_PackTestSuite, Tests_PackTestSuite );
+
+static class TestDescription_PackTestSuite_test_packing : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PackTestSuite_test_packing() : CxxTest::RealTestDescription( Tests_PackTestSuite, suiteDescription_PackTestSuite, 23, "test_packing" ) {}
+ void runTest() { suite_PackTestSuite.test_packing(); }
+} testDescription_PackTestSuite_test_packing;
+
+static class TestDescription_PackTestSuite_test_offsets : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PackTestSuite_test_offsets() : CxxTest::RealTestDescription( Tests_PackTestSuite, suiteDescription_PackTestSuite, 27, "test_offsets" ) {}
+ void runTest() { suite_PackTestSuite.test_offsets(); }
+} testDescription_PackTestSuite_test_offsets;
+
+#include "test/common/ptr.h"
+
+static PtrTestSuite suite_PtrTestSuite;
+
+static CxxTest::List Tests_PtrTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_PtrTestSuite( "test/common/ptr.h", 5, "PtrTestSuite", suite_PtrTestSuite, Tests_PtrTestSuite );
+
+static class TestDescription_PtrTestSuite_test_deletion : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_deletion() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 25, "test_deletion" ) {}
+ void runTest() { suite_PtrTestSuite.test_deletion(); }
+} testDescription_PtrTestSuite_test_deletion;
+
+static class TestDescription_PtrTestSuite_test_scoped_deleter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_scoped_deleter() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 45, "test_scoped_deleter" ) {}
+ void runTest() { suite_PtrTestSuite.test_scoped_deleter(); }
+} testDescription_PtrTestSuite_test_scoped_deleter;
+
+static class TestDescription_PtrTestSuite_test_disposable_deleter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_disposable_deleter() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 56, "test_disposable_deleter" ) {}
+ void runTest() { suite_PtrTestSuite.test_disposable_deleter(); }
+} testDescription_PtrTestSuite_test_disposable_deleter;
+
+static class TestDescription_PtrTestSuite_test_scoped_deref : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_scoped_deref() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 76, "test_scoped_deref" ) {}
+ void runTest() { suite_PtrTestSuite.test_scoped_deref(); }
+} testDescription_PtrTestSuite_test_scoped_deref;
+
+static class TestDescription_PtrTestSuite_test_disposable_deref : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_disposable_deref() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 84, "test_disposable_deref" ) {}
+ void runTest() { suite_PtrTestSuite.test_disposable_deref(); }
+} testDescription_PtrTestSuite_test_disposable_deref;
+
+static class TestDescription_PtrTestSuite_test_assign : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_assign() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 92, "test_assign" ) {}
+ void runTest() { suite_PtrTestSuite.test_assign(); }
+} testDescription_PtrTestSuite_test_assign;
+
+static class TestDescription_PtrTestSuite_test_deleter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_deleter() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 128, "test_deleter" ) {}
+ void runTest() { suite_PtrTestSuite.test_deleter(); }
+} testDescription_PtrTestSuite_test_deleter;
+
+static class TestDescription_PtrTestSuite_test_compare : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_compare() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 140, "test_compare" ) {}
+ void runTest() { suite_PtrTestSuite.test_compare(); }
+} testDescription_PtrTestSuite_test_compare;
+
+static class TestDescription_PtrTestSuite_test_cast : public CxxTest::RealTestDescription {
+public:
+ TestDescription_PtrTestSuite_test_cast() : CxxTest::RealTestDescription( Tests_PtrTestSuite, suiteDescription_PtrTestSuite, 154, "test_cast" ) {}
+ void runTest() { suite_PtrTestSuite.test_cast(); }
+} testDescription_PtrTestSuite_test_cast;
+
+#include "test/common/queue.h"
+
+static QueueTestSuite suite_QueueTestSuite;
+
+static CxxTest::List Tests_QueueTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_QueueTestSuite( "test/common/queue.h", 5, "QueueTestSuite", suite_QueueTestSuite, Tests_QueueTestSuite );
+
+static class TestDescription_QueueTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_QueueTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_QueueTestSuite, suiteDescription_QueueTestSuite, 7, "test_empty_clear" ) {}
+ void runTest() { suite_QueueTestSuite.test_empty_clear(); }
+} testDescription_QueueTestSuite_test_empty_clear;
+
+static class TestDescription_QueueTestSuite_test_size : public CxxTest::RealTestDescription {
+public:
+ TestDescription_QueueTestSuite_test_size() : CxxTest::RealTestDescription( Tests_QueueTestSuite, suiteDescription_QueueTestSuite, 20, "test_size" ) {}
+ void runTest() { suite_QueueTestSuite.test_size(); }
+} testDescription_QueueTestSuite_test_size;
+
+static class TestDescription_QueueTestSuite_test_front_back_push_pop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_QueueTestSuite_test_front_back_push_pop() : CxxTest::RealTestDescription( Tests_QueueTestSuite, suiteDescription_QueueTestSuite, 35, "test_front_back_push_pop" ) {}
+ void runTest() { suite_QueueTestSuite.test_front_back_push_pop(); }
+} testDescription_QueueTestSuite_test_front_back_push_pop;
+
+static class TestDescription_QueueTestSuite_test_assign : public CxxTest::RealTestDescription {
+public:
+ TestDescription_QueueTestSuite_test_assign() : CxxTest::RealTestDescription( Tests_QueueTestSuite, suiteDescription_QueueTestSuite, 54, "test_assign" ) {}
+ void runTest() { suite_QueueTestSuite.test_assign(); }
+} testDescription_QueueTestSuite_test_assign;
+
+#include "test/common/rational.h"
+
+static RationalTestSuite suite_RationalTestSuite;
+
+static CxxTest::List Tests_RationalTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RationalTestSuite( "test/common/rational.h", 5, "RationalTestSuite", suite_RationalTestSuite, Tests_RationalTestSuite );
+
+static class TestDescription_RationalTestSuite_test_operators : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_operators() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 7, "test_operators" ) {}
+ void runTest() { suite_RationalTestSuite.test_operators(); }
+} testDescription_RationalTestSuite_test_operators;
+
+static class TestDescription_RationalTestSuite_test_assign : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_assign() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 48, "test_assign" ) {}
+ void runTest() { suite_RationalTestSuite.test_assign(); }
+} testDescription_RationalTestSuite_test_assign;
+
+static class TestDescription_RationalTestSuite_test_negative : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_negative() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 60, "test_negative" ) {}
+ void runTest() { suite_RationalTestSuite.test_negative(); }
+} testDescription_RationalTestSuite_test_negative;
+
+static class TestDescription_RationalTestSuite_test_add_sub : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_add_sub() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 74, "test_add_sub" ) {}
+ void runTest() { suite_RationalTestSuite.test_add_sub(); }
+} testDescription_RationalTestSuite_test_add_sub;
+
+static class TestDescription_RationalTestSuite_test_add_sub2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_add_sub2() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 89, "test_add_sub2" ) {}
+ void runTest() { suite_RationalTestSuite.test_add_sub2(); }
+} testDescription_RationalTestSuite_test_add_sub2;
+
+static class TestDescription_RationalTestSuite_test_mul : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_mul() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 105, "test_mul" ) {}
+ void runTest() { suite_RationalTestSuite.test_mul(); }
+} testDescription_RationalTestSuite_test_mul;
+
+static class TestDescription_RationalTestSuite_test_div : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_div() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 124, "test_div" ) {}
+ void runTest() { suite_RationalTestSuite.test_div(); }
+} testDescription_RationalTestSuite_test_div;
+
+static class TestDescription_RationalTestSuite_test_isOne : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RationalTestSuite_test_isOne() : CxxTest::RealTestDescription( Tests_RationalTestSuite, suiteDescription_RationalTestSuite, 134, "test_isOne" ) {}
+ void runTest() { suite_RationalTestSuite.test_isOne(); }
+} testDescription_RationalTestSuite_test_isOne;
+
+#include "test/common/rect.h"
+
+static RectTestSuite suite_RectTestSuite;
+
+static CxxTest::List Tests_RectTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RectTestSuite( "test/common/rect.h", 5, "RectTestSuite", suite_RectTestSuite, Tests_RectTestSuite );
+
+static class TestDescription_RectTestSuite_test_point_sqrDist : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RectTestSuite_test_point_sqrDist() : CxxTest::RealTestDescription( Tests_RectTestSuite, suiteDescription_RectTestSuite, 8, "test_point_sqrDist" ) {}
+ void runTest() { suite_RectTestSuite.test_point_sqrDist(); }
+} testDescription_RectTestSuite_test_point_sqrDist;
+
+static class TestDescription_RectTestSuite_test_intersects : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RectTestSuite_test_intersects() : CxxTest::RealTestDescription( Tests_RectTestSuite, suiteDescription_RectTestSuite, 21, "test_intersects" ) {}
+ void runTest() { suite_RectTestSuite.test_intersects(); }
+} testDescription_RectTestSuite_test_intersects;
+
+static class TestDescription_RectTestSuite_test_contains : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RectTestSuite_test_contains() : CxxTest::RealTestDescription( Tests_RectTestSuite, suiteDescription_RectTestSuite, 27, "test_contains" ) {}
+ void runTest() { suite_RectTestSuite.test_contains(); }
+} testDescription_RectTestSuite_test_contains;
+
+static class TestDescription_RectTestSuite_test_extend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RectTestSuite_test_extend() : CxxTest::RealTestDescription( Tests_RectTestSuite, suiteDescription_RectTestSuite, 44, "test_extend" ) {}
+ void runTest() { suite_RectTestSuite.test_extend(); }
+} testDescription_RectTestSuite_test_extend;
+
+#include "test/common/rendermode.h"
+
+static RenderModeTestSuite suite_RenderModeTestSuite;
+
+static CxxTest::List Tests_RenderModeTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RenderModeTestSuite( "test/common/rendermode.h", 6, "RenderModeTestSuite", suite_RenderModeTestSuite, Tests_RenderModeTestSuite );
+
+static class TestDescription_RenderModeTestSuite_test_parse_render_mode_good : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RenderModeTestSuite_test_parse_render_mode_good() : CxxTest::RealTestDescription( Tests_RenderModeTestSuite, suiteDescription_RenderModeTestSuite, 8, "test_parse_render_mode_good" ) {}
+ void runTest() { suite_RenderModeTestSuite.test_parse_render_mode_good(); }
+} testDescription_RenderModeTestSuite_test_parse_render_mode_good;
+
+static class TestDescription_RenderModeTestSuite_test_parse_render_mode_bad : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RenderModeTestSuite_test_parse_render_mode_bad() : CxxTest::RealTestDescription( Tests_RenderModeTestSuite, suiteDescription_RenderModeTestSuite, 28, "test_parse_render_mode_bad" ) {}
+ void runTest() { suite_RenderModeTestSuite.test_parse_render_mode_bad(); }
+} testDescription_RenderModeTestSuite_test_parse_render_mode_bad;
+
+static class TestDescription_RenderModeTestSuite_test_get_render_mode_code_back_and_forth : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RenderModeTestSuite_test_get_render_mode_code_back_and_forth() : CxxTest::RealTestDescription( Tests_RenderModeTestSuite, suiteDescription_RenderModeTestSuite, 46, "test_get_render_mode_code_back_and_forth" ) {}
+ void runTest() { suite_RenderModeTestSuite.test_get_render_mode_code_back_and_forth(); }
+} testDescription_RenderModeTestSuite_test_get_render_mode_code_back_and_forth;
+
+static class TestDescription_RenderModeTestSuite_test_render_2_guio : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RenderModeTestSuite_test_render_2_guio() : CxxTest::RealTestDescription( Tests_RenderModeTestSuite, suiteDescription_RenderModeTestSuite, 64, "test_render_2_guio" ) {}
+ void runTest() { suite_RenderModeTestSuite.test_render_2_guio(); }
+} testDescription_RenderModeTestSuite_test_render_2_guio;
+
+#include "test/common/seekablesubreadstream.h"
+
+static SeekableSubReadStreamTestSuite suite_SeekableSubReadStreamTestSuite;
+
+static CxxTest::List Tests_SeekableSubReadStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_SeekableSubReadStreamTestSuite( "test/common/seekablesubreadstream.h", 6, "SeekableSubReadStreamTestSuite", suite_SeekableSubReadStreamTestSuite, Tests_SeekableSubReadStreamTestSuite );
+
+static class TestDescription_SeekableSubReadStreamTestSuite_test_traverse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SeekableSubReadStreamTestSuite_test_traverse() : CxxTest::RealTestDescription( Tests_SeekableSubReadStreamTestSuite, suiteDescription_SeekableSubReadStreamTestSuite, 8, "test_traverse" ) {}
+ void runTest() { suite_SeekableSubReadStreamTestSuite.test_traverse(); }
+} testDescription_SeekableSubReadStreamTestSuite_test_traverse;
+
+static class TestDescription_SeekableSubReadStreamTestSuite_test_seek : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SeekableSubReadStreamTestSuite_test_seek() : CxxTest::RealTestDescription( Tests_SeekableSubReadStreamTestSuite, suiteDescription_SeekableSubReadStreamTestSuite, 32, "test_seek" ) {}
+ void runTest() { suite_SeekableSubReadStreamTestSuite.test_seek(); }
+} testDescription_SeekableSubReadStreamTestSuite_test_seek;
+
+#include "test/common/serializer.h"
+
+static SerializerTestSuite suite_SerializerTestSuite;
+
+static CxxTest::List Tests_SerializerTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_SerializerTestSuite( "test/common/serializer.h", 7, "SerializerTestSuite", suite_SerializerTestSuite, Tests_SerializerTestSuite );
+
+static class TestDescription_SerializerTestSuite_test_read_v1_as_v1 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SerializerTestSuite_test_read_v1_as_v1() : CxxTest::RealTestDescription( Tests_SerializerTestSuite, suiteDescription_SerializerTestSuite, 97, "test_read_v1_as_v1" ) {}
+ void runTest() { suite_SerializerTestSuite.test_read_v1_as_v1(); }
+} testDescription_SerializerTestSuite_test_read_v1_as_v1;
+
+static class TestDescription_SerializerTestSuite_test_read_v1_as_v2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SerializerTestSuite_test_read_v1_as_v2() : CxxTest::RealTestDescription( Tests_SerializerTestSuite, suiteDescription_SerializerTestSuite, 105, "test_read_v1_as_v2" ) {}
+ void runTest() { suite_SerializerTestSuite.test_read_v1_as_v2(); }
+} testDescription_SerializerTestSuite_test_read_v1_as_v2;
+
+static class TestDescription_SerializerTestSuite_test_read_v2_as_v2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SerializerTestSuite_test_read_v2_as_v2() : CxxTest::RealTestDescription( Tests_SerializerTestSuite, suiteDescription_SerializerTestSuite, 109, "test_read_v2_as_v2" ) {}
+ void runTest() { suite_SerializerTestSuite.test_read_v2_as_v2(); }
+} testDescription_SerializerTestSuite_test_read_v2_as_v2;
+
+static class TestDescription_SerializerTestSuite_test_sync_array : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SerializerTestSuite_test_sync_array() : CxxTest::RealTestDescription( Tests_SerializerTestSuite, suiteDescription_SerializerTestSuite, 113, "test_sync_array" ) {}
+ void runTest() { suite_SerializerTestSuite.test_sync_array(); }
+} testDescription_SerializerTestSuite_test_sync_array;
+
+static class TestDescription_SerializerTestSuite_test_size_only : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SerializerTestSuite_test_size_only() : CxxTest::RealTestDescription( Tests_SerializerTestSuite, suiteDescription_SerializerTestSuite, 156, "test_size_only" ) {}
+ void runTest() { suite_SerializerTestSuite.test_size_only(); }
+} testDescription_SerializerTestSuite_test_size_only;
+
+#include "test/common/span.h"
+
+static SpanTestSuite suite_SpanTestSuite;
+
+static CxxTest::List Tests_SpanTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_SpanTestSuite( "test/common/span.h", 8, "SpanTestSuite", suite_SpanTestSuite, Tests_SpanTestSuite );
+
+static class TestDescription_SpanTestSuite_test_sibling_span : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_sibling_span() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 64, "test_sibling_span" ) {}
+ void runTest() { suite_SpanTestSuite.test_sibling_span(); }
+} testDescription_SpanTestSuite_test_sibling_span;
+
+static class TestDescription_SpanTestSuite_test_sub_span : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_sub_span() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 72, "test_sub_span" ) {}
+ void runTest() { suite_SpanTestSuite.test_sub_span(); }
+} testDescription_SpanTestSuite_test_sub_span;
+
+static class TestDescription_SpanTestSuite_test_span_iterator_const : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_iterator_const() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 82, "test_span_iterator_const" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_iterator_const(); }
+} testDescription_SpanTestSuite_test_span_iterator_const;
+
+static class TestDescription_SpanTestSuite_test_span_iterator : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_iterator() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 134, "test_span_iterator" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_iterator(); }
+} testDescription_SpanTestSuite_test_span_iterator;
+
+static class TestDescription_SpanTestSuite_test_span_iterator_integers : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_iterator_integers() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 200, "test_span_iterator_integers" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_iterator_integers(); }
+} testDescription_SpanTestSuite_test_span_iterator_integers;
+
+static class TestDescription_SpanTestSuite_test_span_iterator_ptr : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_iterator_ptr() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 225, "test_span_iterator_ptr" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_iterator_ptr(); }
+} testDescription_SpanTestSuite_test_span_iterator_ptr;
+
+static class TestDescription_SpanTestSuite_test_span_owner : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_owner() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 242, "test_span_owner" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_owner(); }
+} testDescription_SpanTestSuite_test_span_owner;
+
+static class TestDescription_SpanTestSuite_test_span_owner_named_span : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_owner_named_span() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 336, "test_span_owner_named_span" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_owner_named_span(); }
+} testDescription_SpanTestSuite_test_span_owner_named_span;
+
+static class TestDescription_SpanTestSuite_test_span_allocate_from_stream : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_allocate_from_stream() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 410, "test_span_allocate_from_stream" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_allocate_from_stream(); }
+} testDescription_SpanTestSuite_test_span_allocate_from_stream;
+
+static class TestDescription_SpanTestSuite_test_span_byte : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_byte() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 445, "test_span_byte" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_byte(); }
+} testDescription_SpanTestSuite_test_span_byte;
+
+static class TestDescription_SpanTestSuite_test_span_integers : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_integers() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 483, "test_span_integers" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_integers(); }
+} testDescription_SpanTestSuite_test_span_integers;
+
+static class TestDescription_SpanTestSuite_test_span_string : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_string() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 509, "test_span_string" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_string(); }
+} testDescription_SpanTestSuite_test_span_string;
+
+static class TestDescription_SpanTestSuite_test_span_unsafe_data : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_unsafe_data() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 522, "test_span_unsafe_data" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_unsafe_data(); }
+} testDescription_SpanTestSuite_test_span_unsafe_data;
+
+static class TestDescription_SpanTestSuite_test_span_subspan : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_subspan() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 538, "test_span_subspan" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_subspan(); }
+} testDescription_SpanTestSuite_test_span_subspan;
+
+static class TestDescription_SpanTestSuite_test_span_to_stream : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_to_stream() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 599, "test_span_to_stream" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_to_stream(); }
+} testDescription_SpanTestSuite_test_span_to_stream;
+
+static class TestDescription_SpanTestSuite_test_span_copying : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_copying() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 628, "test_span_copying" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_copying(); }
+} testDescription_SpanTestSuite_test_span_copying;
+
+static class TestDescription_SpanTestSuite_test_span_validation : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_validation() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 646, "test_span_validation" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_validation(); }
+} testDescription_SpanTestSuite_test_span_validation;
+
+static class TestDescription_SpanTestSuite_test_span_validation_message : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_validation_message() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 666, "test_span_validation_message" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_validation_message(); }
+} testDescription_SpanTestSuite_test_span_validation_message;
+
+static class TestDescription_SpanTestSuite_test_span_comparators : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_span_comparators() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 687, "test_span_comparators" ) {}
+ void runTest() { suite_SpanTestSuite.test_span_comparators(); }
+} testDescription_SpanTestSuite_test_span_comparators;
+
+static class TestDescription_SpanTestSuite_test_named_span : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SpanTestSuite_test_named_span() : CxxTest::RealTestDescription( Tests_SpanTestSuite, suiteDescription_SpanTestSuite, 714, "test_named_span" ) {}
+ void runTest() { suite_SpanTestSuite.test_named_span(); }
+} testDescription_SpanTestSuite_test_named_span;
+
+#include "test/common/stack.h"
+
+static StackTestSuite suite_StackTestSuite;
+
+static CxxTest::List Tests_StackTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_StackTestSuite( "test/common/stack.h", 5, "StackTestSuite", suite_StackTestSuite, Tests_StackTestSuite );
+
+static class TestDescription_StackTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StackTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_StackTestSuite, suiteDescription_StackTestSuite, 7, "test_empty_clear" ) {}
+ void runTest() { suite_StackTestSuite.test_empty_clear(); }
+} testDescription_StackTestSuite_test_empty_clear;
+
+static class TestDescription_StackTestSuite_test_size : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StackTestSuite_test_size() : CxxTest::RealTestDescription( Tests_StackTestSuite, suiteDescription_StackTestSuite, 20, "test_size" ) {}
+ void runTest() { suite_StackTestSuite.test_size(); }
+} testDescription_StackTestSuite_test_size;
+
+static class TestDescription_StackTestSuite_test_top_pop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StackTestSuite_test_top_pop() : CxxTest::RealTestDescription( Tests_StackTestSuite, suiteDescription_StackTestSuite, 37, "test_top_pop" ) {}
+ void runTest() { suite_StackTestSuite.test_top_pop(); }
+} testDescription_StackTestSuite_test_top_pop;
+
+static class TestDescription_StackTestSuite_test_assign : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StackTestSuite_test_assign() : CxxTest::RealTestDescription( Tests_StackTestSuite, suiteDescription_StackTestSuite, 55, "test_assign" ) {}
+ void runTest() { suite_StackTestSuite.test_assign(); }
+} testDescription_StackTestSuite_test_assign;
+
+#include "test/common/str.h"
+
+static StringTestSuite suite_StringTestSuite;
+
+static CxxTest::List Tests_StringTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_StringTestSuite( "test/common/str.h", 5, "StringTestSuite", suite_StringTestSuite, Tests_StringTestSuite );
+
+static class TestDescription_StringTestSuite_test_constructors : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_constructors() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 8, "test_constructors" ) {}
+ void runTest() { suite_StringTestSuite.test_constructors(); }
+} testDescription_StringTestSuite_test_constructors;
+
+static class TestDescription_StringTestSuite_test_trim : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_trim() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 19, "test_trim" ) {}
+ void runTest() { suite_StringTestSuite.test_trim(); }
+} testDescription_StringTestSuite_test_trim;
+
+static class TestDescription_StringTestSuite_test_empty_clear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_empty_clear() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 27, "test_empty_clear" ) {}
+ void runTest() { suite_StringTestSuite.test_empty_clear(); }
+} testDescription_StringTestSuite_test_empty_clear;
+
+static class TestDescription_StringTestSuite_test_lastChar : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_lastChar() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 34, "test_lastChar" ) {}
+ void runTest() { suite_StringTestSuite.test_lastChar(); }
+} testDescription_StringTestSuite_test_lastChar;
+
+static class TestDescription_StringTestSuite_test_firstChar : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_firstChar() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 43, "test_firstChar" ) {}
+ void runTest() { suite_StringTestSuite.test_firstChar(); }
+} testDescription_StringTestSuite_test_firstChar;
+
+static class TestDescription_StringTestSuite_test_concat1 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_concat1() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 52, "test_concat1" ) {}
+ void runTest() { suite_StringTestSuite.test_concat1(); }
+} testDescription_StringTestSuite_test_concat1;
+
+static class TestDescription_StringTestSuite_test_concat2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_concat2() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 60, "test_concat2" ) {}
+ void runTest() { suite_StringTestSuite.test_concat2(); }
+} testDescription_StringTestSuite_test_concat2;
+
+static class TestDescription_StringTestSuite_test_concat3 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_concat3() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 66, "test_concat3" ) {}
+ void runTest() { suite_StringTestSuite.test_concat3(); }
+} testDescription_StringTestSuite_test_concat3;
+
+static class TestDescription_StringTestSuite_test_refCount : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 72, "test_refCount" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount(); }
+} testDescription_StringTestSuite_test_refCount;
+
+static class TestDescription_StringTestSuite_test_refCount2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount2() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 87, "test_refCount2" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount2(); }
+} testDescription_StringTestSuite_test_refCount2;
+
+static class TestDescription_StringTestSuite_test_refCount3 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount3() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 102, "test_refCount3" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount3(); }
+} testDescription_StringTestSuite_test_refCount3;
+
+static class TestDescription_StringTestSuite_test_refCount4 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount4() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 116, "test_refCount4" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount4(); }
+} testDescription_StringTestSuite_test_refCount4;
+
+static class TestDescription_StringTestSuite_test_refCount5 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount5() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 130, "test_refCount5" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount5(); }
+} testDescription_StringTestSuite_test_refCount5;
+
+static class TestDescription_StringTestSuite_test_refCount6 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_refCount6() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 142, "test_refCount6" ) {}
+ void runTest() { suite_StringTestSuite.test_refCount6(); }
+} testDescription_StringTestSuite_test_refCount6;
+
+static class TestDescription_StringTestSuite_test_self_asignment : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_self_asignment() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 154, "test_self_asignment" ) {}
+ void runTest() { suite_StringTestSuite.test_self_asignment(); }
+} testDescription_StringTestSuite_test_self_asignment;
+
+static class TestDescription_StringTestSuite_test_hasPrefix : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_hasPrefix() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 204, "test_hasPrefix" ) {}
+ void runTest() { suite_StringTestSuite.test_hasPrefix(); }
+} testDescription_StringTestSuite_test_hasPrefix;
+
+static class TestDescription_StringTestSuite_test_hasSuffix : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_hasSuffix() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 212, "test_hasSuffix" ) {}
+ void runTest() { suite_StringTestSuite.test_hasSuffix(); }
+} testDescription_StringTestSuite_test_hasSuffix;
+
+static class TestDescription_StringTestSuite_test_contains : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_contains() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 220, "test_contains" ) {}
+ void runTest() { suite_StringTestSuite.test_contains(); }
+} testDescription_StringTestSuite_test_contains;
+
+static class TestDescription_StringTestSuite_test_toLowercase : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_toLowercase() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 231, "test_toLowercase" ) {}
+ void runTest() { suite_StringTestSuite.test_toLowercase(); }
+} testDescription_StringTestSuite_test_toLowercase;
+
+static class TestDescription_StringTestSuite_test_toUppercase : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_toUppercase() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 239, "test_toUppercase" ) {}
+ void runTest() { suite_StringTestSuite.test_toUppercase(); }
+} testDescription_StringTestSuite_test_toUppercase;
+
+static class TestDescription_StringTestSuite_test_deleteChar : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_deleteChar() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 247, "test_deleteChar" ) {}
+ void runTest() { suite_StringTestSuite.test_deleteChar(); }
+} testDescription_StringTestSuite_test_deleteChar;
+
+static class TestDescription_StringTestSuite_test_erase : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_erase() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 255, "test_erase" ) {}
+ void runTest() { suite_StringTestSuite.test_erase(); }
+} testDescription_StringTestSuite_test_erase;
+
+static class TestDescription_StringTestSuite_test_sharing : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_sharing() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 263, "test_sharing" ) {}
+ void runTest() { suite_StringTestSuite.test_sharing(); }
+} testDescription_StringTestSuite_test_sharing;
+
+static class TestDescription_StringTestSuite_test_lastPathComponent : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_lastPathComponent() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 272, "test_lastPathComponent" ) {}
+ void runTest() { suite_StringTestSuite.test_lastPathComponent(); }
+} testDescription_StringTestSuite_test_lastPathComponent;
+
+static class TestDescription_StringTestSuite_test_normalizePath : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_normalizePath() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 290, "test_normalizePath" ) {}
+ void runTest() { suite_StringTestSuite.test_normalizePath(); }
+} testDescription_StringTestSuite_test_normalizePath;
+
+static class TestDescription_StringTestSuite_test_matchString : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_matchString() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 319, "test_matchString" ) {}
+ void runTest() { suite_StringTestSuite.test_matchString(); }
+} testDescription_StringTestSuite_test_matchString;
+
+static class TestDescription_StringTestSuite_test_string_printf : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_string_printf() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 355, "test_string_printf" ) {}
+ void runTest() { suite_StringTestSuite.test_string_printf(); }
+} testDescription_StringTestSuite_test_string_printf;
+
+static class TestDescription_StringTestSuite_test_strlcpy : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_strlcpy() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 366, "test_strlcpy" ) {}
+ void runTest() { suite_StringTestSuite.test_strlcpy(); }
+} testDescription_StringTestSuite_test_strlcpy;
+
+static class TestDescription_StringTestSuite_test_strlcat : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_strlcat() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 388, "test_strlcat" ) {}
+ void runTest() { suite_StringTestSuite.test_strlcat(); }
+} testDescription_StringTestSuite_test_strlcat;
+
+static class TestDescription_StringTestSuite_test_strnlen : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_strnlen() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 419, "test_strnlen" ) {}
+ void runTest() { suite_StringTestSuite.test_strnlen(); }
+} testDescription_StringTestSuite_test_strnlen;
+
+static class TestDescription_StringTestSuite_test_scumm_stricmp : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_scumm_stricmp() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 442, "test_scumm_stricmp" ) {}
+ void runTest() { suite_StringTestSuite.test_scumm_stricmp(); }
+} testDescription_StringTestSuite_test_scumm_stricmp;
+
+static class TestDescription_StringTestSuite_test_scumm_strnicmp : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_scumm_strnicmp() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 449, "test_scumm_strnicmp" ) {}
+ void runTest() { suite_StringTestSuite.test_scumm_strnicmp(); }
+} testDescription_StringTestSuite_test_scumm_strnicmp;
+
+static class TestDescription_StringTestSuite_test_wordWrap : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_wordWrap() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 459, "test_wordWrap" ) {}
+ void runTest() { suite_StringTestSuite.test_wordWrap(); }
+} testDescription_StringTestSuite_test_wordWrap;
+
+static class TestDescription_StringTestSuite_test_replace : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_replace() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 481, "test_replace" ) {}
+ void runTest() { suite_StringTestSuite.test_replace(); }
+} testDescription_StringTestSuite_test_replace;
+
+static class TestDescription_StringTestSuite_test_setChar : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_setChar() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 555, "test_setChar" ) {}
+ void runTest() { suite_StringTestSuite.test_setChar(); }
+} testDescription_StringTestSuite_test_setChar;
+
+static class TestDescription_StringTestSuite_test_insertChar : public CxxTest::RealTestDescription {
+public:
+ TestDescription_StringTestSuite_test_insertChar() : CxxTest::RealTestDescription( Tests_StringTestSuite, suiteDescription_StringTestSuite, 563, "test_insertChar" ) {}
+ void runTest() { suite_StringTestSuite.test_insertChar(); }
+} testDescription_StringTestSuite_test_insertChar;
+
+#include "test/common/stream.h"
+
+static ReadLineStreamTestSuite suite_ReadLineStreamTestSuite;
+
+static CxxTest::List Tests_ReadLineStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ReadLineStreamTestSuite( "test/common/stream.h", 5, "ReadLineStreamTestSuite", suite_ReadLineStreamTestSuite, Tests_ReadLineStreamTestSuite );
+
+static class TestDescription_ReadLineStreamTestSuite_test_readline : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ReadLineStreamTestSuite_test_readline() : CxxTest::RealTestDescription( Tests_ReadLineStreamTestSuite, suiteDescription_ReadLineStreamTestSuite, 7, "test_readline" ) {}
+ void runTest() { suite_ReadLineStreamTestSuite.test_readline(); }
+} testDescription_ReadLineStreamTestSuite_test_readline;
+
+static class TestDescription_ReadLineStreamTestSuite_test_readline2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ReadLineStreamTestSuite_test_readline2() : CxxTest::RealTestDescription( Tests_ReadLineStreamTestSuite, suiteDescription_ReadLineStreamTestSuite, 29, "test_readline2" ) {}
+ void runTest() { suite_ReadLineStreamTestSuite.test_readline2(); }
+} testDescription_ReadLineStreamTestSuite_test_readline2;
+
+#include "test/common/subreadstream.h"
+
+static SubReadStreamTestSuite suite_SubReadStreamTestSuite;
+
+static CxxTest::List Tests_SubReadStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_SubReadStreamTestSuite( "test/common/subreadstream.h", 6, "SubReadStreamTestSuite", suite_SubReadStreamTestSuite, Tests_SubReadStreamTestSuite );
+
+static class TestDescription_SubReadStreamTestSuite_test_traverse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SubReadStreamTestSuite_test_traverse() : CxxTest::RealTestDescription( Tests_SubReadStreamTestSuite, suiteDescription_SubReadStreamTestSuite, 8, "test_traverse" ) {}
+ void runTest() { suite_SubReadStreamTestSuite.test_traverse(); }
+} testDescription_SubReadStreamTestSuite_test_traverse;
+
+static class TestDescription_SubReadStreamTestSuite_test_safe_eos : public CxxTest::RealTestDescription {
+public:
+ TestDescription_SubReadStreamTestSuite_test_safe_eos() : CxxTest::RealTestDescription( Tests_SubReadStreamTestSuite, suiteDescription_SubReadStreamTestSuite, 30, "test_safe_eos" ) {}
+ void runTest() { suite_SubReadStreamTestSuite.test_safe_eos(); }
+} testDescription_SubReadStreamTestSuite_test_safe_eos;
+
+#include "test/common/tokenizer.h"
+
+static TokenizerTestSuite suite_TokenizerTestSuite;
+
+static CxxTest::List Tests_TokenizerTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TokenizerTestSuite( "test/common/tokenizer.h", 5, "TokenizerTestSuite", suite_TokenizerTestSuite, Tests_TokenizerTestSuite );
+
+static class TestDescription_TokenizerTestSuite_test_nextToken : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TokenizerTestSuite_test_nextToken() : CxxTest::RealTestDescription( Tests_TokenizerTestSuite, suiteDescription_TokenizerTestSuite, 7, "test_nextToken" ) {}
+ void runTest() { suite_TokenizerTestSuite.test_nextToken(); }
+} testDescription_TokenizerTestSuite_test_nextToken;
+
+static class TestDescription_TokenizerTestSuite_test_resetAndEmpty : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TokenizerTestSuite_test_resetAndEmpty() : CxxTest::RealTestDescription( Tests_TokenizerTestSuite, suiteDescription_TokenizerTestSuite, 40, "test_resetAndEmpty" ) {}
+ void runTest() { suite_TokenizerTestSuite.test_resetAndEmpty(); }
+} testDescription_TokenizerTestSuite_test_resetAndEmpty;
+
+#include "test/common/util.h"
+
+static UtilTestSuite suite_UtilTestSuite;
+
+static CxxTest::List Tests_UtilTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_UtilTestSuite( "test/common/util.h", 7, "UtilTestSuite", suite_UtilTestSuite, Tests_UtilTestSuite );
+
+static class TestDescription_UtilTestSuite_test_parsebool_yesno : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_parsebool_yesno() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 9, "test_parsebool_yesno" ) {}
+ void runTest() { suite_UtilTestSuite.test_parsebool_yesno(); }
+} testDescription_UtilTestSuite_test_parsebool_yesno;
+
+static class TestDescription_UtilTestSuite_test_parsebool_truefalse : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_parsebool_truefalse() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 28, "test_parsebool_truefalse" ) {}
+ void runTest() { suite_UtilTestSuite.test_parsebool_truefalse(); }
+} testDescription_UtilTestSuite_test_parsebool_truefalse;
+
+static class TestDescription_UtilTestSuite_test_parsebool_onezero : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_parsebool_onezero() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 47, "test_parsebool_onezero" ) {}
+ void runTest() { suite_UtilTestSuite.test_parsebool_onezero(); }
+} testDescription_UtilTestSuite_test_parsebool_onezero;
+
+static class TestDescription_UtilTestSuite_test_parsebool_bad : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_parsebool_bad() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 70, "test_parsebool_bad" ) {}
+ void runTest() { suite_UtilTestSuite.test_parsebool_bad(); }
+} testDescription_UtilTestSuite_test_parsebool_bad;
+
+static class TestDescription_UtilTestSuite_test_is_al_num : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_al_num() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 107, "test_is_al_num" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_al_num(); }
+} testDescription_UtilTestSuite_test_is_al_num;
+
+static class TestDescription_UtilTestSuite_test_is_alpha : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_alpha() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 128, "test_is_alpha" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_alpha(); }
+} testDescription_UtilTestSuite_test_is_alpha;
+
+static class TestDescription_UtilTestSuite_test_is_digit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_digit() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 149, "test_is_digit" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_digit(); }
+} testDescription_UtilTestSuite_test_is_digit;
+
+static class TestDescription_UtilTestSuite_test_is_lower : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_lower() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 170, "test_is_lower" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_lower(); }
+} testDescription_UtilTestSuite_test_is_lower;
+
+static class TestDescription_UtilTestSuite_test_is_upper : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_upper() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 192, "test_is_upper" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_upper(); }
+} testDescription_UtilTestSuite_test_is_upper;
+
+static class TestDescription_UtilTestSuite_test_is_space : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_space() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 212, "test_is_space" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_space(); }
+} testDescription_UtilTestSuite_test_is_space;
+
+static class TestDescription_UtilTestSuite_test_is_print : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_print() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 226, "test_is_print" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_print(); }
+} testDescription_UtilTestSuite_test_is_print;
+
+static class TestDescription_UtilTestSuite_test_is_punct : public CxxTest::RealTestDescription {
+public:
+ TestDescription_UtilTestSuite_test_is_punct() : CxxTest::RealTestDescription( Tests_UtilTestSuite, suiteDescription_UtilTestSuite, 237, "test_is_punct" ) {}
+ void runTest() { suite_UtilTestSuite.test_is_punct(); }
+} testDescription_UtilTestSuite_test_is_punct;
+
+#include "test/audio/adpcm.h"
+
+static ADPCMTestSuite suite_ADPCMTestSuite;
+
+static CxxTest::List Tests_ADPCMTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ADPCMTestSuite( "test/audio/adpcm.h", 87, "ADPCMTestSuite", suite_ADPCMTestSuite, Tests_ADPCMTestSuite );
+
+static class TestDescription_ADPCMTestSuite_test_oki : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_oki() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 265, "test_oki" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_oki(); }
+} testDescription_ADPCMTestSuite_test_oki;
+
+static class TestDescription_ADPCMTestSuite_test_dvi_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_dvi_mono() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 270, "test_dvi_mono" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_dvi_mono(); }
+} testDescription_ADPCMTestSuite_test_dvi_mono;
+
+static class TestDescription_ADPCMTestSuite_test_dvi_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_dvi_stereo() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 275, "test_dvi_stereo" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_dvi_stereo(); }
+} testDescription_ADPCMTestSuite_test_dvi_stereo;
+
+static class TestDescription_ADPCMTestSuite_test_ms_ima_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_ms_ima_mono() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 279, "test_ms_ima_mono" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_ms_ima_mono(); }
+} testDescription_ADPCMTestSuite_test_ms_ima_mono;
+
+static class TestDescription_ADPCMTestSuite_test_ms_ima_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_ms_ima_stereo() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 283, "test_ms_ima_stereo" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_ms_ima_stereo(); }
+} testDescription_ADPCMTestSuite_test_ms_ima_stereo;
+
+static class TestDescription_ADPCMTestSuite_test_ms_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_ms_mono() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 287, "test_ms_mono" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_ms_mono(); }
+} testDescription_ADPCMTestSuite_test_ms_mono;
+
+static class TestDescription_ADPCMTestSuite_test_ms_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_ms_stereo() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 291, "test_ms_stereo" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_ms_stereo(); }
+} testDescription_ADPCMTestSuite_test_ms_stereo;
+
+static class TestDescription_ADPCMTestSuite_test_apple_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_apple_mono() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 295, "test_apple_mono" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_apple_mono(); }
+} testDescription_ADPCMTestSuite_test_apple_mono;
+
+static class TestDescription_ADPCMTestSuite_test_apple_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ADPCMTestSuite_test_apple_stereo() : CxxTest::RealTestDescription( Tests_ADPCMTestSuite, suiteDescription_ADPCMTestSuite, 299, "test_apple_stereo" ) {}
+ void runTest() { suite_ADPCMTestSuite.test_apple_stereo(); }
+} testDescription_ADPCMTestSuite_test_apple_stereo;
+
+#include "test/audio/audiostream.h"
+
+static AudioStreamTestSuite suite_AudioStreamTestSuite;
+
+static CxxTest::List Tests_AudioStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_AudioStreamTestSuite( "test/audio/audiostream.h", 7, "AudioStreamTestSuite", suite_AudioStreamTestSuite, Tests_AudioStreamTestSuite );
+
+static class TestDescription_AudioStreamTestSuite_test_convertTimeToStreamPos : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_convertTimeToStreamPos() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 10, "test_convertTimeToStreamPos" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_convertTimeToStreamPos(); }
+} testDescription_AudioStreamTestSuite_test_convertTimeToStreamPos;
+
+static class TestDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_11025_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_11025_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 104, "test_looping_audio_stream_mono_11025_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_looping_audio_stream_mono_11025_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_11025_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_22050_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_22050_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 108, "test_looping_audio_stream_mono_22050_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_looping_audio_stream_mono_22050_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_looping_audio_stream_mono_22050_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_11025_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_11025_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 112, "test_looping_audio_stream_stereo_11025_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_looping_audio_stream_stereo_11025_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_11025_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_22050_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_22050_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 116, "test_looping_audio_stream_stereo_22050_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_looping_audio_stream_stereo_22050_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_looping_audio_stream_stereo_22050_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_mid_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_mid_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 177, "test_sub_looping_audio_stream_mono_11025_mid_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_mono_11025_mid_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_mid_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_mid_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_mid_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 181, "test_sub_looping_audio_stream_mono_22050_mid_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_mono_22050_mid_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_mid_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_mid_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_mid_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 185, "test_sub_looping_audio_stream_stereo_11025_mid_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_stereo_11025_mid_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_mid_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_mid_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_mid_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 189, "test_sub_looping_audio_stream_stereo_22050_mid_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_stereo_22050_mid_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_mid_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_end_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_end_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 193, "test_sub_looping_audio_stream_mono_11025_end_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_mono_11025_end_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_11025_end_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_end_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_end_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 197, "test_sub_looping_audio_stream_mono_22050_end_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_mono_22050_end_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_mono_22050_end_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_end_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_end_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 201, "test_sub_looping_audio_stream_stereo_11025_end_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_stereo_11025_end_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_11025_end_fixed_iter;
+
+static class TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_end_fixed_iter : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() : CxxTest::RealTestDescription( Tests_AudioStreamTestSuite, suiteDescription_AudioStreamTestSuite, 205, "test_sub_looping_audio_stream_stereo_22050_end_fixed_iter" ) {}
+ void runTest() { suite_AudioStreamTestSuite.test_sub_looping_audio_stream_stereo_22050_end_fixed_iter(); }
+} testDescription_AudioStreamTestSuite_test_sub_looping_audio_stream_stereo_22050_end_fixed_iter;
+
+#include "test/audio/rate.h"
+
+static RateConverterTestSuite suite_RateConverterTestSuite;
+
+static CxxTest::List Tests_RateConverterTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RateConverterTestSuite( "test/audio/rate.h", 8, "RateConverterTestSuite", suite_RateConverterTestSuite, Tests_RateConverterTestSuite );
+
+static class TestDescription_RateConverterTestSuite_test_accumulate_copy : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterTestSuite_test_accumulate_copy() : CxxTest::RealTestDescription( Tests_RateConverterTestSuite, suiteDescription_RateConverterTestSuite, 48, "test_accumulate_copy" ) {}
+ void runTest() { suite_RateConverterTestSuite.test_accumulate_copy(); }
+} testDescription_RateConverterTestSuite_test_accumulate_copy;
+
+static class TestDescription_RateConverterTestSuite_test_accumulate_linear : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterTestSuite_test_accumulate_linear() : CxxTest::RealTestDescription( Tests_RateConverterTestSuite, suiteDescription_RateConverterTestSuite, 54, "test_accumulate_linear" ) {}
+ void runTest() { suite_RateConverterTestSuite.test_accumulate_linear(); }
+} testDescription_RateConverterTestSuite_test_accumulate_linear;
+
+static class TestDescription_RateConverterTestSuite_test_accumulate_simple : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterTestSuite_test_accumulate_simple() : CxxTest::RealTestDescription( Tests_RateConverterTestSuite, suiteDescription_RateConverterTestSuite, 60, "test_accumulate_simple" ) {}
+ void runTest() { suite_RateConverterTestSuite.test_accumulate_simple(); }
+} testDescription_RateConverterTestSuite_test_accumulate_simple;
+
+#include "test/audio/raw.h"
+
+static RawStreamTestSuite suite_RawStreamTestSuite;
+
+static CxxTest::List Tests_RawStreamTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RawStreamTestSuite( "test/audio/raw.h", 8, "RawStreamTestSuite", suite_RawStreamTestSuite, Tests_RawStreamTestSuite );
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 28, "test_read_buffer_8_bit_signed_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_8_bit_signed_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 32, "test_read_buffer_8_bit_signed_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_8_bit_signed_stereo(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_8_bit_signed_stereo;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_unsigned_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_8_bit_unsigned_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 36, "test_read_buffer_8_bit_unsigned_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_8_bit_unsigned_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_8_bit_unsigned_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 40, "test_read_buffer_16_bit_signed_be_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_signed_be_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 44, "test_read_buffer_16_bit_signed_be_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_signed_be_stereo(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_be_stereo;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 48, "test_read_buffer_16_bit_unsigned_be_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_unsigned_be_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 52, "test_read_buffer_16_bit_unsigned_be_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_unsigned_be_stereo(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_be_stereo;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 56, "test_read_buffer_16_bit_signed_le_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_signed_le_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 60, "test_read_buffer_16_bit_signed_le_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_signed_le_stereo(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_signed_le_stereo;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 64, "test_read_buffer_16_bit_unsigned_le_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_unsigned_le_mono(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_mono;
+
+static class TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 68, "test_read_buffer_16_bit_unsigned_le_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_buffer_16_bit_unsigned_le_stereo(); }
+} testDescription_RawStreamTestSuite_test_read_buffer_16_bit_unsigned_le_stereo;
+
+static class TestDescription_RawStreamTestSuite_test_partial_read : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_partial_read() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 98, "test_partial_read" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_partial_read(); }
+} testDescription_RawStreamTestSuite_test_partial_read;
+
+static class TestDescription_RawStreamTestSuite_test_read_after_end : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_read_after_end() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 120, "test_read_after_end" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_read_after_end(); }
+} testDescription_RawStreamTestSuite_test_read_after_end;
+
+static class TestDescription_RawStreamTestSuite_test_rewind : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_rewind() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 144, "test_rewind" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_rewind(); }
+} testDescription_RawStreamTestSuite_test_rewind;
+
+static class TestDescription_RawStreamTestSuite_test_length : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_length() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 207, "test_length" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_length(); }
+} testDescription_RawStreamTestSuite_test_length;
+
+static class TestDescription_RawStreamTestSuite_test_seek_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_seek_mono() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 284, "test_seek_mono" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_seek_mono(); }
+} testDescription_RawStreamTestSuite_test_seek_mono;
+
+static class TestDescription_RawStreamTestSuite_test_seek_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RawStreamTestSuite_test_seek_stereo() : CxxTest::RealTestDescription( Tests_RawStreamTestSuite, suiteDescription_RawStreamTestSuite, 288, "test_seek_stereo" ) {}
+ void runTest() { suite_RawStreamTestSuite.test_seek_stereo(); }
+} testDescription_RawStreamTestSuite_test_seek_stereo;
+
+#include "test/audio/timestamp.h"
+
+static TimestampTestSuite suite_TimestampTestSuite;
+
+static CxxTest::List Tests_TimestampTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TimestampTestSuite( "test/audio/timestamp.h", 7, "TimestampTestSuite", suite_TimestampTestSuite, Tests_TimestampTestSuite );
+
+static class TestDescription_TimestampTestSuite_test_diff_add_frames : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_diff_add_frames() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 10, "test_diff_add_frames" ) {}
+ void runTest() { suite_TimestampTestSuite.test_diff_add_frames(); }
+} testDescription_TimestampTestSuite_test_diff_add_frames;
+
+static class TestDescription_TimestampTestSuite_test_diff_add_msecs : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_diff_add_msecs() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 28, "test_diff_add_msecs" ) {}
+ void runTest() { suite_TimestampTestSuite.test_diff_add_msecs(); }
+} testDescription_TimestampTestSuite_test_diff_add_msecs;
+
+static class TestDescription_TimestampTestSuite_test_ticks : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_ticks() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 60, "test_ticks" ) {}
+ void runTest() { suite_TimestampTestSuite.test_ticks(); }
+} testDescription_TimestampTestSuite_test_ticks;
+
+static class TestDescription_TimestampTestSuite_test_more_add_diff : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_more_add_diff() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 87, "test_more_add_diff" ) {}
+ void runTest() { suite_TimestampTestSuite.test_more_add_diff(); }
+} testDescription_TimestampTestSuite_test_more_add_diff;
+
+static class TestDescription_TimestampTestSuite_test_negate : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_negate() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 96, "test_negate" ) {}
+ void runTest() { suite_TimestampTestSuite.test_negate(); }
+} testDescription_TimestampTestSuite_test_negate;
+
+static class TestDescription_TimestampTestSuite_test_add_sub : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_add_sub() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 105, "test_add_sub" ) {}
+ void runTest() { suite_TimestampTestSuite.test_add_sub(); }
+} testDescription_TimestampTestSuite_test_add_sub;
+
+static class TestDescription_TimestampTestSuite_test_diff_with_conversion : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_diff_with_conversion() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 129, "test_diff_with_conversion" ) {}
+ void runTest() { suite_TimestampTestSuite.test_diff_with_conversion(); }
+} testDescription_TimestampTestSuite_test_diff_with_conversion;
+
+static class TestDescription_TimestampTestSuite_test_convert : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_convert() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 148, "test_convert" ) {}
+ void runTest() { suite_TimestampTestSuite.test_convert(); }
+} testDescription_TimestampTestSuite_test_convert;
+
+static class TestDescription_TimestampTestSuite_test_equals : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_equals() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 157, "test_equals" ) {}
+ void runTest() { suite_TimestampTestSuite.test_equals(); }
+} testDescription_TimestampTestSuite_test_equals;
+
+static class TestDescription_TimestampTestSuite_test_compare : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_compare() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 177, "test_compare" ) {}
+ void runTest() { suite_TimestampTestSuite.test_compare(); }
+} testDescription_TimestampTestSuite_test_compare;
+
+static class TestDescription_TimestampTestSuite_test_framerate : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_framerate() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 211, "test_framerate" ) {}
+ void runTest() { suite_TimestampTestSuite.test_framerate(); }
+} testDescription_TimestampTestSuite_test_framerate;
+
+static class TestDescription_TimestampTestSuite_test_direct_query : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_direct_query() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 223, "test_direct_query" ) {}
+ void runTest() { suite_TimestampTestSuite.test_direct_query(); }
+} testDescription_TimestampTestSuite_test_direct_query;
+
+static class TestDescription_TimestampTestSuite_test_no_overflow : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimestampTestSuite_test_no_overflow() : CxxTest::RealTestDescription( Tests_TimestampTestSuite, suiteDescription_TimestampTestSuite, 244, "test_no_overflow" ) {}
+ void runTest() { suite_TimestampTestSuite.test_no_overflow(); }
+} testDescription_TimestampTestSuite_test_no_overflow;
+
+#include "test/audio/towns_pc98_fmsynth.h"
+
+static TownsPC98FmSynthTestSuite suite_TownsPC98FmSynthTestSuite;
+
+static CxxTest::List Tests_TownsPC98FmSynthTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TownsPC98FmSynthTestSuite( "test/audio/towns_pc98_fmsynth.h", 81, "TownsPC98FmSynthTestSuite", suite_TownsPC98FmSynthTestSuite, Tests_TownsPC98FmSynthTestSuite );
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_0 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_0() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 202, "test_algorithm_0" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_0(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_0;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_1 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_1() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 203, "test_algorithm_1" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_1(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_1;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_2 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_2() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 204, "test_algorithm_2" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_2(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_2;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_3 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_3() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 205, "test_algorithm_3" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_3(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_3;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_4 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_4() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 206, "test_algorithm_4" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_4(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_4;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_5 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_5() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 207, "test_algorithm_5" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_5(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_5;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_6 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_6() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 208, "test_algorithm_6" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_6(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_6;
+
+static class TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_7 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TownsPC98FmSynthTestSuite_test_algorithm_7() : CxxTest::RealTestDescription( Tests_TownsPC98FmSynthTestSuite, suiteDescription_TownsPC98FmSynthTestSuite, 209, "test_algorithm_7" ) {}
+ void runTest() { suite_TownsPC98FmSynthTestSuite.test_algorithm_7(); }
+} testDescription_TownsPC98FmSynthTestSuite_test_algorithm_7;
+
+#include "test/graphics/conversion.h"
+
+static ConversionTestSuite suite_ConversionTestSuite;
+
+static CxxTest::List Tests_ConversionTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ConversionTestSuite( "test/graphics/conversion.h", 26, "ConversionTestSuite", suite_ConversionTestSuite, Tests_ConversionTestSuite );
+
+static class TestDescription_ConversionTestSuite_test_rgb565_xrgb8888 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_rgb565_xrgb8888() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 126, "test_rgb565_xrgb8888" ) {}
+ void runTest() { suite_ConversionTestSuite.test_rgb565_xrgb8888(); }
+} testDescription_ConversionTestSuite_test_rgb565_xrgb8888;
+
+static class TestDescription_ConversionTestSuite_test_rgb565_rgba8888 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_rgb565_rgba8888() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 133, "test_rgb565_rgba8888" ) {}
+ void runTest() { suite_ConversionTestSuite.test_rgb565_rgba8888(); }
+} testDescription_ConversionTestSuite_test_rgb565_rgba8888;
+
+static class TestDescription_ConversionTestSuite_test_argb8888_abgr8888 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_argb8888_abgr8888() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 140, "test_argb8888_abgr8888" ) {}
+ void runTest() { suite_ConversionTestSuite.test_argb8888_abgr8888(); }
+} testDescription_ConversionTestSuite_test_argb8888_abgr8888;
+
+static class TestDescription_ConversionTestSuite_test_rgb555_rgb565 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_rgb555_rgb565() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 147, "test_rgb555_rgb565" ) {}
+ void runTest() { suite_ConversionTestSuite.test_rgb555_rgb565(); }
+} testDescription_ConversionTestSuite_test_rgb555_rgb565;
+
+static class TestDescription_ConversionTestSuite_test_argb4444_rgba8888 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_argb4444_rgba8888() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 154, "test_argb4444_rgba8888" ) {}
+ void runTest() { suite_ConversionTestSuite.test_argb4444_rgba8888(); }
+} testDescription_ConversionTestSuite_test_argb4444_rgba8888;
+
+static class TestDescription_ConversionTestSuite_test_generic : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_generic() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 161, "test_generic" ) {}
+ void runTest() { suite_ConversionTestSuite.test_generic(); }
+} testDescription_ConversionTestSuite_test_generic;
+
+static class TestDescription_ConversionTestSuite_test_clut8 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ConversionTestSuite_test_clut8() : CxxTest::RealTestDescription( Tests_ConversionTestSuite, suiteDescription_ConversionTestSuite, 170, "test_clut8" ) {}
+ void runTest() { suite_ConversionTestSuite.test_clut8(); }
+} testDescription_ConversionTestSuite_test_clut8;
+
+#include "test/graphics/dirty_tiles.h"
+
+static DirtyTilesTestSuite suite_DirtyTilesTestSuite;
+
+static CxxTest::List Tests_DirtyTilesTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_DirtyTilesTestSuite( "test/graphics/dirty_tiles.h", 7, "DirtyTilesTestSuite", suite_DirtyTilesTestSuite, Tests_DirtyTilesTestSuite );
+
+static class TestDescription_DirtyTilesTestSuite_test_empty : public CxxTest::RealTestDescription {
+public:
+ TestDescription_DirtyTilesTestSuite_test_empty() : CxxTest::RealTestDescription( Tests_DirtyTilesTestSuite, suiteDescription_DirtyTilesTestSuite, 60, "test_empty" ) {}
+ void runTest() { suite_DirtyTilesTestSuite.test_empty(); }
+} testDescription_DirtyTilesTestSuite_test_empty;
+
+static class TestDescription_DirtyTilesTestSuite_test_single_rect : public CxxTest::RealTestDescription {
+public:
+ TestDescription_DirtyTilesTestSuite_test_single_rect() : CxxTest::RealTestDescription( Tests_DirtyTilesTestSuite, suiteDescription_DirtyTilesTestSuite, 73, "test_single_rect" ) {}
+ void runTest() { suite_DirtyTilesTestSuite.test_single_rect(); }
+} testDescription_DirtyTilesTestSuite_test_single_rect;
+
+static class TestDescription_DirtyTilesTestSuite_test_all : public CxxTest::RealTestDescription {
+public:
+ TestDescription_DirtyTilesTestSuite_test_all() : CxxTest::RealTestDescription( Tests_DirtyTilesTestSuite, suiteDescription_DirtyTilesTestSuite, 87, "test_all" ) {}
+ void runTest() { suite_DirtyTilesTestSuite.test_all(); }
+} testDescription_DirtyTilesTestSuite_test_all;
+
+static class TestDescription_DirtyTilesTestSuite_test_random : public CxxTest::RealTestDescription {
+public:
+ TestDescription_DirtyTilesTestSuite_test_random() : CxxTest::RealTestDescription( Tests_DirtyTilesTestSuite, suiteDescription_DirtyTilesTestSuite, 108, "test_random" ) {}
+ void runTest() { suite_DirtyTilesTestSuite.test_random(); }
+} testDescription_DirtyTilesTestSuite_test_random;
+
+static class TestDescription_DirtyTilesTestSuite_test_resize : public CxxTest::RealTestDescription {
+public:
+ TestDescription_DirtyTilesTestSuite_test_resize() : CxxTest::RealTestDescription( Tests_DirtyTilesTestSuite, suiteDescription_DirtyTilesTestSuite, 137, "test_resize" ) {}
+ void runTest() { suite_DirtyTilesTestSuite.test_resize(); }
+} testDescription_DirtyTilesTestSuite_test_resize;
+
+#include "test/graphics/thumbnail.h"
+
+static ThumbnailTestSuite suite_ThumbnailTestSuite;
+
+static CxxTest::List Tests_ThumbnailTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ThumbnailTestSuite( "test/graphics/thumbnail.h", 6, "ThumbnailTestSuite", suite_ThumbnailTestSuite, Tests_ThumbnailTestSuite );
+
+static class TestDescription_ThumbnailTestSuite_test_uniform : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ThumbnailTestSuite_test_uniform() : CxxTest::RealTestDescription( Tests_ThumbnailTestSuite, suiteDescription_ThumbnailTestSuite, 23, "test_uniform" ) {}
+ void runTest() { suite_ThumbnailTestSuite.test_uniform(); }
+} testDescription_ThumbnailTestSuite_test_uniform;
+
+static class TestDescription_ThumbnailTestSuite_test_average : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ThumbnailTestSuite_test_average() : CxxTest::RealTestDescription( Tests_ThumbnailTestSuite, suiteDescription_ThumbnailTestSuite, 38, "test_average" ) {}
+ void runTest() { suite_ThumbnailTestSuite.test_average(); }
+} testDescription_ThumbnailTestSuite_test_average;
+
+#include "test/graphics/transformed_surface_cache.h"
+
+static TransformedSurfaceCacheTestSuite suite_TransformedSurfaceCacheTestSuite;
+
+static CxxTest::List Tests_TransformedSurfaceCacheTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TransformedSurfaceCacheTestSuite( "test/graphics/transformed_surface_cache.h", 5, "TransformedSurfaceCacheTestSuite", suite_TransformedSurfaceCacheTestSuite, Tests_TransformedSurfaceCacheTestSuite );
+
+static class TestDescription_TransformedSurfaceCacheTestSuite_test_scale : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransformedSurfaceCacheTestSuite_test_scale() : CxxTest::RealTestDescription( Tests_TransformedSurfaceCacheTestSuite, suiteDescription_TransformedSurfaceCacheTestSuite, 35, "test_scale" ) {}
+ void runTest() { suite_TransformedSurfaceCacheTestSuite.test_scale(); }
+} testDescription_TransformedSurfaceCacheTestSuite_test_scale;
+
+static class TestDescription_TransformedSurfaceCacheTestSuite_test_rotoscale : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransformedSurfaceCacheTestSuite_test_rotoscale() : CxxTest::RealTestDescription( Tests_TransformedSurfaceCacheTestSuite, suiteDescription_TransformedSurfaceCacheTestSuite, 71, "test_rotoscale" ) {}
+ void runTest() { suite_TransformedSurfaceCacheTestSuite.test_rotoscale(); }
+} testDescription_TransformedSurfaceCacheTestSuite_test_rotoscale;
+
+static class TestDescription_TransformedSurfaceCacheTestSuite_test_size_limit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransformedSurfaceCacheTestSuite_test_size_limit() : CxxTest::RealTestDescription( Tests_TransformedSurfaceCacheTestSuite, suiteDescription_TransformedSurfaceCacheTestSuite, 97, "test_size_limit" ) {}
+ void runTest() { suite_TransformedSurfaceCacheTestSuite.test_size_limit(); }
+} testDescription_TransformedSurfaceCacheTestSuite_test_size_limit;
+
+#include "test/graphics/transparent_surface.h"
+
+static TransparentSurfaceTestSuite suite_TransparentSurfaceTestSuite;
+
+static CxxTest::List Tests_TransparentSurfaceTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TransparentSurfaceTestSuite( "test/graphics/transparent_surface.h", 95, "TransparentSurfaceTestSuite", suite_TransparentSurfaceTestSuite, Tests_TransparentSurfaceTestSuite );
+
+static class TestDescription_TransparentSurfaceTestSuite_test_alpha_blend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceTestSuite_test_alpha_blend() : CxxTest::RealTestDescription( Tests_TransparentSurfaceTestSuite, suiteDescription_TransparentSurfaceTestSuite, 157, "test_alpha_blend" ) {}
+ void runTest() { suite_TransparentSurfaceTestSuite.test_alpha_blend(); }
+} testDescription_TransparentSurfaceTestSuite_test_alpha_blend;
+
+static class TestDescription_TransparentSurfaceTestSuite_test_binary_blend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceTestSuite_test_binary_blend() : CxxTest::RealTestDescription( Tests_TransparentSurfaceTestSuite, suiteDescription_TransparentSurfaceTestSuite, 158, "test_binary_blend" ) {}
+ void runTest() { suite_TransparentSurfaceTestSuite.test_binary_blend(); }
+} testDescription_TransparentSurfaceTestSuite_test_binary_blend;
+
+static class TestDescription_TransparentSurfaceTestSuite_test_additive_blend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceTestSuite_test_additive_blend() : CxxTest::RealTestDescription( Tests_TransparentSurfaceTestSuite, suiteDescription_TransparentSurfaceTestSuite, 159, "test_additive_blend" ) {}
+ void runTest() { suite_TransparentSurfaceTestSuite.test_additive_blend(); }
+} testDescription_TransparentSurfaceTestSuite_test_additive_blend;
+
+static class TestDescription_TransparentSurfaceTestSuite_test_subtractive_blend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceTestSuite_test_subtractive_blend() : CxxTest::RealTestDescription( Tests_TransparentSurfaceTestSuite, suiteDescription_TransparentSurfaceTestSuite, 160, "test_subtractive_blend" ) {}
+ void runTest() { suite_TransparentSurfaceTestSuite.test_subtractive_blend(); }
+} testDescription_TransparentSurfaceTestSuite_test_subtractive_blend;
+
+static class TestDescription_TransparentSurfaceTestSuite_test_multiply_blend : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceTestSuite_test_multiply_blend() : CxxTest::RealTestDescription( Tests_TransparentSurfaceTestSuite, suiteDescription_TransparentSurfaceTestSuite, 161, "test_multiply_blend" ) {}
+ void runTest() { suite_TransparentSurfaceTestSuite.test_multiply_blend(); }
+} testDescription_TransparentSurfaceTestSuite_test_multiply_blend;
+
+#include "test/graphics/yuv_to_rgb.h"
+
+static YUVToRGBTestSuite suite_YUVToRGBTestSuite;
+
+static CxxTest::List Tests_YUVToRGBTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_YUVToRGBTestSuite( "test/graphics/yuv_to_rgb.h", 29, "YUVToRGBTestSuite", suite_YUVToRGBTestSuite, Tests_YUVToRGBTestSuite );
+
+static class TestDescription_YUVToRGBTestSuite_test_yuv444 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_YUVToRGBTestSuite_test_yuv444() : CxxTest::RealTestDescription( Tests_YUVToRGBTestSuite, suiteDescription_YUVToRGBTestSuite, 148, "test_yuv444" ) {}
+ void runTest() { suite_YUVToRGBTestSuite.test_yuv444(); }
+} testDescription_YUVToRGBTestSuite_test_yuv444;
+
+static class TestDescription_YUVToRGBTestSuite_test_yuv420 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_YUVToRGBTestSuite_test_yuv420() : CxxTest::RealTestDescription( Tests_YUVToRGBTestSuite, suiteDescription_YUVToRGBTestSuite, 153, "test_yuv420" ) {}
+ void runTest() { suite_YUVToRGBTestSuite.test_yuv420(); }
+} testDescription_YUVToRGBTestSuite_test_yuv420;
+
+static class TestDescription_YUVToRGBTestSuite_test_yuv410 : public CxxTest::RealTestDescription {
+public:
+ TestDescription_YUVToRGBTestSuite_test_yuv410() : CxxTest::RealTestDescription( Tests_YUVToRGBTestSuite, suiteDescription_YUVToRGBTestSuite, 158, "test_yuv410" ) {}
+ void runTest() { suite_YUVToRGBTestSuite.test_yuv410(); }
+} testDescription_YUVToRGBTestSuite_test_yuv410;
+
+#include <cxxtest/Root.cpp>
@@ -0,0 +1,142 @@
+#ifndef TEST_SYSTEM_H
+#define TEST_SYSTEM_H
+
+#include "common/system.h"
+#include "common/list.h"
+
+#include "graphics/pixelformat.h"
+
+#include "backends/fs/abstract-fs.h"
+#include "backends/fs/fs-factory.h"
+
+/**
+ * A file system without any files, for the code which looks for some, e.g.
+ * through SearchMan.
+ */
+class TestFSNode : public AbstractFSNode {
+public:
+	TestFSNode(const Common::String &path) : _path(path) {}
+
+	virtual AbstractFSNode *getChild(const Common::String &name) const { return new TestFSNode(_path + "/" + name); }
+	virtual AbstractFSNode *getParent() const { return new TestFSNode(""); }
+	virtual bool exists() const { return false; }
+	virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const { return false; }
+	virtual Common::String getName() const { return Common::lastPathComponent(_path, '/'); }
+	virtual Common::String getPath() const { return _path; }
+	virtual bool isDirectory() const { return false; }
+	virtual bool isReadable() const { return false; }
+	virtual bool isWritable() const { return false; }
+	virtual Common::SeekableReadStream *createReadStream() { return 0; }
+	virtual Common::WriteStream *createWriteStream() { return 0; }
+	virtual bool createDirectory() { return false; }
+
+private:
+	Common::String _path;
+};
+
+class TestFilesystemFactory : public FilesystemFactory {
+public:
+	virtual AbstractFSNode *makeCurrentDirectoryFileNode() const { return new TestFSNode("."); }
+	virtual AbstractFSNode *makeFileNodePath(const Common::String &path) const { return new TestFSNode(path); }
+	virtual AbstractFSNode *makeRootFileNode() const { return new TestFSNode(""); }
+};
+
+/**
+ * A minimal OSystem for the tests of code which needs g_system, e.g. for
+ * its mutexes.
+ *
+ * There is neither a screen nor a mixer, and the overlay only has a size and
+ * a format for the GUI to create its surfaces with. The tests run on a
+ * single thread, so the mutexes only check that they are locked and unlocked
+ * in pairs, and threads and semaphores are not supported at all. The clock
+ * advances by a millisecond whenever it is read, so that code which times
+ * itself always sees time pass.
+ */
+class TestSystem : public OSystem {
+public:
+	TestSystem() : _millis(0) { _fsFactory = new TestFilesystemFactory(); }
+	virtual ~TestSystem() {}
+
+	virtual const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode modes[] = { { 0, 0, 0 } };
+		return modes;
+	}
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return mode == 0; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat::createFormatCLUT8());
+		return formats;
+	}
+
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = nullptr) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeXOffset, int shakeYOffset) {}
+
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 400; }
+	virtual int16 getOverlayWidth() { return 640; }
+
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = nullptr) {}
+
+	virtual uint32 getMillis(bool skipRecord = false) { return _millis++; }
+	virtual void delayMillis(uint msecs) {}
+	virtual void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+
+	virtual MutexRef createMutex() { return (MutexRef)new TestMutex(); }
+	virtual void lockMutex(MutexRef mutex) { ((TestMutex *)mutex)->_locks++; }
+	virtual void unlockMutex(MutexRef mutex) {
+		assert(((TestMutex *)mutex)->_locks > 0);
+		((TestMutex *)mutex)->_locks--;
+	}
+	virtual void deleteMutex(MutexRef mutex) {
+		assert(((TestMutex *)mutex)->_locks == 0);
+		delete (TestMutex *)mutex;
+	}
+
+	virtual Audio::Mixer *getMixer() { return 0; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+
+private:
+	uint32 _millis;
+
+	// Mutexes are recursive, so only count the locks
+	struct TestMutex {
+		TestMutex() : _locks(0) {}
+		int _locks;
+	};
+};
+
+/**
+ * Installs a TestSystem as g_system for as long as the object exists.
+ */
+class ScopedTestSystem {
+public:
+	ScopedTestSystem() : _oldSystem(g_system) { g_system = &_system; }
+	~ScopedTestSystem() { g_system = _oldSystem; }
+
+private:
+	TestSystem _system;
+	OSystem *_oldSystem;
+};
+
+#endif